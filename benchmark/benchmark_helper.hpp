@@ -0,0 +1,51 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef BENCHMARK_HELPER_HPP_
+#define BENCHMARK_HELPER_HPP_
+
+// std
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// romea
+#include "romea_core_common/time/Time.hpp"
+
+// Median duration in milliseconds of numberOfRuns calls of function
+template<typename Function>
+double measureMilliseconds(Function && function, const size_t & numberOfRuns = 5)
+{
+  std::vector<double> durations(numberOfRuns);
+  for (double & d : durations) {
+    romea::core::TimePoint start = romea::core::now();
+    function();
+    d = romea::core::durationToSecond(romea::core::duration(romea::core::now(), start)) * 1000;
+  }
+
+  std::nth_element(durations.begin(), durations.begin() + numberOfRuns / 2, durations.end());
+  return durations[numberOfRuns / 2];
+}
+
+//-----------------------------------------------------------------------------
+inline void printMeasure(const std::string & name, const double & milliseconds)
+{
+  std::cout << std::left << std::setw(48) << name << std::right << std::setw(12) <<
+    std::fixed << std::setprecision(3) << milliseconds << " ms" << std::endl;
+}
+
+#endif  // BENCHMARK_HELPER_HPP_
@@ -0,0 +1,89 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Point containment against thousands of oriented boxes (field zones):
+// linear scan of OrientedBoundingBox::isInside versus bounding volume
+// hierarchy queries, and bounding volume hierarchy construction time.
+
+// Eigen
+#include <Eigen/Geometry>
+
+// std
+#include <string>
+#include <vector>
+
+// romea
+#include "romea_core_common/containers/boundingbox/BoundingVolumeHierarchy.hpp"
+#include "romea_core_common/math/RandomGenerator.hpp"
+#include "benchmark_helper.hpp"
+
+//-----------------------------------------------------------------------------
+void benchmark(const size_t & numberOfBoxes)
+{
+  const size_t numberOfPoints = 100000;
+  romea::core::RandomGenerator generator(0);
+  auto uniform = [&](const double & range) {
+      return range * (2 * romea::core::generateUniform<double>(generator) - 1);
+    };
+
+  std::vector<romea::core::OrientedBoundingBox2d> boxes;
+  for (size_t n = 0; n < numberOfBoxes; ++n) {
+    boxes.emplace_back(Eigen::Vector2d(uniform(500), uniform(500)),
+      Eigen::Vector2d(2 + uniform(1), 2 + uniform(1)),
+      Eigen::Rotation2Dd(uniform(M_PI)).matrix());
+  }
+
+  romea::core::PointSet<Eigen::Vector2d> points(numberOfPoints);
+  for (Eigen::Vector2d & point : points) {
+    point = Eigen::Vector2d(uniform(500), uniform(500));
+  }
+
+  std::string suffix = " " + std::to_string(numberOfBoxes) + " boxes " +
+    std::to_string(numberOfPoints) + " points";
+
+  std::vector<size_t> boxIndexes(numberOfPoints);
+  printMeasure("linear scan" + suffix, measureMilliseconds([&]() {
+      for (size_t n = 0; n < numberOfPoints; ++n) {
+        boxIndexes[n] = romea::core::BoundingVolumeHierarchy2d::NO_BOX;
+        for (size_t k = 0; k < numberOfBoxes; ++k) {
+          if (boxes[k].isInside(points[n])) {
+            boxIndexes[n] = k;
+            break;
+          }
+        }
+      }
+    }, 1));
+
+  romea::core::BoundingVolumeHierarchy2d bvh;
+  printMeasure("bvh build" + suffix, measureMilliseconds([&]() {
+      bvh.clear();
+      for (const auto & box : boxes) {
+        bvh.addBox(box);
+      }
+      bvh.build();
+    }));
+
+  printMeasure("bvh queries" + suffix, measureMilliseconds([&]() {
+      bvh.findContainingBoxes(points, boxIndexes);
+    }));
+}
+
+//-----------------------------------------------------------------------------
+int main()
+{
+  for (size_t numberOfBoxes : {100, 1000, 10000}) {
+    benchmark(numberOfBoxes);
+  }
+  return 0;
+}
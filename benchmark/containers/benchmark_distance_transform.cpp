@@ -0,0 +1,126 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// Distance to closest obstacle on planner like grids : brute force search
+// in a window around each cell versus exact Felzenszwalb-Huttenlocher
+// distance transform, full computation and incremental update after a few
+// cell changes or a wrappable grid translation.
+
+// std
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// romea
+#include "romea_core_common/containers/grid/DistanceTransform.hpp"
+#include "romea_core_common/math/RandomGenerator.hpp"
+#include "benchmark_helper.hpp"
+
+//-----------------------------------------------------------------------------
+template<size_t DIM>
+void benchmark(const Eigen::Matrix<size_t, DIM, 1> & numberOfCells)
+{
+  using CellIndexes = Eigen::Matrix<size_t, DIM, 1>;
+  const double resolution = 0.1;
+  const double maximalDistance = 1.;
+
+  // 1% of random obstacles
+  romea::core::RandomGenerator generator(0);
+  romea::core::WrappableGrid<std::uint8_t, DIM> grid(numberOfCells);
+  for (std::uint8_t & value : grid.getBuffer()) {
+    value = generator() % 100 == 0;
+  }
+  auto isObstacle = [](const std::uint8_t & value) {return value != 0;};
+  auto randomCell = [&]() {
+      CellIndexes cellIndexes;
+      for (size_t i = 0; i < DIM; ++i) {
+        cellIndexes[i] = generator() % numberOfCells[i];
+      }
+      return cellIndexes;
+    };
+
+  std::string suffix = " " + std::to_string(DIM) + "D " +
+    std::to_string(numberOfCells.prod()) + " cells";
+
+  if constexpr (DIM == 2) {
+    // naive search of obstacles closer than maximal distance
+    romea::core::Grid<double, DIM> squaredDistances(numberOfCells);
+    const long long radius = maximalDistance / resolution;
+    printMeasure("brute force window search" + suffix, measureMilliseconds([&]() {
+        for (long long y = 0; y < (long long)numberOfCells[1]; ++y) {
+          for (long long x = 0; x < (long long)numberOfCells[0]; ++x) {
+            long long best = radius * radius;
+            for (long long j = std::max(0LL, y - radius);
+            j <= std::min((long long)numberOfCells[1] - 1, y + radius); ++j)
+            {
+              for (long long i = std::max(0LL, x - radius);
+              i <= std::min((long long)numberOfCells[0] - 1, x + radius); ++i)
+              {
+                if (grid(CellIndexes(i, j))) {
+                  best = std::min(best, (i - x) * (i - x) + (j - y) * (j - y));
+                }
+              }
+            }
+            squaredDistances(CellIndexes(x, y)) = best;
+          }
+        }
+      }, 1));
+  }
+
+  std::vector<size_t> numbersOfThreads = {1};
+  if (romea::core::getDefaultNumberOfThreads() > 1) {
+    numbersOfThreads.push_back(romea::core::getDefaultNumberOfThreads());
+  }
+
+  for (const size_t & numberOfThreads : numbersOfThreads) {
+    std::string threads = " " + std::to_string(numberOfThreads) + " thread(s)";
+    romea::core::DistanceTransform<double, DIM> distanceTransform(
+      numberOfCells, resolution, maximalDistance);
+    distanceTransform.setMaximalNumberOfThreads(numberOfThreads);
+
+    printMeasure("full distance transform" + suffix + threads, measureMilliseconds([&]() {
+        distanceTransform.compute(grid, isObstacle);
+      }));
+
+    printMeasure("update after 10 changed cells" + suffix + threads, measureMilliseconds([&]() {
+        const CellIndexes center = randomCell();
+        for (size_t n = 0; n < 10; ++n) {
+          CellIndexes cellIndexes = center;
+          cellIndexes[0] = std::min(cellIndexes[0] + n, numberOfCells[0] - 1);
+          grid(cellIndexes) = !grid(cellIndexes);
+          distanceTransform.markChangedCell(cellIndexes);
+        }
+        distanceTransform.update(grid, isObstacle);
+      }));
+
+    printMeasure("update after translation" + suffix + threads, measureMilliseconds([&]() {
+        Eigen::Matrix<int, DIM, 1> offset = Eigen::Matrix<int, DIM, 1>::Zero();
+        offset[0] = 2;
+        offset[1] = -1;
+        grid.translate(offset, 0);
+        distanceTransform.translate(offset);
+        distanceTransform.update(grid, isObstacle);
+      }));
+  }
+}
+
+//-----------------------------------------------------------------------------
+int main()
+{
+  benchmark<2>(Eigen::Matrix<size_t, 2, 1>(1000, 1000));
+  benchmark<3>(Eigen::Matrix<size_t, 3, 1>(200, 200, 50));
+  return 0;
+}
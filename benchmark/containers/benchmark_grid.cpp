@@ -0,0 +1,253 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// Compare cell access costs of the legacy virtual grid (copied below) with the
+// non virtual row major Grid, the TiledGrid and the SparseGrid : full sweeps,
+// row by row bulk processing, reductions, random local 3D neighbourhood updates
+// and ray updates.
+
+// std
+#include <string>
+#include <vector>
+
+// romea
+#include "romea_core_common/containers/grid/Grid.hpp"
+#include "romea_core_common/containers/grid/SparseGrid.hpp"
+#include "romea_core_common/containers/grid/TiledGrid.hpp"
+#include "romea_core_common/containers/grid/WrappableGrid.hpp"
+#include "romea_core_common/math/RandomGenerator.hpp"
+#include "benchmark_helper.hpp"
+
+// Previous grid implementation : virtual cell access and Eigen dot product indexing
+template<typename T, size_t DIM>
+class LegacyGrid
+{
+public:
+  using CellIndexes = Eigen::Matrix<size_t, DIM, 1>;
+
+  explicit LegacyGrid(const CellIndexes & numberOfCellsAlongAxes)
+  : numberOfCellsAlongAxes_(numberOfCellsAlongAxes),
+    indexCoefficients_(),
+    buffer_(numberOfCellsAlongAxes.array().prod())
+  {
+    indexCoefficients_[0] = 1;
+    indexCoefficients_[1] = numberOfCellsAlongAxes_[0];
+    if (DIM == 3) {indexCoefficients_[2] = numberOfCellsAlongAxes_[1] * numberOfCellsAlongAxes_[0];}
+  }
+
+  virtual ~LegacyGrid() = default;
+
+  virtual T & operator()(const CellIndexes & cellIndexes)
+  {
+    return buffer_[computeCellLinearIndex_(cellIndexes)];
+  }
+
+protected:
+  virtual size_t computeCellLinearIndex_(const CellIndexes & cellIndexes) const
+  {
+    return cellIndexes.dot(indexCoefficients_);
+  }
+
+  CellIndexes numberOfCellsAlongAxes_;
+  CellIndexes indexCoefficients_;
+  std::vector<T> buffer_;
+};
+
+const size_t SIZE_2D = 2048;
+const size_t SIZE_3D = 320;
+const size_t NUMBER_OF_RAYS = 20000;
+const size_t RAY_LENGTH = 256;
+const size_t NUMBER_OF_UPDATES = 20000;
+const size_t UPDATE_RADIUS = 2;
+
+//-----------------------------------------------------------------------------
+template<class GridType>
+__attribute__((noinline)) float sweep2D(GridType & grid)
+{
+  using CellIndexes = Eigen::Matrix<size_t, 2, 1>;
+  float sum = 0;
+  for (size_t yi = 0; yi < SIZE_2D; ++yi) {
+    for (size_t xi = 0; xi < SIZE_2D; ++xi) {
+      float & value = grid(CellIndexes(xi, yi));
+      value = 0.5f * value + 1.f;
+      sum += value;
+    }
+  }
+  return sum;
+}
+
+//-----------------------------------------------------------------------------
+template<class GridType>
+__attribute__((noinline)) void updateNeighbourhoods3D(
+  GridType & grid,
+  const std::vector<Eigen::Matrix<size_t, 3, 1>> & centers)
+{
+  using CellIndexes = Eigen::Matrix<size_t, 3, 1>;
+  for (const CellIndexes & center : centers) {
+    for (size_t zi = center.z() - UPDATE_RADIUS; zi <= center.z() + UPDATE_RADIUS; ++zi) {
+      for (size_t yi = center.y() - UPDATE_RADIUS; yi <= center.y() + UPDATE_RADIUS; ++yi) {
+        for (size_t xi = center.x() - UPDATE_RADIUS; xi <= center.x() + UPDATE_RADIUS; ++xi) {
+          grid(CellIndexes(xi, yi, zi)) += 0.1f;
+        }
+      }
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+template<class GridType>
+__attribute__((noinline)) void castRays3D(
+  GridType & grid,
+  const std::vector<Eigen::Vector3f> & origins,
+  const std::vector<Eigen::Vector3f> & directions)
+{
+  for (size_t n = 0; n < origins.size(); ++n) {
+    Eigen::Vector3f position = origins[n];
+    for (size_t step = 0; step < RAY_LENGTH; ++step) {
+      grid(position.cast<size_t>()) += 0.1f;
+      position += directions[n];
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+void benchmark2D()
+{
+  using CellIndexes = Eigen::Matrix<size_t, 2, 1>;
+  std::string suffix = " " + std::to_string(SIZE_2D) + "x" + std::to_string(SIZE_2D);
+
+  LegacyGrid<float, 2> legacyGrid(CellIndexes(SIZE_2D, SIZE_2D));
+  LegacyGrid<float, 2> & legacyGridReference = legacyGrid;
+  printMeasure("legacy virtual sweep" + suffix, measureMilliseconds([&]() {
+      sweep2D(legacyGridReference);
+    }));
+
+  romea::core::Grid<float, 2> grid(CellIndexes(SIZE_2D, SIZE_2D));
+  printMeasure("grid sweep" + suffix, measureMilliseconds([&]() {
+      sweep2D(grid);
+    }));
+
+  printMeasure("grid row sweep" + suffix, measureMilliseconds([&]() {
+      for (size_t yi = 0; yi < SIZE_2D; ++yi) {
+        float * row = grid.getRow(yi);
+        for (size_t xi = 0; xi < SIZE_2D; ++xi) {
+          row[xi] = 0.5f * row[xi] + 1.f;
+        }
+      }
+    }));
+
+  volatile float result = 0;
+  printMeasure("legacy sum" + suffix, measureMilliseconds([&]() {
+      float sum = 0;
+      for (size_t yi = 0; yi < SIZE_2D; ++yi) {
+        for (size_t xi = 0; xi < SIZE_2D; ++xi) {
+          sum += legacyGridReference(CellIndexes(xi, yi));
+        }
+      }
+      result = sum;
+    }));
+
+  printMeasure("grid sum" + suffix, measureMilliseconds([&]() {
+      result = grid.sum();
+    }));
+
+  printMeasure("grid box fill" + suffix, measureMilliseconds([&]() {
+      grid.setValue(CellIndexes(1, 1), CellIndexes(SIZE_2D - 2, SIZE_2D - 2), 0.5f);
+    }));
+}
+
+//-----------------------------------------------------------------------------
+void benchmark3D()
+{
+  using CellIndexes = Eigen::Matrix<size_t, 3, 1>;
+  std::string suffix = " " + std::to_string(NUMBER_OF_UPDATES) + " neighbourhoods";
+
+  romea::core::RandomGenerator generator(0);
+  std::vector<CellIndexes> centers(NUMBER_OF_UPDATES);
+  for (CellIndexes & center : centers) {
+    for (size_t n = 0; n < 3; ++n) {
+      center[n] = UPDATE_RADIUS + size_t(
+        romea::core::generateUniform<double>(generator) * (SIZE_3D - 2 * UPDATE_RADIUS));
+    }
+  }
+
+  const CellIndexes numberOfCells = CellIndexes::Constant(SIZE_3D);
+
+  LegacyGrid<float, 3> legacyGrid(numberOfCells);
+  LegacyGrid<float, 3> & legacyGridReference = legacyGrid;
+  printMeasure("legacy virtual 3D updates" + suffix, measureMilliseconds([&]() {
+      updateNeighbourhoods3D(legacyGridReference, centers);
+    }));
+
+  romea::core::Grid<float, 3> grid(numberOfCells);
+  printMeasure("grid 3D updates" + suffix, measureMilliseconds([&]() {
+      updateNeighbourhoods3D(grid, centers);
+    }));
+
+  romea::core::TiledGrid<float, 3, 2> tiledGrid4(numberOfCells);
+  printMeasure("tiled grid 4^3 3D updates" + suffix, measureMilliseconds([&]() {
+      updateNeighbourhoods3D(tiledGrid4, centers);
+    }));
+
+  romea::core::TiledGrid<float, 3, 3> tiledGrid8(numberOfCells);
+  printMeasure("tiled grid 8^3 3D updates" + suffix, measureMilliseconds([&]() {
+      updateNeighbourhoods3D(tiledGrid8, centers);
+    }));
+
+  // Rays start at grid center, each step moves by at most half a cell
+  std::vector<Eigen::Vector3f> origins(NUMBER_OF_RAYS, Eigen::Vector3f::Constant(SIZE_3D / 2.f));
+  std::vector<Eigen::Vector3f> directions(NUMBER_OF_RAYS);
+  romea::core::generateStandardNormals(generator, directions[0].data(), 3 * NUMBER_OF_RAYS);
+  for (Eigen::Vector3f & direction : directions) {
+    direction *= 0.5f / direction.norm();
+  }
+
+  suffix = " " + std::to_string(NUMBER_OF_RAYS) + " rays";
+  printMeasure("legacy virtual 3D rays" + suffix, measureMilliseconds([&]() {
+      castRays3D(legacyGridReference, origins, directions);
+    }));
+
+  printMeasure("grid 3D rays" + suffix, measureMilliseconds([&]() {
+      castRays3D(grid, origins, directions);
+    }));
+
+  printMeasure("tiled grid 4^3 3D rays" + suffix, measureMilliseconds([&]() {
+      castRays3D(tiledGrid4, origins, directions);
+    }));
+
+  printMeasure("tiled grid 8^3 3D rays" + suffix, measureMilliseconds([&]() {
+      castRays3D(tiledGrid8, origins, directions);
+    }));
+
+  romea::core::SparseGrid<float, 3> sparseGrid(numberOfCells);
+  printMeasure("sparse grid 8^3 3D rays" + suffix, measureMilliseconds([&]() {
+      castRays3D(sparseGrid, origins, directions);
+    }));
+
+  // Rolling map following a robot, one cell shift along each axis
+  romea::core::WrappableGrid<float, 3> wrappableGrid(numberOfCells);
+  using CellIndexesOffset = romea::core::WrappableGrid<float, 3>::CellIndexesOffset;
+  printMeasure("wrappable grid translate (1,-1,1)", measureMilliseconds([&]() {
+      wrappableGrid.translate(CellIndexesOffset(1, -1, 1));
+    }));
+}
+
+//-----------------------------------------------------------------------------
+int main()
+{
+  benchmark2D();
+  benchmark3D();
+  return 0;
+}
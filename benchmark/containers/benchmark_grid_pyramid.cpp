@@ -0,0 +1,84 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Max pooled grid pyramid : naive cell by cell pooling of each level versus
+// GridPyramid row wise construction, and refresh after a small modification.
+
+// std
+#include <algorithm>
+#include <string>
+#include <vector>
+
+// romea
+#include "romea_core_common/containers/grid/GridPyramid.hpp"
+#include "romea_core_common/math/RandomGenerator.hpp"
+#include "benchmark_helper.hpp"
+
+//-----------------------------------------------------------------------------
+void benchmark(const size_t & size, const size_t & numberOfLevels)
+{
+  using CellIndexes = Eigen::Matrix<size_t, 2, 1>;
+
+  romea::core::RandomGenerator generator(0);
+  romea::core::Grid<float, 2> grid(CellIndexes(size, size));
+  for (float & value : grid.getBuffer()) {
+    value = romea::core::generateUniform<float>(generator);
+  }
+
+  std::string suffix = " " + std::to_string(size) + "x" + std::to_string(size) +
+    " " + std::to_string(numberOfLevels) + " levels";
+
+  std::vector<romea::core::Grid<float, 2>> levels(numberOfLevels);
+  printMeasure("naive cell by cell" + suffix, measureMilliseconds([&]() {
+      const romea::core::Grid<float, 2> * source = &grid;
+      for (size_t level = 1; level < numberOfLevels; ++level) {
+        const CellIndexes sourceNumberOfCells = source->getNumberOfCellsAlongAxes();
+        levels[level].init((sourceNumberOfCells.array() + 1) / 2);
+        const CellIndexes numberOfCells = levels[level].getNumberOfCellsAlongAxes();
+        for (size_t y = 0; y < numberOfCells[1]; ++y) {
+          for (size_t x = 0; x < numberOfCells[0]; ++x) {
+            float value = (*source)(CellIndexes(2 * x, 2 * y));
+            for (size_t j = 2 * y; j < std::min(2 * y + 2, sourceNumberOfCells[1]); ++j) {
+              for (size_t i = 2 * x; i < std::min(2 * x + 2, sourceNumberOfCells[0]); ++i) {
+                value = std::max(value, (*source)(CellIndexes(i, j)));
+              }
+            }
+            levels[level](CellIndexes(x, y)) = value;
+          }
+        }
+        source = &levels[level];
+      }
+    }));
+
+  romea::core::GridPyramid<float, 2> pyramid(numberOfLevels);
+  printMeasure("grid pyramid build" + suffix, measureMilliseconds([&]() {
+      pyramid.build(grid);
+    }));
+
+  printMeasure("grid pyramid refresh 10x10 cells" + suffix, measureMilliseconds([&]() {
+      const CellIndexes first(generator() % (size - 10), generator() % (size - 10));
+      const CellIndexes last = first + CellIndexes(9, 9);
+      grid.setValue(first, last, 2.f);
+      pyramid.markDirtyCells(first, last);
+      pyramid.refresh();
+    }));
+}
+
+//-----------------------------------------------------------------------------
+int main()
+{
+  benchmark(1024, 6);
+  benchmark(4001, 8);
+  return 0;
+}
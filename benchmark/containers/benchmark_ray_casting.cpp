@@ -0,0 +1,231 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// Cast full scans on the ray tracing test grids (10 m range, 10 cm cells) :
+// one allocated cell vector per ray versus scan level visitor and
+// deduplicated free and occupied cells, with one and all hardware threads,
+// and log odds occupancy grid scan integration. Raw traversal speed of the
+// fixed point DDA is compared with the former floating point one.
+
+// std
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+// romea
+#include "romea_core_common/containers/grid/Grid.hpp"
+#include "romea_core_common/containers/grid/OccupancyGrid.hpp"
+#include "romea_core_common/containers/grid/ScanRayCasting.hpp"
+#include "romea_core_common/math/RandomGenerator.hpp"
+#include "benchmark_helper.hpp"
+
+// Floating point traversal as implemented before the fixed point one
+template<size_t DIM>
+class LegacyRayCasting
+{
+public:
+  using PointType = Eigen::Matrix<double, DIM, 1>;
+  using CellIndexes = Eigen::Matrix<size_t, DIM, 1>;
+
+  explicit LegacyRayCasting(romea::core::GridIndexMapping<double, DIM> * gridIndexMapping)
+  : gridIndexMapping_(gridIndexMapping)
+  {
+  }
+
+  void setOriginPoint(const PointType & originPoint)
+  {
+    rayOriginPoint_ = originPoint;
+    rayOriginIndexes_ = gridIndexMapping_->computeCellIndexes(originPoint);
+  }
+
+  void setEndPoint(const PointType & endPoint)
+  {
+    rayEndIndexes_ = gridIndexMapping_->computeCellIndexes(endPoint);
+    PointType center = gridIndexMapping_->computeCellCenterPosition(rayOriginIndexes_);
+    PointType direction = (endPoint - rayOriginPoint_).normalized();
+    for (size_t i = 0; i < DIM; ++i) {
+      rayStep_[i] = direction[i] > 0 ? 1 : (direction[i] < 0 ? -1 : 0);
+      if (rayStep_[i] != 0) {
+        double border = center[i] + rayStep_[i] * gridIndexMapping_->getCellResolution() * 0.5;
+        rayTMax_[i] = (border - rayOriginPoint_[i]) / direction[i];
+        rayTDelta_[i] = gridIndexMapping_->getCellResolution() / std::abs(direction[i]);
+      } else {
+        rayTMax_[i] = rayTDelta_[i] = std::numeric_limits<double>::max();
+      }
+    }
+  }
+
+  size_t computeRayNumberOfCells() const
+  {
+    return (rayEndIndexes_.template cast<int>() -
+           rayOriginIndexes_.template cast<int>()).array().abs().sum() + 1;
+  }
+
+  const CellIndexes & getOriginPointIndexes() const {return rayOriginIndexes_;}
+
+  void next(CellIndexes & cellIndexes)
+  {
+    size_t axis = 0;
+    for (size_t i = 1; i < DIM; ++i) {
+      if (!(rayTMax_[axis] < rayTMax_[i])) {
+        axis = i;
+      }
+    }
+    cellIndexes[axis] += rayStep_[axis];
+    rayTMax_[axis] += rayTDelta_[axis];
+  }
+
+private:
+  romea::core::GridIndexMapping<double, DIM> * gridIndexMapping_;
+  PointType rayOriginPoint_;
+  CellIndexes rayOriginIndexes_;
+  CellIndexes rayEndIndexes_;
+  PointType rayTMax_;
+  PointType rayTDelta_;
+  Eigen::Matrix<int, DIM, 1> rayStep_;
+};
+
+//-----------------------------------------------------------------------------
+template<class RayCastingType, class PointType>
+size_t traverse(
+  RayCastingType & rayCasting,
+  const PointType & originPoint,
+  const romea::core::VectorOfEigenVector<PointType> & endPoints)
+{
+  size_t checksum = 0;
+  rayCasting.setOriginPoint(originPoint);
+  for (const PointType & endPoint : endPoints) {
+    rayCasting.setEndPoint(endPoint);
+    auto cellIndexes = rayCasting.getOriginPointIndexes();
+    for (size_t n = rayCasting.computeRayNumberOfCells(); n > 1; --n) {
+      rayCasting.next(cellIndexes);
+    }
+    checksum += cellIndexes.sum();
+  }
+  return checksum;
+}
+
+//-----------------------------------------------------------------------------
+template<class RayCastingType, class PointType>
+void benchmarkTraversal(
+  const std::string & name,
+  RayCastingType & rayCasting,
+  const PointType & originPoint,
+  const romea::core::VectorOfEigenVector<PointType> & endPoints)
+{
+  size_t numberOfSteps = 0;
+  rayCasting.setOriginPoint(originPoint);
+  for (const PointType & endPoint : endPoints) {
+    rayCasting.setEndPoint(endPoint);
+    numberOfSteps += rayCasting.computeRayNumberOfCells() - 1;
+  }
+
+  size_t checksum = 0;
+  double milliseconds = measureMilliseconds([&]() {
+        checksum += traverse(rayCasting, originPoint, endPoints);
+      });
+  printMeasure(name, milliseconds);
+  std::cout << "  " << numberOfSteps / (milliseconds * 1000) << " Msteps/s (checksum " <<
+    checksum << ")" << std::endl;
+}
+
+//-----------------------------------------------------------------------------
+template<size_t DIM>
+void benchmark(const size_t & numberOfRays)
+{
+  using PointType = Eigen::Matrix<double, DIM, 1>;
+  using CellIndexes = Eigen::Matrix<size_t, DIM, 1>;
+
+  romea::core::GridIndexMapping<double, DIM> gridIndexMapping(10., 0.1);
+  romea::core::Grid<float, DIM> grid(gridIndexMapping.getNumberOfCellsAlongAxes());
+
+  // Lidar like scan, end points between 5 and 9.5 meters
+  romea::core::RandomGenerator generator(0);
+  const PointType originPoint = PointType::Constant(0.03);
+  romea::core::VectorOfEigenVector<PointType> endPoints(numberOfRays);
+  for (PointType & endPoint : endPoints) {
+    romea::core::generateStandardNormals(generator, endPoint.data(), DIM);
+    endPoint *= (5 + 4.5 * romea::core::generateUniform<double>(generator)) / endPoint.norm();
+  }
+
+  std::string suffix = " " + std::to_string(DIM) + "D " + std::to_string(numberOfRays) + " rays";
+
+  LegacyRayCasting<DIM> legacyRayCasting(&gridIndexMapping);
+  benchmarkTraversal("floating point DDA" + suffix, legacyRayCasting, originPoint, endPoints);
+
+  romea::core::RayCasting<double, DIM> rayCasting(&gridIndexMapping);
+  benchmarkTraversal("fixed point DDA" + suffix, rayCasting, originPoint, endPoints);
+
+  printMeasure("ray by ray cast" + suffix, measureMilliseconds([&]() {
+      for (const PointType & endPoint : endPoints) {
+        for (const CellIndexes & cellIndexes : rayCasting.cast(originPoint, endPoint)) {
+          grid(cellIndexes) += 1.f;
+        }
+      }
+    }));
+
+  romea::core::ScanRayCasting<double, DIM> scanRayCasting(&gridIndexMapping);
+  std::vector<size_t> numbersOfThreads = {1};
+  if (romea::core::getDefaultNumberOfThreads() > 1) {
+    numbersOfThreads.push_back(romea::core::getDefaultNumberOfThreads());
+  }
+
+  for (const size_t & numberOfThreads : numbersOfThreads) {
+    scanRayCasting.setMaximalNumberOfThreads(numberOfThreads);
+    std::string threads = " " + std::to_string(numberOfThreads) + " thread(s)";
+
+    printMeasure("scan cast counting cells" + suffix + threads, measureMilliseconds([&]() {
+        std::vector<size_t> numberOfCells(numberOfThreads, 0);
+        scanRayCasting.cast(
+          originPoint, endPoints,
+          [&](const size_t & threadIndex, const CellIndexes &, const bool &) {
+            ++numberOfCells[threadIndex];
+          });
+      }));
+
+    printMeasure("scan free/occupied cells" + suffix + threads, measureMilliseconds([&]() {
+        scanRayCasting.computeFreeAndOccupiedCells(originPoint, endPoints);
+        for (const CellIndexes & cellIndexes : scanRayCasting.getFreeCells()) {
+          grid(cellIndexes) -= 1.f;
+        }
+        for (const CellIndexes & cellIndexes : scanRayCasting.getOccupiedCells()) {
+          grid(cellIndexes) += 1.f;
+        }
+      }));
+
+    romea::core::OccupancyGrid<double, DIM, std::int8_t> occupancyGrid(10., 0.1);
+    occupancyGrid.setMaximalNumberOfThreads(numberOfThreads);
+    printMeasure("occupancy grid integration" + suffix + threads, measureMilliseconds([&]() {
+        occupancyGrid.integrateScan(originPoint, endPoints);
+      }));
+
+    const romea::core::OccupancyGridStatistics & statistics = occupancyGrid.getStatistics();
+    printMeasure("  of which ray casting", romea::core::durationToSecond(
+        statistics.rayCastingDuration) * 1000);
+    printMeasure("  of which cell updates", romea::core::durationToSecond(
+        statistics.updateDuration) * 1000);
+  }
+}
+
+//-----------------------------------------------------------------------------
+int main()
+{
+  benchmark<2>(1440);
+  benchmark<3>(64 * 1024);
+  return 0;
+}
@@ -0,0 +1,95 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+// ECEF to geodetic coordinates : fixed point iteration on latitude versus
+// Vermeille closed form solution. Accuracy is given by the largest errors
+// with respect to the geodetic coordinates used to generate ECEF positions
+// and throughput in millions of conversions per second.
+
+// std
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// romea
+#include "romea_core_common/geodesy/ECEFConverter.hpp"
+#include "romea_core_common/math/RandomGenerator.hpp"
+#include "benchmark_helper.hpp"
+
+using WGS84ConversionMethod = romea::core::ECEFConverter::WGS84ConversionMethod;
+
+//-----------------------------------------------------------------------------
+void benchmark(
+  const std::string & name,
+  const WGS84ConversionMethod & method,
+  const std::vector<romea::core::GeodeticCoordinates> & llhs,
+  const Eigen::MatrixX3d & ecefPositions)
+{
+  romea::core::ECEFConverter ecefConverter;
+  ecefConverter.setWGS84ConversionMethod(method);
+  ecefConverter.setMaximalNumberOfThreads(1);
+
+  double maximalAngularError = 0;
+  double maximalAltitudeError = 0;
+  for (size_t n = 0; n < llhs.size(); ++n) {
+    const romea::core::GeodeticCoordinates llh =
+      ecefConverter.toWGS84(ecefPositions.row(n).transpose());
+    maximalAngularError = std::max(
+      maximalAngularError, std::abs(llh.latitude - llhs[n].latitude));
+    maximalAngularError = std::max(
+      maximalAngularError, std::abs(llh.longitude - llhs[n].longitude));
+    maximalAltitudeError = std::max(
+      maximalAltitudeError, std::abs(llh.altitude - llhs[n].altitude));
+  }
+
+  std::cout << name << " maximal errors : " << std::scientific << std::setprecision(2) <<
+    maximalAngularError << " rad " << maximalAltitudeError << " m" << std::endl;
+
+  romea::core::GeodeticCoordinatesArray llhArray;
+  const double milliseconds = measureMilliseconds(
+    [&]() {ecefConverter.toWGS84(ecefPositions, llhArray);});
+  printMeasure(name, milliseconds);
+  std::cout << std::left << std::setw(48) << "" << std::right << std::setw(12) <<
+    std::fixed << std::setprecision(1) << llhs.size() / milliseconds / 1000 <<
+    " Mconv/s" << std::endl;
+}
+
+//-----------------------------------------------------------------------------
+int main()
+{
+  const size_t numberOfPositions = 1000000;
+
+  // Ground and airborne positions all around the world
+  romea::core::RandomGenerator generator(0);
+  std::vector<romea::core::GeodeticCoordinates> llhs(numberOfPositions);
+  for (romea::core::GeodeticCoordinates & llh : llhs) {
+    llh = romea::core::makeGeodeticCoordinates(
+      0.999 * M_PI * (romea::core::generateUniform<double>(generator) - 0.5),
+      M_PI * (2 * romea::core::generateUniform<double>(generator) - 1),
+      -500 + 10000 * romea::core::generateUniform<double>(generator));
+  }
+
+  Eigen::MatrixX3d ecefPositions;
+  romea::core::ECEFConverter().toECEF(
+    romea::core::makeGeodeticCoordinatesArray(llhs), ecefPositions);
+
+  benchmark("fixed point", WGS84ConversionMethod::FIXED_POINT, llhs, ecefPositions);
+  benchmark("vermeille", WGS84ConversionMethod::VERMEILLE, llhs, ecefPositions);
+  return 0;
+}
@@ -0,0 +1,127 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+// Conversions of a whole GNSS trajectory or geo referenced point cloud :
+// one call per position versus batch conversions over structure of arrays,
+// with one thread and with all threads. Throughputs are given in millions of
+// conversions per second.
+
+// std
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// romea
+#include "romea_core_common/concurrency/ParallelFor.hpp"
+#include "romea_core_common/geodesy/ENUConverter.hpp"
+#include "romea_core_common/math/RandomGenerator.hpp"
+#include "benchmark_helper.hpp"
+
+//-----------------------------------------------------------------------------
+void printThroughput(
+  const std::string & name,
+  const size_t & numberOfConversions,
+  const double & milliseconds)
+{
+  printMeasure(name, milliseconds);
+  std::cout << std::left << std::setw(48) << "" << std::right << std::setw(12) <<
+    std::fixed << std::setprecision(1) << numberOfConversions / milliseconds / 1000 <<
+    " Mconv/s" << std::endl;
+}
+
+//-----------------------------------------------------------------------------
+int main()
+{
+  const size_t numberOfPositions = 1000000;
+  auto anchor = romea::core::makeGeodeticCoordinates(45.78 / 180 * M_PI, 3.08 / 180 * M_PI, 365);
+
+  // Positions spread over a few kilometers around anchor
+  romea::core::RandomGenerator generator(0);
+  std::vector<romea::core::GeodeticCoordinates> llhs(numberOfPositions);
+  for (romea::core::GeodeticCoordinates & llh : llhs) {
+    llh = romea::core::makeGeodeticCoordinates(
+      anchor.latitude + 1e-3 * (romea::core::generateUniform<double>(generator) - 0.5),
+      anchor.longitude + 1e-3 * (romea::core::generateUniform<double>(generator) - 0.5),
+      anchor.altitude + 10 * romea::core::generateUniform<double>(generator));
+  }
+  const romea::core::GeodeticCoordinatesArray llhArray =
+    romea::core::makeGeodeticCoordinatesArray(llhs);
+
+  romea::core::ENUConverter enuConverter(anchor);
+  romea::core::ECEFConverter ecefConverter;
+  Eigen::MatrixX3d positions(numberOfPositions, 3);
+  romea::core::GeodeticCoordinatesArray llhResults = llhArray;
+
+  std::vector<size_t> numbersOfThreads = {1};
+  if (romea::core::getDefaultNumberOfThreads() > 1) {
+    numbersOfThreads.push_back(romea::core::getDefaultNumberOfThreads());
+  }
+
+  printThroughput(
+    "WGS84 to ECEF single", numberOfPositions, measureMilliseconds(
+      [&]() {
+        for (size_t n = 0; n < numberOfPositions; ++n) {
+          positions.row(n) = ecefConverter.toECEF(llhs[n]).transpose();
+        }
+      }));
+
+  for (const size_t & numberOfThreads : numbersOfThreads) {
+    ecefConverter.setMaximalNumberOfThreads(numberOfThreads);
+    printThroughput(
+      "WGS84 to ECEF batch " + std::to_string(numberOfThreads) + " threads",
+      numberOfPositions, measureMilliseconds(
+        [&]() {ecefConverter.toECEF(llhArray, positions);}));
+  }
+
+  printThroughput(
+    "WGS84 to ENU single", numberOfPositions, measureMilliseconds(
+      [&]() {
+        for (size_t n = 0; n < numberOfPositions; ++n) {
+          positions.row(n) = enuConverter.toENU(llhs[n]).transpose();
+        }
+      }));
+
+  for (const size_t & numberOfThreads : numbersOfThreads) {
+    enuConverter.setMaximalNumberOfThreads(numberOfThreads);
+    printThroughput(
+      "WGS84 to ENU batch " + std::to_string(numberOfThreads) + " threads",
+      numberOfPositions, measureMilliseconds(
+        [&]() {enuConverter.toENU(llhArray, positions);}));
+  }
+
+  printThroughput(
+    "ENU to WGS84 single", numberOfPositions, measureMilliseconds(
+      [&]() {
+        for (size_t n = 0; n < numberOfPositions; ++n) {
+          const romea::core::GeodeticCoordinates llh =
+            enuConverter.toWGS84(Eigen::Vector3d(positions.row(n).transpose()));
+          llhResults.latitudes[n] = llh.latitude;
+          llhResults.longitudes[n] = llh.longitude;
+          llhResults.altitudes[n] = llh.altitude;
+        }
+      }));
+
+  for (const size_t & numberOfThreads : numbersOfThreads) {
+    enuConverter.setMaximalNumberOfThreads(numberOfThreads);
+    printThroughput(
+      "ENU to WGS84 batch " + std::to_string(numberOfThreads) + " threads",
+      numberOfPositions, measureMilliseconds(
+        [&]() {enuConverter.toWGS84(positions, llhResults);}));
+  }
+
+  return 0;
+}
@@ -0,0 +1,104 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+// Compute Huber weights of residual vectors made of 80 percent of gaussian
+// inliers and 20 percent of uniform outliers. Legacy computation, which copies
+// residuals twice before each selection, is reproduced as reference.
+
+// std
+#include <algorithm>
+#include <string>
+
+// romea
+#include "romea_core_common/math/RandomGenerator.hpp"
+#include "romea_core_common/regression/leastsquares/MEstimator.hpp"
+#include "benchmark_helper.hpp"
+
+//-----------------------------------------------------------------------------
+double legacyComputeWeights(
+  const Eigen::VectorXd & residuals,
+  const double & dataNoiseStd,
+  Eigen::VectorXd & sortedVector,
+  Eigen::VectorXd & normalizedResiduals,
+  Eigen::VectorXd & weights)
+{
+  const Eigen::Index dataSize = residuals.rows();
+  sortedVector = residuals;
+  double * itBegin = sortedVector.data();
+  double * itMedian = itBegin + dataSize / 2;
+  std::nth_element(itBegin, itMedian, itBegin + dataSize);
+
+  normalizedResiduals = (residuals.array() - (*itMedian)).abs();
+  sortedVector = normalizedResiduals;
+  std::nth_element(itBegin, itMedian, itBegin + dataSize);
+
+  double mad = std::max(1.4826 * (*itMedian), dataNoiseStd);
+  normalizedResiduals /= mad;
+  weights = (normalizedResiduals.array() / 1.2107).inverse().
+    min(Eigen::VectorXd::Ones(dataSize).array());
+  return (normalizedResiduals.array() > 1.2107).count() / double(dataSize);
+}
+
+//-----------------------------------------------------------------------------
+Eigen::VectorXd makeResiduals(const size_t & size)
+{
+  romea::core::RandomGenerator generator(0);
+  Eigen::VectorXd residuals(size);
+  romea::core::generateStandardNormals(generator, residuals.data(), size);
+  for (size_t n = 0; n < size; n += 5) {
+    residuals[n] = 10 * romea::core::generateUniform<double>(generator);
+  }
+  return residuals;
+}
+
+//-----------------------------------------------------------------------------
+void benchmark(const size_t & size)
+{
+  const size_t numberOfCalls = 10000000 / size;
+  Eigen::VectorXd residuals = makeResiduals(size);
+  std::string suffix = " n=" + std::to_string(size);
+
+  Eigen::VectorXd sortedVector, normalizedResiduals, weights;
+  printMeasure("legacy" + suffix, measureMilliseconds([&]() {
+      for (size_t n = 0; n < numberOfCalls; ++n) {
+        legacyComputeWeights(residuals, 0.01, sortedVector, normalizedResiduals, weights);
+      }
+    }));
+
+  romea::core::MEstimator<double> exact(0.01);
+  printMeasure("selection" + suffix, measureMilliseconds([&]() {
+      for (size_t n = 0; n < numberOfCalls; ++n) {
+        exact.computeWeights(residuals);
+      }
+    }));
+
+  romea::core::MEstimator<double> approximate(0.01);
+  approximate.enableApproximateMedian(0);
+  printMeasure("histogram" + suffix, measureMilliseconds([&]() {
+      for (size_t n = 0; n < numberOfCalls; ++n) {
+        approximate.computeWeights(residuals);
+      }
+    }));
+}
+
+//-----------------------------------------------------------------------------
+int main()
+{
+  for (size_t size : {1000, 100000, 1000000}) {
+    benchmark(size);
+  }
+  return 0;
+}
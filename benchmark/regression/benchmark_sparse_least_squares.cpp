@@ -0,0 +1,157 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// Solve one linearized step of a synthetic 2D pose chain : each pose is
+// linked to the next one by an odometry measurement and to the pose 10 steps
+// before by a loop closure. Estimate is (x, y, theta) for each pose.
+
+// std
+#include <cmath>
+#include <string>
+
+// romea
+#include "romea_core_common/math/RandomGenerator.hpp"
+#include "romea_core_common/regression/leastsquares/LeastSquares.hpp"
+#include "romea_core_common/regression/leastsquares/SparseLeastSquares.hpp"
+#include "benchmark_helper.hpp"
+
+const size_t LOOP_CLOSURE_STEP = 10;
+
+//-----------------------------------------------------------------------------
+size_t numberOfResiduals(const size_t & numberOfPoses)
+{
+  size_t numberOfEdges = numberOfPoses - 1;
+  if (numberOfPoses > LOOP_CLOSURE_STEP) {
+    numberOfEdges += numberOfPoses - LOOP_CLOSURE_STEP;
+  }
+  return 3 * (numberOfEdges + 1);
+}
+
+//-----------------------------------------------------------------------------
+template<typename AddBlock>
+void buildChain(
+  const size_t & numberOfPoses,
+  Eigen::VectorXd & Y,
+  AddBlock && addBlock)
+{
+  romea::core::RandomGenerator generator(0);
+
+  // Ground truth poses on a spiral and noisy linearization point
+  Eigen::Matrix3Xd poses(3, numberOfPoses);
+  Eigen::Matrix3Xd noisyPoses(3, numberOfPoses);
+  romea::core::generateStandardNormals(generator, noisyPoses.data(), size_t(noisyPoses.size()));
+  for (size_t n = 0; n < numberOfPoses; ++n) {
+    double s = 0.1 * n;
+    poses.col(n) << 10 * std::cos(s), 10 * std::sin(s), s + M_PI / 2;
+    noisyPoses.col(n) = poses.col(n) + 0.05 * noisyPoses.col(n);
+  }
+
+  size_t row = 0;
+  auto addEdge = [&](const size_t & i, const size_t & j) {
+      Eigen::Rotation2Dd Ri(noisyPoses(2, i));
+      Eigen::Rotation2Dd measuredRi(poses(2, i));
+      Eigen::Vector2d dt = noisyPoses.col(j).head<2>() - noisyPoses.col(i).head<2>();
+      Eigen::Vector2d measuredDt = poses.col(j).head<2>() - poses.col(i).head<2>();
+
+      Eigen::Matrix2d RiT = Ri.toRotationMatrix().transpose();
+      Eigen::Matrix2d dRiT;
+      dRiT << -std::sin(noisyPoses(2, i)), std::cos(noisyPoses(2, i)),
+        -std::cos(noisyPoses(2, i)), -std::sin(noisyPoses(2, i));
+
+      Eigen::Matrix3d Ji = -Eigen::Matrix3d::Identity();
+      Ji.topLeftCorner<2, 2>() = -RiT;
+      Ji.topRightCorner<2, 1>() = dRiT * dt;
+      Eigen::Matrix3d Jj = Eigen::Matrix3d::Identity();
+      Jj.topLeftCorner<2, 2>() = RiT;
+
+      Y.segment<2>(row) = RiT * dt - measuredRi.toRotationMatrix().transpose() * measuredDt;
+      Y(row + 2) = (noisyPoses(2, j) - noisyPoses(2, i)) - (poses(2, j) - poses(2, i));
+      addBlock(row, 3 * i, Ji);
+      addBlock(row, 3 * j, Jj);
+      row += 3;
+    };
+
+  // Prior on first pose
+  Y.head<3>() = noisyPoses.col(0) - poses.col(0);
+  addBlock(row, 0, Eigen::Matrix3d::Identity());
+  row += 3;
+
+  for (size_t n = 1; n < numberOfPoses; ++n) {
+    addEdge(n - 1, n);
+    if (n >= LOOP_CLOSURE_STEP) {
+      addEdge(n - LOOP_CLOSURE_STEP, n);
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+void benchmarkDense(const size_t & numberOfPoses)
+{
+  size_t dataSize = numberOfResiduals(numberOfPoses);
+  romea::core::LeastSquares<double> leastSquares(3 * numberOfPoses, dataSize);
+
+  double milliseconds = measureMilliseconds(
+    [&]() {
+      leastSquares.getJ().setZero();
+      buildChain(
+        numberOfPoses, leastSquares.getY(),
+        [&](const size_t & row, const size_t & col, const Eigen::Matrix3d & block) {
+          leastSquares.getJ().block<3, 3>(row, col) = block;
+        });
+      leastSquares.estimateUsingCholeskyDecomposition();
+    }, 3);
+
+  printMeasure("dense " + std::to_string(numberOfPoses) + " poses", milliseconds);
+}
+
+//-----------------------------------------------------------------------------
+void benchmarkSparse(const size_t & numberOfPoses)
+{
+  size_t dataSize = numberOfResiduals(numberOfPoses);
+  romea::core::SparseLeastSquares<double> leastSquares(3 * numberOfPoses);
+
+  auto solve = [&]() {
+      leastSquares.setDataSize(dataSize);
+      buildChain(
+        numberOfPoses, leastSquares.getY(),
+        [&](const size_t & row, const size_t & col, const Eigen::Matrix3d & block) {
+          leastSquares.addJacobianBlock(row, col, block);
+        });
+      leastSquares.estimateUsingCholeskyDecomposition();
+    };
+
+  // First solve includes symbolic analysis, next ones only factorize
+  double firstMilliseconds = measureMilliseconds(solve, 1);
+  double milliseconds = measureMilliseconds(solve);
+  printMeasure("sparse " + std::to_string(numberOfPoses) + " poses (first solve)",
+    firstMilliseconds);
+  printMeasure("sparse " + std::to_string(numberOfPoses) + " poses", milliseconds);
+  printMeasure("sparse " + std::to_string(numberOfPoses) + " poses last pose covariance",
+    measureMilliseconds([&]() {
+      leastSquares.computeEstimateCovarianceBlock(3 * (numberOfPoses - 1), 3, 1);
+    }));
+}
+
+//-----------------------------------------------------------------------------
+int main()
+{
+  for (size_t numberOfPoses : {100, 300, 1000, 3000}) {
+    if (numberOfPoses <= 300) {
+      benchmarkDense(numberOfPoses);
+    }
+    benchmarkSparse(numberOfPoses);
+  }
+  return 0;
+}
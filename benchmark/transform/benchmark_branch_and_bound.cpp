@@ -0,0 +1,90 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Global registration of a synthetic 2D scan of a rectangular room against
+// a likelihood grid of the room: exhaustive correlative search (one pyramid
+// level) versus branch and bound over max pooled pyramids of several depths.
+
+// std
+#include <cmath>
+#include <cstdint>
+#include <string>
+
+// romea
+#include "romea_core_common/containers/grid/DistanceTransform.hpp"
+#include "romea_core_common/transform/estimation/FindRigidTransformationByBranchAndBound.hpp"
+#include "benchmark_helper.hpp"
+
+//-----------------------------------------------------------------------------
+romea::core::PointSet<Eigen::Vector2d> makeRoomScan(const size_t & numberOfPoints)
+{
+  romea::core::PointSet<Eigen::Vector2d> points(numberOfPoints);
+  for (size_t n = 0; n < numberOfPoints; ++n) {
+    double angle = 2 * M_PI * n / numberOfPoints;
+    Eigen::Vector2d direction(std::cos(angle), std::sin(angle));
+    double range = std::min(4 / std::abs(direction.x()), 3 / std::abs(direction.y()));
+    points[n] = range * direction;
+  }
+  return points;
+}
+
+//-----------------------------------------------------------------------------
+void benchmark(const size_t & numberOfPoints)
+{
+  using BranchAndBound = romea::core::FindRigidTransformationByBranchAndBound<Eigen::Vector2d>;
+  const double resolution = 0.05;
+
+  const Eigen::Affine2d transformation = Eigen::Translation2d(0.6, -0.3) * Eigen::Rotation2Dd(0.2);
+  romea::core::PointSet<Eigen::Vector2d> sourcePoints = makeRoomScan(numberOfPoints);
+
+  const romea::core::GridIndexMapping2d gridIndexMapping(6., resolution);
+  romea::core::Grid<std::uint8_t, 2> obstacles(gridIndexMapping.getNumberOfCellsAlongAxes());
+  obstacles.setValue(0);
+  for (const Eigen::Vector2d & point : sourcePoints) {
+    obstacles(gridIndexMapping.computeCellIndexes(transformation * point)) = 1;
+  }
+
+  romea::core::DistanceTransform<double, 2> distanceTransform(
+    obstacles.getNumberOfCellsAlongAxes(), resolution, 0.5);
+  distanceTransform.compute(obstacles, [](const std::uint8_t & value) {return value != 0;});
+  romea::core::Grid<double, 2> likelihoods(obstacles.getNumberOfCellsAlongAxes());
+  const auto & squaredDistances = distanceTransform.getSquaredDistances().getBuffer();
+  for (size_t n = 0; n < squaredDistances.size(); ++n) {
+    likelihoods.getBuffer()[n] = std::exp(-squaredDistances[n] * resolution * resolution / 0.02);
+  }
+
+  std::string suffix = " n=" + std::to_string(numberOfPoints);
+  for (size_t numberOfLevels : {1, 4, 7}) {
+    BranchAndBound scanMatcher;
+    scanMatcher.setLinearSearchWindow(1.);
+    scanMatcher.setAngularSearchWindow(M_PI / 6);
+    scanMatcher.setNumberOfPyramidLevels(numberOfLevels);
+    scanMatcher.setLikelihoodGrid(likelihoods, gridIndexMapping);
+
+    std::string name = numberOfLevels == 1 ? "exhaustive search" :
+      "branch and bound " + std::to_string(numberOfLevels) + " levels";
+    printMeasure(name + suffix, measureMilliseconds([&]() {
+        scanMatcher.find(sourcePoints, Eigen::Matrix3d::Identity());
+      }, 1));
+  }
+}
+
+//-----------------------------------------------------------------------------
+int main()
+{
+  for (size_t numberOfPoints : {360, 1000}) {
+    benchmark(numberOfPoints);
+  }
+  return 0;
+}
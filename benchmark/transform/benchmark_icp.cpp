@@ -0,0 +1,89 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+// Register a synthetic 2D scan of a rectangular room with 5 percent of
+// outliers, comparing ransac consensus and M-estimator reweighting. Transformation
+// epsilon is set to zero so each call runs the same number of iterations.
+
+// std
+#include <string>
+
+// romea
+#include "romea_core_common/math/RandomGenerator.hpp"
+#include "romea_core_common/transform/estimation/FindRigidTransformationByICP.hpp"
+#include "benchmark_helper.hpp"
+
+const size_t NUMBER_OF_ITERATIONS = 10;
+
+//-----------------------------------------------------------------------------
+romea::core::PointSet<Eigen::Vector2d> makeRoomScan(const size_t & numberOfPoints)
+{
+  romea::core::RandomGenerator generator(0);
+  romea::core::PointSet<Eigen::Vector2d> points(numberOfPoints);
+  for (size_t n = 0; n < numberOfPoints; ++n) {
+    double angle = 2 * M_PI * n / numberOfPoints;
+    Eigen::Vector2d direction(std::cos(angle), std::sin(angle));
+    double range = std::min(4 / std::abs(direction.x()), 3 / std::abs(direction.y()));
+    if (n % 20 == 0) {
+      range *= romea::core::generateUniform<double>(generator);
+    }
+    points[n] = range * direction;
+  }
+  return points;
+}
+
+//-----------------------------------------------------------------------------
+void benchmark(const size_t & numberOfPoints)
+{
+  using ICP = romea::core::FindRigidTransformationByICP<Eigen::Vector2d>;
+
+  const Eigen::Affine2d transformation = Eigen::Translation2d(0.1, 0.2) * Eigen::Rotation2Dd(0.05);
+  romea::core::PointSet<Eigen::Vector2d> sourcePoints = makeRoomScan(numberOfPoints);
+  romea::core::PointSet<Eigen::Vector2d> targetPoints(numberOfPoints);
+  for (size_t n = 0; n < numberOfPoints; ++n) {
+    targetPoints[n] = transformation * sourcePoints[n];
+  }
+
+  romea::core::KdTree<Eigen::Vector2d> sourcePointsKdTree(sourcePoints);
+  romea::core::KdTree<Eigen::Vector2d> targetPointsKdTree(targetPoints);
+  std::string suffix = " n=" + std::to_string(numberOfPoints) + " per iteration";
+
+  auto measure = [&](const std::string & name, const ICP::EstimationMethod & method) {
+      ICP icp(0.02);
+      icp.setMaximalNumberOfIterations(NUMBER_OF_ITERATIONS);
+      icp.setTransformationEspilon(0);
+      printMeasure(name + suffix, measureMilliseconds([&]() {
+          icp.find(
+            sourcePoints, sourcePointsKdTree,
+            targetPoints, targetPointsKdTree,
+            Eigen::Matrix3d::Identity(), method);
+        }) / NUMBER_OF_ITERATIONS);
+    };
+
+  measure("ransac least squares", ICP::EstimationMethod::LEAST_SQUARES);
+  measure("robust least squares", ICP::EstimationMethod::ROBUST_LEAST_SQUARES);
+  measure("ransac svd", ICP::EstimationMethod::SVD);
+  measure("robust svd", ICP::EstimationMethod::ROBUST_SVD);
+}
+
+//-----------------------------------------------------------------------------
+int main()
+{
+  for (size_t numberOfPoints : {1000, 10000}) {
+    benchmark(numberOfPoints);
+  }
+  return 0;
+}
@@ -0,0 +1,103 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef ROMEA_CORE_COMMON__CONCURRENCY__PARALLELFOR_HPP_
+#define ROMEA_CORE_COMMON__CONCURRENCY__PARALLELFOR_HPP_
+
+// std
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+namespace romea
+{
+namespace core
+{
+
+size_t getDefaultNumberOfThreads();
+
+size_t computeNumberOfThreads(
+  const size_t & size,
+  const size_t & minimalRangeSize,
+  const size_t & maximalNumberOfThreads);
+
+// Split [0,size) in numberOfThreads contiguous ranges and call
+// function(threadIndex, rangeBegin, rangeEnd) for each of them. Ranges only
+// depend on size and numberOfThreads, so per thread results reduced in thread
+// index order are deterministic. First range is processed by calling thread.
+// If it throws, started threads are joined before the exception is rethrown.
+// Exceptions thrown by other threads are not propagated, they terminate the
+// program as for any std::thread.
+template<typename Function>
+void parallelFor(
+  const size_t & size,
+  const size_t & numberOfThreads,
+  Function && function);
+
+//-----------------------------------------------------------------------------
+inline size_t getDefaultNumberOfThreads()
+{
+  return std::max(size_t(1), size_t(std::thread::hardware_concurrency()));
+}
+
+//-----------------------------------------------------------------------------
+inline size_t computeNumberOfThreads(
+  const size_t & size,
+  const size_t & minimalRangeSize,
+  const size_t & maximalNumberOfThreads)
+{
+  return std::max(size_t(1), std::min(maximalNumberOfThreads, size / std::max(size_t(1),
+    minimalRangeSize)));
+}
+
+//-----------------------------------------------------------------------------
+template<typename Function>
+void parallelFor(
+  const size_t & size,
+  const size_t & numberOfThreads,
+  Function && function)
+{
+  const size_t numberOfRanges = std::max(size_t(1), std::min(numberOfThreads, size));
+  auto rangeBegin = [&](const size_t & rangeIndex) {
+      return size * rangeIndex / numberOfRanges;
+    };
+
+  std::vector<std::thread> threads;
+  auto joinThreads = [&]() {
+      for (std::thread & thread : threads) {
+        thread.join();
+      }
+    };
+
+  try {
+    threads.reserve(numberOfRanges - 1);
+    for (size_t n = 1; n < numberOfRanges; ++n) {
+      threads.emplace_back(function, n, rangeBegin(n), rangeBegin(n + 1));
+    }
+
+    function(size_t(0), rangeBegin(0), rangeBegin(1));
+  } catch (...) {
+    // Destroying a joinable thread would call std::terminate
+    joinThreads();
+    throw;
+  }
+
+  joinThreads();
+}
+
+}  // namespace core
+}  // namespace romea
+
+#endif  // ROMEA_CORE_COMMON__CONCURRENCY__PARALLELFOR_HPP_
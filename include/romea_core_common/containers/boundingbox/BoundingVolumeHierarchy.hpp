@@ -0,0 +1,208 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+#ifndef ROMEA_CORE_COMMON__CONTAINERS__BOUNDINGBOX__BOUNDINGVOLUMEHIERARCHY_HPP_
+#define ROMEA_CORE_COMMON__CONTAINERS__BOUNDINGBOX__BOUNDINGVOLUMEHIERARCHY_HPP_
+
+// Eigen
+#include <Eigen/StdVector>
+
+// std
+#include <limits>
+#include <vector>
+
+// romea
+#include "romea_core_common/containers/boundingbox/AxisAlignedBoundingBox.hpp"
+#include "romea_core_common/containers/boundingbox/OrientedBoundingBox.hpp"
+#include "romea_core_common/pointset/PointSet.hpp"
+
+namespace romea
+{
+namespace core
+{
+
+// Bounding volume hierarchy over a set of axis aligned and oriented boxes.
+// Tree is built over box envelopes (toAxisAlignedBoundingBox for oriented
+// boxes) by recursive binned surface area heuristic splits, and stored as a
+// flat array of nodes, children of a node being contiguous. Queries traverse
+// envelopes then refine candidates with exact tests against oriented boxes.
+// Boxes are identified by their insertion index and build() must be called
+// after adding boxes. Batch queries are answered in parallel.
+template<typename Scalar, size_t DIM>
+class BoundingVolumeHierarchy
+{
+public:
+  using AABBType = AxisAlignedBoundingBox<Scalar, DIM>;
+  using OBBType = OrientedBoundingBox<Scalar, DIM>;
+  using PointType = Eigen::Matrix<Scalar, DIM, 1>;
+  using PointSetType = PointSet<PointType>;
+
+  static constexpr size_t NO_BOX = std::numeric_limits<size_t>::max();
+
+public:
+  BoundingVolumeHierarchy();
+
+  size_t addBox(const AABBType & box);
+
+  size_t addBox(const OBBType & box);
+
+  void clear();
+
+  void build();
+
+  size_t getNumberOfBoxes() const;
+
+  void setMaximalNumberOfThreads(const size_t & maximalNumberOfThreads);
+
+public:
+  // Indexes of found boxes are given in increasing order
+  void findBoxesContaining(
+    const PointType & point,
+    std::vector<size_t> & boxIndexes) const;
+
+  void findBoxesOverlapping(
+    const AABBType & box,
+    std::vector<size_t> & boxIndexes) const;
+
+  void findBoxesOverlapping(
+    const OBBType & box,
+    std::vector<size_t> & boxIndexes) const;
+
+  // First box hit by ray origin + t * direction with t in [0, maximalDistance],
+  // distance is given in direction norm unit and is 0 when origin is inside
+  bool findFirstRayIntersection(
+    const PointType & origin,
+    const PointType & direction,
+    const Scalar & maximalDistance,
+    size_t & boxIndex,
+    Scalar & distance) const;
+
+public:
+  // Lowest index of boxes containing each point or NO_BOX
+  void findContainingBoxes(
+    const PointSetType & points,
+    std::vector<size_t> & boxIndexes) const;
+
+  // First box hit by each ray or NO_BOX, distance being infinite without hit
+  void castRays(
+    const PointSetType & origins,
+    const PointSetType & directions,
+    const Scalar & maximalDistance,
+    std::vector<size_t> & boxIndexes,
+    std::vector<Scalar> & distances) const;
+
+private:
+  static constexpr size_t MAXIMAL_NUMBER_OF_BOXES_PER_LEAF = 4;
+  static constexpr size_t NUMBER_OF_BINS = 16;
+  static constexpr size_t MAXIMAL_DEPTH = 64;
+  // Nodes shallower than this depth use SAH splits, deeper ones median splits
+  static constexpr size_t MAXIMAL_SAH_DEPTH = MAXIMAL_DEPTH / 2;
+  static constexpr size_t MINIMAL_NUMBER_OF_QUERIES_PER_THREAD = 256;
+
+  using RotationType = Eigen::Matrix<Scalar, DIM, DIM>;
+
+  struct Box
+  {
+    PointType lower;
+    PointType upper;
+    PointType centerPosition;
+    PointType halfWidthExtents;
+    RotationType rotation;
+    bool isOriented;
+
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+  };
+
+  // Leaf when numberOfBoxes is not null, first is then the first index of
+  // its boxes in boxIndexes_, otherwise it is the index of its first child
+  struct Node
+  {
+    PointType lower;
+    PointType upper;
+    size_t first;
+    size_t numberOfBoxes;
+
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+  };
+
+  // Split node in two children unless it is small enough to be a leaf,
+  // nodes at depth MAXIMAL_SAH_DEPTH or deeper are split at median in order
+  // to bound tree depth
+  bool split_(
+    const size_t & nodeIndex,
+    const size_t & depth);
+
+  void computeBounds_(
+    const size_t & first,
+    const size_t & numberOfBoxes,
+    PointType & lower,
+    PointType & upper) const;
+
+  static Scalar computeArea_(const PointType & lower, const PointType & upper);
+
+  static bool isInside_(const Box & box, const PointType & point);
+
+  static bool overlap_(
+    const Box & box,
+    const PointType & centerPosition,
+    const PointType & halfWidthExtents,
+    const RotationType & rotation);
+
+  // Ray parameter range [entry, exit] inside box [lower, upper]
+  static bool intersectRay_(
+    const PointType & lower,
+    const PointType & upper,
+    const PointType & origin,
+    const PointType & inverseDirection,
+    const Scalar & maximalDistance,
+    Scalar & entry);
+
+  static bool intersectRay_(
+    const Box & box,
+    const PointType & origin,
+    const PointType & direction,
+    const PointType & inverseDirection,
+    const Scalar & maximalDistance,
+    Scalar & entry);
+
+  template<typename NodeTest, typename LeafBoxFunction>
+  void traverse_(NodeTest && nodeTest, LeafBoxFunction && leafBoxFunction) const;
+
+  void findBoxesOverlapping_(
+    const PointType & centerPosition,
+    const PointType & halfWidthExtents,
+    const RotationType & rotation,
+    const PointType & lower,
+    const PointType & upper,
+    std::vector<size_t> & boxIndexes) const;
+
+private:
+  std::vector<Box, Eigen::aligned_allocator<Box>> boxes_;
+  std::vector<Node, Eigen::aligned_allocator<Node>> nodes_;
+  std::vector<size_t> boxIndexes_;
+  std::vector<PointType, Eigen::aligned_allocator<PointType>> boxCenters_;
+  size_t maximalNumberOfThreads_;
+};
+
+using BoundingVolumeHierarchy2f = BoundingVolumeHierarchy<float, 2>;
+using BoundingVolumeHierarchy3f = BoundingVolumeHierarchy<float, 3>;
+using BoundingVolumeHierarchy2d = BoundingVolumeHierarchy<double, 2>;
+using BoundingVolumeHierarchy3d = BoundingVolumeHierarchy<double, 3>;
+
+}  // namespace core
+}  // namespace romea
+
+#endif  // ROMEA_CORE_COMMON__CONTAINERS__BOUNDINGBOX__BOUNDINGVOLUMEHIERARCHY_HPP_
@@ -0,0 +1,267 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+#ifndef ROMEA_CORE_COMMON__CONTAINERS__GRID__DISTANCETRANSFORM_HPP_
+#define ROMEA_CORE_COMMON__CONTAINERS__GRID__DISTANCETRANSFORM_HPP_
+
+// std
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+// romea
+#include "romea_core_common/concurrency/ParallelFor.hpp"
+#include "romea_core_common/containers/grid/WrappableGrid.hpp"
+
+namespace romea
+{
+namespace core
+{
+
+const std::uint8_t INFLATION_LAYER_LETHAL_COST = 254;
+const std::uint8_t INFLATION_LAYER_INSCRIBED_COST = 253;
+const std::uint8_t INFLATION_LAYER_FREE_COST = 0;
+
+// Exact euclidean distance transform of the obstacles of a grid, computed
+// with Felzenszwalb-Huttenlocher separable algorithm : lower envelopes of
+// parabolas are computed along x rows, then y and z columns, lines being
+// processed in parallel. Squared distances are stored in cells unit and
+// clamped to maximal distance. Obstacle grids are read through their
+// operator(), so a translated WrappableGrid is seen in its logical order.
+//
+// Distances only depend on obstacles closer than maximal distance, so after
+// a few cells changed or after a translation, update only recomputes the
+// cells closer than maximal distance to changed or vacated cells, reading
+// obstacles up to maximal distance around them. Distance storage is itself
+// a WrappableGrid translated like the obstacle grid.
+template<typename Scalar, size_t DIM>
+class DistanceTransform
+{
+public:
+  using CellIndexes = Eigen::Matrix<size_t, DIM, 1>;
+  using CellIndexesOffset = Eigen::Matrix<int, DIM, 1>;
+
+public:
+  DistanceTransform(
+    const CellIndexes & numberOfCellsAlongAxes,
+    const Scalar & cellResolution,
+    const Scalar & maximalDistance = std::numeric_limits<Scalar>::infinity());
+
+  void setMaximalNumberOfThreads(const size_t & maximalNumberOfThreads);
+
+  const Scalar & getCellResolution() const;
+
+  const Scalar & getMaximalDistance() const;
+
+public:
+  // Compute distances of all cells, isObstacle(value) telling if a cell
+  // value is an obstacle
+  template<typename GridType, typename IsObstacle>
+  void compute(
+    const GridType & grid,
+    IsObstacle && isObstacle);
+
+  // Declare a cell whose obstacle state has changed since last computation,
+  // changed cells are merged in their bounding box
+  void markChangedCell(const CellIndexes & cellIndexes);
+
+  // Follow a translation of the obstacle grid (see WrappableGrid::translate),
+  // cells near vacated and removed layers are marked as changed
+  void translate(const CellIndexesOffset & indexOffset);
+
+  // Recompute distances around changed cells only
+  template<typename GridType, typename IsObstacle>
+  void update(
+    const GridType & grid,
+    IsObstacle && isObstacle);
+
+public:
+  // Distance in meters to the closest obstacle, clamped to maximal distance
+  Scalar getDistance(const CellIndexes & cellIndexes) const;
+
+  // Squared distance in cells unit
+  const Scalar & getSquaredDistance(const CellIndexes & cellIndexes) const;
+
+  const WrappableGrid<Scalar, DIM> & getSquaredDistances() const;
+
+  // Costmap like inflation layer : lethal cost on obstacles, inscribed cost
+  // up to inscribed radius then exponentially decreasing cost up to
+  // inflation radius (which should not exceed maximal distance)
+  void computeInflationLayer(
+    const Scalar & inscribedRadius,
+    const Scalar & inflationRadius,
+    const Scalar & costScalingFactor,
+    Grid<std::uint8_t, DIM> & costs) const;
+
+  // Same inflation layer written in logical order, costs being translated
+  // like the obstacle grid
+  void computeInflationLayer(
+    const Scalar & inscribedRadius,
+    const Scalar & inflationRadius,
+    const Scalar & costScalingFactor,
+    WrappableGrid<std::uint8_t, DIM> & costs) const;
+
+private:
+  static constexpr size_t MINIMAL_NUMBER_OF_LINES_PER_THREAD = 16;
+
+  struct Box
+  {
+    CellIndexes first;
+    CellIndexes last;
+  };
+
+  // Box grown by maximal distance and clipped to grid
+  Box expandBox_(const Box & box) const;
+
+  Box computeGridBox_() const;
+
+  std::uint8_t computeInflationCost_(
+    const Scalar & squaredDistance,
+    const Scalar & inscribedRadius,
+    const Scalar & inflationRadius,
+    const Scalar & costScalingFactor) const;
+
+  // Load obstacles of window box [first,last] in window buffer
+  template<typename GridType, typename IsObstacle>
+  void loadWindow_(
+    const GridType & grid,
+    IsObstacle && isObstacle,
+    const Box & window);
+
+  void transformWindow_();
+
+  void transformLine_(
+    Scalar * line,
+    const size_t & stride,
+    const size_t & size,
+    std::vector<size_t> & vertices,
+    std::vector<Scalar> & bounds,
+    std::vector<Scalar> & values) const;
+
+  void storeWindow_(const Box & region);
+
+private:
+  Scalar cellResolution_;
+  Scalar maximalDistance_;
+  Scalar maximalSquaredDistance_;
+  size_t maximalDistanceInCells_;
+  size_t maximalNumberOfThreads_;
+
+  WrappableGrid<Scalar, DIM> squaredDistances_;
+
+  bool isFullUpdateRequired_;
+  bool hasChangedCells_;
+  Box changedCellsBox_;
+  std::vector<Box> changedBoxes_;
+
+  Box window_;
+  CellIndexes windowNumberOfCells_;
+  std::vector<Scalar> windowBuffer_;
+
+public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW_IF_VECTORIZABLE_FIXED_SIZE(Scalar, DIM)
+};
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+template<typename GridType, typename IsObstacle>
+void DistanceTransform<Scalar, DIM>::compute(
+  const GridType & grid,
+  IsObstacle && isObstacle)
+{
+  isFullUpdateRequired_ = true;
+  update(grid, std::forward<IsObstacle>(isObstacle));
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+template<typename GridType, typename IsObstacle>
+void DistanceTransform<Scalar, DIM>::update(
+  const GridType & grid,
+  IsObstacle && isObstacle)
+{
+  assert(grid.getNumberOfCellsAlongAxes() == squaredDistances_.getNumberOfCellsAlongAxes());
+
+  if (isFullUpdateRequired_) {
+    loadWindow_(grid, isObstacle, computeGridBox_());
+    transformWindow_();
+    storeWindow_(computeGridBox_());
+  } else {
+    if (hasChangedCells_) {
+      changedBoxes_.push_back(changedCellsBox_);
+    }
+
+    // Cells farther than maximal distance from changed cells keep their
+    // distances, the others only depend on obstacles up to maximal distance
+    for (const Box & changedBox : changedBoxes_) {
+      const Box region = expandBox_(changedBox);
+      loadWindow_(grid, isObstacle, expandBox_(region));
+      transformWindow_();
+      storeWindow_(region);
+    }
+  }
+
+  isFullUpdateRequired_ = false;
+  hasChangedCells_ = false;
+  changedBoxes_.clear();
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+template<typename GridType, typename IsObstacle>
+void DistanceTransform<Scalar, DIM>::loadWindow_(
+  const GridType & grid,
+  IsObstacle && isObstacle,
+  const Box & window)
+{
+  window_ = window;
+  windowNumberOfCells_.array() = window.last.array() - window.first.array() + 1;
+  windowBuffer_.resize(windowNumberOfCells_.array().prod());
+
+  // Obstacles are read row by row, a row being windowNumberOfCells_[0] cells
+  const size_t numberOfRows = windowBuffer_.size() / windowNumberOfCells_[0];
+  const size_t numberOfThreads = computeNumberOfThreads(
+    numberOfRows, MINIMAL_NUMBER_OF_LINES_PER_THREAD, maximalNumberOfThreads_);
+
+  parallelFor(
+    numberOfRows, numberOfThreads,
+    [&](const size_t & /*threadIndex*/, const size_t & begin, const size_t & end) {
+      CellIndexes cellIndexes = window.first;
+      for (size_t row = begin; row < end; ++row) {
+        cellIndexes[1] = window.first[1] + row % windowNumberOfCells_[1];
+        if constexpr (DIM == 3) {
+          cellIndexes[2] = window.first[2] + row / windowNumberOfCells_[1];
+        }
+
+        Scalar * value = windowBuffer_.data() + row * windowNumberOfCells_[0];
+        for (size_t x = 0; x < windowNumberOfCells_[0]; ++x, ++value) {
+          cellIndexes[0] = window.first[0] + x;
+          *value = isObstacle(grid(cellIndexes)) ? 0 : std::numeric_limits<Scalar>::infinity();
+        }
+      }
+    });
+}
+
+using DistanceTransform2f = DistanceTransform<float, 2>;
+using DistanceTransform2d = DistanceTransform<double, 2>;
+using DistanceTransform3f = DistanceTransform<float, 3>;
+using DistanceTransform3d = DistanceTransform<double, 3>;
+
+}  // namespace core
+}  // namespace romea
+
+#endif  // ROMEA_CORE_COMMON__CONTAINERS__GRID__DISTANCETRANSFORM_HPP_
@@ -23,6 +23,8 @@
 #include <cstddef>
 #include <cassert>
 #include <algorithm>
+#include <numeric>
+#include <type_traits>
 #include <vector>
 
 
@@ -31,9 +33,16 @@ namespace romea
 namespace core
 {
 
+// Dense grid stored in row major order (x index varies fastest, then y and z).
+// Cell accessors are not virtual in order to be inlined in update loops, so
+// derived grids changing indexing (like WrappableGrid) must be used through
+// their own type. Rows (and slabs in 3D) are contiguous in memory and can be
+// processed in bulk using getRow and getSlab.
 template<typename T, size_t DIM>
 class Grid
 {
+  static_assert(DIM == 2 || DIM == 3, "Grid is only defined in 2D and 3D");
+
 public:
   using CellIndexes = Eigen::Matrix<size_t, DIM, 1>;
 
@@ -53,15 +62,51 @@ public:
 
   void setValue(const T & value);
 
+  // Fill box between first and last cells (included) row by row
+  void setValue(
+    const CellIndexes & firstCellIndexes,
+    const CellIndexes & lastCellIndexes,
+    const T & value);
+
 public:
-  virtual T & operator()(const CellIndexes & cellIndexes);
+  T & operator()(const CellIndexes & cellIndexes);
 
-  virtual const T & operator()(const CellIndexes & cellIndexes)const;
+  const T & operator()(const CellIndexes & cellIndexes)const;
 
   const CellIndexes & getNumberOfCellsAlongAxes() const;
 
+public:
+  // First cell of the row (numberOfCellsAlongAxes[0] contiguous cells)
+  T * getRow(const size_t & yIndex, const size_t & zIndex = 0);
+
+  const T * getRow(const size_t & yIndex, const size_t & zIndex = 0) const;
+
+  // First cell of the slab (numberOfCellsAlongAxes[0]*numberOfCellsAlongAxes[1]
+  // contiguous cells), only available for 3D grids
+  T * getSlab(const size_t & zIndex);
+
+  const T * getSlab(const size_t & zIndex) const;
+
+public:
+  // Reductions over all cells, arithmetic types are evaluated by Eigen
+  // in order to be vectorized
+  T sum() const;
+
+  T minValue() const;
+
+  T maxValue() const;
+
+  size_t count(const T & value) const;
+
+  template<typename BinaryOperation>
+  T reduce(const T & init, BinaryOperation operation) const;
+
 protected:
-  virtual size_t computeCellLinearIndex_(const CellIndexes & CellIndexes) const;
+  size_t computeCellLinearIndex_(const CellIndexes & CellIndexes) const;
+
+  size_t computeRowLinearIndex_(const size_t & yIndex, const size_t & zIndex) const;
+
+  Eigen::Map<const Eigen::Array<T, Eigen::Dynamic, 1>> mapBuffer_() const;
 
 protected:
   CellIndexes numberOfCellsAlongAxes_;
@@ -98,8 +143,9 @@ void Grid<T, DIM>::init(const CellIndexes & numberOfCellsAlongAxes)
 
   indexCoefficients_[0] = 1;
   indexCoefficients_[1] = numberOfCellsAlongAxes_[0];
-  // TODO(Jean) utiliser ici constexpr if
-  if (DIM == 3) {indexCoefficients_[2] = numberOfCellsAlongAxes_[1] * numberOfCellsAlongAxes_[0];}
+  if constexpr (DIM == 3) {
+    indexCoefficients_[2] = numberOfCellsAlongAxes_[1] * numberOfCellsAlongAxes_[0];
+  }
 }
 
 //-----------------------------------------------------------------------------
@@ -121,7 +167,28 @@ template<typename T, size_t DIM>
 size_t Grid<T, DIM>::computeCellLinearIndex_(const CellIndexes & cellIndexes) const
 {
   assert((cellIndexes.array() < numberOfCellsAlongAxes_.array()).prod());
-  return cellIndexes.dot(indexCoefficients_);
+  if constexpr (DIM == 2) {
+    return cellIndexes[0] + cellIndexes[1] * indexCoefficients_[1];
+  } else {
+    return cellIndexes[0] + cellIndexes[1] * indexCoefficients_[1] +
+           cellIndexes[2] * indexCoefficients_[2];
+  }
+}
+
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM>
+size_t Grid<T, DIM>::computeRowLinearIndex_(
+  const size_t & yIndex,
+  const size_t & zIndex) const
+{
+  assert(yIndex < numberOfCellsAlongAxes_[1]);
+  if constexpr (DIM == 2) {
+    assert(zIndex == 0);
+    return yIndex * indexCoefficients_[1];
+  } else {
+    assert(zIndex < numberOfCellsAlongAxes_[2]);
+    return yIndex * indexCoefficients_[1] + zIndex * indexCoefficients_[2];
+  }
 }
 
 //-----------------------------------------------------------------------------
@@ -147,6 +214,35 @@ Grid<T, DIM>::getNumberOfCellsAlongAxes() const
   return numberOfCellsAlongAxes_;
 }
 
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM>
+T * Grid<T, DIM>::getRow(const size_t & yIndex, const size_t & zIndex)
+{
+  return buffer_.data() + computeRowLinearIndex_(yIndex, zIndex);
+}
+
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM>
+const T * Grid<T, DIM>::getRow(const size_t & yIndex, const size_t & zIndex) const
+{
+  return buffer_.data() + computeRowLinearIndex_(yIndex, zIndex);
+}
+
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM>
+T * Grid<T, DIM>::getSlab(const size_t & zIndex)
+{
+  static_assert(DIM == 3, "slabs are only defined for 3D grids");
+  return buffer_.data() + computeRowLinearIndex_(0, zIndex);
+}
+
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM>
+const T * Grid<T, DIM>::getSlab(const size_t & zIndex) const
+{
+  static_assert(DIM == 3, "slabs are only defined for 3D grids");
+  return buffer_.data() + computeRowLinearIndex_(0, zIndex);
+}
 
 //-----------------------------------------------------------------------------
 template<typename T, size_t DIM>
@@ -155,6 +251,86 @@ void Grid<T, DIM>::setValue(const T & value)
   std::fill(std::begin(buffer_), std::end(buffer_), value);
 }
 
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM>
+void Grid<T, DIM>::setValue(
+  const CellIndexes & firstCellIndexes,
+  const CellIndexes & lastCellIndexes,
+  const T & value)
+{
+  assert((firstCellIndexes.array() <= lastCellIndexes.array()).all());
+  assert((lastCellIndexes.array() < numberOfCellsAlongAxes_.array()).all());
+
+  const size_t & xBegin = firstCellIndexes[0];
+  const size_t xEnd = lastCellIndexes[0] + 1;
+
+  auto fillRows = [&](const size_t & zIndex) {
+      for (size_t yIndex = firstCellIndexes[1]; yIndex <= lastCellIndexes[1]; ++yIndex) {
+        T * row = getRow(yIndex, zIndex);
+        std::fill(row + xBegin, row + xEnd, value);
+      }
+    };
+
+  if constexpr (DIM == 2) {
+    fillRows(0);
+  } else {
+    for (size_t zIndex = firstCellIndexes[2]; zIndex <= lastCellIndexes[2]; ++zIndex) {
+      fillRows(zIndex);
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM>
+Eigen::Map<const Eigen::Array<T, Eigen::Dynamic, 1>> Grid<T, DIM>::mapBuffer_() const
+{
+  static_assert(std::is_arithmetic<T>::value, "Cell type must be arithmetic");
+  return Eigen::Map<const Eigen::Array<T, Eigen::Dynamic, 1>>(
+    buffer_.data(), Eigen::Index(buffer_.size()));
+}
+
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM>
+T Grid<T, DIM>::sum() const
+{
+  return mapBuffer_().sum();
+}
+
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM>
+T Grid<T, DIM>::minValue() const
+{
+  assert(!buffer_.empty());
+  return mapBuffer_().minCoeff();
+}
+
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM>
+T Grid<T, DIM>::maxValue() const
+{
+  assert(!buffer_.empty());
+  return mapBuffer_().maxCoeff();
+}
+
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM>
+size_t Grid<T, DIM>::count(const T & value) const
+{
+  if constexpr (std::is_arithmetic<T>::value) {
+    return (mapBuffer_() == value).count();
+  } else {
+    return std::count(std::begin(buffer_), std::end(buffer_), value);
+  }
+}
+
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM>
+template<typename BinaryOperation>
+T Grid<T, DIM>::reduce(const T & init, BinaryOperation operation) const
+{
+  return std::accumulate(std::begin(buffer_), std::end(buffer_), init, operation);
+}
+
 }  // namespace core
 }  // namespace romea
 
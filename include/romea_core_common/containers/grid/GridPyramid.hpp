@@ -0,0 +1,295 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+#ifndef ROMEA_CORE_COMMON__CONTAINERS__GRID__GRIDPYRAMID_HPP_
+#define ROMEA_CORE_COMMON__CONTAINERS__GRID__GRIDPYRAMID_HPP_
+
+// Eigen
+#include <Eigen/Core>
+
+// std
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+// romea
+#include "romea_core_common/concurrency/ParallelFor.hpp"
+#include "romea_core_common/containers/grid/Grid.hpp"
+
+namespace romea
+{
+namespace core
+{
+
+// Pooling operators combine elementwise two Eigen arrays of cell values.
+// Cells on the border of grids having an odd number of cells are pooled
+// with themselves, so combine(a, a) must be equal to a.
+struct MaxPooling
+{
+  template<typename ArrayA, typename ArrayB>
+  static auto combine(const ArrayA & a, const ArrayB & b) {return a.max(b);}
+};
+
+struct MinPooling
+{
+  template<typename ArrayA, typename ArrayB>
+  static auto combine(const ArrayA & a, const ArrayB & b) {return a.min(b);}
+};
+
+// Only meaningful for floating point cell values
+struct MeanPooling
+{
+  template<typename ArrayA, typename ArrayB>
+  static auto combine(const ArrayA & a, const ArrayB & b)
+  {
+    return (a + b) * typename ArrayA::Scalar(0.5);
+  }
+};
+
+// Multi resolution views of a Grid. Level 0 is the base grid and each cell
+// of level l+1 pools the 2^DIM cells of level l it covers, so level l cell
+// of indexes i covers base cells [i*2^l, (i+1)*2^l). For a GridIndexMapping
+// of resolution r, level l has resolution r*2^l and cell indexes are given
+// by computeLevelCellIndexes. Levels are computed row by row with Eigen
+// arrays, rows of a level being processed in parallel. After modifications
+// of base grid cells, only the pyramid cells covering them are refreshed.
+template<typename T, size_t DIM, typename Pooling = MaxPooling>
+class GridPyramid
+{
+public:
+  using CellIndexes = Eigen::Matrix<size_t, DIM, 1>;
+  using GridType = Grid<T, DIM>;
+
+public:
+  explicit GridPyramid(const size_t & numberOfLevels);
+
+  void setMaximalNumberOfThreads(const size_t & maximalNumberOfThreads);
+
+  // Base grid is not copied and must outlive the pyramid
+  void build(const GridType & grid);
+
+  // Declare base cells in box [first, last] as modified, dirty boxes are
+  // merged in their bounding box
+  void markDirtyCells(
+    const CellIndexes & firstCellIndexes,
+    const CellIndexes & lastCellIndexes);
+
+  void refresh();
+
+public:
+  size_t getNumberOfLevels() const;
+
+  const GridType & getLevel(const size_t & level) const;
+
+  static CellIndexes computeLevelCellIndexes(
+    const CellIndexes & cellIndexes,
+    const size_t & level);
+
+private:
+  static constexpr size_t MINIMAL_NUMBER_OF_ROWS_PER_THREAD = 16;
+
+  using Array = Eigen::Array<T, Eigen::Dynamic, 1>;
+  using RowMap = Eigen::Map<const Array>;
+
+  // Pool level-1 cells into level cells of box [first, last]
+  void pool_(
+    const size_t & level,
+    const CellIndexes & firstCellIndexes,
+    const CellIndexes & lastCellIndexes);
+
+private:
+  size_t numberOfLevels_;
+  size_t maximalNumberOfThreads_;
+
+  const GridType * baseGrid_;
+  std::vector<GridType> levels_;
+
+  bool hasDirtyCells_;
+  CellIndexes firstDirtyCellIndexes_;
+  CellIndexes lastDirtyCellIndexes_;
+};
+
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM, typename Pooling>
+GridPyramid<T, DIM, Pooling>::GridPyramid(const size_t & numberOfLevels)
+: numberOfLevels_(std::max(size_t(1), numberOfLevels)),
+  maximalNumberOfThreads_(getDefaultNumberOfThreads()),
+  baseGrid_(nullptr),
+  levels_(),
+  hasDirtyCells_(false),
+  firstDirtyCellIndexes_(CellIndexes::Zero()),
+  lastDirtyCellIndexes_(CellIndexes::Zero())
+{
+}
+
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM, typename Pooling>
+void GridPyramid<T, DIM, Pooling>::setMaximalNumberOfThreads(
+  const size_t & maximalNumberOfThreads)
+{
+  maximalNumberOfThreads_ = std::max(size_t(1), maximalNumberOfThreads);
+}
+
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM, typename Pooling>
+void GridPyramid<T, DIM, Pooling>::build(const GridType & grid)
+{
+  baseGrid_ = &grid;
+  levels_.resize(numberOfLevels_ - 1);
+
+  CellIndexes numberOfCells = grid.getNumberOfCellsAlongAxes();
+  for (size_t level = 1; level < numberOfLevels_; ++level) {
+    numberOfCells = (numberOfCells.array() + 1) / 2;
+    levels_[level - 1].init(numberOfCells);
+    pool_(level, CellIndexes::Zero(), numberOfCells - CellIndexes::Ones());
+  }
+
+  hasDirtyCells_ = false;
+}
+
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM, typename Pooling>
+void GridPyramid<T, DIM, Pooling>::markDirtyCells(
+  const CellIndexes & firstCellIndexes,
+  const CellIndexes & lastCellIndexes)
+{
+  assert((firstCellIndexes.array() <= lastCellIndexes.array()).all());
+  assert((lastCellIndexes.array() < baseGrid_->getNumberOfCellsAlongAxes().array()).all());
+  if (!hasDirtyCells_) {
+    firstDirtyCellIndexes_ = firstCellIndexes;
+    lastDirtyCellIndexes_ = lastCellIndexes;
+    hasDirtyCells_ = true;
+  } else {
+    firstDirtyCellIndexes_ = firstDirtyCellIndexes_.cwiseMin(firstCellIndexes);
+    lastDirtyCellIndexes_ = lastDirtyCellIndexes_.cwiseMax(lastCellIndexes);
+  }
+}
+
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM, typename Pooling>
+void GridPyramid<T, DIM, Pooling>::refresh()
+{
+  if (!hasDirtyCells_) {
+    return;
+  }
+
+  for (size_t level = 1; level < numberOfLevels_; ++level) {
+    pool_(level, computeLevelCellIndexes(firstDirtyCellIndexes_, level),
+      computeLevelCellIndexes(lastDirtyCellIndexes_, level));
+  }
+  hasDirtyCells_ = false;
+}
+
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM, typename Pooling>
+size_t GridPyramid<T, DIM, Pooling>::getNumberOfLevels() const
+{
+  return numberOfLevels_;
+}
+
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM, typename Pooling>
+const typename GridPyramid<T, DIM, Pooling>::GridType &
+GridPyramid<T, DIM, Pooling>::getLevel(const size_t & level) const
+{
+  assert(level < numberOfLevels_);
+  return level == 0 ? *baseGrid_ : levels_[level - 1];
+}
+
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM, typename Pooling>
+typename GridPyramid<T, DIM, Pooling>::CellIndexes
+GridPyramid<T, DIM, Pooling>::computeLevelCellIndexes(
+  const CellIndexes & cellIndexes,
+  const size_t & level)
+{
+  CellIndexes levelCellIndexes;
+  for (size_t i = 0; i < DIM; ++i) {
+    levelCellIndexes[i] = cellIndexes[i] >> level;
+  }
+  return levelCellIndexes;
+}
+
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM, typename Pooling>
+void GridPyramid<T, DIM, Pooling>::pool_(
+  const size_t & level,
+  const CellIndexes & firstCellIndexes,
+  const CellIndexes & lastCellIndexes)
+{
+  const GridType & source = getLevel(level - 1);
+  GridType & destination = levels_[level - 1];
+  const CellIndexes & sourceNumberOfCells = source.getNumberOfCellsAlongAxes();
+
+  // Source cells [2*first, 2*last+1] clamped to source grid along x
+  const size_t sourceFirstX = 2 * firstCellIndexes[0];
+  const size_t sourceLastX = std::min(2 * lastCellIndexes[0] + 1, sourceNumberOfCells[0] - 1);
+  const size_t sourceRowSize = sourceLastX - sourceFirstX + 1;
+  const size_t numberOfPairs = sourceRowSize / 2;
+
+  const size_t numberOfRowsAlongY = lastCellIndexes[1] - firstCellIndexes[1] + 1;
+  size_t numberOfRows = numberOfRowsAlongY;
+  if constexpr (DIM == 3) {
+    numberOfRows *= lastCellIndexes[2] - firstCellIndexes[2] + 1;
+  }
+
+  const size_t numberOfThreads = computeNumberOfThreads(
+    numberOfRows, MINIMAL_NUMBER_OF_ROWS_PER_THREAD, maximalNumberOfThreads_);
+
+  parallelFor(
+    numberOfRows, numberOfThreads,
+    [&](const size_t & /*threadIndex*/, const size_t & begin, const size_t & end) {
+      Array pooledRow(sourceRowSize);
+      for (size_t row = begin; row < end; ++row) {
+        const size_t y = firstCellIndexes[1] + row % numberOfRowsAlongY;
+        const size_t y0 = 2 * y;
+        const size_t y1 = std::min(y0 + 1, sourceNumberOfCells[1] - 1);
+
+        // Pool rows of source cells along y (and z)
+        size_t z = 0;
+        if constexpr (DIM == 2) {
+          pooledRow = Pooling::combine(
+            RowMap(source.getRow(y0) + sourceFirstX, sourceRowSize),
+            RowMap(source.getRow(y1) + sourceFirstX, sourceRowSize));
+        } else {
+          z = firstCellIndexes[2] + row / numberOfRowsAlongY;
+          const size_t z0 = 2 * z;
+          const size_t z1 = std::min(z0 + 1, sourceNumberOfCells[2] - 1);
+          pooledRow = Pooling::combine(
+            Pooling::combine(
+              RowMap(source.getRow(y0, z0) + sourceFirstX, sourceRowSize),
+              RowMap(source.getRow(y1, z0) + sourceFirstX, sourceRowSize)),
+            Pooling::combine(
+              RowMap(source.getRow(y0, z1) + sourceFirstX, sourceRowSize),
+              RowMap(source.getRow(y1, z1) + sourceFirstX, sourceRowSize)));
+        }
+
+        // Then pairs of cells along x, last one being alone for odd row size
+        T * destinationRow = destination.getRow(y, z) + firstCellIndexes[0];
+        Eigen::Map<Array>(destinationRow, numberOfPairs) = Pooling::combine(
+          Eigen::Map<const Array, 0, Eigen::InnerStride<2>>(pooledRow.data(), numberOfPairs),
+          Eigen::Map<const Array, 0, Eigen::InnerStride<2>>(pooledRow.data() + 1, numberOfPairs));
+        if (sourceRowSize % 2 == 1) {
+          destinationRow[numberOfPairs] = pooledRow[sourceRowSize - 1];
+        }
+      }
+    });
+}
+
+}  // namespace core
+}  // namespace romea
+
+#endif  // ROMEA_CORE_COMMON__CONTAINERS__GRID__GRIDPYRAMID_HPP_
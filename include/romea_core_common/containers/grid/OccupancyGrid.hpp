@@ -0,0 +1,154 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef ROMEA_CORE_COMMON__CONTAINERS__GRID__OCCUPANCYGRID_HPP_
+#define ROMEA_CORE_COMMON__CONTAINERS__GRID__OCCUPANCYGRID_HPP_
+
+// std
+#include <cstdint>
+
+// romea
+#include "romea_core_common/containers/grid/GridIndexMapping.hpp"
+#include "romea_core_common/containers/grid/ScanRayCasting.hpp"
+#include "romea_core_common/containers/grid/WrappableGrid.hpp"
+#include "romea_core_common/time/Time.hpp"
+
+namespace romea
+{
+namespace core
+{
+
+const double OCCUPANCY_GRID_DEFAULT_HIT_PROBABILITY = 0.7;
+const double OCCUPANCY_GRID_DEFAULT_MISS_PROBABILITY = 0.4;
+const double OCCUPANCY_GRID_DEFAULT_MINIMAL_PROBABILITY = 0.12;
+const double OCCUPANCY_GRID_DEFAULT_MAXIMAL_PROBABILITY = 0.97;
+
+// Statistics of the last integrated scan
+struct OccupancyGridStatistics
+{
+  size_t numberOfRays = 0;
+  size_t numberOfFreeCells = 0;
+  size_t numberOfOccupiedCells = 0;
+  Duration rayCastingDuration = Duration::zero();
+  Duration updateDuration = Duration::zero();
+};
+
+// Robot centric occupancy grid. Cells store clamped log odds as fixed point
+// integers (CellType is std::int8_t or std::int16_t), zero meaning unknown.
+// Each scan updates every cell at most once : cells hit by rays are updated
+// with hit probability and cells only crossed by rays with miss probability.
+// Positions are given in world frame, grid is centered on the cell of the
+// position given to moveTo and rolled using WrappableGrid::translate.
+template<typename Scalar, size_t DIM, typename CellType = std::int16_t>
+class OccupancyGrid
+{
+public:
+  using PointType = Eigen::Matrix<Scalar, DIM, 1>;
+  using CellIndexes = Eigen::Matrix<size_t, DIM, 1>;
+  using CellIndexesOffset = Eigen::Matrix<int, DIM, 1>;
+  using PointSetType = VectorOfEigenVector<PointType>;
+
+public:
+  OccupancyGrid(
+    const Scalar & maximalRange,
+    const Scalar & cellResolution);
+
+  OccupancyGrid(const OccupancyGrid &) = delete;
+
+  OccupancyGrid & operator=(const OccupancyGrid &) = delete;
+
+  void setHitProbability(const Scalar & hitProbability);
+
+  void setMissProbability(const Scalar & missProbability);
+
+  // Clamping bounds use the whole cell type range, stored cells are rescaled
+  // (and clamped) to keep their log odds
+  void setClampingProbabilities(
+    const Scalar & minimalProbability,
+    const Scalar & maximalProbability);
+
+  // Scan points farther than maximal sensor range are only used for free space
+  void setMaximalSensorRange(const Scalar & maximalSensorRange);
+
+  void setMaximalNumberOfThreads(const size_t & maximalNumberOfThreads);
+
+public:
+  void moveTo(const PointType & position);
+
+  void integrateScan(
+    const PointType & sensorPosition,
+    const PointSetType & scanPoints);
+
+public:
+  bool isInside(const PointType & position) const;
+
+  CellIndexes computeCellIndexes(const PointType & position) const;
+
+  Scalar getLogOdds(const CellIndexes & cellIndexes) const;
+
+  Scalar getLogOdds(const PointType & position) const;
+
+  Scalar getOccupancyProbability(const PointType & position) const;
+
+  const PointType & getCenterPosition() const;
+
+  const GridIndexMapping<Scalar, DIM> & getGridIndexMapping() const;
+
+  const WrappableGrid<CellType, DIM> & getGrid() const;
+
+  const OccupancyGridStatistics & getStatistics() const;
+
+private:
+  static constexpr size_t MINIMAL_NUMBER_OF_CELLS_PER_THREAD = 4096;
+
+  void updateCellIncrements_();
+
+  static Scalar logit_(const Scalar & probability);
+
+  template<typename CellFunction>
+  void updateCells_(
+    const VectorOfEigenVector<CellIndexes> & cells,
+    CellFunction && cellFunction);
+
+private:
+  Scalar hitProbability_;
+  Scalar missProbability_;
+  Scalar minimalProbability_;
+  Scalar maximalProbability_;
+  Scalar maximalSensorRange_;
+  size_t maximalNumberOfThreads_;
+
+  Scalar cellsPerLogOdds_;
+  int hitIncrement_;
+  int missIncrement_;
+  int minimalCellValue_;
+  int maximalCellValue_;
+
+  PointType centerPosition_;
+  Scalar halfExtent_;
+  GridIndexMapping<Scalar, DIM> gridIndexMapping_;
+  WrappableGrid<CellType, DIM> grid_;
+  ScanRayCasting<Scalar, DIM> scanRayCasting_;
+  PointSetType localScanPoints_;
+  OccupancyGridStatistics statistics_;
+
+public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW_IF_VECTORIZABLE_FIXED_SIZE(Scalar, DIM)
+};
+
+}  // namespace core
+}  // namespace romea
+
+#endif  // ROMEA_CORE_COMMON__CONTAINERS__GRID__OCCUPANCYGRID_HPP_
@@ -16,6 +16,9 @@
 #ifndef ROMEA_CORE_COMMON__CONTAINERS__GRID__RAYTRACING_HPP_
 #define ROMEA_CORE_COMMON__CONTAINERS__GRID__RAYTRACING_HPP_
 
+// std
+#include <cstdint>
+
 // romea
 #include "romea_core_common/containers/grid/GridIndexMapping.hpp"
 #include "romea_core_common/containers/Eigen/VectorOfEigenVector.hpp"
@@ -25,12 +28,16 @@ namespace romea
 namespace core
 {
 
+// Amanatides-Woo traversal. Crossing parameters are measured along the
+// unnormalized ray (0 at origin point, 1 at end point) and stored in fixed
+// point, so next() only performs integer comparisons and additions.
 template<typename Scalar, size_t DIM>
 class RayCasting
 {
 public:
   using PointType = Eigen::Matrix<Scalar, DIM, 1>;
   using CellIndexes = Eigen::Matrix<size_t, DIM, 1>;
+  using FixedPointVector = Eigen::Matrix<std::uint64_t, DIM, 1>;
 
 public:
   RayCasting();
@@ -64,6 +71,14 @@ public:
   void next(CellIndexes & cellIndexes);
 
 private:
+  static std::uint64_t toFixedPoint_(const Scalar & t);
+
+private:
+  // 2^40 fixed point units per ray length, values saturate at 2^62 so
+  // that an addition of two of them can never overflow
+  static constexpr int FIXED_POINT_SHIFT = 40;
+  static constexpr std::uint64_t FIXED_POINT_INFINITY = std::uint64_t(1) << 62;
+
   GridIndexMapping<Scalar, DIM> * gridIndexMapping_;
 
   PointType rayOriginPoint_;
@@ -72,15 +87,40 @@ private:
   CellIndexes rayOriginIndexes_;
   CellIndexes rayEndIndexes_;
 
-  PointType rayTMax_;
-  PointType rayTDelta_;
-  PointType rayDirection_;
+  PointType rayOriginCellLowerCorner_;
+
+  FixedPointVector rayTMax_;
+  FixedPointVector rayTDelta_;
   Eigen::Matrix<int, DIM, 1> rayStep_;
 
 public:
   EIGEN_MAKE_ALIGNED_OPERATOR_NEW_IF_VECTORIZABLE_FIXED_SIZE(Scalar, DIM)
 };
 
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+inline void RayCasting<Scalar, DIM>::next(CellIndexes & cellIndexes)
+{
+  // find minimum rayTMax_ and increment current position along its axis,
+  // written with comparison results rather than branches which are
+  // unpredictable along oblique rays
+  size_t axis = !(rayTMax_[0] < rayTMax_[1]);
+  if constexpr (DIM == 3) {
+    axis = rayTMax_[axis] < rayTMax_[2] ? axis : 2;
+  }
+
+  // every axis is updated with a select so that state is indexed by
+  // constants and can be kept in registers by the caller loop, an axis
+  // whose end index is reached is no longer stepped, so ties on cell
+  // borders never overstep the end cell
+  for (size_t i = 0; i < DIM; ++i) {
+    const std::uint64_t tMax = rayTMax_[i] + (i == axis ? rayTDelta_[i] : 0);
+    cellIndexes[i] += i == axis ? rayStep_[i] : 0;
+    rayTMax_[i] = tMax < FIXED_POINT_INFINITY && cellIndexes[i] != rayEndIndexes_[i] ?
+      tMax : FIXED_POINT_INFINITY;
+  }
+}
+
 using RayCasting2f = RayCasting<float, 2>;
 using RayCasting3f = RayCasting<float, 3>;
 using RayCasting2d = RayCasting<double, 2>;
@@ -0,0 +1,161 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef ROMEA_CORE_COMMON__CONTAINERS__GRID__SCANRAYCASTING_HPP_
+#define ROMEA_CORE_COMMON__CONTAINERS__GRID__SCANRAYCASTING_HPP_
+
+// std
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// romea
+#include "romea_core_common/concurrency/ParallelFor.hpp"
+#include "romea_core_common/containers/grid/RayTracing.hpp"
+
+namespace romea
+{
+namespace core
+{
+
+// Cast all the rays of a scan from a common origin point. Rays are split in
+// contiguous ranges processed in parallel, each thread owning its own ray
+// traversal state, so no memory is allocated per ray. Rays longer than the
+// maximal range are truncated and do not hit their last cell. Origin and
+// (truncated) end points must lie inside the grid.
+template<typename Scalar, size_t DIM>
+class ScanRayCasting
+{
+public:
+  using PointType = Eigen::Matrix<Scalar, DIM, 1>;
+  using CellIndexes = Eigen::Matrix<size_t, DIM, 1>;
+  using PointSetType = VectorOfEigenVector<PointType>;
+
+public:
+  ScanRayCasting();
+
+  explicit ScanRayCasting(GridIndexMapping<Scalar, DIM> * gridIndexMapping);
+
+  void setGridIndexMapping(GridIndexMapping<Scalar, DIM> * gridIndexMapping);
+
+  void setMaximalNumberOfThreads(const size_t & maximalNumberOfThreads);
+
+  void setMaximalRange(const Scalar & maximalRange);
+
+  const Scalar & getMaximalRange() const;
+
+public:
+  // Call visitor(threadIndex, cellIndexes, isHitCell) for each cell crossed
+  // by each ray, in ray order. Only the last cell of rays shorter than
+  // maximal range is hit. Visitor is called concurrently by several
+  // threads, per thread data can be indexed by threadIndex which is lower
+  // than computeNumberOfThreads(endPoints.size()).
+  template<typename Visitor>
+  void cast(
+    const PointType & originPoint,
+    const PointSetType & endPoints,
+    Visitor && visitor);
+
+  // Compute cells hit by rays (occupied) and cells crossed by rays
+  // without being hit by any of them (free), each cell being given once.
+  // Deduplication uses a bitmap covering the bounding box of scan cells.
+  // When several threads are used, free cells order is not deterministic.
+  void computeFreeAndOccupiedCells(
+    const PointType & originPoint,
+    const PointSetType & endPoints);
+
+  const VectorOfEigenVector<CellIndexes> & getFreeCells() const;
+
+  const VectorOfEigenVector<CellIndexes> & getOccupiedCells() const;
+
+  size_t computeNumberOfThreads(const size_t & numberOfRays) const;
+
+private:
+  static constexpr size_t MINIMAL_NUMBER_OF_RAYS_PER_THREAD = 64;
+
+  bool computeRayEndPoint_(
+    const PointType & originPoint,
+    const PointType & endPoint,
+    PointType & rayEndPoint) const;
+
+  void initScanCellBox_(
+    const PointType & originPoint,
+    const PointSetType & endPoints);
+
+  size_t computeScanCellLinearIndex_(const CellIndexes & cellIndexes) const;
+
+private:
+  GridIndexMapping<Scalar, DIM> * gridIndexMapping_;
+  size_t maximalNumberOfThreads_;
+  Scalar maximalRange_;
+  std::vector<RayCasting<Scalar, DIM>> threadRayCastings_;
+
+  CellIndexes scanMinimalCellIndexes_;
+  CellIndexes scanNumberOfCells_;
+  std::vector<std::uint64_t> occupiedCellsBitmap_;
+  std::unique_ptr<std::atomic<std::uint64_t>[]> freeCellsBitmap_;
+  size_t freeCellsBitmapSize_;
+
+  std::vector<VectorOfEigenVector<CellIndexes>> threadFreeCells_;
+  VectorOfEigenVector<CellIndexes> freeCells_;
+  VectorOfEigenVector<CellIndexes> occupiedCells_;
+};
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+template<typename Visitor>
+void ScanRayCasting<Scalar, DIM>::cast(
+  const PointType & originPoint,
+  const PointSetType & endPoints,
+  Visitor && visitor)
+{
+  const size_t numberOfThreads = computeNumberOfThreads(endPoints.size());
+  threadRayCastings_.resize(numberOfThreads);
+  for (RayCasting<Scalar, DIM> & rayCasting : threadRayCastings_) {
+    rayCasting.setGridIndexMapping(gridIndexMapping_);
+    rayCasting.setOriginPoint(originPoint);
+  }
+
+  parallelFor(
+    endPoints.size(), numberOfThreads,
+    [&](const size_t & threadIndex, const size_t & begin, const size_t & end) {
+      RayCasting<Scalar, DIM> & rayCasting = threadRayCastings_[threadIndex];
+      PointType rayEndPoint;
+      for (size_t n = begin; n < end; ++n) {
+        const bool isHit = computeRayEndPoint_(originPoint, endPoints[n], rayEndPoint);
+        rayCasting.setEndPoint(rayEndPoint);
+        const size_t rayNumberOfCells = rayCasting.computeRayNumberOfCells();
+
+        CellIndexes cellIndexes = rayCasting.getOriginPointIndexes();
+        for (size_t m = 1; m < rayNumberOfCells; ++m) {
+          visitor(threadIndex, std::as_const(cellIndexes), false);
+          rayCasting.next(cellIndexes);
+        }
+        visitor(threadIndex, std::as_const(cellIndexes), isHit);
+      }
+    });
+}
+
+using ScanRayCasting2f = ScanRayCasting<float, 2>;
+using ScanRayCasting3f = ScanRayCasting<float, 3>;
+using ScanRayCasting2d = ScanRayCasting<double, 2>;
+using ScanRayCasting3d = ScanRayCasting<double, 3>;
+
+}  // namespace core
+}  // namespace romea
+
+#endif  // ROMEA_CORE_COMMON__CONTAINERS__GRID__SCANRAYCASTING_HPP_
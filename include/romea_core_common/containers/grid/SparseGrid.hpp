@@ -0,0 +1,493 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef ROMEA_CORE_COMMON__CONTAINERS__GRID__SPARSEGRID_HPP_
+#define ROMEA_CORE_COMMON__CONTAINERS__GRID__SPARSEGRID_HPP_
+
+// Eigen
+#include <Eigen/Core>
+
+// std
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+
+namespace romea
+{
+namespace core
+{
+
+// Sparse grid for large extent maps indexed like Grid (for instance with cell
+// indexes given by a GridIndexMapping). Cells are stored by blocks of
+// 2^BLOCK_SIZE_LOG2 cells along each axis, blocks being allocated on first
+// write access and found through an open addressing hash map (linear probing).
+// Reading an unallocated cell returns the empty value without allocating.
+// Write accesses update a block usage stamp, so when a maximal number of blocks
+// is given the least recently written blocks are evicted. Blocks far from a
+// given cell can be evicted too. References returned by write accessors are
+// invalidated when blocks are evicted.
+template<typename T, size_t DIM, size_t BLOCK_SIZE_LOG2 = 3>
+class SparseGrid
+{
+  static_assert(DIM == 2 || DIM == 3, "SparseGrid is only defined in 2D and 3D");
+
+public:
+  using CellIndexes = Eigen::Matrix<size_t, DIM, 1>;
+
+  static constexpr size_t BLOCK_SIZE = size_t(1) << BLOCK_SIZE_LOG2;
+  static constexpr size_t BLOCK_MASK = BLOCK_SIZE - 1;
+  static constexpr size_t NUMBER_OF_CELLS_IN_BLOCK = size_t(1) << (DIM * BLOCK_SIZE_LOG2);
+
+  using BlockCells = std::array<T, NUMBER_OF_CELLS_IN_BLOCK>;
+
+public:
+  SparseGrid();
+
+  explicit SparseGrid(const CellIndexes & numberOfCellsAlongAxes, const T & emptyValue = T());
+
+  void init(const CellIndexes & numberOfCellsAlongAxes, const T & emptyValue = T());
+
+public:
+  T & operator()(const CellIndexes & cellIndexes);
+
+  const T & operator()(const CellIndexes & cellIndexes)const;
+
+  // Return nullptr when cell block is not allocated
+  const T * find(const CellIndexes & cellIndexes) const;
+
+  const CellIndexes & getNumberOfCellsAlongAxes() const;
+
+  const T & getEmptyValue() const;
+
+public:
+  size_t getNumberOfBlocks() const;
+
+  // Call function(firstCellIndexes, blockCells) for each allocated block,
+  // cells are stored x index first inside a block
+  template<typename Function>
+  void forEachBlock(Function && function);
+
+  template<typename Function>
+  void forEachBlock(Function && function) const;
+
+  void clear();
+
+  // When it is reached, a quarter of the blocks (least recently written) is evicted
+  void setMaximalNumberOfBlocks(const size_t & maximalNumberOfBlocks);
+
+  // Evict blocks having all their cells farther than maximalDistance cells
+  // (along at least one axis) from center cell, return number of evicted blocks
+  size_t evictBlocks(const CellIndexes & centerCellIndexes, const size_t & maximalDistance);
+
+protected:
+  struct Block
+  {
+    std::uint64_t key;
+    std::uint64_t lastAccess;
+    BlockCells cells;
+  };
+
+  struct Slot
+  {
+    std::uint64_t key;
+    size_t blockIndex;
+  };
+
+  static constexpr std::uint64_t EMPTY_KEY = std::numeric_limits<std::uint64_t>::max();
+  static constexpr size_t KEY_BITS_PER_AXIS = 21;
+  static constexpr std::uint64_t KEY_AXIS_MASK = (std::uint64_t(1) << KEY_BITS_PER_AXIS) - 1;
+
+  static std::uint64_t computeBlockKey_(const CellIndexes & cellIndexes);
+
+  static CellIndexes computeFirstCellIndexes_(const std::uint64_t & key);
+
+  static size_t computeCellIndexInBlock_(const CellIndexes & cellIndexes);
+
+  size_t computeHomeSlot_(const std::uint64_t & key) const;
+
+  size_t findSlot_(const std::uint64_t & key) const;
+
+  Block * findBlock_(const std::uint64_t & key) const;
+
+  Block * allocateBlock_(const std::uint64_t & key);
+
+  void eraseBlock_(const size_t & blockIndex);
+
+  void rehash_(const size_t & numberOfSlots);
+
+  void evictLeastRecentlyUsedBlocks_();
+
+protected:
+  CellIndexes numberOfCellsAlongAxes_;
+  T emptyValue_;
+
+  std::vector<std::unique_ptr<Block>> blocks_;
+  std::vector<std::unique_ptr<Block>> freeBlocks_;
+  std::vector<Slot> slots_;
+  size_t hashShift_;
+
+  size_t maximalNumberOfBlocks_;
+  std::uint64_t accessCounter_;
+  Block * lastBlock_;
+};
+
+
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM, size_t BLOCK_SIZE_LOG2>
+SparseGrid<T, DIM, BLOCK_SIZE_LOG2>::SparseGrid()
+: numberOfCellsAlongAxes_(CellIndexes::Zero()),
+  emptyValue_(),
+  blocks_(),
+  freeBlocks_(),
+  slots_(),
+  hashShift_(64),
+  maximalNumberOfBlocks_(std::numeric_limits<size_t>::max()),
+  accessCounter_(0),
+  lastBlock_(nullptr)
+{
+}
+
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM, size_t BLOCK_SIZE_LOG2>
+SparseGrid<T, DIM, BLOCK_SIZE_LOG2>::SparseGrid(
+  const CellIndexes & numberOfCellsAlongAxes,
+  const T & emptyValue)
+: SparseGrid()
+{
+  init(numberOfCellsAlongAxes, emptyValue);
+}
+
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM, size_t BLOCK_SIZE_LOG2>
+void SparseGrid<T, DIM, BLOCK_SIZE_LOG2>::init(
+  const CellIndexes & numberOfCellsAlongAxes,
+  const T & emptyValue)
+{
+  assert((numberOfCellsAlongAxes.array() / BLOCK_SIZE <= size_t(KEY_AXIS_MASK)).all());
+  numberOfCellsAlongAxes_ = numberOfCellsAlongAxes;
+  emptyValue_ = emptyValue;
+  clear();
+}
+
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM, size_t BLOCK_SIZE_LOG2>
+std::uint64_t SparseGrid<T, DIM, BLOCK_SIZE_LOG2>::computeBlockKey_(
+  const CellIndexes & cellIndexes)
+{
+  std::uint64_t key = 0;
+  for (size_t axis = 0; axis < DIM; ++axis) {
+    key |= std::uint64_t(cellIndexes[axis] >> BLOCK_SIZE_LOG2) << (axis * KEY_BITS_PER_AXIS);
+  }
+  return key;
+}
+
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM, size_t BLOCK_SIZE_LOG2>
+typename SparseGrid<T, DIM, BLOCK_SIZE_LOG2>::CellIndexes
+SparseGrid<T, DIM, BLOCK_SIZE_LOG2>::computeFirstCellIndexes_(const std::uint64_t & key)
+{
+  CellIndexes cellIndexes;
+  for (size_t axis = 0; axis < DIM; ++axis) {
+    cellIndexes[axis] = size_t((key >> (axis * KEY_BITS_PER_AXIS)) & KEY_AXIS_MASK) <<
+      BLOCK_SIZE_LOG2;
+  }
+  return cellIndexes;
+}
+
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM, size_t BLOCK_SIZE_LOG2>
+size_t SparseGrid<T, DIM, BLOCK_SIZE_LOG2>::computeCellIndexInBlock_(
+  const CellIndexes & cellIndexes)
+{
+  if constexpr (DIM == 2) {
+    return (cellIndexes[0] & BLOCK_MASK) + ((cellIndexes[1] & BLOCK_MASK) << BLOCK_SIZE_LOG2);
+  } else {
+    return (cellIndexes[0] & BLOCK_MASK) + ((cellIndexes[1] & BLOCK_MASK) << BLOCK_SIZE_LOG2) +
+           ((cellIndexes[2] & BLOCK_MASK) << (2 * BLOCK_SIZE_LOG2));
+  }
+}
+
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM, size_t BLOCK_SIZE_LOG2>
+size_t SparseGrid<T, DIM, BLOCK_SIZE_LOG2>::computeHomeSlot_(const std::uint64_t & key) const
+{
+  // Fibonacci hashing, upper bits are well mixed
+  return size_t((key * 0x9e3779b97f4a7c15ULL) >> hashShift_);
+}
+
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM, size_t BLOCK_SIZE_LOG2>
+size_t SparseGrid<T, DIM, BLOCK_SIZE_LOG2>::findSlot_(const std::uint64_t & key) const
+{
+  // Load factor is kept below one half so an empty slot is always found
+  const size_t slotMask = slots_.size() - 1;
+  size_t slot = computeHomeSlot_(key);
+  while (slots_[slot].key != key && slots_[slot].key != EMPTY_KEY) {
+    slot = (slot + 1) & slotMask;
+  }
+  return slot;
+}
+
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM, size_t BLOCK_SIZE_LOG2>
+typename SparseGrid<T, DIM, BLOCK_SIZE_LOG2>::Block *
+SparseGrid<T, DIM, BLOCK_SIZE_LOG2>::findBlock_(const std::uint64_t & key) const
+{
+  if (blocks_.empty()) {
+    return nullptr;
+  }
+
+  const Slot & slot = slots_[findSlot_(key)];
+  return slot.key == key ? blocks_[slot.blockIndex].get() : nullptr;
+}
+
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM, size_t BLOCK_SIZE_LOG2>
+typename SparseGrid<T, DIM, BLOCK_SIZE_LOG2>::Block *
+SparseGrid<T, DIM, BLOCK_SIZE_LOG2>::allocateBlock_(const std::uint64_t & key)
+{
+  if (blocks_.size() >= maximalNumberOfBlocks_) {
+    evictLeastRecentlyUsedBlocks_();
+  }
+
+  if (2 * (blocks_.size() + 1) > slots_.size()) {
+    rehash_(std::max(size_t(64), 2 * slots_.size()));
+  }
+
+  std::unique_ptr<Block> block;
+  if (freeBlocks_.empty()) {
+    block = std::make_unique<Block>();
+  } else {
+    block = std::move(freeBlocks_.back());
+    freeBlocks_.pop_back();
+  }
+  block->key = key;
+  block->cells.fill(emptyValue_);
+
+  slots_[findSlot_(key)] = {key, blocks_.size()};
+  blocks_.push_back(std::move(block));
+  return blocks_.back().get();
+}
+
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM, size_t BLOCK_SIZE_LOG2>
+void SparseGrid<T, DIM, BLOCK_SIZE_LOG2>::eraseBlock_(const size_t & blockIndex)
+{
+  const size_t slotMask = slots_.size() - 1;
+
+  // Backward shift deletion, entries of the probe sequence following the
+  // erased one are moved back when it does not put them before their home slot
+  size_t hole = findSlot_(blocks_[blockIndex]->key);
+  size_t slot = (hole + 1) & slotMask;
+  while (slots_[slot].key != EMPTY_KEY) {
+    const size_t homeSlot = computeHomeSlot_(slots_[slot].key);
+    if (((slot - homeSlot) & slotMask) >= ((slot - hole) & slotMask)) {
+      slots_[hole] = slots_[slot];
+      hole = slot;
+    }
+    slot = (slot + 1) & slotMask;
+  }
+  slots_[hole].key = EMPTY_KEY;
+
+  // Last block takes the place of the erased one
+  freeBlocks_.push_back(std::move(blocks_[blockIndex]));
+  if (blockIndex + 1 != blocks_.size()) {
+    blocks_[blockIndex] = std::move(blocks_.back());
+    slots_[findSlot_(blocks_[blockIndex]->key)].blockIndex = blockIndex;
+  }
+  blocks_.pop_back();
+  lastBlock_ = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM, size_t BLOCK_SIZE_LOG2>
+void SparseGrid<T, DIM, BLOCK_SIZE_LOG2>::rehash_(const size_t & numberOfSlots)
+{
+  assert((numberOfSlots & (numberOfSlots - 1)) == 0);
+  slots_.assign(numberOfSlots, {EMPTY_KEY, 0});
+  hashShift_ = 64;
+  for (size_t n = numberOfSlots; n > 1; n >>= 1) {
+    --hashShift_;
+  }
+
+  for (size_t n = 0; n < blocks_.size(); ++n) {
+    slots_[findSlot_(blocks_[n]->key)] = {blocks_[n]->key, n};
+  }
+}
+
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM, size_t BLOCK_SIZE_LOG2>
+void SparseGrid<T, DIM, BLOCK_SIZE_LOG2>::evictLeastRecentlyUsedBlocks_()
+{
+  // Evicting blocks by batch keeps allocation cost constant in average
+  const size_t numberOfEvictedBlocks =
+    blocks_.size() - std::min(blocks_.size() - 1, maximalNumberOfBlocks_ * 3 / 4);
+
+  std::vector<std::uint64_t> lastAccesses(blocks_.size());
+  for (size_t n = 0; n < blocks_.size(); ++n) {
+    lastAccesses[n] = blocks_[n]->lastAccess;
+  }
+  std::nth_element(
+    lastAccesses.begin(),
+    lastAccesses.begin() + numberOfEvictedBlocks - 1,
+    lastAccesses.end());
+  const std::uint64_t lastEvictedAccess = lastAccesses[numberOfEvictedBlocks - 1];
+
+  // Blocks are visited backward because erased ones are replaced by last ones
+  for (size_t n = blocks_.size(); n-- > 0; ) {
+    if (blocks_[n]->lastAccess <= lastEvictedAccess) {
+      eraseBlock_(n);
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM, size_t BLOCK_SIZE_LOG2>
+T & SparseGrid<T, DIM, BLOCK_SIZE_LOG2>::operator()(const CellIndexes & cellIndexes)
+{
+  assert((cellIndexes.array() < numberOfCellsAlongAxes_.array()).all());
+
+  // Consecutive accesses (along a ray for instance) often fall in the same block
+  const std::uint64_t key = computeBlockKey_(cellIndexes);
+  if (lastBlock_ == nullptr || lastBlock_->key != key) {
+    lastBlock_ = findBlock_(key);
+    if (lastBlock_ == nullptr) {
+      lastBlock_ = allocateBlock_(key);
+    }
+  }
+
+  lastBlock_->lastAccess = ++accessCounter_;
+  return lastBlock_->cells[computeCellIndexInBlock_(cellIndexes)];
+}
+
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM, size_t BLOCK_SIZE_LOG2>
+const T & SparseGrid<T, DIM, BLOCK_SIZE_LOG2>::operator()(const CellIndexes & cellIndexes)const
+{
+  const T * cell = find(cellIndexes);
+  return cell != nullptr ? *cell : emptyValue_;
+}
+
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM, size_t BLOCK_SIZE_LOG2>
+const T * SparseGrid<T, DIM, BLOCK_SIZE_LOG2>::find(const CellIndexes & cellIndexes) const
+{
+  assert((cellIndexes.array() < numberOfCellsAlongAxes_.array()).all());
+
+  const Block * block = findBlock_(computeBlockKey_(cellIndexes));
+  return block != nullptr ? &block->cells[computeCellIndexInBlock_(cellIndexes)] : nullptr;
+}
+
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM, size_t BLOCK_SIZE_LOG2>
+const typename SparseGrid<T, DIM, BLOCK_SIZE_LOG2>::CellIndexes &
+SparseGrid<T, DIM, BLOCK_SIZE_LOG2>::getNumberOfCellsAlongAxes() const
+{
+  return numberOfCellsAlongAxes_;
+}
+
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM, size_t BLOCK_SIZE_LOG2>
+const T & SparseGrid<T, DIM, BLOCK_SIZE_LOG2>::getEmptyValue() const
+{
+  return emptyValue_;
+}
+
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM, size_t BLOCK_SIZE_LOG2>
+size_t SparseGrid<T, DIM, BLOCK_SIZE_LOG2>::getNumberOfBlocks() const
+{
+  return blocks_.size();
+}
+
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM, size_t BLOCK_SIZE_LOG2>
+template<typename Function>
+void SparseGrid<T, DIM, BLOCK_SIZE_LOG2>::forEachBlock(Function && function)
+{
+  for (const std::unique_ptr<Block> & block : blocks_) {
+    function(computeFirstCellIndexes_(block->key), block->cells);
+  }
+}
+
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM, size_t BLOCK_SIZE_LOG2>
+template<typename Function>
+void SparseGrid<T, DIM, BLOCK_SIZE_LOG2>::forEachBlock(Function && function) const
+{
+  for (const std::unique_ptr<Block> & block : blocks_) {
+    function(computeFirstCellIndexes_(block->key), std::as_const(block->cells));
+  }
+}
+
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM, size_t BLOCK_SIZE_LOG2>
+void SparseGrid<T, DIM, BLOCK_SIZE_LOG2>::clear()
+{
+  for (std::unique_ptr<Block> & block : blocks_) {
+    freeBlocks_.push_back(std::move(block));
+  }
+  blocks_.clear();
+  slots_.clear();
+  hashShift_ = 64;
+  lastBlock_ = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM, size_t BLOCK_SIZE_LOG2>
+void SparseGrid<T, DIM, BLOCK_SIZE_LOG2>::setMaximalNumberOfBlocks(
+  const size_t & maximalNumberOfBlocks)
+{
+  assert(maximalNumberOfBlocks > 0);
+  maximalNumberOfBlocks_ = maximalNumberOfBlocks;
+  if (blocks_.size() > maximalNumberOfBlocks_) {
+    evictLeastRecentlyUsedBlocks_();
+  }
+}
+
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM, size_t BLOCK_SIZE_LOG2>
+size_t SparseGrid<T, DIM, BLOCK_SIZE_LOG2>::evictBlocks(
+  const CellIndexes & centerCellIndexes,
+  const size_t & maximalDistance)
+{
+  const size_t numberOfBlocks = blocks_.size();
+  for (size_t n = blocks_.size(); n-- > 0; ) {
+    const CellIndexes firstCellIndexes = computeFirstCellIndexes_(blocks_[n]->key);
+    for (size_t axis = 0; axis < DIM; ++axis) {
+      const size_t & first = firstCellIndexes[axis];
+      const size_t last = first + BLOCK_MASK;
+      const size_t & center = centerCellIndexes[axis];
+      const size_t distance = center < first ? first - center : center > last ? center - last : 0;
+      if (distance > maximalDistance) {
+        eraseBlock_(n);
+        break;
+      }
+    }
+  }
+  return numberOfBlocks - blocks_.size();
+}
+
+}  // namespace core
+}  // namespace romea
+
+#endif  // ROMEA_CORE_COMMON__CONTAINERS__GRID__SPARSEGRID_HPP_
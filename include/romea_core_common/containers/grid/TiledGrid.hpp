@@ -0,0 +1,194 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef ROMEA_CORE_COMMON__CONTAINERS__GRID__TILEDGRID_HPP_
+#define ROMEA_CORE_COMMON__CONTAINERS__GRID__TILEDGRID_HPP_
+
+// Eigen
+#include <Eigen/Core>
+
+// std
+#include <cstddef>
+#include <cassert>
+#include <algorithm>
+#include <vector>
+
+
+namespace romea
+{
+namespace core
+{
+
+// Dense grid stored by square (2D) or cubic (3D) tiles of 2^TILE_SIZE_LOG2 cells
+// along each axis. Cells of a tile are contiguous in memory, so neighbourhood
+// accesses (stencils, ray traversals, local map updates) touch fewer cache lines
+// than with the row major Grid. Number of cells along each axis is rounded up
+// to a multiple of the tile size, padding cells are never accessed by indexes.
+template<typename T, size_t DIM, size_t TILE_SIZE_LOG2 = 3>
+class TiledGrid
+{
+  static_assert(DIM == 2 || DIM == 3, "TiledGrid is only defined in 2D and 3D");
+
+public:
+  using CellIndexes = Eigen::Matrix<size_t, DIM, 1>;
+
+  static constexpr size_t TILE_SIZE = size_t(1) << TILE_SIZE_LOG2;
+  static constexpr size_t TILE_MASK = TILE_SIZE - 1;
+  static constexpr size_t NUMBER_OF_CELLS_IN_TILE = size_t(1) << (DIM * TILE_SIZE_LOG2);
+
+public:
+  TiledGrid();
+
+  explicit TiledGrid(const CellIndexes & numberOfCellsAlongAxes);
+
+  void init(const CellIndexes & numberOfCellsAlongAxes);
+
+public:
+  // Tiled buffer including padding cells
+  std::vector<T> & getBuffer();
+
+  const std::vector<T> & getBuffer() const;
+
+  void setValue(const T & value);
+
+public:
+  T & operator()(const CellIndexes & cellIndexes);
+
+  const T & operator()(const CellIndexes & cellIndexes)const;
+
+  const CellIndexes & getNumberOfCellsAlongAxes() const;
+
+  const CellIndexes & getNumberOfTilesAlongAxes() const;
+
+protected:
+  size_t computeCellLinearIndex_(const CellIndexes & CellIndexes) const;
+
+protected:
+  CellIndexes numberOfCellsAlongAxes_;
+  CellIndexes numberOfTilesAlongAxes_;
+  std::vector<T> buffer_;
+};
+
+
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM, size_t TILE_SIZE_LOG2>
+TiledGrid<T, DIM, TILE_SIZE_LOG2>::TiledGrid()
+: numberOfCellsAlongAxes_(),
+  numberOfTilesAlongAxes_(),
+  buffer_()
+{
+}
+
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM, size_t TILE_SIZE_LOG2>
+TiledGrid<T, DIM, TILE_SIZE_LOG2>::TiledGrid(const CellIndexes & numberOfCellsAlongAxes)
+: numberOfCellsAlongAxes_(),
+  numberOfTilesAlongAxes_(),
+  buffer_()
+{
+  init(numberOfCellsAlongAxes);
+}
+
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM, size_t TILE_SIZE_LOG2>
+void TiledGrid<T, DIM, TILE_SIZE_LOG2>::init(const CellIndexes & numberOfCellsAlongAxes)
+{
+  numberOfCellsAlongAxes_ = numberOfCellsAlongAxes;
+  for (size_t n = 0; n < DIM; ++n) {
+    numberOfTilesAlongAxes_[n] = (numberOfCellsAlongAxes_[n] + TILE_MASK) >> TILE_SIZE_LOG2;
+  }
+  buffer_.resize(numberOfTilesAlongAxes_.array().prod() * NUMBER_OF_CELLS_IN_TILE);
+}
+
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM, size_t TILE_SIZE_LOG2>
+std::vector<T> & TiledGrid<T, DIM, TILE_SIZE_LOG2>::getBuffer()
+{
+  return buffer_;
+}
+
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM, size_t TILE_SIZE_LOG2>
+const std::vector<T> & TiledGrid<T, DIM, TILE_SIZE_LOG2>::getBuffer() const
+{
+  return buffer_;
+}
+
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM, size_t TILE_SIZE_LOG2>
+void TiledGrid<T, DIM, TILE_SIZE_LOG2>::setValue(const T & value)
+{
+  std::fill(std::begin(buffer_), std::end(buffer_), value);
+}
+
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM, size_t TILE_SIZE_LOG2>
+size_t TiledGrid<T, DIM, TILE_SIZE_LOG2>::computeCellLinearIndex_(
+  const CellIndexes & cellIndexes) const
+{
+  assert((cellIndexes.array() < numberOfCellsAlongAxes_.array()).prod());
+
+  const size_t xTile = cellIndexes[0] >> TILE_SIZE_LOG2;
+  const size_t yTile = cellIndexes[1] >> TILE_SIZE_LOG2;
+  const size_t xCell = cellIndexes[0] & TILE_MASK;
+  const size_t yCell = cellIndexes[1] & TILE_MASK;
+
+  if constexpr (DIM == 2) {
+    const size_t tile = xTile + yTile * numberOfTilesAlongAxes_[0];
+    return (tile << (2 * TILE_SIZE_LOG2)) + (yCell << TILE_SIZE_LOG2) + xCell;
+  } else {
+    const size_t zTile = cellIndexes[2] >> TILE_SIZE_LOG2;
+    const size_t zCell = cellIndexes[2] & TILE_MASK;
+    const size_t tile = xTile + numberOfTilesAlongAxes_[0] *
+      (yTile + zTile * numberOfTilesAlongAxes_[1]);
+    return (tile << (3 * TILE_SIZE_LOG2)) + (zCell << (2 * TILE_SIZE_LOG2)) +
+           (yCell << TILE_SIZE_LOG2) + xCell;
+  }
+}
+
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM, size_t TILE_SIZE_LOG2>
+T & TiledGrid<T, DIM, TILE_SIZE_LOG2>::operator()(const CellIndexes & cellIndexes)
+{
+  return buffer_[computeCellLinearIndex_(cellIndexes)];
+}
+
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM, size_t TILE_SIZE_LOG2>
+const T & TiledGrid<T, DIM, TILE_SIZE_LOG2>::operator()(const CellIndexes & cellIndexes)const
+{
+  return buffer_[computeCellLinearIndex_(cellIndexes)];
+}
+
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM, size_t TILE_SIZE_LOG2>
+const typename TiledGrid<T, DIM, TILE_SIZE_LOG2>::CellIndexes &
+TiledGrid<T, DIM, TILE_SIZE_LOG2>::getNumberOfCellsAlongAxes() const
+{
+  return numberOfCellsAlongAxes_;
+}
+
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM, size_t TILE_SIZE_LOG2>
+const typename TiledGrid<T, DIM, TILE_SIZE_LOG2>::CellIndexes &
+TiledGrid<T, DIM, TILE_SIZE_LOG2>::getNumberOfTilesAlongAxes() const
+{
+  return numberOfTilesAlongAxes_;
+}
+
+}  // namespace core
+}  // namespace romea
+
+#endif  // ROMEA_CORE_COMMON__CONTAINERS__GRID__TILEDGRID_HPP_
@@ -16,6 +16,11 @@
 #ifndef ROMEA_CORE_COMMON__CONTAINERS__GRID__WRAPPABLEGRID_HPP_
 #define ROMEA_CORE_COMMON__CONTAINERS__GRID__WRAPPABLEGRID_HPP_
 
+// std
+#include <algorithm>
+#include <cstdlib>
+
+// romea
 #include "romea_core_common/containers/grid/Grid.hpp"
 
 namespace romea
@@ -23,6 +28,11 @@ namespace romea
 namespace core
 {
 
+// Grid whose content can be translated without moving cells, cell indexes
+// being wrapped by an offset along each axis. Grid cell accessors are not
+// virtual, so cells must be accessed through the WrappableGrid type and not
+// through a Grid reference. Rows and slabs of the physical buffer do not match
+// logical ones, getRow and getSlab are therefore hidden.
 template<typename T, size_t DIM>
 class WrappableGrid : public Grid<T, DIM>
 {
@@ -36,9 +46,17 @@ public:
   virtual ~WrappableGrid() = default;
 
 public:
-  T & operator()(const CellIndexes & cellIndexes)override;
+  T & operator()(const CellIndexes & cellIndexes);
+
+  const T & operator()(const CellIndexes & cellIndexes)const;
 
-  const T & operator()(const CellIndexes & cellIndexes)const override;
+  using Grid<T, DIM>::setValue;
+
+  // Fill box between first and last cells (included) in logical order
+  void setValue(
+    const CellIndexes & firstCellIndexes,
+    const CellIndexes & lastCellIndexes,
+    const T & value);
 
   void translate(const CellIndexesOffset & indexOffset, const T & emptyValue = T());
 
@@ -47,19 +65,27 @@ public:
 protected:
   CellIndexes wrapCellIndexes_(const CellIndexes & cellIndexes) const;
 
-  size_t computeCellLinearIndex_(const CellIndexes & CellIndexes) const override;
+  void clearLayers_(
+    const size_t & axis,
+    const size_t & begin,
+    const size_t & end,
+    const T & emptyValue);
+
+  size_t computeCellLinearIndex_(const CellIndexes & CellIndexes) const;
 
 protected:
   CellIndexes indexOffsetsAlongAxes_;
-  CellIndexes numberOfCellsAlongAxesMinusOne_;
+
+private:
+  using Grid<T, DIM>::getRow;
+  using Grid<T, DIM>::getSlab;
 };
 
 //-----------------------------------------------------------------------------
 template<typename T, size_t DIM>
 WrappableGrid<T, DIM>::WrappableGrid(const CellIndexes & numberOfCellAlongAxes)
 : Grid<T, DIM>(numberOfCellAlongAxes),
-  indexOffsetsAlongAxes_(CellIndexes::Zero()),
-  numberOfCellsAlongAxesMinusOne_(this->numberOfCellsAlongAxes_ - CellIndexes::Ones())
+  indexOffsetsAlongAxes_(CellIndexes::Zero())
 {
 }
 
@@ -69,7 +95,6 @@ typename WrappableGrid<T, DIM>::CellIndexes
 WrappableGrid<T, DIM>::wrapCellIndexes_(const CellIndexes & cellIndexes) const
 {
   assert((cellIndexes.array() < this->numberOfCellsAlongAxes_.array()).prod());
-  // return (cellIndexes + indexOffsetsAlongAxes_)%numberOfCellsAlongAxesMinusOne_;
 
   CellIndexes wrappredCellIndexes;
 
@@ -79,8 +104,7 @@ WrappableGrid<T, DIM>::wrapCellIndexes_(const CellIndexes & cellIndexes) const
   wrappredCellIndexes[1] = (cellIndexes[1] + indexOffsetsAlongAxes_[1]) %
     this->numberOfCellsAlongAxes_[1];
 
-  // TODO(Jean) utiliser constexpr if
-  if (DIM == 3) {
+  if constexpr (DIM == 3) {
     wrappredCellIndexes[2] = (cellIndexes[2] + indexOffsetsAlongAxes_[2]) %
       this->numberOfCellsAlongAxes_[2];
   }
@@ -92,7 +116,7 @@ WrappableGrid<T, DIM>::wrapCellIndexes_(const CellIndexes & cellIndexes) const
 template<typename T, size_t DIM>
 size_t WrappableGrid<T, DIM>::computeCellLinearIndex_(const CellIndexes & cellIndexes) const
 {
-  return wrapCellIndexes_(cellIndexes).dot(this->indexCoefficients_);
+  return Grid<T, DIM>::computeCellLinearIndex_(wrapCellIndexes_(cellIndexes));
 }
 
 //-----------------------------------------------------------------------------
@@ -109,6 +133,47 @@ const T & WrappableGrid<T, DIM>::operator()(const CellIndexes & cellIndexes)cons
   return this->buffer_[computeCellLinearIndex_(cellIndexes)];
 }
 
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM>
+void WrappableGrid<T, DIM>::setValue(
+  const CellIndexes & firstCellIndexes,
+  const CellIndexes & lastCellIndexes,
+  const T & value)
+{
+  assert((firstCellIndexes.array() <= lastCellIndexes.array()).all());
+  assert((lastCellIndexes.array() < this->numberOfCellsAlongAxes_.array()).all());
+
+  // A logical row range is wrapped in at most two physical row ranges
+  const size_t & numberOfCellsAlongX = this->numberOfCellsAlongAxes_[0];
+  const size_t xBegin = (firstCellIndexes[0] + indexOffsetsAlongAxes_[0]) % numberOfCellsAlongX;
+  const size_t xEnd = xBegin + lastCellIndexes[0] - firstCellIndexes[0] + 1;
+
+  auto fillRows = [&](CellIndexes cellIndexes) {
+      for (cellIndexes[1] = firstCellIndexes[1]; cellIndexes[1] <= lastCellIndexes[1];
+        ++cellIndexes[1])
+      {
+        const CellIndexes wrappedCellIndexes = wrapCellIndexes_(cellIndexes);
+        T * row = DIM == 2 ?
+          Grid<T, DIM>::getRow(wrappedCellIndexes[1]) :
+          Grid<T, DIM>::getRow(wrappedCellIndexes[1], wrappedCellIndexes[DIM - 1]);
+        if (xEnd <= numberOfCellsAlongX) {
+          std::fill(row + xBegin, row + xEnd, value);
+        } else {
+          std::fill(row + xBegin, row + numberOfCellsAlongX, value);
+          std::fill(row, row + xEnd - numberOfCellsAlongX, value);
+        }
+      }
+    };
+
+  CellIndexes cellIndexes = firstCellIndexes;
+  if constexpr (DIM == 2) {
+    fillRows(cellIndexes);
+  } else {
+    for (; cellIndexes[2] <= lastCellIndexes[2]; ++cellIndexes[2]) {
+      fillRows(cellIndexes);
+    }
+  }
+}
 
 //-----------------------------------------------------------------------------
 template<typename T, size_t DIM>
@@ -124,150 +189,63 @@ void WrappableGrid<T, DIM>::translate(
   const CellIndexesOffset & indexOffset,
   const T & emptyValue)
 {
-  // TODO(JEAN) utiliser constexpr if
-  if (DIM == 2) {
-    CellIndexes cellIndexes;
-    size_t & xIndex = cellIndexes[0];
-    size_t & yIndex = cellIndexes[1];
-
-    const int & indexOffsetAlongXAxis = indexOffset[0];
-    const int & indexOffsetAlongYAxis = indexOffset[1];
-
-    const size_t & numberOfCellsAlongXAxis = this->numberOfCellsAlongAxes_[0];
-    const size_t & numberOfCellsAlongYAxis = this->numberOfCellsAlongAxes_[1];
-
-    const size_t & numberOfCellsAlongXAxisMinusOne = numberOfCellsAlongAxesMinusOne_[0];
-    const size_t & numberOfCellsAlongYAxisMinusOne = numberOfCellsAlongAxesMinusOne_[1];
-
-
-    // translation along X
-    if (indexOffsetAlongXAxis) {
-      for (yIndex = 0; yIndex < numberOfCellsAlongYAxis; yIndex++) {
-        xIndex = indexOffsetsAlongAxes_[0];
-        for (int xOffset = 0; xOffset < indexOffsetAlongXAxis; xOffset++) {
-          this->buffer_[computeCellLinearIndex_(cellIndexes)] = emptyValue;
-          xIndex = (xIndex + 1) % numberOfCellsAlongXAxis;
-        }
-
-        xIndex = indexOffsetsAlongAxes_[0];
-        for (int xOffset = 0; xOffset > indexOffsetAlongXAxis; xOffset--) {
-          xIndex = (xIndex + numberOfCellsAlongXAxisMinusOne) % numberOfCellsAlongXAxis;
-          this->buffer_[computeCellLinearIndex_(cellIndexes)] = emptyValue;
-        }
-      }
-      indexOffsetsAlongAxes_[0] = (numberOfCellsAlongXAxis + indexOffsetAlongXAxis) %
-        numberOfCellsAlongXAxis;
+  // After translation cell i holds the value of cell i+indexOffset. Along each
+  // axis vacated cells are |indexOffset| consecutive layers in the wrapped buffer,
+  // so they are cleared layer range by layer range whatever other offsets are.
+  bool isCleared = false;
+  for (size_t axis = 0; axis < DIM; ++axis) {
+    const long long numberOfCells = this->numberOfCellsAlongAxes_[axis];
+    const long long offset = indexOffset[axis];
+    if (offset == 0) {
+      continue;
     }
 
-    // translation along Y
-    if (indexOffsetAlongYAxis) {
-      yIndex = indexOffsetsAlongAxes_[1];
-      for (int yOffset = 0; yOffset < indexOffsetAlongYAxis; yOffset++) {
-        for (xIndex = 0; xIndex < numberOfCellsAlongXAxis; xIndex++) {
-          this->buffer_[computeCellLinearIndex_(cellIndexes)] = emptyValue;
-        }
-        yIndex = (yIndex + 1) % numberOfCellsAlongYAxis;
-      }
-
-      for (int yOffset = 0; yOffset > indexOffsetAlongYAxis; yOffset--) {
-        yIndex = (yIndex + numberOfCellsAlongYAxisMinusOne) % numberOfCellsAlongYAxis;
-        for (xIndex = 0; xIndex < numberOfCellsAlongXAxis; xIndex++) {
-          this->buffer_[computeCellLinearIndex_(cellIndexes)] = emptyValue;
-        }
-      }
+    const long long previousIndexOffset = indexOffsetsAlongAxes_[axis];
+    const long long nextIndexOffset =
+      ((previousIndexOffset + offset) % numberOfCells + numberOfCells) % numberOfCells;
+    indexOffsetsAlongAxes_[axis] = nextIndexOffset;
 
-      indexOffsetsAlongAxes_[1] = (numberOfCellsAlongYAxis + indexOffsetAlongYAxis) %
-        numberOfCellsAlongYAxis;
-    }
-  } else {
-    CellIndexes cellIndexes;
-    size_t & xIndex = cellIndexes[0];
-    size_t & yIndex = cellIndexes[1];
-    size_t & zIndex = cellIndexes[2];
-
-    const int & indexOffsetAlongXAxis = indexOffset[0];
-    const int & indexOffsetAlongYAxis = indexOffset[1];
-    const int & indexOffsetAlongZAxis = indexOffset[2];
-
-    const size_t & numberOfCellsAlongXAxis = this->numberOfCellsAlongAxes_[0];
-    const size_t & numberOfCellsAlongYAxis = this->numberOfCellsAlongAxes_[1];
-    const size_t & numberOfCellsAlongZAxis = this->numberOfCellsAlongAxes_[2];
-
-    const size_t & numberOfCellsAlongXAxisMinusOne = numberOfCellsAlongAxesMinusOne_[0];
-    const size_t & numberOfCellsAlongYAxisMinusOne = numberOfCellsAlongAxesMinusOne_[1];
-    const size_t & numberOfCellsAlongZAxisMinusOne = numberOfCellsAlongAxesMinusOne_[2];
-
-    // translation along X
-    if (indexOffsetAlongXAxis) {
-      for (zIndex = 0; zIndex < numberOfCellsAlongZAxis; zIndex++) {
-        for (yIndex = 0; yIndex < numberOfCellsAlongYAxis; yIndex++) {
-          xIndex = indexOffsetsAlongAxes_[0];
-          for (int xOffset = 0; xOffset < indexOffsetAlongXAxis; xOffset++) {
-            this->buffer_[computeCellLinearIndex_(cellIndexes)] = emptyValue;
-            xIndex = (xIndex + 1) % numberOfCellsAlongXAxis;
-          }
-
-          for (int xOffset = 0; xOffset > indexOffsetAlongXAxis; xOffset--) {
-            xIndex = (xIndex + numberOfCellsAlongXAxisMinusOne) % numberOfCellsAlongXAxis;
-            this->buffer_[computeCellLinearIndex_(cellIndexes)] = emptyValue;
-          }
-        }
-      }
-      indexOffsetsAlongAxes_[0] = (numberOfCellsAlongXAxis + indexOffsetAlongXAxis) %
-        numberOfCellsAlongXAxis;
+    if (isCleared) {
+      continue;
     }
 
-    // translation along Y
-    if (indexOffsetAlongYAxis) {
-      for (zIndex = 0; zIndex < numberOfCellsAlongZAxis; zIndex++) {
-        yIndex = indexOffsetsAlongAxes_[1];
-        for (int yOffset = 0; yOffset < indexOffsetAlongYAxis; yOffset++) {
-          for (xIndex = 0; xIndex < numberOfCellsAlongXAxis; xIndex++) {
-            this->buffer_[computeCellLinearIndex_(cellIndexes)] = emptyValue;
-          }
-          yIndex = (yIndex + 1) % numberOfCellsAlongYAxis;
-        }
-
-
-        for (int yOffset = 0; yOffset > indexOffsetAlongYAxis; yOffset--) {
-          yIndex = (yIndex + numberOfCellsAlongYAxisMinusOne) % numberOfCellsAlongYAxis;
-          for (xIndex = 0; xIndex < numberOfCellsAlongXAxis; xIndex++) {
-            this->buffer_[computeCellLinearIndex_(cellIndexes)] = emptyValue;
-          }
-        }
-      }
-      indexOffsetsAlongAxes_[1] = (numberOfCellsAlongYAxis + indexOffsetAlongYAxis) %
-        numberOfCellsAlongYAxis;
+    if (std::abs(offset) >= numberOfCells) {
+      this->setValue(emptyValue);
+      isCleared = true;
+      continue;
     }
 
-    // translation along Z
-    if (indexOffsetAlongZAxis) {
-      zIndex = indexOffsetsAlongAxes_[2];
-
-      for (int zOffset = 0; zOffset < indexOffsetAlongZAxis; zOffset++) {
-        for (yIndex = 0; yIndex < numberOfCellsAlongYAxis; yIndex++) {
-          for (xIndex = 0; xIndex < numberOfCellsAlongXAxis; xIndex++) {
-            this->buffer_[computeCellLinearIndex_(cellIndexes)] = emptyValue;
-          }
-        }
-        zIndex = (zIndex + 1) % numberOfCellsAlongZAxis;
-      }
-
-      for (int zOffset = 0; zOffset < indexOffsetAlongZAxis; zOffset++) {
-        zIndex = (zIndex + numberOfCellsAlongZAxisMinusOne) % numberOfCellsAlongZAxis;
-
-        for (yIndex = 0; yIndex < numberOfCellsAlongYAxis; yIndex++) {
-          for (xIndex = 0; xIndex < numberOfCellsAlongXAxis; xIndex++) {
-            this->buffer_[computeCellLinearIndex_(cellIndexes)] = emptyValue;
-          }
-        }
-      }
-      indexOffsetsAlongAxes_[2] = (numberOfCellsAlongZAxis + indexOffsetAlongZAxis) %
-        numberOfCellsAlongZAxis;
+    // Old first layers when moving forward, new first layers when moving backward
+    const size_t begin = offset > 0 ? previousIndexOffset : nextIndexOffset;
+    const size_t end = begin + std::abs(offset);
+    if (end <= size_t(numberOfCells)) {
+      clearLayers_(axis, begin, end, emptyValue);
+    } else {
+      clearLayers_(axis, begin, numberOfCells, emptyValue);
+      clearLayers_(axis, 0, end - numberOfCells, emptyValue);
     }
   }
 }
 
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM>
+void WrappableGrid<T, DIM>::clearLayers_(
+  const size_t & axis,
+  const size_t & begin,
+  const size_t & end,
+  const T & emptyValue)
+{
+  // Layers [begin,end) along axis are contiguous inside each block of cells
+  // sharing the same indexes along upper axes
+  const size_t layerSize = this->indexCoefficients_[axis];
+  const size_t blockSize = layerSize * this->numberOfCellsAlongAxes_[axis];
+  for (auto blockBegin = std::begin(this->buffer_); blockBegin != std::end(this->buffer_);
+    blockBegin += blockSize)
+  {
+    std::fill(blockBegin + begin * layerSize, blockBegin + end * layerSize, emptyValue);
+  }
+}
+
 }  // namespace core
 }  // namespace romea
 
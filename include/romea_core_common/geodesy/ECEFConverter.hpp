@@ -21,6 +21,7 @@
 
 // romea
 #include "romea_core_common/geodesy/GeodeticCoordinates.hpp"
+#include "romea_core_common/geodesy/GeodeticCoordinatesArray.hpp"
 #include "romea_core_common/geodesy/EarthEllipsoid.hpp"
 
 namespace romea
@@ -30,15 +31,53 @@ namespace core
 
 class ECEFConverter
 {
+public:
+  // Computation of geodetic coordinates from ECEF positions. Fixed point
+  // iterates on latitude until convergence, so its duration depends on the
+  // position. Vermeille is the closed form solution of H. Vermeille (Direct
+  // transformation from geocentric coordinates to geodetic coordinates,
+  // Journal of Geodesy, 2002) taking a constant time, it is valid for all
+  // positions farther than about 43 km from earth center.
+  enum class WGS84ConversionMethod
+  {
+    FIXED_POINT = 0,
+    VERMEILLE
+  };
+
 public:
   explicit ECEFConverter(const EarthEllipsoid & earthEllipsoid = EarthEllipsoid::GRS80);
 
+  void setWGS84ConversionMethod(const WGS84ConversionMethod & method);
+
   Eigen::Vector3d toECEF(const GeodeticCoordinates & geodeticCoordinates)const;
 
   GeodeticCoordinates  toWGS84(const Eigen::Vector3d & ecefPosition)const;
 
+public:
+  // Batch conversions, row n of cartesian positions being the x, y and z
+  // coordinates of position n so each column is contiguous. Positions are
+  // processed by blocks with vectorized trigonometry and split between
+  // threads for large batches. Geodetic coordinates arrays of different
+  // sizes throw std::invalid_argument.
+  void toECEF(
+    const GeodeticCoordinatesArray & geodeticCoordinates,
+    Eigen::MatrixX3d & ecefPositions)const;
+
+  void toWGS84(
+    const Eigen::MatrixX3d & ecefPositions,
+    GeodeticCoordinatesArray & geodeticCoordinates)const;
+
+  void setMaximalNumberOfThreads(const size_t & numberOfThreads);
+
+private:
+  GeodeticCoordinates toWGS84ByFixedPoint_(const Eigen::Vector3d & ecefPosition)const;
+
+  GeodeticCoordinates toWGS84ByVermeille_(const Eigen::Vector3d & ecefPosition)const;
+
 protected:
   EarthEllipsoid ellipsoid_;
+  WGS84ConversionMethod wgs84ConversionMethod_;
+  size_t maximalNumberOfThreads_;
 };
 
 }  // namespace core
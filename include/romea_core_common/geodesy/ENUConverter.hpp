@@ -62,10 +62,33 @@ public:
 
   const Eigen::Affine3d & getEnuToEcefTransform()const;
 
+public:
+  // Batch conversions, row n of cartesian positions being the x, y and z
+  // coordinates of position n. Converter must be anchored.
+  void toWGS84(
+    const Eigen::MatrixX3d & enuPositions,
+    GeodeticCoordinatesArray & geodeticCoordinates)const;
+
+  void toECEF(
+    const Eigen::MatrixX3d & enuPositions,
+    Eigen::MatrixX3d & ecefPositions)const;
+
+  void toENU(
+    const GeodeticCoordinatesArray & geodeticCoordinates,
+    Eigen::MatrixX3d & enuPositions)const;
+
+  void toENU(
+    const Eigen::MatrixX3d & ecefPositions,
+    Eigen::MatrixX3d & enuPositions)const;
+
+  void setMaximalNumberOfThreads(const size_t & numberOfThreads);
+
 private:
   ECEFConverter ecefConverter_;
   GeodeticCoordinates wgs84Anchor_;
   Eigen::Affine3d enu2ecef_;
+  Eigen::Affine3d ecef2enu_;
+  size_t maximalNumberOfThreads_;
 
   bool isAnchored_;
 };
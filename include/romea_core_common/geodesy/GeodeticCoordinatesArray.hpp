@@ -0,0 +1,54 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+#ifndef ROMEA_CORE_COMMON__GEODESY__GEODETICCOORDINATESARRAY_HPP_
+#define ROMEA_CORE_COMMON__GEODESY__GEODETICCOORDINATESARRAY_HPP_
+
+// Eigen
+#include <Eigen/Core>
+
+// std
+#include <vector>
+
+// romea
+#include "romea_core_common/geodesy/GeodeticCoordinates.hpp"
+
+namespace romea
+{
+namespace core
+{
+
+// Geodetic coordinates of a batch of positions (a GNSS trajectory, a geo
+// referenced point cloud...) stored as structure of arrays, so converters
+// can process several positions per SIMD instruction.
+struct GeodeticCoordinatesArray
+{
+  Eigen::ArrayXd latitudes;
+  Eigen::ArrayXd longitudes;
+  Eigen::ArrayXd altitudes;
+};
+
+GeodeticCoordinatesArray makeGeodeticCoordinatesArray(
+  const std::vector<GeodeticCoordinates> & geodeticCoordinates);
+
+GeodeticCoordinates getGeodeticCoordinates(
+  const GeodeticCoordinatesArray & geodeticCoordinatesArray,
+  const size_t & index);
+
+}  // namespace core
+}  // namespace romea
+
+#endif  // ROMEA_CORE_COMMON__GEODESY__GEODETICCOORDINATESARRAY_HPP_
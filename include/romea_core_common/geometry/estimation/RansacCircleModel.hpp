@@ -0,0 +1,92 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef ROMEA_CORE_COMMON__GEOMETRY__ESTIMATION__RANSACCIRCLEMODEL_HPP_
+#define ROMEA_CORE_COMMON__GEOMETRY__ESTIMATION__RANSACCIRCLEMODEL_HPP_
+
+// romea
+#include "romea_core_common/geometry/Circle.hpp"
+#include "romea_core_common/geometry/estimation/RansacPrimitiveModel.hpp"
+#include "romea_core_common/regression/leastsquares/LeastSquares.hpp"
+
+namespace romea
+{
+namespace core
+{
+
+template<class PointType>
+class RansacCircleModel : public RansacPrimitiveModel<PointType>
+{
+public:
+  using Scalar = typename PointType::Scalar;
+  using VectorType = typename RansacPrimitiveModel<PointType>::VectorType;
+  static_assert(PointTraits<PointType>::DIM == 2, "circle model is only defined for 2D points");
+
+  struct Parameters
+  {
+    VectorType center;
+    Scalar radius;
+
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW_IF_VECTORIZABLE_FIXED_SIZE(Scalar, 2)
+  };
+
+public:
+  RansacCircleModel();
+
+  void setRadiusRange(
+    const Scalar & minimalRadius,
+    const Scalar & maximalRadius);
+
+public:
+  bool draw(const double & modelDeviationError);
+
+  size_t countInliers(const double & modelDeviationError);
+
+  void refine();
+
+public:
+  const VectorType & getCenter() const;
+
+  const Scalar & getRadius() const;
+
+  Parameters getParameters() const;
+
+  Circle getCircle() const;
+
+private:
+  Scalar computeSquareError_(
+    const VectorType & center,
+    const Scalar & radius,
+    const size_t & pointIndex) const;
+
+private:
+  Scalar minimalRadius_;
+  Scalar maximalRadius_;
+
+  VectorType center_;
+  Scalar radius_;
+  VectorType bestCenter_;
+  Scalar bestRadius_;
+
+  LeastSquares<Scalar> leastSquares_;
+
+public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW_IF_VECTORIZABLE_FIXED_SIZE(Scalar, 2)
+};
+
+}  // namespace core
+}  // namespace romea
+
+#endif  // ROMEA_CORE_COMMON__GEOMETRY__ESTIMATION__RANSACCIRCLEMODEL_HPP_
@@ -0,0 +1,96 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef ROMEA_CORE_COMMON__GEOMETRY__ESTIMATION__RANSACPRIMITIVEMODEL_HPP_
+#define ROMEA_CORE_COMMON__GEOMETRY__ESTIMATION__RANSACPRIMITIVEMODEL_HPP_
+
+// std
+#include <vector>
+#include <cstdint>
+
+// romea
+#include "romea_core_common/math/RandomGenerator.hpp"
+#include "romea_core_common/pointset/PointSet.hpp"
+#include "romea_core_common/pointset/PointTraits.hpp"
+
+namespace romea
+{
+namespace core
+{
+
+// Common part of ransac models fitting a geometric primitive to a point set.
+// Derived models provide draw, countInliers and refine.
+template<class PointType>
+class RansacPrimitiveModel
+{
+public:
+  using Scalar = typename PointType::Scalar;
+  static constexpr size_t CARTESIAN_DIM = PointTraits<PointType>::DIM;
+  static constexpr size_t POINT_SIZE = PointTraits<PointType>::SIZE;
+
+  using VectorType = Eigen::Matrix<Scalar, CARTESIAN_DIM, 1>;
+  using PointSetType = PointSet<PointType>;
+
+public:
+  explicit RansacPrimitiveModel(const size_t & numberOfPointsToDrawModel);
+
+  void loadPointSet(const PointSet<PointType> * points);
+
+  void setMinimalNumberOfInliers(const size_t & minimalNumberOfInliers);
+
+  void setSeed(const std::uint64_t & seed);
+
+public:
+  size_t getNumberOfPoints() const;
+
+  size_t getNumberOfPointsToDrawModel() const;
+
+  size_t getMinimalNumberOfInliers() const;
+
+  double getRootMeanSquareError() const;
+
+  const std::vector<size_t> & getInliers() const;
+
+protected:
+  void drawSample_();
+
+  VectorType getPoint_(const size_t & pointIndex) const;
+
+  VectorType computeInliersMean_() const;
+
+  bool backupInliers_(const double & sumOfSquareErrors);
+
+protected:
+  // Gauss-Newton refinement of the best model on its inliers
+  static constexpr size_t REFINEMENT_MAXIMAL_NUMBER_OF_ITERATIONS = 10;
+  static constexpr double REFINEMENT_EPSILON = 1e-6;
+
+  const PointSet<PointType> * points_;
+
+  size_t numberOfPointsToDrawModel_;
+  size_t minimalNumberOfInliers_;
+
+  std::vector<size_t> sampleIndexes_;
+  std::vector<size_t> inliers_;
+  std::vector<size_t> bestInliers_;
+  double bestRootMeanSquareError_;
+
+  RandomGenerator randomGenerator_;
+};
+
+}  // namespace core
+}  // namespace romea
+
+#endif  // ROMEA_CORE_COMMON__GEOMETRY__ESTIMATION__RANSACPRIMITIVEMODEL_HPP_
@@ -0,0 +1,196 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef ROMEA_CORE_COMMON__GEOMETRY__ESTIMATION__RANSACSEQUENTIALEXTRACTION_HPP_
+#define ROMEA_CORE_COMMON__GEOMETRY__ESTIMATION__RANSACSEQUENTIALEXTRACTION_HPP_
+
+// Eigen
+#include <Eigen/StdVector>
+
+// std
+#include <vector>
+#include <limits>
+#include <numeric>
+
+// romea
+#include "romea_core_common/regression/ransac/Ransac.hpp"
+
+namespace romea
+{
+namespace core
+{
+
+// Extract several primitives from a point set : each time a model is found
+// its inliers are removed from the point set before the next ransac pass.
+template<class Model>
+class RansacSequentialExtraction
+{
+public:
+  using PointSetType = typename Model::PointSetType;
+  using Parameters = typename Model::Parameters;
+
+  struct Primitive
+  {
+    Parameters parameters;
+    std::vector<size_t> inliers;
+    double rootMeanSquareError;
+
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+  };
+
+  using Primitives = std::vector<Primitive, Eigen::aligned_allocator<Primitive>>;
+
+public:
+  explicit RansacSequentialExtraction(const double & modelErrorDeviation);
+
+  RansacSequentialExtraction(const RansacSequentialExtraction &) = delete;
+
+  RansacSequentialExtraction & operator=(const RansacSequentialExtraction &) = delete;
+
+  void setMaximalNumberOfPrimitives(const size_t & maximalNumberOfPrimitives);
+
+  Model & getModel();
+
+  Ransac<Model> & getRansac();
+
+  const Primitives & extract(const PointSetType & points);
+
+  const Primitives & getPrimitives() const;
+
+  const std::vector<size_t> & getRemainingPointIndexes() const;
+
+private:
+  void removeInliers_(const std::vector<size_t> & inliers);
+
+private:
+  size_t maximalNumberOfPrimitives_;
+
+  Model model_;
+  Ransac<Model> ransac_;
+
+  PointSetType remainingPoints_;
+  std::vector<size_t> remainingPointIndexes_;
+  Primitives primitives_;
+};
+
+//-----------------------------------------------------------------------------
+template<class Model>
+RansacSequentialExtraction<Model>::RansacSequentialExtraction(
+  const double & modelErrorDeviation)
+: maximalNumberOfPrimitives_(std::numeric_limits<size_t>::max()),
+  model_(),
+  ransac_(&model_, modelErrorDeviation),
+  remainingPoints_(),
+  remainingPointIndexes_(),
+  primitives_()
+{
+}
+
+//-----------------------------------------------------------------------------
+template<class Model>
+void RansacSequentialExtraction<Model>::setMaximalNumberOfPrimitives(
+  const size_t & maximalNumberOfPrimitives)
+{
+  maximalNumberOfPrimitives_ = maximalNumberOfPrimitives;
+}
+
+//-----------------------------------------------------------------------------
+template<class Model>
+Model & RansacSequentialExtraction<Model>::getModel()
+{
+  return model_;
+}
+
+//-----------------------------------------------------------------------------
+template<class Model>
+Ransac<Model> & RansacSequentialExtraction<Model>::getRansac()
+{
+  return ransac_;
+}
+
+//-----------------------------------------------------------------------------
+template<class Model>
+const typename RansacSequentialExtraction<Model>::Primitives &
+RansacSequentialExtraction<Model>::extract(const PointSetType & points)
+{
+  remainingPoints_ = points;
+  remainingPointIndexes_.resize(points.size());
+  std::iota(std::begin(remainingPointIndexes_), std::end(remainingPointIndexes_), 0);
+  primitives_.clear();
+
+  while (primitives_.size() < maximalNumberOfPrimitives_) {
+    model_.loadPointSet(&remainingPoints_);
+    if (!ransac_.estimateModel()) {
+      break;
+    }
+
+    // Inliers are given as indexes of the input point set
+    const std::vector<size_t> & inliers = model_.getInliers();
+    Primitive primitive;
+    primitive.parameters = model_.getParameters();
+    primitive.rootMeanSquareError = model_.getRootMeanSquareError();
+    primitive.inliers.reserve(inliers.size());
+    for (const size_t & index : inliers) {
+      primitive.inliers.push_back(remainingPointIndexes_[index]);
+    }
+    primitives_.push_back(std::move(primitive));
+
+    removeInliers_(inliers);
+  }
+
+  return primitives_;
+}
+
+//-----------------------------------------------------------------------------
+template<class Model>
+void RansacSequentialExtraction<Model>::removeInliers_(const std::vector<size_t> & inliers)
+{
+  // Inliers are sorted, remaining points are compacted in place
+  size_t inlierRank = 0;
+  size_t numberOfRemainingPoints = 0;
+  for (size_t n = 0, N = remainingPoints_.size(); n < N; ++n) {
+    if (inlierRank < inliers.size() && inliers[inlierRank] == n) {
+      ++inlierRank;
+    } else {
+      remainingPoints_[numberOfRemainingPoints] = remainingPoints_[n];
+      remainingPointIndexes_[numberOfRemainingPoints] = remainingPointIndexes_[n];
+      ++numberOfRemainingPoints;
+    }
+  }
+
+  remainingPoints_.resize(numberOfRemainingPoints);
+  remainingPointIndexes_.resize(numberOfRemainingPoints);
+}
+
+//-----------------------------------------------------------------------------
+template<class Model>
+const typename RansacSequentialExtraction<Model>::Primitives &
+RansacSequentialExtraction<Model>::getPrimitives() const
+{
+  return primitives_;
+}
+
+//-----------------------------------------------------------------------------
+template<class Model>
+const std::vector<size_t> &
+RansacSequentialExtraction<Model>::getRemainingPointIndexes() const
+{
+  return remainingPointIndexes_;
+}
+
+}  // namespace core
+}  // namespace romea
+
+#endif  // ROMEA_CORE_COMMON__GEOMETRY__ESTIMATION__RANSACSEQUENTIALEXTRACTION_HPP_
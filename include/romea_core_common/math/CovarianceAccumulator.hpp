@@ -0,0 +1,290 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef ROMEA_CORE_COMMON__MATH__COVARIANCEACCUMULATOR_HPP_
+#define ROMEA_CORE_COMMON__MATH__COVARIANCEACCUMULATOR_HPP_
+
+// Eigen
+#include <Eigen/Core>
+
+namespace romea
+{
+namespace core
+{
+
+// Single pass weighted mean and cross covariance of two paired samples x and y
+// updated with West's incremental algorithm (weighted Welford). Compared to the
+// sum of products formula it does not suffer from cancellation when samples are
+// far from origin. Accumulators computed on disjoint samples can be merged.
+template<typename Scalar, int Dim>
+class CrossCovarianceAccumulator
+{
+public:
+  using Vector = Eigen::Matrix<Scalar, Dim, 1>;
+  using Matrix = Eigen::Matrix<Scalar, Dim, Dim>;
+
+public:
+  CrossCovarianceAccumulator();
+
+  void reset();
+
+  template<typename DerivedX, typename DerivedY>
+  void add(
+    const Eigen::MatrixBase<DerivedX> & x,
+    const Eigen::MatrixBase<DerivedY> & y,
+    const Scalar & weight = 1);
+
+  void merge(const CrossCovarianceAccumulator & other);
+
+  const Scalar & getWeightSum() const;
+
+  const Vector & getFirstMean() const;
+
+  const Vector & getSecondMean() const;
+
+  // Sum of weighted products of deviations, i.e. unnormalized cross covariance
+  const Matrix & getCoMoment() const;
+
+  Matrix getCrossCovariance() const;
+
+private:
+  Scalar weightSum_;
+  Vector meanX_;
+  Vector meanY_;
+  Matrix coMoment_;
+
+public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW_IF_VECTORIZABLE_FIXED_SIZE(Scalar, Dim)
+};
+
+// Single pass weighted mean and covariance of one sample
+template<typename Scalar, int Dim>
+class CovarianceAccumulator
+{
+public:
+  using Vector = Eigen::Matrix<Scalar, Dim, 1>;
+  using Matrix = Eigen::Matrix<Scalar, Dim, Dim>;
+
+public:
+  CovarianceAccumulator();
+
+  void reset();
+
+  template<typename Derived>
+  void add(const Eigen::MatrixBase<Derived> & x, const Scalar & weight = 1);
+
+  void merge(const CovarianceAccumulator & other);
+
+  const Scalar & getWeightSum() const;
+
+  const Vector & getMean() const;
+
+  const Matrix & getCoMoment() const;
+
+  Matrix getCovariance() const;
+
+private:
+  Scalar weightSum_;
+  Vector mean_;
+  Matrix coMoment_;
+
+public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW_IF_VECTORIZABLE_FIXED_SIZE(Scalar, Dim)
+};
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, int Dim>
+CrossCovarianceAccumulator<Scalar, Dim>::CrossCovarianceAccumulator()
+: weightSum_(0),
+  meanX_(Vector::Zero()),
+  meanY_(Vector::Zero()),
+  coMoment_(Matrix::Zero())
+{
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, int Dim>
+void CrossCovarianceAccumulator<Scalar, Dim>::reset()
+{
+  weightSum_ = 0;
+  meanX_.setZero();
+  meanY_.setZero();
+  coMoment_.setZero();
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, int Dim>
+template<typename DerivedX, typename DerivedY>
+void CrossCovarianceAccumulator<Scalar, Dim>::add(
+  const Eigen::MatrixBase<DerivedX> & x,
+  const Eigen::MatrixBase<DerivedY> & y,
+  const Scalar & weight)
+{
+  if (weight == 0) {
+    return;
+  }
+
+  weightSum_ += weight;
+  const Scalar ratio = weight / weightSum_;
+  const Vector deviationX = x - meanX_;
+  meanX_ += ratio * deviationX;
+  meanY_ += ratio * (y - meanY_);
+  coMoment_.noalias() += (weight * deviationX) * (y - meanY_).transpose();
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, int Dim>
+void CrossCovarianceAccumulator<Scalar, Dim>::merge(const CrossCovarianceAccumulator & other)
+{
+  if (other.weightSum_ == 0) {
+    return;
+  }
+
+  // Chan et al. pairwise update
+  const Scalar weightSum = weightSum_ + other.weightSum_;
+  const Vector deltaX = other.meanX_ - meanX_;
+  const Vector deltaY = other.meanY_ - meanY_;
+  coMoment_ += other.coMoment_ + (weightSum_ * other.weightSum_ / weightSum) * deltaX *
+    deltaY.transpose();
+  meanX_ += (other.weightSum_ / weightSum) * deltaX;
+  meanY_ += (other.weightSum_ / weightSum) * deltaY;
+  weightSum_ = weightSum;
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, int Dim>
+const Scalar & CrossCovarianceAccumulator<Scalar, Dim>::getWeightSum() const
+{
+  return weightSum_;
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, int Dim>
+const typename CrossCovarianceAccumulator<Scalar, Dim>::Vector &
+CrossCovarianceAccumulator<Scalar, Dim>::getFirstMean() const
+{
+  return meanX_;
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, int Dim>
+const typename CrossCovarianceAccumulator<Scalar, Dim>::Vector &
+CrossCovarianceAccumulator<Scalar, Dim>::getSecondMean() const
+{
+  return meanY_;
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, int Dim>
+const typename CrossCovarianceAccumulator<Scalar, Dim>::Matrix &
+CrossCovarianceAccumulator<Scalar, Dim>::getCoMoment() const
+{
+  return coMoment_;
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, int Dim>
+typename CrossCovarianceAccumulator<Scalar, Dim>::Matrix
+CrossCovarianceAccumulator<Scalar, Dim>::getCrossCovariance() const
+{
+  return coMoment_ / weightSum_;
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, int Dim>
+CovarianceAccumulator<Scalar, Dim>::CovarianceAccumulator()
+: weightSum_(0),
+  mean_(Vector::Zero()),
+  coMoment_(Matrix::Zero())
+{
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, int Dim>
+void CovarianceAccumulator<Scalar, Dim>::reset()
+{
+  weightSum_ = 0;
+  mean_.setZero();
+  coMoment_.setZero();
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, int Dim>
+template<typename Derived>
+void CovarianceAccumulator<Scalar, Dim>::add(
+  const Eigen::MatrixBase<Derived> & x,
+  const Scalar & weight)
+{
+  if (weight == 0) {
+    return;
+  }
+
+  weightSum_ += weight;
+  const Vector deviation = x - mean_;
+  mean_ += (weight / weightSum_) * deviation;
+  coMoment_.noalias() += (weight * deviation) * (x - mean_).transpose();
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, int Dim>
+void CovarianceAccumulator<Scalar, Dim>::merge(const CovarianceAccumulator & other)
+{
+  if (other.weightSum_ == 0) {
+    return;
+  }
+
+  const Scalar weightSum = weightSum_ + other.weightSum_;
+  const Vector delta = other.mean_ - mean_;
+  coMoment_ += other.coMoment_ + (weightSum_ * other.weightSum_ / weightSum) * delta *
+    delta.transpose();
+  mean_ += (other.weightSum_ / weightSum) * delta;
+  weightSum_ = weightSum;
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, int Dim>
+const Scalar & CovarianceAccumulator<Scalar, Dim>::getWeightSum() const
+{
+  return weightSum_;
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, int Dim>
+const typename CovarianceAccumulator<Scalar, Dim>::Vector &
+CovarianceAccumulator<Scalar, Dim>::getMean() const
+{
+  return mean_;
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, int Dim>
+const typename CovarianceAccumulator<Scalar, Dim>::Matrix &
+CovarianceAccumulator<Scalar, Dim>::getCoMoment() const
+{
+  return coMoment_;
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, int Dim>
+typename CovarianceAccumulator<Scalar, Dim>::Matrix
+CovarianceAccumulator<Scalar, Dim>::getCovariance() const
+{
+  return coMoment_ / weightSum_;
+}
+
+}  // namespace core
+}  // namespace romea
+
+#endif  // ROMEA_CORE_COMMON__MATH__COVARIANCEACCUMULATOR_HPP_
@@ -24,10 +24,12 @@
 // std
 #include <utility>
 #include <limits>
-#include <random>
 #include <cassert>
-#include <iostream>
+#include <cstdint>
+#include <type_traits>
 
+// romea
+#include "romea_core_common/math/RandomGenerator.hpp"
 
 namespace romea
 {
@@ -35,7 +37,7 @@ namespace core
 {
 
 template<typename Scalar, size_t DIM, template<class> class ContainerBase = Eigen::MatrixBase,
-  class PRNG = std::mt19937>
+  class PRNG = RandomGenerator>
 class NormalRandomMatrixGenerator
 {
 public:
@@ -44,15 +46,20 @@ public:
   using TransformMatrix = Eigen::Matrix<Scalar, DIM, DIM>;
 
 public:
-  NormalRandomMatrixGenerator()
-  :// engine_(std::random_device{}()),
-    engine_(0),
+  explicit NormalRandomMatrixGenerator(const std::uint64_t & seed = RandomGenerator::DEFAULT_SEED)
+  : engine_(seed),
     mean_(MeanVector::Zero()),
     covariance_(CovarianceMatrix::Zero()),
-    transform_(TransformMatrix::Zero())
+    transform_(TransformMatrix::Zero()),
+    normals_()
   {
   }
 
+  void seed(const std::uint64_t & seed)
+  {
+    engine_.seed(seed);
+  }
+
   void init(const MeanVector & mean, const CovarianceMatrix & covariance)
   {
     mean_ = mean;
@@ -60,32 +67,19 @@ public:
     transform_ = covariance.llt().matrixL();
   }
 
-
   template<class Derived>
   void fill(ContainerBase<Derived> & container)
   {
-    std::normal_distribution<Scalar> distribution(0, 1);
-    //    container.unaryExpr([&](double /*dummy*/){return distribution(engine_);});
+    assert(container.rows() == int(DIM));
 
-    for (int i = 0; i < int(DIM); ++i) {
-      for (int j = 0; j < container.cols(); ++j) {
-        container(i, j) = distribution(engine_);
-      }
-    }
+    normals_.resize(DIM, container.cols());
+    generateStandardNormals(engine_, normals_.data(), size_t(normals_.size()));
+    normals_ = (transform_.template triangularView<Eigen::Lower>() * normals_).colwise() + mean_;
 
-    // TODO(Jean) using constexpr if with c++17
-    //    if(Eigen::internal::traits<Derived>::Options== Eigen::ColMajor)
-    //    {
-    //      container.matrix() = (transform_*container.matrix()).colwise()+mean_;
-    //    }
-    //    else
-    //    {
-
-    for (int i = DIM - 1; i >= 0; --i) {
-      container.row(i) = transform_(i, i) * container.row(i) + mean_(i);
-      for (int j = i - 1; j >= 0; --j) {
-        container.row(i) += transform_(i, j) * container.row(j);
-      }
+    if constexpr (std::is_base_of<Eigen::ArrayBase<Derived>, Derived>::value) {
+      container = normals_.array();
+    } else {
+      container = normals_;
     }
   }
 
@@ -95,6 +89,7 @@ private:
   CovarianceMatrix covariance_;
 
   TransformMatrix transform_;
+  Eigen::Matrix<Scalar, DIM, Eigen::Dynamic> normals_;
 };
 
 
@@ -102,13 +97,19 @@ template<typename Scalar, template<class> class ContainerBase, class PRNG>
 class NormalRandomMatrixGenerator<Scalar, 1, ContainerBase, PRNG>
 {
 public:
-  NormalRandomMatrixGenerator()
-  : engine_(std::random_device{}()),
+  explicit NormalRandomMatrixGenerator(const std::uint64_t & seed = RandomGenerator::DEFAULT_SEED)
+  : engine_(seed),
     mean_(0),
-    std_(0)
+    std_(0),
+    normals_()
   {
   }
 
+  void seed(const std::uint64_t & seed)
+  {
+    engine_.seed(seed);
+  }
+
   void init(const Scalar & mean, const Scalar & std)
   {
     mean_ = mean;
@@ -116,16 +117,24 @@ public:
   }
 
   template<class Derived>
-  void fill(ContainerBase<Derived> & matrix)
+  void fill(ContainerBase<Derived> & container)
   {
-    std::normal_distribution<double> distribution(mean_, std_);
-    matrix.unaryExpr([&](double /*dummy*/) {return distribution(engine_);});
+    normals_.resize(container.rows(), container.cols());
+    generateStandardNormals(engine_, normals_.data(), size_t(normals_.size()));
+    normals_ = normals_ * std_ + mean_;
+
+    if constexpr (std::is_base_of<Eigen::ArrayBase<Derived>, Derived>::value) {
+      container = normals_;
+    } else {
+      container = normals_.matrix();
+    }
   }
 
 private:
   PRNG engine_;
   Scalar mean_;
   Scalar std_;
+  Eigen::Array<Scalar, Eigen::Dynamic, Eigen::Dynamic> normals_;
 };
 
 template<typename Scalar>
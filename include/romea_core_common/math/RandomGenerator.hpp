@@ -0,0 +1,236 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef ROMEA_CORE_COMMON__MATH__RANDOMGENERATOR_HPP_
+#define ROMEA_CORE_COMMON__MATH__RANDOMGENERATOR_HPP_
+
+// Eigen
+#include <Eigen/Core>
+
+// std
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <algorithm>
+#include <type_traits>
+
+namespace romea
+{
+namespace core
+{
+
+// xoshiro256++ pseudo random generator (D. Blackman and S. Vigna).
+// It satisfies UniformRandomBitGenerator requirements so it can be used
+// with std distributions. Its state is always initialized from an explicit
+// seed, default seed is 0, so two generators built with the same seed draw
+// the same sequence. Parallel workers must not share a generator, they should
+// use non overlapping streams obtained by jump() or makeRandomStream.
+class RandomGenerator
+{
+public:
+  using result_type = std::uint64_t;
+
+  static constexpr std::uint64_t DEFAULT_SEED = 0;
+
+public:
+  explicit RandomGenerator(const std::uint64_t & seed = DEFAULT_SEED);
+
+  void seed(const std::uint64_t & seed);
+
+  result_type operator()();
+
+  static constexpr result_type min() {return 0;}
+
+  static constexpr result_type max() {return std::numeric_limits<result_type>::max();}
+
+  // Advance the generator by 2^128 draws
+  void jump();
+
+  // Return a generator starting at the current state and jump this one
+  // in order to get two non overlapping streams
+  RandomGenerator split();
+
+private:
+  static std::uint64_t rotl_(const std::uint64_t & x, const int & k);
+
+private:
+  std::array<std::uint64_t, 4> state_;
+};
+
+// Stream streamIndex of seed: generator seeded by seed and jumped streamIndex times
+RandomGenerator makeRandomStream(const std::uint64_t & seed, const size_t & streamIndex);
+
+// Generator owned by calling thread. Each thread gets its own stream of the
+// default seed, stream index being given by the order of first use, so drawn
+// sequences are not reproducible between runs when several threads use it.
+// Reproducible parallel draws must use makeRandomStream(seed, threadIndex).
+RandomGenerator & threadLocalRandomGenerator();
+
+// Uniform real in [0,1)
+template<typename Scalar, class Generator>
+Scalar generateUniform(Generator & generator);
+
+// Fill data with standard normal values using Box-Muller transform
+// evaluated by blocks in order to be vectorized by Eigen
+template<typename Scalar, class Generator>
+void generateStandardNormals(Generator & generator, Scalar * data, const size_t & size);
+
+//-----------------------------------------------------------------------------
+inline RandomGenerator::RandomGenerator(const std::uint64_t & seed)
+: state_()
+{
+  this->seed(seed);
+}
+
+//-----------------------------------------------------------------------------
+inline void RandomGenerator::seed(const std::uint64_t & seed)
+{
+  // State is expanded from seed with splitmix64 as advised by xoshiro authors
+  std::uint64_t x = seed;
+  for (std::uint64_t & s : state_) {
+    std::uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    s = z ^ (z >> 31);
+  }
+}
+
+//-----------------------------------------------------------------------------
+inline std::uint64_t RandomGenerator::rotl_(const std::uint64_t & x, const int & k)
+{
+  return (x << k) | (x >> (64 - k));
+}
+
+//-----------------------------------------------------------------------------
+inline RandomGenerator::result_type RandomGenerator::operator()()
+{
+  const std::uint64_t result = rotl_(state_[0] + state_[3], 23) + state_[0];
+  const std::uint64_t t = state_[1] << 17;
+
+  state_[2] ^= state_[0];
+  state_[3] ^= state_[1];
+  state_[1] ^= state_[2];
+  state_[0] ^= state_[3];
+  state_[2] ^= t;
+  state_[3] = rotl_(state_[3], 45);
+
+  return result;
+}
+
+//-----------------------------------------------------------------------------
+inline void RandomGenerator::jump()
+{
+  static constexpr std::uint64_t JUMP[] = {
+    0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+    0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL};
+
+  std::array<std::uint64_t, 4> jumpedState = {0, 0, 0, 0};
+  for (const std::uint64_t & jump : JUMP) {
+    for (int b = 0; b < 64; ++b) {
+      if (jump & (std::uint64_t(1) << b)) {
+        for (size_t i = 0; i < 4; ++i) {
+          jumpedState[i] ^= state_[i];
+        }
+      }
+      (*this)();
+    }
+  }
+  state_ = jumpedState;
+}
+
+//-----------------------------------------------------------------------------
+inline RandomGenerator RandomGenerator::split()
+{
+  RandomGenerator stream(*this);
+  jump();
+  return stream;
+}
+
+//-----------------------------------------------------------------------------
+inline RandomGenerator makeRandomStream(
+  const std::uint64_t & seed,
+  const size_t & streamIndex)
+{
+  RandomGenerator generator(seed);
+  for (size_t n = 0; n < streamIndex; ++n) {
+    generator.jump();
+  }
+  return generator;
+}
+
+//-----------------------------------------------------------------------------
+inline RandomGenerator & threadLocalRandomGenerator()
+{
+  static std::atomic<size_t> numberOfStreams(0);
+  thread_local RandomGenerator generator =
+    makeRandomStream(RandomGenerator::DEFAULT_SEED, numberOfStreams++);
+  return generator;
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, class Generator>
+Scalar generateUniform(Generator & generator)
+{
+  static_assert(std::is_floating_point<Scalar>::value, "Scalar must be a floating point type");
+
+  if constexpr (Generator::min() == 0 &&
+    Generator::max() == std::numeric_limits<std::uint64_t>::max())
+  {
+    // Keep the upper bits, they are the best ones for xoshiro generators
+    constexpr int DIGITS = std::numeric_limits<Scalar>::digits;
+    return Scalar(generator() >> (64 - DIGITS)) * (Scalar(1) / Scalar(std::uint64_t(1) << DIGITS));
+  } else {
+    return std::generate_canonical<Scalar, std::numeric_limits<Scalar>::digits>(generator);
+  }
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, class Generator>
+void generateStandardNormals(Generator & generator, Scalar * data, const size_t & size)
+{
+  constexpr int BLOCK_SIZE = 64;
+  constexpr double PI = 3.14159265358979323846;
+  using Block = Eigen::Array<Scalar, BLOCK_SIZE, 1>;
+
+  Block u1, u2, radius;
+  size_t n = 0;
+  while (n < size) {
+    for (int i = 0; i < BLOCK_SIZE; ++i) {
+      // u1 in (0,1] to avoid log(0)
+      u1[i] = Scalar(1) - generateUniform<Scalar>(generator);
+      u2[i] = generateUniform<Scalar>(generator);
+    }
+
+    radius = (Scalar(-2) * u1.log()).sqrt();
+    u2 *= Scalar(2 * PI);
+
+    // Each block of uniforms gives 2*BLOCK_SIZE normals
+    auto store = [&](const Block & normals) {
+        const size_t length = std::min(size - n, size_t(BLOCK_SIZE));
+        std::copy(normals.data(), normals.data() + length, data + n);
+        n += length;
+      };
+    store(radius * u2.cos());
+    store(radius * u2.sin());
+  }
+}
+
+}  // namespace core
+}  // namespace romea
+
+#endif  // ROMEA_CORE_COMMON__MATH__RANDOMGENERATOR_HPP_
@@ -0,0 +1,97 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+#ifndef ROMEA_CORE_COMMON__MATH__TRIGONOMETRY_HPP_
+#define ROMEA_CORE_COMMON__MATH__TRIGONOMETRY_HPP_
+
+// Eigen
+#include <Eigen/Core>
+
+// std
+#include <type_traits>
+
+namespace romea
+{
+namespace core
+{
+
+// Sine and cosine of each element of x computed without any per element
+// branch, so Eigen vectorizes them, which is not the case of std::sin and
+// std::cos for doubles. The argument is reduced to [-pi/4,pi/4] by the
+// nearest multiple of pi/2 (Cody-Waite), Cephes polynomials are evaluated on
+// the remainder and permuted according to the quadrant by arithmetic.
+// Results are within a few ulps for |x| < 1e5. It must not be compiled with
+// -ffast-math which would break the rounding trick. Intermediate arrays have
+// the type of sines, use fixed maximal size blocks to avoid allocations.
+template<typename Derived, typename SinDerived, typename CosDerived>
+void sincos(
+  const Eigen::ArrayBase<Derived> & x,
+  Eigen::ArrayBase<SinDerived> & sines,
+  Eigen::ArrayBase<CosDerived> & cosines);
+
+//-----------------------------------------------------------------------------
+template<typename Derived, typename SinDerived, typename CosDerived>
+void sincos(
+  const Eigen::ArrayBase<Derived> & x,
+  Eigen::ArrayBase<SinDerived> & sines,
+  Eigen::ArrayBase<CosDerived> & cosines)
+{
+  using Scalar = typename Derived::Scalar;
+  using ArrayType = typename SinDerived::PlainObject;
+  static_assert(std::is_same<Scalar, double>::value, "sincos is only implemented for doubles");
+
+  constexpr double TWO_OVER_PI = 6.36619772367581382433e-01;
+
+  // pi/2 split in 33 bits and remaining ones, so k * PI_2_HIGH is exact
+  constexpr double PI_2_HIGH = 1.57079632673412561417e+00;
+  constexpr double PI_2_LOW = 6.07710050650619224932e-11;
+
+  // Adding and subtracting 1.5 * 2^52 rounds to nearest integer, which only
+  // takes two vectorized additions whatever the instruction set
+  static constexpr double ROUNDING = 6755399441055744.0;
+  auto round = [](const ArrayType & a) {return ((a + ROUNDING) - ROUNDING).eval();};
+
+  const ArrayType k = round(x * TWO_OVER_PI);
+  const ArrayType r = (x - k * PI_2_HIGH) - k * PI_2_LOW;
+  const ArrayType z = r * r;
+
+  const ArrayType sinR = r + r * z * (((((1.58962301576546568060e-10 * z -
+    2.50507477628578072866e-8) * z + 2.75573136213857245213e-6) * z -
+    1.98412698295895385996e-4) * z + 8.33333333332211858878e-3) * z -
+    1.66666666666666307295e-1);
+
+  const ArrayType cosR = 1 - 0.5 * z + z * z * (((((-1.13585365213876817300e-11 * z +
+    2.08757008419747316778e-9) * z - 2.75573141792967388112e-7) * z +
+    2.48015872888517045348e-5) * z - 1.38888888888730564116e-3) * z +
+    4.16666666666665929218e-2);
+
+  // sin(r + j * pi/2) is sinR, cosR, -sinR, -cosR for j = 0, 1, 2, 3 modulo 4
+  // and cos(r + j * pi/2) is sin(r + (j + 1) * pi/2). For an integer j,
+  // floor(j/2) is the rounding of j/2 - 1/4 which is never a tie. Values are
+  // selected by multiplications by 0 or 1 which are exact.
+  const ArrayType h = round(k * 0.5 - 0.25);
+  const ArrayType odd = k - 2 * h;
+  const ArrayType sinSign = 1 - 2 * (h - 2 * round(h * 0.5 - 0.25));
+  const ArrayType cosSign = 1 - 2 * (h + odd - 2 * round((h + odd) * 0.5 - 0.25));
+
+  sines.derived() = sinSign * (sinR * (1 - odd) + cosR * odd);
+  cosines.derived() = cosSign * (cosR * (1 - odd) + sinR * odd);
+}
+
+}  // namespace core
+}  // namespace romea
+
+#endif  // ROMEA_CORE_COMMON__MATH__TRIGONOMETRY_HPP_
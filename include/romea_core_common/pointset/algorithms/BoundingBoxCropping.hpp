@@ -0,0 +1,126 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+#ifndef ROMEA_CORE_COMMON__POINTSET__ALGORITHMS__BOUNDINGBOXCROPPING_HPP_
+#define ROMEA_CORE_COMMON__POINTSET__ALGORITHMS__BOUNDINGBOXCROPPING_HPP_
+
+// Eigen
+#include <Eigen/StdVector>
+
+// std
+#include <cstdint>
+#include <vector>
+
+// romea
+#include "romea_core_common/containers/boundingbox/AxisAlignedBoundingBox.hpp"
+#include "romea_core_common/containers/boundingbox/OrientedBoundingBox.hpp"
+#include "romea_core_common/pointset/PointSet.hpp"
+#include "romea_core_common/pointset/PointTraits.hpp"
+
+namespace romea
+{
+namespace core
+{
+
+// Crop a point set to the union of axis aligned and oriented boxes (or to
+// its complement in negative mode). Boxes are stored with their inverse
+// rotation and points are tested by blocks: block coordinates are copied in
+// contiguous arrays, then for each box the largest overflow of point local
+// coordinates beyond box half width extents is evaluated with Eigen arrays.
+// A point is inside the union when its smallest overflow among boxes is not
+// positive, which gives the same answer as AxisAlignedBoundingBox::isInside
+// and OrientedBoundingBox::isInside without a virtual call per point.
+template<class PointType>
+class BoundingBoxCropping
+{
+public:
+  using Scalar = typename PointType::Scalar;
+  static constexpr size_t CARTESIAN_DIM = PointTraits<PointType>::DIM;
+  static constexpr size_t POINT_SIZE = PointTraits<PointType>::SIZE;
+
+  using PointSetType = PointSet<PointType>;
+  using AABBType = AxisAlignedBoundingBox<Scalar, CARTESIAN_DIM>;
+  using OBBType = OrientedBoundingBox<Scalar, CARTESIAN_DIM>;
+
+public:
+  BoundingBoxCropping();
+
+  void addBox(const AABBType & box);
+
+  void addBox(const OBBType & box);
+
+  void clearBoxes();
+
+  size_t getNumberOfBoxes() const;
+
+  // In negative mode points inside boxes are removed instead of being kept
+  void setNegative(const bool & negative);
+
+  void setMaximalNumberOfThreads(const size_t & maximalNumberOfThreads);
+
+public:
+  // Mask value is 1 for kept points and 0 for removed ones
+  void computeMask(
+    const PointSetType & points,
+    std::vector<std::uint8_t> & mask) const;
+
+  void computeKeptPointIndexes(
+    const PointSetType & points,
+    std::vector<size_t> & keptPointIndexes);
+
+  void crop(
+    const PointSetType & points,
+    PointSetType & croppedPoints);
+
+  // Kept points are compacted in place, their order is preserved
+  void crop(PointSetType & points);
+
+private:
+  static constexpr int BLOCK_SIZE = 256;
+  static constexpr size_t MINIMAL_NUMBER_OF_POINTS_PER_THREAD = 8 * BLOCK_SIZE;
+
+  using Block = Eigen::Array<Scalar, BLOCK_SIZE, 1>;
+  using VectorType = Eigen::Matrix<Scalar, CARTESIAN_DIM, 1>;
+  using RotationType = Eigen::Matrix<Scalar, CARTESIAN_DIM, CARTESIAN_DIM>;
+
+  struct Box
+  {
+    VectorType centerPosition;
+    VectorType halfWidthExtents;
+    RotationType inverseRotation;
+    bool isAxisAligned;
+
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+  };
+
+  void computeBlockMask_(
+    const PointSetType & points,
+    const size_t & begin,
+    const size_t & end,
+    std::uint8_t * mask) const;
+
+private:
+  std::vector<Box, Eigen::aligned_allocator<Box>> boxes_;
+  bool negative_;
+  size_t maximalNumberOfThreads_;
+
+  std::vector<std::uint8_t> mask_;
+};
+
+}  // namespace core
+}  // namespace romea
+
+#endif  // ROMEA_CORE_COMMON__POINTSET__ALGORITHMS__BOUNDINGBOXCROPPING_HPP_
@@ -0,0 +1,96 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+#ifndef ROMEA_CORE_COMMON__POINTSET__ALGORITHMS__BOUNDINGBOXFITTING_HPP_
+#define ROMEA_CORE_COMMON__POINTSET__ALGORITHMS__BOUNDINGBOXFITTING_HPP_
+
+// Eigen
+#include <Eigen/StdVector>
+
+// std
+#include <vector>
+
+// romea
+#include "romea_core_common/containers/boundingbox/AxisAlignedBoundingBox.hpp"
+#include "romea_core_common/containers/boundingbox/OrientedBoundingBox.hpp"
+#include "romea_core_common/pointset/PointSet.hpp"
+#include "romea_core_common/pointset/PointTraits.hpp"
+
+namespace romea
+{
+namespace core
+{
+
+// Fit bounding boxes to point sets, typically clusters of a segmentation. Axis
+// aligned boxes are given by a min/max reduction over point coordinates
+// processed by blocks of several points, so Eigen vectorizes it whatever the
+// point size. In 2D the oriented box of minimal area is found by rotating
+// calipers over the convex hull (one of its sides lies on a hull edge). In 3D
+// principal axes give a first frame, then for each axis of the frame the box
+// is refined by fitting the minimal 2D rectangle of points projected on the
+// orthogonal plane, the smallest volume giving the next frame. Working buffers
+// are kept between calls so fitting many small clusters does not allocate
+// memory.
+template<class PointType>
+class BoundingBoxFitting
+{
+public:
+  using Scalar = typename PointType::Scalar;
+  static constexpr size_t CARTESIAN_DIM = PointTraits<PointType>::DIM;
+  static constexpr size_t POINT_SIZE = PointTraits<PointType>::SIZE;
+
+  using PointSetType = PointSet<PointType>;
+  using AABBType = AxisAlignedBoundingBox<Scalar, CARTESIAN_DIM>;
+  using OBBType = OrientedBoundingBox<Scalar, CARTESIAN_DIM>;
+
+public:
+  BoundingBoxFitting();
+
+  AABBType fitAxisAlignedBoundingBox(const PointSetType & points) const;
+
+  OBBType fitOrientedBoundingBox(const PointSetType & points);
+
+private:
+  static constexpr int NUMBER_OF_POINTS_PER_BLOCK = 16;
+  static constexpr int MAXIMAL_NUMBER_OF_REFINEMENT_PASSES = 8;
+  static constexpr Scalar REFINEMENT_TOLERANCE = Scalar(1e-4);
+
+  using Vector2 = Eigen::Matrix<Scalar, 2, 1>;
+  using VectorType = Eigen::Matrix<Scalar, CARTESIAN_DIM, 1>;
+  using RotationType = Eigen::Matrix<Scalar, CARTESIAN_DIM, CARTESIAN_DIM>;
+
+  struct Rectangle
+  {
+    Vector2 centerPosition;
+    Vector2 halfWidthExtents;
+    Eigen::Matrix<Scalar, 2, 2> rotation;
+  };
+
+  // Minimal area rectangle of planarPoints_, which are reordered
+  Rectangle fitRectangle_();
+
+  // Counterclockwise convex hull of planarPoints_ without collinear points
+  void computeConvexHull_();
+
+private:
+  std::vector<Vector2, Eigen::aligned_allocator<Vector2>> planarPoints_;
+  std::vector<Vector2, Eigen::aligned_allocator<Vector2>> convexHull_;
+};
+
+}  // namespace core
+}  // namespace romea
+
+#endif  // ROMEA_CORE_COMMON__POINTSET__ALGORITHMS__BOUNDINGBOXFITTING_HPP_
@@ -20,6 +20,7 @@
 #include <Eigen/Eigenvalues>
 
 // romea
+#include "romea_core_common/math/CovarianceAccumulator.hpp"
 #include "romea_core_common/pointset/PointSet.hpp"
 #include "romea_core_common/pointset/NormalSet.hpp"
 #include "romea_core_common/pointset/KdTree.hpp"
@@ -101,6 +102,7 @@ private:
   size_t numberOfNeighborPoints_;
   std::vector<size_t> neighborIndexes_;
   std::vector<Scalar> neighborSquareDistances_;
+  CovarianceAccumulator<Scalar, CARTESIAN_DIM> accumulator_;
   Eigen::SelfAdjointEigenSolver<EigenVectorsType> eigenSolver_;
   EigenValuesType eigenValues_;
   EigenVectorsType eigenVectors_;
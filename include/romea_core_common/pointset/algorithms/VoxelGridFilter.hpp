@@ -0,0 +1,135 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+#ifndef ROMEA_CORE_COMMON__POINTSET__ALGORITHMS__VOXELGRIDFILTER_HPP_
+#define ROMEA_CORE_COMMON__POINTSET__ALGORITHMS__VOXELGRIDFILTER_HPP_
+
+// std
+#include <cstdint>
+#include <vector>
+
+// romea
+#include "romea_core_common/containers/grid/GridIndexMapping.hpp"
+#include "romea_core_common/pointset/PointSet.hpp"
+#include "romea_core_common/pointset/PointTraits.hpp"
+
+namespace romea
+{
+namespace core
+{
+
+// Downsample a point set keeping one point per voxel. Voxels are the cells
+// of a GridIndexMapping covering the point set bounding box. Points are
+// sorted by linearized voxel index with a stable parallel radix sort, so
+// filtering is linear in the number of points and filtered points are
+// given in voxel index order whatever the number of threads.
+template<class PointType>
+class VoxelGridFilter
+{
+public:
+  using Scalar = typename PointType::Scalar;
+  static constexpr size_t CARTESIAN_DIM = PointTraits<PointType>::DIM;
+  static constexpr size_t POINT_SIZE = PointTraits<PointType>::SIZE;
+
+  using PointSetType = PointSet<PointType>;
+  using GridIndexMappingType = GridIndexMapping<Scalar, CARTESIAN_DIM>;
+
+  enum class Mode
+  {
+    CENTROID = 0,  // mean of voxel points
+    FIRST_POINT,  // voxel point of lowest index
+    CLOSEST_TO_CENTER  // voxel point closest to voxel center
+  };
+
+public:
+  explicit VoxelGridFilter(
+    const Scalar & voxelSize,
+    const Mode & mode = Mode::CENTROID);
+
+  void setVoxelSize(const Scalar & voxelSize);
+
+  const Scalar & getVoxelSize() const;
+
+  void setMode(const Mode & mode);
+
+  const Mode & getMode() const;
+
+  void setMaximalNumberOfThreads(const size_t & maximalNumberOfThreads);
+
+public:
+  void filter(
+    const PointSetType & points,
+    PointSetType & filteredPoints);
+
+  // Index in input point set of the point kept for each voxel, for
+  // centroid mode it is the index of the first point of the voxel
+  const std::vector<size_t> & getFilteredPointIndexes() const;
+
+  const GridIndexMappingType & getGridIndexMapping() const;
+
+private:
+  struct KeyIndex
+  {
+    std::uint64_t key;
+    size_t index;
+  };
+
+  static constexpr size_t MINIMAL_NUMBER_OF_POINTS_PER_THREAD = 4096;
+  static constexpr int RADIX_BITS = 8;
+  static constexpr size_t RADIX_SIZE = size_t(1) << RADIX_BITS;
+
+  void initGridIndexMapping_(const PointSetType & points);
+
+  void computeKeys_(const PointSetType & points);
+
+  void radixSort_();
+
+  void reduceVoxels_(
+    const PointSetType & points,
+    PointSetType & filteredPoints);
+
+  size_t reduceVoxel_(
+    const PointSetType & points,
+    const size_t & begin,
+    const size_t & end,
+    PointType & filteredPoint) const;
+
+  size_t findVoxelBegin_(const size_t & index) const;
+
+private:
+  Scalar voxelSize_;
+  Mode mode_;
+  size_t maximalNumberOfThreads_;
+  size_t numberOfThreads_;
+
+  GridIndexMappingType gridIndexMapping_;
+  Eigen::Matrix<std::uint64_t, CARTESIAN_DIM, 1> keyStrides_;
+  std::uint64_t maximalKey_;
+
+  std::vector<KeyIndex> keyIndexes_;
+  std::vector<KeyIndex> sortedKeyIndexes_;
+  std::vector<size_t> histograms_;
+  std::vector<size_t> threadNumberOfVoxels_;
+  std::vector<size_t> filteredPointIndexes_;
+
+public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW_IF_VECTORIZABLE_FIXED_SIZE(Scalar, CARTESIAN_DIM)
+};
+
+}  // namespace core
+}  // namespace romea
+
+#endif  // ROMEA_CORE_COMMON__POINTSET__ALGORITHMS__VOXELGRIDFILTER_HPP_
@@ -19,14 +19,76 @@
 // Eigen
 #include <Eigen/Eigen>
 
+// std
+#include <limits>
+
 namespace romea
 {
 namespace core
 {
 
-template<typename RealType>
+// Least squares with compile-time estimate size. Jacobian rows are not stored,
+// JtJ and JtY are accumulated row by row, so memory does not depend on the number
+// of data and nothing is allocated on the heap.
+template<typename RealType, int EstimateSize = Eigen::Dynamic>
 class LeastSquares
 {
+public:
+  using Matrix = Eigen::Matrix<RealType, EstimateSize, EstimateSize>;
+  using Vector = Eigen::Matrix<RealType, EstimateSize, 1>;
+
+public:
+  LeastSquares();
+
+  void reset();
+
+  // Weight is applied to normal equations : JtJ += w j jt, JtY += w j y
+  template<typename Derived>
+  void addRow(
+    const Eigen::MatrixBase<Derived> & jacobianRow,
+    const RealType & y,
+    const RealType & weight = 1);
+
+  // Add normal equations accumulated by another least squares (e.g. one per thread)
+  void merge(const LeastSquares & other);
+
+  size_t getDataSize() const;
+
+public:
+  Vector estimateUsingCholeskyDecomposition();
+
+  Vector estimateUsingSVD();
+
+  Matrix computeEstimateCovariance(const RealType & dataVariance);
+
+  void setPreconditionner(const Matrix & Ac, const Vector & Bc);
+
+  void setPreconditionner(const Matrix & Ac);
+
+public:
+  const Matrix & getJtJ() const;
+
+  const Vector & getJtY() const;
+
+private:
+  size_t dataSize_;
+
+  Matrix Ac_;
+  Vector Bc_;
+
+  Matrix JtJ_;
+  Matrix inverseJtJ_;
+  Vector JtY_;
+
+public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW_IF_VECTORIZABLE_FIXED_SIZE(RealType, EstimateSize)
+};
+
+// Least squares with estimate size given at runtime, Jacobian J and
+// residuals Y are stored and filled by user
+template<typename RealType>
+class LeastSquares<RealType, Eigen::Dynamic>
+{
 public:
   using Matrix = Eigen::Matrix<RealType, Eigen::Dynamic, Eigen::Dynamic>;
   using Vector = Eigen::Matrix<RealType, Eigen::Dynamic, 1>;
@@ -49,6 +111,13 @@ public:
 
   Vector estimateUsingSVD();
 
+  // Solve (JtJ + damping * diag(JtJ)) x = JtY using a Cholesky decomposition,
+  // SVD is only used when decomposition fails. When computeNormalEquations is
+  // false previous JtJ and JtY are reused, allowing to try several dampings.
+  Vector estimateUsingDampedCholeskyDecomposition(
+    const RealType & damping,
+    const bool & computeNormalEquations = true);
+
   Vector weightedEstimate();
 
   Matrix computeEstimateCovariance(const RealType & dataVariance);
@@ -67,7 +136,10 @@ public:
   Vector & getW();
   const Vector & getW()const;
 
+  size_t getDataSize() const;
+
 private:
+  void invertJtJUsingSVD_(const Matrix & JtJ);
   void weightJAndY_();
   void computeJTJ_();
   void computeJTY_();
@@ -88,6 +160,124 @@ private:
   Vector JtY_;
 };
 
+//-----------------------------------------------------------------------------
+template<typename RealType, int EstimateSize>
+LeastSquares<RealType, EstimateSize>::LeastSquares()
+: dataSize_(0),
+  Ac_(Matrix::Identity()),
+  Bc_(Vector::Zero()),
+  JtJ_(Matrix::Zero()),
+  inverseJtJ_(Matrix::Zero()),
+  JtY_(Vector::Zero())
+{
+}
+
+//-----------------------------------------------------------------------------
+template<typename RealType, int EstimateSize>
+void LeastSquares<RealType, EstimateSize>::reset()
+{
+  dataSize_ = 0;
+  JtJ_.setZero();
+  JtY_.setZero();
+}
+
+//-----------------------------------------------------------------------------
+template<typename RealType, int EstimateSize>
+template<typename Derived>
+void LeastSquares<RealType, EstimateSize>::addRow(
+  const Eigen::MatrixBase<Derived> & jacobianRow,
+  const RealType & y,
+  const RealType & weight)
+{
+  JtJ_.noalias() += weight * jacobianRow * jacobianRow.transpose();
+  JtY_.noalias() += weight * y * jacobianRow;
+  ++dataSize_;
+}
+
+//-----------------------------------------------------------------------------
+template<typename RealType, int EstimateSize>
+void LeastSquares<RealType, EstimateSize>::merge(const LeastSquares & other)
+{
+  JtJ_ += other.JtJ_;
+  JtY_ += other.JtY_;
+  dataSize_ += other.dataSize_;
+}
+
+//-----------------------------------------------------------------------------
+template<typename RealType, int EstimateSize>
+size_t LeastSquares<RealType, EstimateSize>::getDataSize() const
+{
+  return dataSize_;
+}
+
+//-----------------------------------------------------------------------------
+template<typename RealType, int EstimateSize>
+typename LeastSquares<RealType, EstimateSize>::Vector
+LeastSquares<RealType, EstimateSize>::estimateUsingCholeskyDecomposition()
+{
+  inverseJtJ_ = JtJ_.ldlt().solve(Matrix::Identity());
+  return Ac_ * inverseJtJ_ * JtY_ + Bc_;
+}
+
+//-----------------------------------------------------------------------------
+template<typename RealType, int EstimateSize>
+typename LeastSquares<RealType, EstimateSize>::Vector
+LeastSquares<RealType, EstimateSize>::estimateUsingSVD()
+{
+  Eigen::JacobiSVD<Matrix> svd(JtJ_, Eigen::ComputeFullU | Eigen::ComputeFullV);
+
+  Vector inverseSingularValues = Vector::Zero();
+  for (int n = 0; n < EstimateSize; n++) {
+    if (svd.singularValues()(n) > std::numeric_limits<RealType>::epsilon()) {
+      inverseSingularValues(n) = 1 / svd.singularValues()(n);
+    }
+  }
+
+  inverseJtJ_ = svd.matrixV() * inverseSingularValues.asDiagonal() * svd.matrixU().transpose();
+  return Ac_ * inverseJtJ_ * JtY_ + Bc_;
+}
+
+//-----------------------------------------------------------------------------
+template<typename RealType, int EstimateSize>
+typename LeastSquares<RealType, EstimateSize>::Matrix
+LeastSquares<RealType, EstimateSize>::computeEstimateCovariance(const RealType & dataVariance)
+{
+  return Ac_.transpose() * inverseJtJ_ * Ac_ * dataVariance;
+}
+
+//-----------------------------------------------------------------------------
+template<typename RealType, int EstimateSize>
+void LeastSquares<RealType, EstimateSize>::setPreconditionner(
+  const Matrix & Ac,
+  const Vector & Bc)
+{
+  Ac_ = Ac;
+  Bc_ = Bc;
+}
+
+//-----------------------------------------------------------------------------
+template<typename RealType, int EstimateSize>
+void LeastSquares<RealType, EstimateSize>::setPreconditionner(const Matrix & Ac)
+{
+  setPreconditionner(Ac, Vector::Zero());
+}
+
+//-----------------------------------------------------------------------------
+template<typename RealType, int EstimateSize>
+const typename LeastSquares<RealType, EstimateSize>::Matrix &
+LeastSquares<RealType, EstimateSize>::getJtJ() const
+{
+  return JtJ_;
+}
+
+//-----------------------------------------------------------------------------
+template<typename RealType, int EstimateSize>
+const typename LeastSquares<RealType, EstimateSize>::Vector &
+LeastSquares<RealType, EstimateSize>::getJtY() const
+{
+  return JtY_;
+}
+
 }  // namespace core
 }  // namespace romea
 
@@ -21,6 +21,7 @@
 
 // std
 #include <limits>
+#include <vector>
 
 namespace romea
 {
@@ -36,26 +37,76 @@ class MEstimator
 public:
   using Vector = Eigen::Matrix<RealType, Eigen::Dynamic, 1>;
 
-  explicit MEstimator(RealType dataNoiseStd);
+  enum class Kernel
+  {
+    HUBER,
+    CAUCHY,
+    TUKEY
+  };
 
-  RealType computeWeights(const Vector & residuals);
+  explicit MEstimator(RealType dataNoiseStd, Kernel kernel = Kernel::HUBER);
+
+  void setDataNoiseStd(const RealType & dataNoiseStd);
+
+  void setKernel(const Kernel & kernel);
+
+  // Median and MAD are computed with a two level histogram instead of a
+  // selection when there are at least minimalDataSize residuals
+  void enableApproximateMedian(const size_t & minimalDataSize);
+
+  void disableApproximateMedian();
+
+  RealType computeWeights(const Eigen::Ref<const Vector> & residuals);
 
   RealType computeWeights(
-    const Vector & residualsWithDiscardedValue,
+    const Eigen::Ref<const Vector> & residualsWithDiscardedValue,
     const size_t & numberOfDiscardedData);
 
+  // Distances (point to point errors for instance) are non negative, they
+  // are not centered on their median as signed residuals but on zero, and
+  // their scale is given by their median
+  RealType computeWeightsOfDistances(const Eigen::Ref<const Vector> & distances);
+
   const Vector & getWeights()const { return weights_; }
 
 private:
   void allocate_(const int & dataSize);
 
+  RealType computeWeights_(
+    const Eigen::Ref<const Vector> & residuals,
+    const RealType & center,
+    const RealType & mad,
+    const size_t & numberOfDiscardedData);
+
+  RealType computeMedian_(
+    const Eigen::Ref<const Vector> & residuals,
+    const int & numberOfAvailableData);
+
+  RealType computeMedianAbsoluteDeviation_(
+    const Eigen::Ref<const Vector> & residuals,
+    const RealType & median,
+    const int & numberOfAvailableData);
+
+  template<typename Derived>
+  RealType computeApproximateQuantile_(
+    const Eigen::Ref<const Vector> & residuals,
+    const Eigen::ArrayBase<Derived> & values,
+    RealType minimum,
+    RealType maximum,
+    const int & rank);
+
 private:
+  static constexpr int NUMBER_OF_HISTOGRAM_BINS = 1024;
+
   int dataSize_;
   RealType dataNoiseStd_;
+  Kernel kernel_;
+  size_t approximateMedianMinimalDataSize_;
+  RealType minimum_;
+  RealType maximum_;
   Vector sortedVector_;
-  Vector normalizedResiduals_;
   Vector weights_;
-  Vector ones_;
+  std::vector<int> histogram_;
 };
 
 }  // namespace core
@@ -16,7 +16,14 @@
 #ifndef ROMEA_CORE_COMMON__REGRESSION__LEASTSQUARES__NLSE_HPP_
 #define ROMEA_CORE_COMMON__REGRESSION__LEASTSQUARES__NLSE_HPP_
 
+// std
+#include <vector>
+#include <optional>
+
+// romea
 #include "romea_core_common/regression/leastsquares/LeastSquares.hpp"
+#include "romea_core_common/regression/leastsquares/MEstimator.hpp"
+#include "romea_core_common/time/Time.hpp"
 
 namespace romea
 {
@@ -29,6 +36,13 @@ class NLSE
 public:
   using Vector = Eigen::Matrix<RealType, Eigen::Dynamic, 1>;
   using Matrix = Eigen::Matrix<RealType, Eigen::Dynamic, Eigen::Dynamic>;
+  using RobustKernel = typename MEstimator<RealType>::Kernel;
+
+  enum class Method
+  {
+    GAUSS_NEWTON,
+    LEVENBERG_MARQUARDT
+  };
 
 public:
   NLSE();
@@ -39,6 +53,18 @@ public:
 
   virtual ~NLSE() = default;
 
+  void setMethod(const Method & method);
+
+  void setInitialDamping(const double & initialDamping);
+
+  // Iteratively reweighted least squares, residual weights are given by MEstimator
+  void setRobustKernel(const RobustKernel & kernel);
+
+  void disableRobustKernel();
+
+  // Stop when cost decreases by less than this ratio, 0 to disable
+  void setRelativeCostEpsilon(const double & relativeCostEpsilon);
+
 public:
   virtual bool estimate(
     const size_t & maximalNumberOfIterations,
@@ -46,6 +72,11 @@ public:
 
   const size_t & getNumberOfIterations();
 
+  // Cost of the initial guess followed by cost after each iteration
+  const std::vector<double> & getCostHistory() const;
+
+  const std::vector<Duration> & getIterationDurations() const;
+
   const double & getRootMeanSquareError();
 
   const Vector & getEstimate();
@@ -57,8 +88,24 @@ protected:
 
   virtual void computeJacobianAndY_() = 0;
 
+private:
+  bool estimateUsingGaussNewton_(const size_t & maximalNumberOfIterations);
+
+  bool estimateUsingLevenbergMarquardt_(const size_t & maximalNumberOfIterations);
+
+  void computeWeights_();
+
+  double computeCost_() const;
+
+  void weightJacobianAndY_();
+
+  bool isConverged_(const double & previousCost, const double & cost) const;
+
 protected:
+  Method method_;
   double alpha_;
+  double initialDamping_;
+  double relativeCostEpsilon_;
   Vector estimate_;
   Vector estimateDelta_;
   Matrix estimateCovariance_;
@@ -66,6 +113,13 @@ protected:
   size_t numberOfIterations_;
   LeastSquares<RealType> leastSquares_;
   double rmse_;
+
+  std::optional<RobustKernel> robustKernel_;
+  MEstimator<RealType> mEstimator_;
+  Vector weights_;
+
+  std::vector<double> costHistory_;
+  std::vector<Duration> iterationDurations_;
 };
 
 }  // namespace core
@@ -0,0 +1,139 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef ROMEA_CORE_COMMON__REGRESSION__LEASTSQUARES__SPARSELEASTSQUARES_HPP_
+#define ROMEA_CORE_COMMON__REGRESSION__LEASTSQUARES__SPARSELEASTSQUARES_HPP_
+
+// Eigen
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+#include <Eigen/SparseCholesky>
+
+// std
+#include <vector>
+#include <cassert>
+
+namespace romea
+{
+namespace core
+{
+
+// Least squares for problems with a block sparse Jacobian (e.g. pose graphs).
+// Jacobian is assembled block by block, JtJ is factorized by a sparse Cholesky
+// decomposition. Preconditioner and covariance API mirror LeastSquares.
+template<typename RealType>
+class SparseLeastSquares
+{
+public:
+  using Matrix = Eigen::Matrix<RealType, Eigen::Dynamic, Eigen::Dynamic>;
+  using Vector = Eigen::Matrix<RealType, Eigen::Dynamic, 1>;
+  using SparseMatrix = Eigen::SparseMatrix<RealType>;
+
+public:
+  SparseLeastSquares();
+
+  explicit SparseLeastSquares(const size_t & estimateSize);
+
+  void setEstimateSize(const size_t & estimateSize);
+
+  // Clear Jacobian blocks and allocate residuals and weights (set to 1)
+  void setDataSize(const size_t & dataSize);
+
+  template<typename Derived>
+  void addJacobianBlock(
+    const size_t & row,
+    const size_t & col,
+    const Eigen::MatrixBase<Derived> & block);
+
+public:
+  Vector estimateUsingCholeskyDecomposition();
+
+  Vector weightedEstimate();
+
+  // Whole covariance is dense, prefer blocks for large problems
+  Matrix computeEstimateCovariance(const RealType & dataVariance);
+
+  Matrix computeEstimateCovarianceBlock(
+    const size_t & index,
+    const size_t & size,
+    const RealType & dataVariance);
+
+  void setPreconditionner(const SparseMatrix & Ac, const Vector & Bc);
+
+  void setPreconditionner(const SparseMatrix & Ac);
+
+  bool isSolved() const;
+
+public:
+  const SparseMatrix & getJ();
+
+  Vector & getY();
+  const Vector & getY()const;
+
+  Vector & getW();
+  const Vector & getW()const;
+
+private:
+  void assembleJ_();
+
+  bool hasAnalyzedPattern_() const;
+
+  Vector solve_(const SparseMatrix & J, const Vector & Y);
+
+private:
+  int dataSize_;
+  int estimateSize_;
+
+  SparseMatrix Ac_;
+  Vector Bc_;
+
+  std::vector<Eigen::Triplet<RealType>> triplets_;
+  SparseMatrix J_;
+  bool isJAssembled_;
+  Vector Y_;
+  Vector W_;
+
+  SparseMatrix JtJ_;
+  Eigen::SimplicialLDLT<SparseMatrix> solver_;
+  std::vector<typename SparseMatrix::StorageIndex> analyzedOuterIndexes_;
+  std::vector<typename SparseMatrix::StorageIndex> analyzedInnerIndexes_;
+  bool isSolved_;
+};
+
+//-----------------------------------------------------------------------------
+template<typename RealType>
+template<typename Derived>
+void SparseLeastSquares<RealType>::addJacobianBlock(
+  const size_t & row,
+  const size_t & col,
+  const Eigen::MatrixBase<Derived> & block)
+{
+  assert(int(row + block.rows()) <= dataSize_);
+  assert(int(col + block.cols()) <= estimateSize_);
+
+  for (int j = 0; j < block.cols(); ++j) {
+    for (int i = 0; i < block.rows(); ++i) {
+      if (block(i, j) != 0) {
+        triplets_.emplace_back(int(row) + i, int(col) + j, block(i, j));
+      }
+    }
+  }
+  isJAssembled_ = false;
+}
+
+}  // namespace core
+}  // namespace romea
+
+#endif  // ROMEA_CORE_COMMON__REGRESSION__LEASTSQUARES__SPARSELEASTSQUARES_HPP_
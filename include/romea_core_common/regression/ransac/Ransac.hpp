@@ -16,30 +16,160 @@
 #ifndef ROMEA_CORE_COMMON__REGRESSION__RANSAC__RANSAC_HPP_
 #define ROMEA_CORE_COMMON__REGRESSION__RANSAC__RANSAC_HPP_
 
+// std
+#include <limits>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+// romea
 #include "romea_core_common/regression/ransac/RansacModel.hpp"
+#include "romea_core_common/regression/ransac/RansacIterations.hpp"
+#include "romea_core_common/time/Time.hpp"
 
 namespace romea
 {
 namespace core
 {
 
+const double RANSAC_DEFAULT_FITTING_PROBABILITY = 0.99;
+const size_t RANSAC_DEFAULT_MAXIMAL_NUMBER_OF_ITERATIONS = 1000;
+
+struct RansacStatistics
+{
+  size_t numberOfIterations = 0;
+  size_t bestNumberOfInliers = 0;
+  Duration drawDuration = Duration::zero();
+  Duration countInliersDuration = Duration::zero();
+  Duration refineDuration = Duration::zero();
+};
+
+// Model is resolved at compile time, so draw and countInliers can be inlined.
+// Models deriving from RansacModel can still be used through Ransac<RansacModel>.
+template<class Model>
 class Ransac
 {
 public:
   Ransac(
-    RansacModel * ransacModel,
+    Model * ransacModel,
     double modelErrorDeviation);
 
+  void setFittingProbability(const double & fittingProbability);
+
+  void setMaximalNumberOfIterations(const size_t & maximalNumberOfIterations);
+
+  void setSeed(const std::uint64_t & seed);
+
   bool estimateModel();
 
+  const RansacStatistics & getStatistics() const;
+
 private:
   double fittingProbability_;
   double modelErrorDeviation_;
-  int maximalNumberOfIterations_;
+  size_t maximalNumberOfIterations_;
 
-  RansacModel * ransacModel_;
+  Model * ransacModel_;
+  RansacStatistics statistics_;
 };
 
+//-----------------------------------------------------------------------------
+template<class Model>
+Ransac<Model>::Ransac(
+  Model * ransacModel,
+  double modelErrorDeviation)
+: fittingProbability_(RANSAC_DEFAULT_FITTING_PROBABILITY),
+  modelErrorDeviation_(modelErrorDeviation),
+  maximalNumberOfIterations_(RANSAC_DEFAULT_MAXIMAL_NUMBER_OF_ITERATIONS),
+  ransacModel_(ransacModel),
+  statistics_()
+{
+  assert(modelErrorDeviation_ > std::numeric_limits<double>::epsilon());
+}
+
+//-----------------------------------------------------------------------------
+template<class Model>
+void Ransac<Model>::setFittingProbability(const double & fittingProbability)
+{
+  assert(fittingProbability > 0 && fittingProbability < 1);
+  fittingProbability_ = fittingProbability;
+}
+
+//-----------------------------------------------------------------------------
+template<class Model>
+void Ransac<Model>::setMaximalNumberOfIterations(const size_t & maximalNumberOfIterations)
+{
+  maximalNumberOfIterations_ = maximalNumberOfIterations;
+}
+
+//-----------------------------------------------------------------------------
+template<class Model>
+void Ransac<Model>::setSeed(const std::uint64_t & seed)
+{
+  ransacModel_->setSeed(seed);
+}
+
+//-----------------------------------------------------------------------------
+template<class Model>
+bool Ransac<Model>::estimateModel()
+{
+  statistics_ = RansacStatistics();
+
+  const size_t numberOfPoints = ransacModel_->getNumberOfPoints();
+  const size_t numberOfPointsToDrawModel = ransacModel_->getNumberOfPointsToDrawModel();
+
+  if (numberOfPoints < ransacModel_->getMinimalNumberOfInliers()) {
+    return false;
+  }
+
+  RansacIterations ransacIterations(
+    numberOfPoints,
+    fittingProbability_,
+    maximalNumberOfIterations_);
+
+  size_t iteration = 0;
+  size_t bestNumberOfInliers = 0;
+  while (iteration < ransacIterations.get()) {
+    // Draw and evaluate a new model
+    TimePoint drawStart = now();
+    bool drawn = ransacModel_->draw(modelErrorDeviation_);
+    TimePoint drawEnd = now();
+    statistics_.drawDuration += duration(drawEnd, drawStart);
+
+    if (drawn) {
+      size_t numberOfInliers = ransacModel_->countInliers(modelErrorDeviation_);
+      statistics_.countInliersDuration += duration(now(), drawEnd);
+
+      if (numberOfInliers > bestNumberOfInliers) {
+        ransacIterations.update(numberOfInliers, numberOfPointsToDrawModel);
+        bestNumberOfInliers = numberOfInliers;
+      }
+    }
+    ++iteration;
+  }
+
+  statistics_.numberOfIterations = iteration;
+  statistics_.bestNumberOfInliers = bestNumberOfInliers;
+
+  // Points drawn to build a model are always its inliers, so a model is only
+  // supported by the data if at least one other point agrees with it
+  if (bestNumberOfInliers <= numberOfPointsToDrawModel) {
+    return false;
+  }
+
+  TimePoint refineStart = now();
+  ransacModel_->refine();
+  statistics_.refineDuration = duration(now(), refineStart);
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+template<class Model>
+const RansacStatistics & Ransac<Model>::getStatistics() const
+{
+  return statistics_;
+}
+
 }  // namespace core
 }  // namespace romea
 
@@ -18,13 +18,15 @@
 
 // stl
 #include <cstddef>
+#include <cstdint>
 
 namespace romea
 {
 namespace core
 {
 
-// TODO(jean) perhaps use crtp here
+// Dynamic interface, models can also be given directly to Ransac<Model>
+// to avoid virtual calls in the draw / count inliers loop
 
 class RansacModel
 {
@@ -46,6 +48,8 @@ public:
   virtual size_t getMinimalNumberOfInliers() const = 0;
 
   virtual double getRootMeanSquareError() const = 0;
+
+  virtual void setSeed(const std::uint64_t & seed);
 };
 
 }  // namespace core
@@ -22,9 +22,10 @@
 
 // stl
 #include <vector>
-#include <random>
+#include <cstdint>
 
 // romea
+#include "romea_core_common/math/RandomGenerator.hpp"
 #include "romea_core_common/pointset/PointSet.hpp"
 #include "romea_core_common/pointset/PointTraits.hpp"
 #include "romea_core_common/pointset/algorithms/Correspondence.hpp"
@@ -42,6 +43,8 @@ class RansacRandomCorrespondences
 public:
   RansacRandomCorrespondences();
 
+  void setSeed(const std::uint64_t & seed);
+
   void computeScale(
     const PointType & pointSetMin,
     const PointType & pointSetMax);
@@ -70,8 +73,7 @@ private:
   std::vector<double> cumSumWeights_;
 
 
-  std::default_random_engine randomGenerator_;
-  std::uniform_real_distribution<double> uniformDistribution_;
+  RandomGenerator randomGenerator_;
 
 public:
   EIGEN_MAKE_ALIGNED_OPERATOR_NEW_IF_VECTORIZABLE_FIXED_SIZE(
@@ -0,0 +1,147 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+#ifndef ROMEA_CORE_COMMON__TRANSFORM__ESTIMATION__FINDRIGIDTRANSFORMATIONBYBRANCHANDBOUND_HPP_
+#define ROMEA_CORE_COMMON__TRANSFORM__ESTIMATION__FINDRIGIDTRANSFORMATIONBYBRANCHANDBOUND_HPP_
+
+// Eigen
+#include <Eigen/Core>
+
+// std
+#include <atomic>
+#include <vector>
+
+// romea
+#include "romea_core_common/containers/grid/GridIndexMapping.hpp"
+#include "romea_core_common/containers/grid/GridPyramid.hpp"
+#include "romea_core_common/pointset/PointSet.hpp"
+#include "romea_core_common/pointset/PointTraits.hpp"
+
+namespace romea
+{
+namespace core
+{
+
+// Exhaustive 2D scan matching against a likelihood grid (E. Olson, real-time
+// correlative scan matching, W. Hess et al., real-time loop closure in 2D
+// lidar SLAM). Every pose of a (x, y, yaw) window centered on guess pose is
+// scored by the mean likelihood of the grid cells hit by the scan. Window is
+// discretized with grid resolution for translations and with an angular step
+// moving the farthest scan point by about one cell. For each yaw slice the
+// rotated scan is computed once, then translations are explored by branch and
+// bound: the score of a block of 2^l x 2^l translations is bounded using the
+// max pooled level l of a GridPyramid. Yaw slices are searched in parallel.
+// Likelihoods must be positive, cells outside of the grid count for 0.
+// The returned transformation maps scan points into grid frame and can be
+// used as guess of FindRigidTransformationByICP.
+template<class PointType>
+class FindRigidTransformationByBranchAndBound
+{
+public:
+  using Scalar = typename PointType::Scalar;
+  static constexpr size_t CARTESIAN_DIM = PointTraits<PointType>::DIM;
+  static_assert(CARTESIAN_DIM == 2, "correlative scan matching is only defined for 2D points");
+
+  using LikelihoodGrid = Grid<Scalar, 2>;
+  using GridIndexMappingType = GridIndexMapping<Scalar, 2>;
+  using TransformationMatrixType = Eigen::Matrix<Scalar, 3, 3>;
+
+public:
+  FindRigidTransformationByBranchAndBound();
+
+  void setLinearSearchWindow(const Scalar & halfWidth);
+
+  void setAngularSearchWindow(const Scalar & halfWidth);
+
+  void setMinimalScore(const Scalar & minimalScore);
+
+  // Deepest pyramid level is used for blocks of 2^(numberOfLevels-1) cells
+  void setNumberOfPyramidLevels(const size_t & numberOfLevels);
+
+  void setMaximalNumberOfThreads(const size_t & maximalNumberOfThreads);
+
+  // Grid is not copied and must outlive the scan matcher
+  void setLikelihoodGrid(
+    const LikelihoodGrid & likelihoodGrid,
+    const GridIndexMappingType & gridIndexMapping);
+
+  // Likelihood cells of box [first, last] have been modified
+  void updateLikelihoodGrid(
+    const typename LikelihoodGrid::CellIndexes & firstCellIndexes,
+    const typename LikelihoodGrid::CellIndexes & lastCellIndexes);
+
+public:
+  // Return false when no pose of the window reaches minimal score
+  bool find(
+    const PointSet<PointType> & scanPoints,
+    const TransformationMatrixType & guessTransformation);
+
+  const TransformationMatrixType & getTransformation() const;
+
+  const Scalar & getScore() const;
+
+private:
+  static constexpr size_t MINIMAL_NUMBER_OF_SLICES_PER_THREAD = 1;
+
+  using ScanCells = std::vector<Eigen::Vector2i, Eigen::aligned_allocator<Eigen::Vector2i>>;
+
+  // Block of 2^level x 2^level translations starting at offset, score is
+  // an upper bound of scores of its translations (exact score at level 0)
+  struct Candidate
+  {
+    Scalar score;
+    int xOffset;
+    int yOffset;
+  };
+
+  using Candidates = std::vector<Candidate>;
+
+  Scalar computeScoreBound_(
+    const ScanCells & scanCells,
+    const size_t & level,
+    const int & xOffset,
+    const int & yOffset) const;
+
+  // Depth first search of candidates of levelCandidates[level] sorted by
+  // decreasing score, children are stored in the buffer of the lower level
+  void branchAndBound_(
+    const ScanCells & scanCells,
+    const size_t & level,
+    std::vector<Candidates> & levelCandidates,
+    Candidate & bestCandidate,
+    std::atomic<Scalar> & sharedBestScore) const;
+
+  static void sortCandidates_(Candidates & candidates);
+
+private:
+  Scalar linearSearchHalfWidth_;
+  Scalar angularSearchHalfWidth_;
+  Scalar minimalScore_;
+  size_t maximalNumberOfThreads_;
+
+  const LikelihoodGrid * likelihoodGrid_;
+  const GridIndexMappingType * gridIndexMapping_;
+  GridPyramid<Scalar, 2, MaxPooling> pyramid_;
+
+  int linearSearchHalfSize_;
+  TransformationMatrixType transformation_;
+  Scalar score_;
+};
+
+}  // namespace core
+}  // namespace romea
+
+#endif  // ROMEA_CORE_COMMON__TRANSFORM__ESTIMATION__FINDRIGIDTRANSFORMATIONBYBRANCHANDBOUND_HPP_
@@ -22,6 +22,7 @@
 // romea
 #include "romea_core_common/transform/estimation/RansacRigidTransformationModel.hpp"
 #include "romea_core_common/regression/ransac/Ransac.hpp"
+#include "romea_core_common/regression/leastsquares/MEstimator.hpp"
 #include "romea_core_common/pointset/KdTree.hpp"
 
 
@@ -42,10 +43,14 @@ public:
   using TransformationMatrixType = Eigen::Matrix<Scalar, CARTESIAN_DIM + 1, CARTESIAN_DIM + 1>;
 
 public:
+  // Robust methods weight correspondences with a M-estimator at each
+  // iteration instead of running a ransac consensus
   enum class EstimationMethod
   {
     LEAST_SQUARES = 0,
-    SVD
+    SVD,
+    ROBUST_LEAST_SQUARES,
+    ROBUST_SVD
   };
 
 public:
@@ -76,6 +81,14 @@ public:
 protected:
   void allocate_(size_t numberOfPoints);
 
+  bool estimateByConsensus_(EstimationMethod estimationMethod);
+
+  void estimateByReweighting_(EstimationMethod estimationMethod);
+
+  void reweightCorrespondences_(EstimationMethod estimationMethod);
+
+  double computeRootMeanSquareError_() const;
+
 protected:
   PointSet<PointType> targetPointsNormals_;
   PointSet<PointType> projectedTargetPoints_;
@@ -87,10 +100,21 @@ protected:
   std::vector<Correspondence> matchedCorrespondences_;
 
   RansacRigidTransformationModel<PointType> ransacModel_;
-  Ransac ransac_;
+  Ransac<RansacRigidTransformationModel<PointType>> ransac_;
+
+  MEstimator<Scalar> mEstimator_;
+  typename MEstimator<Scalar>::Vector residuals_;
+  FindRigidTransformationByLeastSquares<PointType> findRigidTransformationByLeastSquares_;
+  FindRigidTransformationBySVD<PointType> findRigidTransformationBySVD_;
+
+  TransformationMatrixType transformation_;
+  double rootMeanSquareError_;
 
   size_t maximalNumberOfIterations_;
   Scalar transformationEpsilon_;
+
+public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW_IF_VECTORIZABLE_FIXED_SIZE(Scalar, CARTESIAN_DIM + 1)
 };
 
 }  // namespace core
@@ -40,8 +40,12 @@ public:
   static constexpr size_t CARTESIAN_DIM = PointTraits<PointType>::DIM;
   static constexpr size_t POINT_SIZE = PointTraits<PointType>::SIZE;
 
+  // 2D : (tx, ty, theta), 3D : (tx, ty, tz, rx, ry, rz)
+  static constexpr int ESTIMATE_SIZE = CARTESIAN_DIM == 2 ? 3 : 6;
+
   using PreconditionedPointSetType = PreconditionedPointSet<PointType>;
   using TransformationMatrixType = Eigen::Matrix<Scalar, CARTESIAN_DIM + 1, CARTESIAN_DIM + 1>;
+  using EstimateVector = Eigen::Matrix<Scalar, ESTIMATE_SIZE, 1>;
 
 public:
   FindRigidTransformationByLeastSquares();
@@ -57,6 +61,7 @@ public:
     const NormalSet<PointType> & targetPointsNormals);
 
 
+  // Point to plane rows are weighted by Correspondence::weight
   TransformationMatrixType find(
     const PointSet<PointType> & sourcePoints,
     const PointSet<PointType> & targetPoints,
@@ -73,6 +78,9 @@ public:
     const PreconditionedPointSetType & sourcePoints,
     const PreconditionedPointSetType & targetPoints);
 
+  // Normal equations are built in parallel over correspondences
+  void setMaximalNumberOfThreads(const size_t & maximalNumberOfThreads);
+
 private:
   TransformationMatrixType estimate_(
     const PointSet<PointType> & sourcePoints,
@@ -85,8 +93,30 @@ private:
     const NormalSet<PointType> & targetPointsNormals,
     const std::vector<Correspondence> & correspondences);
 
+  template<typename RowFunction>
+  void buildNormalEquations_(
+    const size_t & numberOfRows,
+    RowFunction && rowFunction);
+
+  static void addPointToPlaneRow_(
+    LeastSquares<Scalar, ESTIMATE_SIZE> & leastSquares,
+    const PointType & sourcePoint,
+    const PointType & targetPoint,
+    const PointType & targetPointNormal,
+    const Scalar & weight);
+
+  TransformationMatrixType toTransformationMatrix_(const EstimateVector & estimate) const;
+
 private:
-  LeastSquares<Scalar> leastSquares_;
+  static constexpr size_t MINIMAL_NUMBER_OF_ROWS_PER_THREAD = 2048;
+
+  LeastSquares<Scalar, ESTIMATE_SIZE> leastSquares_;
+  std::vector<LeastSquares<Scalar, ESTIMATE_SIZE>,
+    Eigen::aligned_allocator<LeastSquares<Scalar, ESTIMATE_SIZE>>> threadLeastSquares_;
+  size_t maximalNumberOfThreads_;
+
+public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW_IF_VECTORIZABLE_FIXED_SIZE(Scalar, ESTIMATE_SIZE)
 };
 
 }  // namespace core
@@ -25,6 +25,7 @@
 #include <vector>
 
 // romea
+#include "romea_core_common/math/CovarianceAccumulator.hpp"
 #include "romea_core_common/pointset/algorithms/PreconditionedPointSet.hpp"
 #include "romea_core_common/pointset/algorithms/Correspondence.hpp"
 
@@ -44,10 +45,12 @@ public:
 
   using PreconditionedPointSetType = PreconditionedPointSet<PointType>;
   using TransformationMatrixType = Eigen::Matrix<Scalar, CARTESIAN_DIM + 1, CARTESIAN_DIM + 1>;
+  using CovarianceAccumulatorType = CrossCovarianceAccumulator<Scalar, CARTESIAN_DIM>;
 
 public:
   FindRigidTransformationBySVD();
 
+  // Correspondences are weighted by Correspondence::weight (weighted Umeyama)
   TransformationMatrixType find(
     const PreconditionedPointSetType & sourcePoints,
     const PreconditionedPointSetType & targetPoints,
@@ -75,6 +78,15 @@ private:
   TransformationMatrixType estimate_(
     const PointSet<PointType> & sourcePoints,
     const PointSet<PointType> & targetPoints);
+
+  TransformationMatrixType toTransformationMatrix_(
+    const CovarianceAccumulatorType & accumulator) const;
+
+private:
+  CovarianceAccumulatorType accumulator_;
+
+public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW_IF_VECTORIZABLE_FIXED_SIZE(Scalar, CARTESIAN_DIM)
 };
 
 }  // namespace core
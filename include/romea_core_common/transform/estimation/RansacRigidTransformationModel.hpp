@@ -32,8 +32,10 @@ namespace romea
 namespace core
 {
 
+// Final so calls made by Ransac<RansacRigidTransformationModel> are
+// devirtualized while the model is still usable as a RansacModel
 template<class PointType>
-class RansacRigidTransformationModel : public RansacModel
+class RansacRigidTransformationModel final : public RansacModel
 {
 public:
   using Scalar = typename PointType::Scalar;
@@ -67,19 +69,21 @@ public:
     const size_t & numberOfSourcePointsInCorrespondences);
 
 public:
-  virtual bool draw(const double & modelDeviationError);
+  bool draw(const double & modelDeviationError) override;
 
-  virtual size_t countInliers(const double & modelDeviationError);
+  size_t countInliers(const double & modelDeviationError) override;
 
-  virtual void refine();
+  void refine() override;
 
-  virtual size_t getNumberOfPoints() const;
+  size_t getNumberOfPoints() const override;
 
-  virtual size_t getNumberOfPointsToDrawModel() const;
+  size_t getNumberOfPointsToDrawModel() const override;
 
-  virtual size_t getMinimalNumberOfInliers() const;
+  size_t getMinimalNumberOfInliers() const override;
 
-  virtual double getRootMeanSquareError() const;
+  double getRootMeanSquareError() const override;
+
+  void setSeed(const std::uint64_t & seed) override;
 
   const TransformationMatrixType & getTransformation()const;
 
@@ -0,0 +1,601 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+// std
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+// romea
+#include "romea_core_common/concurrency/ParallelFor.hpp"
+
+// local
+#include "romea_core_common/containers/boundingbox/BoundingVolumeHierarchy.hpp"
+
+namespace romea
+{
+namespace core
+{
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+BoundingVolumeHierarchy<Scalar, DIM>::BoundingVolumeHierarchy()
+: boxes_(),
+  nodes_(),
+  boxIndexes_(),
+  boxCenters_(),
+  maximalNumberOfThreads_(getDefaultNumberOfThreads())
+{
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+size_t BoundingVolumeHierarchy<Scalar, DIM>::addBox(const AABBType & box)
+{
+  const PointType & centerPosition = box.getCenterPosition();
+  const PointType & halfWidthExtents = box.getHalfWidthExtents();
+  boxes_.push_back({centerPosition - halfWidthExtents, centerPosition + halfWidthExtents,
+      centerPosition, halfWidthExtents, RotationType::Identity(), false});
+  return boxes_.size() - 1;
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+size_t BoundingVolumeHierarchy<Scalar, DIM>::addBox(const OBBType & box)
+{
+  const AABBType envelope = box.toAxisAlignedBoundingBox();
+  const PointType & centerPosition = envelope.getCenterPosition();
+  const PointType & halfWidthExtents = envelope.getHalfWidthExtents();
+  boxes_.push_back({centerPosition - halfWidthExtents, centerPosition + halfWidthExtents,
+      box.getCenterPosition(), box.getHalfWidthExtents(), box.getRotationMatrix(), true});
+  return boxes_.size() - 1;
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+void BoundingVolumeHierarchy<Scalar, DIM>::clear()
+{
+  boxes_.clear();
+  nodes_.clear();
+  boxIndexes_.clear();
+  boxCenters_.clear();
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+size_t BoundingVolumeHierarchy<Scalar, DIM>::getNumberOfBoxes() const
+{
+  return boxes_.size();
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+void BoundingVolumeHierarchy<Scalar, DIM>::setMaximalNumberOfThreads(
+  const size_t & maximalNumberOfThreads)
+{
+  maximalNumberOfThreads_ = std::max(size_t(1), maximalNumberOfThreads);
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+void BoundingVolumeHierarchy<Scalar, DIM>::build()
+{
+  nodes_.clear();
+  boxIndexes_.resize(boxes_.size());
+  std::iota(std::begin(boxIndexes_), std::end(boxIndexes_), 0);
+  if (boxes_.empty()) {
+    return;
+  }
+
+  boxCenters_.resize(boxes_.size());
+  for (size_t n = 0; n < boxes_.size(); ++n) {
+    boxCenters_[n] = (boxes_[n].lower + boxes_[n].upper) / 2;
+  }
+
+  // A binary tree with leaves of at least one box has less than 2n nodes
+  nodes_.reserve(2 * boxes_.size());
+  Node root;
+  computeBounds_(0, boxes_.size(), root.lower, root.upper);
+  root.first = 0;
+  root.numberOfBoxes = boxes_.size();
+  nodes_.push_back(root);
+
+  std::vector<std::pair<size_t, size_t>> pendingNodes = {{0, 0}};
+  while (!pendingNodes.empty()) {
+    const auto [nodeIndex, depth] = pendingNodes.back();
+    pendingNodes.pop_back();
+    if (split_(nodeIndex, depth)) {
+      const size_t firstChildIndex = nodes_[nodeIndex].first;
+      pendingNodes.emplace_back(firstChildIndex, depth + 1);
+      pendingNodes.emplace_back(firstChildIndex + 1, depth + 1);
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+void BoundingVolumeHierarchy<Scalar, DIM>::computeBounds_(
+  const size_t & first,
+  const size_t & numberOfBoxes,
+  PointType & lower,
+  PointType & upper) const
+{
+  lower = PointType::Constant(std::numeric_limits<Scalar>::max());
+  upper = PointType::Constant(std::numeric_limits<Scalar>::lowest());
+  for (size_t k = first; k < first + numberOfBoxes; ++k) {
+    const Box & box = boxes_[boxIndexes_[k]];
+    lower = lower.cwiseMin(box.lower);
+    upper = upper.cwiseMax(box.upper);
+  }
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+Scalar BoundingVolumeHierarchy<Scalar, DIM>::computeArea_(
+  const PointType & lower,
+  const PointType & upper)
+{
+  // Half surface in 3D and half perimeter in 2D
+  const PointType extents = upper - lower;
+  if constexpr (DIM == 2) {
+    return extents[0] + extents[1];
+  } else {
+    return extents[0] * extents[1] + extents[1] * extents[2] + extents[2] * extents[0];
+  }
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+bool BoundingVolumeHierarchy<Scalar, DIM>::split_(
+  const size_t & nodeIndex,
+  const size_t & depth)
+{
+  const size_t first = nodes_[nodeIndex].first;
+  const size_t numberOfBoxes = nodes_[nodeIndex].numberOfBoxes;
+  if (numberOfBoxes <= MAXIMAL_NUMBER_OF_BOXES_PER_LEAF) {
+    return false;
+  }
+
+  const auto begin = std::begin(boxIndexes_) + first;
+  const auto end = begin + numberOfBoxes;
+
+  // Split along axis of largest extent of box centers
+  PointType centersLower = PointType::Constant(std::numeric_limits<Scalar>::max());
+  PointType centersUpper = PointType::Constant(std::numeric_limits<Scalar>::lowest());
+  for (auto it = begin; it != end; ++it) {
+    centersLower = centersLower.cwiseMin(boxCenters_[*it]);
+    centersUpper = centersUpper.cwiseMax(boxCenters_[*it]);
+  }
+
+  Eigen::Index axis;
+  const Scalar extent = (centersUpper - centersLower).maxCoeff(&axis);
+
+  size_t numberOfLeftBoxes = numberOfBoxes / 2;
+  if (extent > 0 && depth < MAXIMAL_SAH_DEPTH) {
+    // Binned surface area heuristic
+    auto computeBin = [&](const size_t & boxIndex) {
+        const Scalar position = (boxCenters_[boxIndex][axis] - centersLower[axis]) / extent;
+        return std::min(NUMBER_OF_BINS - 1, static_cast<size_t>(position * NUMBER_OF_BINS));
+      };
+
+    std::array<size_t, NUMBER_OF_BINS> binCounts;
+    std::array<PointType, NUMBER_OF_BINS> binLowers, binUppers;
+    binCounts.fill(0);
+    binLowers.fill(PointType::Constant(std::numeric_limits<Scalar>::max()));
+    binUppers.fill(PointType::Constant(std::numeric_limits<Scalar>::lowest()));
+    for (auto it = begin; it != end; ++it) {
+      const size_t bin = computeBin(*it);
+      ++binCounts[bin];
+      binLowers[bin] = binLowers[bin].cwiseMin(boxes_[*it].lower);
+      binUppers[bin] = binUppers[bin].cwiseMax(boxes_[*it].upper);
+    }
+
+    // Costs of splits after each bin, left sides are swept forward and
+    // right sides backward
+    std::array<Scalar, NUMBER_OF_BINS> leftCosts;
+    PointType lower = PointType::Constant(std::numeric_limits<Scalar>::max());
+    PointType upper = PointType::Constant(std::numeric_limits<Scalar>::lowest());
+    size_t count = 0;
+    for (size_t bin = 0; bin + 1 < NUMBER_OF_BINS; ++bin) {
+      count += binCounts[bin];
+      lower = lower.cwiseMin(binLowers[bin]);
+      upper = upper.cwiseMax(binUppers[bin]);
+      leftCosts[bin] = count ? count * computeArea_(lower, upper) : 0;
+    }
+
+    size_t bestBin = NUMBER_OF_BINS;
+    Scalar bestCost = std::numeric_limits<Scalar>::max();
+    lower = PointType::Constant(std::numeric_limits<Scalar>::max());
+    upper = PointType::Constant(std::numeric_limits<Scalar>::lowest());
+    count = 0;
+    for (size_t bin = NUMBER_OF_BINS - 1; bin > 0; --bin) {
+      count += binCounts[bin];
+      lower = lower.cwiseMin(binLowers[bin]);
+      upper = upper.cwiseMax(binUppers[bin]);
+      const Scalar cost = leftCosts[bin - 1] + count * computeArea_(lower, upper);
+      if (count != 0 && count != numberOfBoxes && cost < bestCost) {
+        bestBin = bin - 1;
+        bestCost = cost;
+      }
+    }
+
+    // Centers extent is not null so first and last bins are not empty
+    assert(bestBin != NUMBER_OF_BINS);
+    numberOfLeftBoxes = std::distance(begin, std::partition(begin, end,
+      [&](const size_t & boxIndex) {return computeBin(boxIndex) <= bestBin;}));
+  } else {
+    std::nth_element(begin, begin + numberOfLeftBoxes, end,
+      [&](const size_t & i, const size_t & j) {
+        return boxCenters_[i][axis] < boxCenters_[j][axis];
+      });
+  }
+
+  Node left, right;
+  left.first = first;
+  left.numberOfBoxes = numberOfLeftBoxes;
+  right.first = first + numberOfLeftBoxes;
+  right.numberOfBoxes = numberOfBoxes - numberOfLeftBoxes;
+  computeBounds_(left.first, left.numberOfBoxes, left.lower, left.upper);
+  computeBounds_(right.first, right.numberOfBoxes, right.lower, right.upper);
+
+  nodes_[nodeIndex].first = nodes_.size();
+  nodes_[nodeIndex].numberOfBoxes = 0;
+  nodes_.push_back(left);
+  nodes_.push_back(right);
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+template<typename NodeTest, typename LeafBoxFunction>
+void BoundingVolumeHierarchy<Scalar, DIM>::traverse_(
+  NodeTest && nodeTest,
+  LeafBoxFunction && leafBoxFunction) const
+{
+  if (nodes_.empty()) {
+    return;
+  }
+
+  std::array<size_t, MAXIMAL_DEPTH + 1> stack;
+  size_t stackSize = 0;
+  stack[stackSize++] = 0;
+  while (stackSize != 0) {
+    const Node & node = nodes_[stack[--stackSize]];
+    if (!nodeTest(node.lower, node.upper)) {
+      continue;
+    }
+
+    if (node.numberOfBoxes != 0) {
+      for (size_t k = node.first; k < node.first + node.numberOfBoxes; ++k) {
+        leafBoxFunction(boxIndexes_[k]);
+      }
+    } else {
+      stack[stackSize++] = node.first + 1;
+      stack[stackSize++] = node.first;
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+bool BoundingVolumeHierarchy<Scalar, DIM>::isInside_(const Box & box, const PointType & point)
+{
+  if (box.isOriented) {
+    return ((box.rotation.transpose() * (point - box.centerPosition)).array().abs() <=
+           box.halfWidthExtents.array()).all();
+  } else {
+    return (point.array() >= box.lower.array()).all() &&
+           (point.array() <= box.upper.array()).all();
+  }
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+void BoundingVolumeHierarchy<Scalar, DIM>::findBoxesContaining(
+  const PointType & point,
+  std::vector<size_t> & boxIndexes) const
+{
+  assert(nodes_.empty() == boxes_.empty());
+  boxIndexes.clear();
+  traverse_(
+    [&](const PointType & lower, const PointType & upper) {
+      return (point.array() >= lower.array()).all() && (point.array() <= upper.array()).all();
+    },
+    [&](const size_t & boxIndex) {
+      if (isInside_(boxes_[boxIndex], point)) {
+        boxIndexes.push_back(boxIndex);
+      }
+    });
+  std::sort(std::begin(boxIndexes), std::end(boxIndexes));
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+bool BoundingVolumeHierarchy<Scalar, DIM>::overlap_(
+  const Box & box,
+  const PointType & centerPosition,
+  const PointType & halfWidthExtents,
+  const RotationType & rotation)
+{
+  // Separating axis theorem, candidate axes are box axes and in 3D cross
+  // products of their axes
+  const PointType translation = centerPosition - box.centerPosition;
+  auto isSeparatingAxis = [&](const PointType & axis) {
+      const Scalar boxRadius =
+        (box.rotation.transpose() * axis).cwiseAbs().dot(box.halfWidthExtents);
+      const Scalar radius = (rotation.transpose() * axis).cwiseAbs().dot(halfWidthExtents);
+      return std::abs(axis.dot(translation)) > boxRadius + radius;
+    };
+
+  for (size_t i = 0; i < DIM; ++i) {
+    if (isSeparatingAxis(box.rotation.col(i)) || isSeparatingAxis(rotation.col(i))) {
+      return false;
+    }
+  }
+
+  if constexpr (DIM == 3) {
+    for (size_t i = 0; i < 3; ++i) {
+      for (size_t j = 0; j < 3; ++j) {
+        if (isSeparatingAxis(box.rotation.col(i).cross(rotation.col(j)))) {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+void BoundingVolumeHierarchy<Scalar, DIM>::findBoxesOverlapping_(
+  const PointType & centerPosition,
+  const PointType & halfWidthExtents,
+  const RotationType & rotation,
+  const PointType & lower,
+  const PointType & upper,
+  std::vector<size_t> & boxIndexes) const
+{
+  // Envelopes overlap test is exact for two axis aligned boxes
+  const bool isOriented = !rotation.isIdentity(0);
+  auto overlapEnvelope = [&](const PointType & nodeLower, const PointType & nodeUpper) {
+      return (lower.array() <= nodeUpper.array()).all() &&
+             (nodeLower.array() <= upper.array()).all();
+    };
+
+  boxIndexes.clear();
+  traverse_(
+    overlapEnvelope,
+    [&](const size_t & boxIndex) {
+      const Box & box = boxes_[boxIndex];
+      if (overlapEnvelope(box.lower, box.upper) &&
+      (!(box.isOriented || isOriented) ||
+      overlap_(box, centerPosition, halfWidthExtents, rotation)))
+      {
+        boxIndexes.push_back(boxIndex);
+      }
+    });
+  std::sort(std::begin(boxIndexes), std::end(boxIndexes));
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+void BoundingVolumeHierarchy<Scalar, DIM>::findBoxesOverlapping(
+  const AABBType & box,
+  std::vector<size_t> & boxIndexes) const
+{
+  const PointType & centerPosition = box.getCenterPosition();
+  const PointType & halfWidthExtents = box.getHalfWidthExtents();
+  findBoxesOverlapping_(
+    centerPosition, halfWidthExtents, RotationType::Identity(),
+    centerPosition - halfWidthExtents, centerPosition + halfWidthExtents, boxIndexes);
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+void BoundingVolumeHierarchy<Scalar, DIM>::findBoxesOverlapping(
+  const OBBType & box,
+  std::vector<size_t> & boxIndexes) const
+{
+  const AABBType envelope = box.toAxisAlignedBoundingBox();
+  findBoxesOverlapping_(
+    box.getCenterPosition(), box.getHalfWidthExtents(), box.getRotationMatrix(),
+    envelope.getCenterPosition() - envelope.getHalfWidthExtents(),
+    envelope.getCenterPosition() + envelope.getHalfWidthExtents(), boxIndexes);
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+bool BoundingVolumeHierarchy<Scalar, DIM>::intersectRay_(
+  const PointType & lower,
+  const PointType & upper,
+  const PointType & origin,
+  const PointType & inverseDirection,
+  const Scalar & maximalDistance,
+  Scalar & entry)
+{
+  // Slab test, NaN given by null direction components on slab boundaries
+  // are ignored by std::min and std::max argument order
+  Scalar exit = maximalDistance;
+  entry = 0;
+  for (size_t i = 0; i < DIM; ++i) {
+    const Scalar t1 = (lower[i] - origin[i]) * inverseDirection[i];
+    const Scalar t2 = (upper[i] - origin[i]) * inverseDirection[i];
+    entry = std::max(entry, std::min(t1, t2));
+    exit = std::min(exit, std::max(t1, t2));
+  }
+  return entry <= exit;
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+bool BoundingVolumeHierarchy<Scalar, DIM>::intersectRay_(
+  const Box & box,
+  const PointType & origin,
+  const PointType & direction,
+  const PointType & inverseDirection,
+  const Scalar & maximalDistance,
+  Scalar & entry)
+{
+  if (box.isOriented) {
+    // Ray is expressed in box frame
+    const PointType localDirection = box.rotation.transpose() * direction;
+    return intersectRay_(
+      -box.halfWidthExtents, box.halfWidthExtents,
+      box.rotation.transpose() * (origin - box.centerPosition),
+      localDirection.cwiseInverse(), maximalDistance, entry);
+  } else {
+    return intersectRay_(
+      box.lower, box.upper, origin, inverseDirection, maximalDistance, entry);
+  }
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+bool BoundingVolumeHierarchy<Scalar, DIM>::findFirstRayIntersection(
+  const PointType & origin,
+  const PointType & direction,
+  const Scalar & maximalDistance,
+  size_t & boxIndex,
+  Scalar & distance) const
+{
+  boxIndex = NO_BOX;
+  distance = maximalDistance;
+  if (nodes_.empty()) {
+    return false;
+  }
+
+  const PointType inverseDirection = direction.cwiseInverse();
+
+  // Nodes are visited nearest first and discarded when they are entered
+  // farther than the closest hit, equal hits are broken by box index
+  std::array<std::pair<size_t, Scalar>, MAXIMAL_DEPTH + 1> stack;
+  size_t stackSize = 0;
+  Scalar entry;
+  if (intersectRay_(nodes_[0].lower, nodes_[0].upper, origin, inverseDirection,
+    maximalDistance, entry))
+  {
+    stack[stackSize++] = {0, entry};
+  }
+
+  while (stackSize != 0) {
+    const auto [nodeIndex, nodeEntry] = stack[--stackSize];
+    if (nodeEntry > distance) {
+      continue;
+    }
+
+    const Node & node = nodes_[nodeIndex];
+    if (node.numberOfBoxes != 0) {
+      for (size_t k = node.first; k < node.first + node.numberOfBoxes; ++k) {
+        const size_t index = boxIndexes_[k];
+        if (intersectRay_(boxes_[index], origin, direction, inverseDirection, distance, entry) &&
+          (entry < distance || index < boxIndex))
+        {
+          boxIndex = index;
+          distance = entry;
+        }
+      }
+    } else {
+      Scalar entries[2];
+      bool hits[2];
+      for (size_t c = 0; c < 2; ++c) {
+        const Node & child = nodes_[node.first + c];
+        hits[c] = intersectRay_(child.lower, child.upper, origin, inverseDirection,
+          distance, entries[c]);
+      }
+
+      const size_t nearest = hits[1] && (!hits[0] || entries[1] < entries[0]);
+      if (hits[1 - nearest]) {
+        stack[stackSize++] = {node.first + 1 - nearest, entries[1 - nearest]};
+      }
+      if (hits[nearest]) {
+        stack[stackSize++] = {node.first + nearest, entries[nearest]};
+      }
+    }
+  }
+
+  if (boxIndex == NO_BOX) {
+    distance = std::numeric_limits<Scalar>::infinity();
+    return false;
+  }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+void BoundingVolumeHierarchy<Scalar, DIM>::findContainingBoxes(
+  const PointSetType & points,
+  std::vector<size_t> & boxIndexes) const
+{
+  boxIndexes.resize(points.size());
+  const size_t numberOfThreads = computeNumberOfThreads(
+    points.size(), MINIMAL_NUMBER_OF_QUERIES_PER_THREAD, maximalNumberOfThreads_);
+
+  parallelFor(
+    points.size(), numberOfThreads,
+    [&](const size_t & /*threadIndex*/, const size_t & begin, const size_t & end) {
+      for (size_t n = begin; n < end; ++n) {
+        const PointType & point = points[n];
+        size_t & lowestBoxIndex = boxIndexes[n];
+        lowestBoxIndex = NO_BOX;
+        traverse_(
+          [&](const PointType & lower, const PointType & upper) {
+            return (point.array() >= lower.array()).all() &&
+            (point.array() <= upper.array()).all();
+          },
+          [&](const size_t & boxIndex) {
+            if (boxIndex < lowestBoxIndex && isInside_(boxes_[boxIndex], point)) {
+              lowestBoxIndex = boxIndex;
+            }
+          });
+      }
+    });
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+void BoundingVolumeHierarchy<Scalar, DIM>::castRays(
+  const PointSetType & origins,
+  const PointSetType & directions,
+  const Scalar & maximalDistance,
+  std::vector<size_t> & boxIndexes,
+  std::vector<Scalar> & distances) const
+{
+  assert(origins.size() == directions.size());
+  boxIndexes.resize(origins.size());
+  distances.resize(origins.size());
+  const size_t numberOfThreads = computeNumberOfThreads(
+    origins.size(), MINIMAL_NUMBER_OF_QUERIES_PER_THREAD, maximalNumberOfThreads_);
+
+  parallelFor(
+    origins.size(), numberOfThreads,
+    [&](const size_t & /*threadIndex*/, const size_t & begin, const size_t & end) {
+      for (size_t n = begin; n < end; ++n) {
+        findFirstRayIntersection(
+          origins[n], directions[n], maximalDistance, boxIndexes[n], distances[n]);
+      }
+    });
+}
+
+template class BoundingVolumeHierarchy<float, 2>;
+template class BoundingVolumeHierarchy<float, 3>;
+template class BoundingVolumeHierarchy<double, 2>;
+template class BoundingVolumeHierarchy<double, 3>;
+
+}  // namespace core
+}  // namespace romea
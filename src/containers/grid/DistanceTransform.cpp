@@ -0,0 +1,417 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+// std
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+// local
+#include "romea_core_common/containers/grid/DistanceTransform.hpp"
+
+namespace romea
+{
+namespace core
+{
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+DistanceTransform<Scalar, DIM>::DistanceTransform(
+  const CellIndexes & numberOfCellsAlongAxes,
+  const Scalar & cellResolution,
+  const Scalar & maximalDistance)
+: cellResolution_(cellResolution),
+  maximalDistance_(maximalDistance),
+  maximalSquaredDistance_(std::pow(maximalDistance / cellResolution, 2)),
+  maximalDistanceInCells_(std::numeric_limits<size_t>::max()),
+  maximalNumberOfThreads_(getDefaultNumberOfThreads()),
+  squaredDistances_(numberOfCellsAlongAxes),
+  isFullUpdateRequired_(true),
+  hasChangedCells_(false),
+  changedCellsBox_(),
+  changedBoxes_(),
+  window_(),
+  windowNumberOfCells_(CellIndexes::Zero()),
+  windowBuffer_()
+{
+  assert(cellResolution > 0);
+  assert(maximalDistance > 0);
+  if (std::isfinite(maximalDistance)) {
+    maximalDistanceInCells_ = std::ceil(maximalDistance / cellResolution);
+  }
+  squaredDistances_.setValue(maximalSquaredDistance_);
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+void DistanceTransform<Scalar, DIM>::setMaximalNumberOfThreads(
+  const size_t & maximalNumberOfThreads)
+{
+  maximalNumberOfThreads_ = std::max(size_t(1), maximalNumberOfThreads);
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+const Scalar & DistanceTransform<Scalar, DIM>::getCellResolution() const
+{
+  return cellResolution_;
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+const Scalar & DistanceTransform<Scalar, DIM>::getMaximalDistance() const
+{
+  return maximalDistance_;
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+void DistanceTransform<Scalar, DIM>::markChangedCell(const CellIndexes & cellIndexes)
+{
+  assert((cellIndexes.array() < squaredDistances_.getNumberOfCellsAlongAxes().array()).all());
+  if (!std::isfinite(maximalDistance_)) {
+    isFullUpdateRequired_ = true;
+  } else if (!hasChangedCells_) {
+    changedCellsBox_.first = cellIndexes;
+    changedCellsBox_.last = cellIndexes;
+    hasChangedCells_ = true;
+  } else {
+    changedCellsBox_.first = changedCellsBox_.first.cwiseMin(cellIndexes);
+    changedCellsBox_.last = changedCellsBox_.last.cwiseMax(cellIndexes);
+  }
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+void DistanceTransform<Scalar, DIM>::translate(const CellIndexesOffset & indexOffset)
+{
+  const CellIndexes & numberOfCells = squaredDistances_.getNumberOfCellsAlongAxes();
+  squaredDistances_.translate(indexOffset, maximalSquaredDistance_);
+  if (isFullUpdateRequired_ || !std::isfinite(maximalDistance_)) {
+    isFullUpdateRequired_ = true;
+    return;
+  }
+
+  // Pending changes move with the grid, parts leaving the grid are
+  // covered by removed layers
+  auto translateBox = [&](Box & box) {
+      for (size_t axis = 0; axis < DIM; ++axis) {
+        const long long first = box.first[axis] - (long long)(indexOffset[axis]);
+        const long long last = box.last[axis] - (long long)(indexOffset[axis]);
+        if (last < 0 || first >= (long long)(numberOfCells[axis])) {
+          return false;
+        }
+        box.first[axis] = std::max(first, 0LL);
+        box.last[axis] = std::min(last, (long long)(numberOfCells[axis]) - 1);
+      }
+      return true;
+    };
+
+  if (hasChangedCells_) {
+    changedBoxes_.push_back(changedCellsBox_);
+    hasChangedCells_ = false;
+  }
+  changedBoxes_.erase(
+    std::remove_if(
+      changedBoxes_.begin(), changedBoxes_.end(),
+      [&](Box & box) {return !translateBox(box);}), changedBoxes_.end());
+
+  // Along each axis, layers that left the grid were just before the first
+  // layer (positive offset) or after the last one (negative offset) and
+  // vacated layers are at the opposite side
+  for (size_t axis = 0; axis < DIM; ++axis) {
+    const long long offset = indexOffset[axis];
+    if (offset == 0) {
+      continue;
+    }
+
+    if (size_t(std::abs(offset)) >= numberOfCells[axis]) {
+      isFullUpdateRequired_ = true;
+      changedBoxes_.clear();
+      return;
+    }
+
+    Box removedLayers = computeGridBox_();
+    Box vacatedLayers = computeGridBox_();
+    if (offset > 0) {
+      removedLayers.last[axis] = 0;
+      vacatedLayers.first[axis] = numberOfCells[axis] - offset;
+    } else {
+      removedLayers.first[axis] = numberOfCells[axis] - 1;
+      vacatedLayers.last[axis] = -offset - 1;
+    }
+    changedBoxes_.push_back(removedLayers);
+    changedBoxes_.push_back(vacatedLayers);
+  }
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+Scalar DistanceTransform<Scalar, DIM>::getDistance(const CellIndexes & cellIndexes) const
+{
+  return std::sqrt(squaredDistances_(cellIndexes)) * cellResolution_;
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+const Scalar & DistanceTransform<Scalar, DIM>::getSquaredDistance(
+  const CellIndexes & cellIndexes) const
+{
+  return squaredDistances_(cellIndexes);
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+const WrappableGrid<Scalar, DIM> & DistanceTransform<Scalar, DIM>::getSquaredDistances() const
+{
+  return squaredDistances_;
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+void DistanceTransform<Scalar, DIM>::computeInflationLayer(
+  const Scalar & inscribedRadius,
+  const Scalar & inflationRadius,
+  const Scalar & costScalingFactor,
+  Grid<std::uint8_t, DIM> & costs) const
+{
+  assert(inscribedRadius <= inflationRadius);
+  const CellIndexes & numberOfCells = squaredDistances_.getNumberOfCellsAlongAxes();
+  if (costs.getNumberOfCellsAlongAxes() != numberOfCells) {
+    costs.init(numberOfCells);
+  }
+
+  const size_t numberOfSlabs = DIM == 3 ? numberOfCells[DIM - 1] : 1;
+  CellIndexes cellIndexes;
+  for (size_t z = 0; z < numberOfSlabs; ++z) {
+    if constexpr (DIM == 3) {
+      cellIndexes[2] = z;
+    }
+    for (cellIndexes[1] = 0; cellIndexes[1] < numberOfCells[1]; ++cellIndexes[1]) {
+      std::uint8_t * cost = costs.getRow(cellIndexes[1], z);
+      for (cellIndexes[0] = 0; cellIndexes[0] < numberOfCells[0]; ++cellIndexes[0], ++cost) {
+        *cost = computeInflationCost_(
+          squaredDistances_(cellIndexes), inscribedRadius, inflationRadius, costScalingFactor);
+      }
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+void DistanceTransform<Scalar, DIM>::computeInflationLayer(
+  const Scalar & inscribedRadius,
+  const Scalar & inflationRadius,
+  const Scalar & costScalingFactor,
+  WrappableGrid<std::uint8_t, DIM> & costs) const
+{
+  assert(inscribedRadius <= inflationRadius);
+  const CellIndexes & numberOfCells = squaredDistances_.getNumberOfCellsAlongAxes();
+  assert(costs.getNumberOfCellsAlongAxes() == numberOfCells);
+
+  // Logical rows of a wrappable grid are not contiguous in memory, cells are
+  // written one by one
+  const size_t numberOfSlabs = DIM == 3 ? numberOfCells[DIM - 1] : 1;
+  CellIndexes cellIndexes;
+  for (size_t z = 0; z < numberOfSlabs; ++z) {
+    if constexpr (DIM == 3) {
+      cellIndexes[2] = z;
+    }
+    for (cellIndexes[1] = 0; cellIndexes[1] < numberOfCells[1]; ++cellIndexes[1]) {
+      for (cellIndexes[0] = 0; cellIndexes[0] < numberOfCells[0]; ++cellIndexes[0]) {
+        costs(cellIndexes) = computeInflationCost_(
+          squaredDistances_(cellIndexes), inscribedRadius, inflationRadius, costScalingFactor);
+      }
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+std::uint8_t DistanceTransform<Scalar, DIM>::computeInflationCost_(
+  const Scalar & squaredDistance,
+  const Scalar & inscribedRadius,
+  const Scalar & inflationRadius,
+  const Scalar & costScalingFactor) const
+{
+  const Scalar distance = std::sqrt(squaredDistance) * cellResolution_;
+  if (squaredDistance == 0) {
+    return INFLATION_LAYER_LETHAL_COST;
+  } else if (distance <= inscribedRadius) {
+    return INFLATION_LAYER_INSCRIBED_COST;
+  } else if (distance <= inflationRadius) {
+    return static_cast<std::uint8_t>((INFLATION_LAYER_INSCRIBED_COST - 1) *
+           std::exp(-costScalingFactor * (distance - inscribedRadius)));
+  } else {
+    return INFLATION_LAYER_FREE_COST;
+  }
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+typename DistanceTransform<Scalar, DIM>::Box
+DistanceTransform<Scalar, DIM>::computeGridBox_() const
+{
+  Box box;
+  box.first = CellIndexes::Zero();
+  box.last = squaredDistances_.getNumberOfCellsAlongAxes() - CellIndexes::Ones();
+  return box;
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+typename DistanceTransform<Scalar, DIM>::Box
+DistanceTransform<Scalar, DIM>::expandBox_(const Box & box) const
+{
+  const CellIndexes & numberOfCells = squaredDistances_.getNumberOfCellsAlongAxes();
+  Box expandedBox;
+  for (size_t i = 0; i < DIM; ++i) {
+    expandedBox.first[i] = box.first[i] - std::min(box.first[i], maximalDistanceInCells_);
+    expandedBox.last[i] = box.last[i] +
+      std::min(numberOfCells[i] - 1 - box.last[i], maximalDistanceInCells_);
+  }
+  return expandedBox;
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+void DistanceTransform<Scalar, DIM>::transformWindow_()
+{
+  // One dimensional transforms along x rows then y and z columns
+  size_t stride = 1;
+  for (size_t axis = 0; axis < DIM; ++axis) {
+    const size_t size = windowNumberOfCells_[axis];
+    const size_t numberOfLines = windowBuffer_.size() / size;
+    const size_t numberOfThreads = computeNumberOfThreads(
+      numberOfLines, MINIMAL_NUMBER_OF_LINES_PER_THREAD, maximalNumberOfThreads_);
+
+    parallelFor(
+      numberOfLines, numberOfThreads,
+      [&](const size_t & /*threadIndex*/, const size_t & begin, const size_t & end) {
+        std::vector<size_t> vertices(size);
+        std::vector<Scalar> bounds(size + 1);
+        std::vector<Scalar> values(size);
+        for (size_t line = begin; line < end; ++line) {
+          const size_t first = line % stride + (line / stride) * stride * size;
+          transformLine_(windowBuffer_.data() + first, stride, size, vertices, bounds, values);
+        }
+      });
+
+    stride *= size;
+  }
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+void DistanceTransform<Scalar, DIM>::transformLine_(
+  Scalar * line,
+  const size_t & stride,
+  const size_t & size,
+  std::vector<size_t> & vertices,
+  std::vector<Scalar> & bounds,
+  std::vector<Scalar> & values) const
+{
+  for (size_t q = 0; q < size; ++q) {
+    values[q] = line[q * stride];
+  }
+
+  // Lower envelope of parabolas rooted at cells of finite value,
+  // parabola k being the lowest one between bounds[k] and bounds[k+1]
+  auto intersection = [&](const size_t & q, const size_t & v) {
+      return (values[q] + Scalar(q * q) - values[v] - Scalar(v * v)) / Scalar(2 * (q - v));
+    };
+
+  size_t k = 0;
+  bool isEmpty = true;
+  for (size_t q = 0; q < size; ++q) {
+    if (std::isinf(values[q])) {
+      continue;
+    }
+
+    if (isEmpty) {
+      vertices[0] = q;
+      bounds[0] = -std::numeric_limits<Scalar>::infinity();
+      bounds[1] = std::numeric_limits<Scalar>::infinity();
+      isEmpty = false;
+      continue;
+    }
+
+    Scalar s = intersection(q, vertices[k]);
+    while (k > 0 && s <= bounds[k]) {
+      --k;
+      s = intersection(q, vertices[k]);
+    }
+    ++k;
+    vertices[k] = q;
+    bounds[k] = s;
+    bounds[k + 1] = std::numeric_limits<Scalar>::infinity();
+  }
+
+  if (isEmpty) {
+    return;
+  }
+
+  k = 0;
+  for (size_t q = 0; q < size; ++q) {
+    while (bounds[k + 1] < Scalar(q)) {
+      ++k;
+    }
+    const Scalar distance = Scalar(q) - Scalar(vertices[k]);
+    line[q * stride] = distance * distance + values[vertices[k]];
+  }
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+void DistanceTransform<Scalar, DIM>::storeWindow_(const Box & region)
+{
+  const CellIndexes regionNumberOfCells = region.last - region.first + CellIndexes::Ones();
+  const CellIndexes regionOffset = region.first - window_.first;
+  const size_t numberOfRows = regionNumberOfCells.array().prod() / regionNumberOfCells[0];
+  const size_t numberOfThreads = computeNumberOfThreads(
+    numberOfRows, MINIMAL_NUMBER_OF_LINES_PER_THREAD, maximalNumberOfThreads_);
+
+  parallelFor(
+    numberOfRows, numberOfThreads,
+    [&](const size_t & /*threadIndex*/, const size_t & begin, const size_t & end) {
+      CellIndexes cellIndexes = region.first;
+      for (size_t row = begin; row < end; ++row) {
+        size_t windowRow = regionOffset[1] + row % regionNumberOfCells[1];
+        cellIndexes[1] = region.first[1] + row % regionNumberOfCells[1];
+        if constexpr (DIM == 3) {
+          windowRow += (regionOffset[2] + row / regionNumberOfCells[1]) * windowNumberOfCells_[1];
+          cellIndexes[2] = region.first[2] + row / regionNumberOfCells[1];
+        }
+
+        const Scalar * value = windowBuffer_.data() + windowRow * windowNumberOfCells_[0] +
+          regionOffset[0];
+        for (size_t x = 0; x < regionNumberOfCells[0]; ++x, ++value) {
+          cellIndexes[0] = region.first[0] + x;
+          squaredDistances_(cellIndexes) = std::min(*value, maximalSquaredDistance_);
+        }
+      }
+    });
+}
+
+template class DistanceTransform<float, 2>;
+template class DistanceTransform<float, 3>;
+template class DistanceTransform<double, 2>;
+template class DistanceTransform<double, 3>;
+
+}  // namespace core
+}  // namespace romea
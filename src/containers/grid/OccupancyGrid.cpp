@@ -0,0 +1,299 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// std
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+// romea
+#include "romea_core_common/containers/grid/OccupancyGrid.hpp"
+#include "romea_core_common/concurrency/ParallelFor.hpp"
+
+namespace romea
+{
+namespace core
+{
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM, typename CellType>
+OccupancyGrid<Scalar, DIM, CellType>::OccupancyGrid(
+  const Scalar & maximalRange,
+  const Scalar & cellResolution)
+: hitProbability_(OCCUPANCY_GRID_DEFAULT_HIT_PROBABILITY),
+  missProbability_(OCCUPANCY_GRID_DEFAULT_MISS_PROBABILITY),
+  minimalProbability_(OCCUPANCY_GRID_DEFAULT_MINIMAL_PROBABILITY),
+  maximalProbability_(OCCUPANCY_GRID_DEFAULT_MAXIMAL_PROBABILITY),
+  maximalSensorRange_(std::numeric_limits<Scalar>::max()),
+  maximalNumberOfThreads_(getDefaultNumberOfThreads()),
+  cellsPerLogOdds_(0),
+  hitIncrement_(0),
+  missIncrement_(0),
+  minimalCellValue_(0),
+  maximalCellValue_(0),
+  centerPosition_(PointType::Zero()),
+  halfExtent_(0),
+  gridIndexMapping_(maximalRange, cellResolution),
+  grid_(gridIndexMapping_.getNumberOfCellsAlongAxes()),
+  scanRayCasting_(&gridIndexMapping_),
+  localScanPoints_(),
+  statistics_()
+{
+  // Grid has the same odd number of cells along each axis, center cell is
+  // centered on origin
+  halfExtent_ = gridIndexMapping_.getNumberOfCellsAlongAxes()[0] * cellResolution / 2;
+  updateCellIncrements_();
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM, typename CellType>
+void OccupancyGrid<Scalar, DIM, CellType>::setHitProbability(const Scalar & hitProbability)
+{
+  hitProbability_ = hitProbability;
+  updateCellIncrements_();
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM, typename CellType>
+void OccupancyGrid<Scalar, DIM, CellType>::setMissProbability(const Scalar & missProbability)
+{
+  missProbability_ = missProbability;
+  updateCellIncrements_();
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM, typename CellType>
+void OccupancyGrid<Scalar, DIM, CellType>::setClampingProbabilities(
+  const Scalar & minimalProbability,
+  const Scalar & maximalProbability)
+{
+  minimalProbability_ = minimalProbability;
+  maximalProbability_ = maximalProbability;
+
+  // Clamping bounds give the fixed point scale, stored cells are rescaled
+  // in order to keep their log odds
+  const Scalar previousCellsPerLogOdds = cellsPerLogOdds_;
+  updateCellIncrements_();
+
+  const Scalar scale = cellsPerLogOdds_ / previousCellsPerLogOdds;
+  if (scale != 1) {
+    for (CellType & cell : grid_.getBuffer()) {
+      cell = static_cast<CellType>(std::clamp(
+          int(std::lround(cell * scale)), minimalCellValue_, maximalCellValue_));
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM, typename CellType>
+void OccupancyGrid<Scalar, DIM, CellType>::setMaximalSensorRange(
+  const Scalar & maximalSensorRange)
+{
+  maximalSensorRange_ = maximalSensorRange;
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM, typename CellType>
+void OccupancyGrid<Scalar, DIM, CellType>::setMaximalNumberOfThreads(
+  const size_t & maximalNumberOfThreads)
+{
+  maximalNumberOfThreads_ = std::max(size_t(1), maximalNumberOfThreads);
+  scanRayCasting_.setMaximalNumberOfThreads(maximalNumberOfThreads_);
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM, typename CellType>
+Scalar OccupancyGrid<Scalar, DIM, CellType>::logit_(const Scalar & probability)
+{
+  return std::log(probability / (1 - probability));
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM, typename CellType>
+void OccupancyGrid<Scalar, DIM, CellType>::updateCellIncrements_()
+{
+  assert(0 < minimalProbability_ && minimalProbability_ < 0.5);
+  assert(0.5 < maximalProbability_ && maximalProbability_ < 1);
+  assert(missProbability_ < 0.5 && hitProbability_ > 0.5);
+
+  // Clamping bounds use the whole cell type range
+  const Scalar maximalLogOdds = std::max(-logit_(minimalProbability_), logit_(maximalProbability_));
+  cellsPerLogOdds_ = std::numeric_limits<CellType>::max() / maximalLogOdds;
+
+  auto toCellValue = [this](const Scalar & probability) {
+      return int(std::lround(logit_(probability) * cellsPerLogOdds_));
+    };
+
+  hitIncrement_ = std::max(1, toCellValue(hitProbability_));
+  missIncrement_ = std::min(-1, toCellValue(missProbability_));
+  minimalCellValue_ = toCellValue(minimalProbability_);
+  maximalCellValue_ = toCellValue(maximalProbability_);
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM, typename CellType>
+void OccupancyGrid<Scalar, DIM, CellType>::moveTo(const PointType & position)
+{
+  const Scalar & cellResolution = gridIndexMapping_.getCellResolution();
+  const CellIndexesOffset offset =
+    ((position - centerPosition_) / cellResolution).array().round().template cast<int>();
+
+  if (!offset.isZero()) {
+    grid_.translate(offset, CellType(0));
+    centerPosition_ += offset.template cast<Scalar>() * cellResolution;
+  }
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM, typename CellType>
+template<typename CellFunction>
+void OccupancyGrid<Scalar, DIM, CellType>::updateCells_(
+  const VectorOfEigenVector<CellIndexes> & cells,
+  CellFunction && cellFunction)
+{
+  // Cells are unique so they can be updated concurrently
+  const size_t numberOfThreads = computeNumberOfThreads(
+    cells.size(), MINIMAL_NUMBER_OF_CELLS_PER_THREAD, maximalNumberOfThreads_);
+
+  parallelFor(
+    cells.size(), numberOfThreads,
+    [&](const size_t &, const size_t & begin, const size_t & end) {
+      for (size_t n = begin; n < end; ++n) {
+        CellType & cell = grid_(cells[n]);
+        cell = CellType(cellFunction(int(cell)));
+      }
+    });
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM, typename CellType>
+void OccupancyGrid<Scalar, DIM, CellType>::integrateScan(
+  const PointType & sensorPosition,
+  const PointSetType & scanPoints)
+{
+  assert(isInside(sensorPosition));
+  const PointType localSensorPosition = sensorPosition - centerPosition_;
+
+  // Rays are truncated before leaving the grid
+  const Scalar rangeInsideGrid = halfExtent_ - localSensorPosition.cwiseAbs().maxCoeff() -
+    gridIndexMapping_.getCellResolution();
+  scanRayCasting_.setMaximalRange(
+    std::max(Scalar(0), std::min(maximalSensorRange_, rangeInsideGrid)));
+
+  localScanPoints_.resize(scanPoints.size());
+  for (size_t n = 0; n < scanPoints.size(); ++n) {
+    localScanPoints_[n] = scanPoints[n] - centerPosition_;
+  }
+
+  TimePoint start = now();
+  scanRayCasting_.computeFreeAndOccupiedCells(localSensorPosition, localScanPoints_);
+  TimePoint rayCastingEnd = now();
+
+  updateCells_(
+    scanRayCasting_.getFreeCells(), [this](const int & cell) {
+      return std::max(cell + missIncrement_, minimalCellValue_);
+    });
+  updateCells_(
+    scanRayCasting_.getOccupiedCells(), [this](const int & cell) {
+      return std::min(cell + hitIncrement_, maximalCellValue_);
+    });
+
+  statistics_.numberOfRays = scanPoints.size();
+  statistics_.numberOfFreeCells = scanRayCasting_.getFreeCells().size();
+  statistics_.numberOfOccupiedCells = scanRayCasting_.getOccupiedCells().size();
+  statistics_.rayCastingDuration = duration(rayCastingEnd, start);
+  statistics_.updateDuration = duration(now(), rayCastingEnd);
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM, typename CellType>
+bool OccupancyGrid<Scalar, DIM, CellType>::isInside(const PointType & position) const
+{
+  return ((position - centerPosition_).cwiseAbs().array() < halfExtent_).all();
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM, typename CellType>
+typename OccupancyGrid<Scalar, DIM, CellType>::CellIndexes
+OccupancyGrid<Scalar, DIM, CellType>::computeCellIndexes(const PointType & position) const
+{
+  assert(isInside(position));
+  return gridIndexMapping_.computeCellIndexes(position - centerPosition_);
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM, typename CellType>
+Scalar OccupancyGrid<Scalar, DIM, CellType>::getLogOdds(const CellIndexes & cellIndexes) const
+{
+  return grid_(cellIndexes) / cellsPerLogOdds_;
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM, typename CellType>
+Scalar OccupancyGrid<Scalar, DIM, CellType>::getLogOdds(const PointType & position) const
+{
+  return getLogOdds(computeCellIndexes(position));
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM, typename CellType>
+Scalar OccupancyGrid<Scalar, DIM, CellType>::getOccupancyProbability(
+  const PointType & position) const
+{
+  return 1 / (1 + std::exp(-getLogOdds(position)));
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM, typename CellType>
+const typename OccupancyGrid<Scalar, DIM, CellType>::PointType &
+OccupancyGrid<Scalar, DIM, CellType>::getCenterPosition() const
+{
+  return centerPosition_;
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM, typename CellType>
+const GridIndexMapping<Scalar, DIM> &
+OccupancyGrid<Scalar, DIM, CellType>::getGridIndexMapping() const
+{
+  return gridIndexMapping_;
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM, typename CellType>
+const WrappableGrid<CellType, DIM> & OccupancyGrid<Scalar, DIM, CellType>::getGrid() const
+{
+  return grid_;
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM, typename CellType>
+const OccupancyGridStatistics & OccupancyGrid<Scalar, DIM, CellType>::getStatistics() const
+{
+  return statistics_;
+}
+
+template class OccupancyGrid<float, 2, std::int8_t>;
+template class OccupancyGrid<float, 2, std::int16_t>;
+template class OccupancyGrid<float, 3, std::int8_t>;
+template class OccupancyGrid<float, 3, std::int16_t>;
+template class OccupancyGrid<double, 2, std::int8_t>;
+template class OccupancyGrid<double, 2, std::int16_t>;
+template class OccupancyGrid<double, 3, std::int8_t>;
+template class OccupancyGrid<double, 3, std::int16_t>;
+
+}  // namespace core
+}  // namespace romea
@@ -14,7 +14,7 @@
 
 
 // std
-#include <limits>
+#include <cmath>
 
 // local
 #include "romea_core_common/containers/grid/RayTracing.hpp"
@@ -40,9 +40,9 @@ RayCasting<Scalar, DIM>::RayCasting(GridIndexMapping<Scalar, DIM> * gridIndexMap
   rayEndPoint_(PointType::Zero()),
   rayOriginIndexes_(CellIndexes::Zero()),
   rayEndIndexes_(CellIndexes::Zero()),
-  rayTMax_(PointType::Zero()),
-  rayTDelta_(PointType::Zero()),
-  rayDirection_(PointType::Zero()),
+  rayOriginCellLowerCorner_(PointType::Zero()),
+  rayTMax_(FixedPointVector::Zero()),
+  rayTDelta_(FixedPointVector::Zero()),
   rayStep_(Eigen::Matrix<int, DIM, 1>::Zero())
 {
 }
@@ -62,6 +62,10 @@ RayCasting<Scalar, DIM>::setOriginPoint(const PointType & originPoint)
 {
   rayOriginPoint_ = originPoint;
   rayOriginIndexes_ = gridIndexMapping_->computeCellIndexes(rayOriginPoint_);
+
+  // cached once per origin so that setEndPoint does no cell center lookup
+  rayOriginCellLowerCorner_ = gridIndexMapping_->computeCellCenterPosition(rayOriginIndexes_);
+  rayOriginCellLowerCorner_.array() -= gridIndexMapping_->getCellResolution() * Scalar(0.5);
 }
 
 //-----------------------------------------------------------------------------
@@ -98,34 +102,38 @@ RayCasting<Scalar, DIM>::setEndPoint(const PointType & endPoint)
   rayEndPoint_ = endPoint;
   rayEndIndexes_ = gridIndexMapping_->computeCellIndexes(rayEndPoint_);
 
-  PointType rayOriginCellCenterPosition =
-    gridIndexMapping_->computeCellCenterPosition(rayOriginIndexes_);
-
-  PointType direction = rayEndPoint_ - rayOriginPoint_;
-  Scalar range = direction.norm();
-  rayDirection_ = direction / range;
+  const Scalar resolution = gridIndexMapping_->getCellResolution();
+  const PointType direction = rayEndPoint_ - rayOriginPoint_;
 
   for (int i = 0; i < static_cast<int>(DIM); ++i) {
-    // compute step direction
-    if (rayDirection_[i] > 0) {
-      rayStep_[i] = 1;
-    } else if (rayDirection_[i] < 0) {
-      rayStep_[i] = -1;
+    if (direction[i] != 0 && rayOriginIndexes_[i] != rayEndIndexes_[i]) {
+      // distances to the next voxel border and between two borders
+      // expressed in ray length units
+      const Scalar inverseDirection = 1 / direction[i];
+      rayStep_[i] = direction[i] > 0 ? 1 : -1;
+      Scalar voxelBorder = rayOriginCellLowerCorner_[i] + (direction[i] > 0 ? resolution : 0);
+      rayTMax_[i] = toFixedPoint_((voxelBorder - rayOriginPoint_[i]) * inverseDirection);
+      rayTDelta_[i] = toFixedPoint_(resolution * std::abs(inverseDirection));
     } else {
       rayStep_[i] = 0;
+      rayTMax_[i] = FIXED_POINT_INFINITY;
+      rayTDelta_[i] = FIXED_POINT_INFINITY;
     }
+  }
+}
 
-    // compute rayTMax_, tDelta
-    if (rayStep_[i] != 0) {
-      // corner point of voxel (in direction of ray)
-      Scalar voxelBorder = rayOriginCellCenterPosition[i];
-      voxelBorder += (rayStep_[i] * gridIndexMapping_->getCellResolution() * Scalar(0.5));
-      rayTMax_[i] = (voxelBorder - rayOriginPoint_[i]) / rayDirection_[i];
-      rayTDelta_[i] = gridIndexMapping_->getCellResolution() / std::abs(rayDirection_[i]);
-    } else {
-      rayTMax_[i] = std::numeric_limits<Scalar>::max();
-      rayTDelta_[i] = std::numeric_limits<Scalar>::max();
-    }
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+std::uint64_t RayCasting<Scalar, DIM>::toFixedPoint_(const Scalar & t)
+{
+  constexpr Scalar SCALE = Scalar(std::uint64_t(1) << FIXED_POINT_SHIFT);
+  constexpr Scalar MAXIMAL_T = Scalar(FIXED_POINT_INFINITY >> FIXED_POINT_SHIFT);
+  if (!(t > 0)) {
+    return 0;
+  } else if (t >= MAXIMAL_T) {
+    return FIXED_POINT_INFINITY;
+  } else {
+    return static_cast<std::uint64_t>(t * SCALE);
   }
 }
 
@@ -184,82 +192,6 @@ RayCasting<Scalar, DIM>::cast(const PointType & originPoint, const PointType & e
   return cast(endPoint);
 }
 
-// TODO(Jean) factoriser en utilisant const expr if
-//-----------------------------------------------------------------------------
-template<>
-void RayCasting<float, 2>::next(CellIndexes & cellIndexes)
-{
-  // find minimum rayTMax_
-  // increment current position
-  if (rayTMax_[0] < rayTMax_[1]) {
-    cellIndexes[0] += rayStep_[0];
-    rayTMax_[0] += rayTDelta_[0];
-  } else {
-    cellIndexes[1] += rayStep_[1];
-    rayTMax_[1] += rayTDelta_[1];
-  }
-}
-
-template<>
-void RayCasting<double, 2>::next(CellIndexes & cellIndexes)
-{
-  // find minimum rayTMax_
-  // increment current position
-  if (rayTMax_[0] < rayTMax_[1]) {
-    cellIndexes[0] += rayStep_[0];
-    rayTMax_[0] += rayTDelta_[0];
-  } else {
-    cellIndexes[1] += rayStep_[1];
-    rayTMax_[1] += rayTDelta_[1];
-  }
-}
-
-template<>
-void RayCasting<float, 3>::next(CellIndexes & cellIndexes)
-{
-  // find minimum tMax:
-  if (rayTMax_[0] < rayTMax_[1]) {
-    if (rayTMax_[0] < rayTMax_[2]) {
-      cellIndexes[0] += rayStep_[0];
-      rayTMax_[0] += rayTDelta_[0];
-    } else {
-      cellIndexes[2] += rayStep_[2];
-      rayTMax_[2] += rayTDelta_[2];
-    }
-  } else {
-    if (rayTMax_[1] < rayTMax_[2]) {
-      cellIndexes[1] += rayStep_[1];
-      rayTMax_[1] += rayTDelta_[1];
-    } else {
-      cellIndexes[2] += rayStep_[2];
-      rayTMax_[2] += rayTDelta_[2];
-    }
-  }
-}
-
-template<>
-void RayCasting<double, 3>::next(CellIndexes & cellIndexes)
-{
-  // find minimum tMax:
-  if (rayTMax_[0] < rayTMax_[1]) {
-    if (rayTMax_[0] < rayTMax_[2]) {
-      cellIndexes[0] += rayStep_[0];
-      rayTMax_[0] += rayTDelta_[0];
-    } else {
-      cellIndexes[2] += rayStep_[2];
-      rayTMax_[2] += rayTDelta_[2];
-    }
-  } else {
-    if (rayTMax_[1] < rayTMax_[2]) {
-      cellIndexes[1] += rayStep_[1];
-      rayTMax_[1] += rayTDelta_[1];
-    } else {
-      cellIndexes[2] += rayStep_[2];
-      rayTMax_[2] += rayTDelta_[2];
-    }
-  }
-}
-
 template class RayCasting<float, 2>;
 template class RayCasting<float, 3>;
 template class RayCasting<double, 2>;
@@ -0,0 +1,250 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// std
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+// local
+#include "romea_core_common/containers/grid/ScanRayCasting.hpp"
+
+namespace romea
+{
+namespace core
+{
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+ScanRayCasting<Scalar, DIM>::ScanRayCasting()
+: ScanRayCasting<Scalar, DIM>(nullptr)
+{
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+ScanRayCasting<Scalar, DIM>::ScanRayCasting(GridIndexMapping<Scalar, DIM> * gridIndexMapping)
+: gridIndexMapping_(gridIndexMapping),
+  maximalNumberOfThreads_(getDefaultNumberOfThreads()),
+  maximalRange_(std::numeric_limits<Scalar>::max()),
+  threadRayCastings_(),
+  scanMinimalCellIndexes_(CellIndexes::Zero()),
+  scanNumberOfCells_(CellIndexes::Zero()),
+  occupiedCellsBitmap_(),
+  freeCellsBitmap_(),
+  freeCellsBitmapSize_(0),
+  threadFreeCells_(),
+  freeCells_(),
+  occupiedCells_()
+{
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+void ScanRayCasting<Scalar, DIM>::setGridIndexMapping(
+  GridIndexMapping<Scalar, DIM> * gridIndexMapping)
+{
+  gridIndexMapping_ = gridIndexMapping;
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+void ScanRayCasting<Scalar, DIM>::setMaximalNumberOfThreads(
+  const size_t & maximalNumberOfThreads)
+{
+  maximalNumberOfThreads_ = std::max(size_t(1), maximalNumberOfThreads);
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+void ScanRayCasting<Scalar, DIM>::setMaximalRange(const Scalar & maximalRange)
+{
+  maximalRange_ = maximalRange;
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+const Scalar & ScanRayCasting<Scalar, DIM>::getMaximalRange() const
+{
+  return maximalRange_;
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+bool ScanRayCasting<Scalar, DIM>::computeRayEndPoint_(
+  const PointType & originPoint,
+  const PointType & endPoint,
+  PointType & rayEndPoint) const
+{
+  const PointType direction = endPoint - originPoint;
+  const Scalar squaredRange = direction.squaredNorm();
+  if (squaredRange <= maximalRange_ * maximalRange_) {
+    rayEndPoint = endPoint;
+    return true;
+  }
+
+  rayEndPoint = originPoint + direction * (maximalRange_ / std::sqrt(squaredRange));
+  return false;
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+size_t ScanRayCasting<Scalar, DIM>::computeNumberOfThreads(const size_t & numberOfRays) const
+{
+  return core::computeNumberOfThreads(
+    numberOfRays, MINIMAL_NUMBER_OF_RAYS_PER_THREAD, maximalNumberOfThreads_);
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+void ScanRayCasting<Scalar, DIM>::initScanCellBox_(
+  const PointType & originPoint,
+  const PointSetType & endPoints)
+{
+  // Rays stay inside the box of their extremity cells, up to one cell when
+  // extremities lie on cell borders, so the box is padded by one cell
+  // (clipped to the grid)
+  CellIndexes minimalCellIndexes = gridIndexMapping_->computeCellIndexes(originPoint);
+  CellIndexes maximalCellIndexes = minimalCellIndexes;
+  PointType rayEndPoint;
+  for (const PointType & endPoint : endPoints) {
+    computeRayEndPoint_(originPoint, endPoint, rayEndPoint);
+    const CellIndexes cellIndexes = gridIndexMapping_->computeCellIndexes(rayEndPoint);
+    minimalCellIndexes = minimalCellIndexes.cwiseMin(cellIndexes);
+    maximalCellIndexes = maximalCellIndexes.cwiseMax(cellIndexes);
+  }
+
+  const CellIndexes & numberOfCells = gridIndexMapping_->getNumberOfCellsAlongAxes();
+  for (size_t n = 0; n < DIM; ++n) {
+    if (minimalCellIndexes[n] > 0) {
+      --minimalCellIndexes[n];
+    }
+    if (maximalCellIndexes[n] + 1 < numberOfCells[n]) {
+      ++maximalCellIndexes[n];
+    }
+  }
+
+  scanMinimalCellIndexes_ = minimalCellIndexes;
+  scanNumberOfCells_ = maximalCellIndexes - minimalCellIndexes + CellIndexes::Ones();
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+size_t ScanRayCasting<Scalar, DIM>::computeScanCellLinearIndex_(
+  const CellIndexes & cellIndexes) const
+{
+  assert((cellIndexes.array() >= scanMinimalCellIndexes_.array()).all());
+  const CellIndexes scanCellIndexes = cellIndexes - scanMinimalCellIndexes_;
+  assert((scanCellIndexes.array() < scanNumberOfCells_.array()).all());
+  if constexpr (DIM == 2) {
+    return scanCellIndexes[0] + scanNumberOfCells_[0] * scanCellIndexes[1];
+  } else {
+    return scanCellIndexes[0] + scanNumberOfCells_[0] *
+           (scanCellIndexes[1] + scanNumberOfCells_[1] * scanCellIndexes[2]);
+  }
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+void ScanRayCasting<Scalar, DIM>::computeFreeAndOccupiedCells(
+  const PointType & originPoint,
+  const PointSetType & endPoints)
+{
+  initScanCellBox_(originPoint, endPoints);
+  const size_t bitmapSize = (scanNumberOfCells_.prod() + 63) / 64;
+
+  occupiedCellsBitmap_.assign(bitmapSize, 0);
+  if (freeCellsBitmapSize_ < bitmapSize) {
+    freeCellsBitmap_ = std::make_unique<std::atomic<std::uint64_t>[]>(bitmapSize);
+    freeCellsBitmapSize_ = bitmapSize;
+  }
+  for (size_t n = 0; n < bitmapSize; ++n) {
+    freeCellsBitmap_[n].store(0, std::memory_order_relaxed);
+  }
+
+  occupiedCells_.clear();
+  PointType rayEndPoint;
+  for (const PointType & endPoint : endPoints) {
+    if (!computeRayEndPoint_(originPoint, endPoint, rayEndPoint)) {
+      continue;
+    }
+
+    const CellIndexes cellIndexes = gridIndexMapping_->computeCellIndexes(rayEndPoint);
+    const size_t linearIndex = computeScanCellLinearIndex_(cellIndexes);
+    std::uint64_t & word = occupiedCellsBitmap_[linearIndex >> 6];
+    const std::uint64_t mask = std::uint64_t(1) << (linearIndex & 63);
+    if (!(word & mask)) {
+      word |= mask;
+      occupiedCells_.push_back(cellIndexes);
+    }
+  }
+
+  threadFreeCells_.resize(computeNumberOfThreads(endPoints.size()));
+  for (VectorOfEigenVector<CellIndexes> & cells : threadFreeCells_) {
+    cells.clear();
+  }
+
+  // First thread setting the bit of a free cell stores it
+  cast(
+    originPoint, endPoints,
+    [&](const size_t & threadIndex, const CellIndexes & cellIndexes, const bool & isHitCell) {
+      if (isHitCell) {
+        return;
+      }
+
+      const size_t linearIndex = computeScanCellLinearIndex_(cellIndexes);
+      const std::uint64_t mask = std::uint64_t(1) << (linearIndex & 63);
+      std::atomic<std::uint64_t> & word = freeCellsBitmap_[linearIndex >> 6];
+      if ((occupiedCellsBitmap_[linearIndex >> 6] & mask) ||
+      (word.load(std::memory_order_relaxed) & mask))
+      {
+        return;
+      }
+
+      if (!(word.fetch_or(mask, std::memory_order_relaxed) & mask)) {
+        threadFreeCells_[threadIndex].push_back(cellIndexes);
+      }
+    });
+
+  freeCells_.clear();
+  for (const VectorOfEigenVector<CellIndexes> & cells : threadFreeCells_) {
+    freeCells_.insert(freeCells_.end(), cells.begin(), cells.end());
+  }
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+const VectorOfEigenVector<typename ScanRayCasting<Scalar, DIM>::CellIndexes> &
+ScanRayCasting<Scalar, DIM>::getFreeCells() const
+{
+  return freeCells_;
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+const VectorOfEigenVector<typename ScanRayCasting<Scalar, DIM>::CellIndexes> &
+ScanRayCasting<Scalar, DIM>::getOccupiedCells() const
+{
+  return occupiedCells_;
+}
+
+template class ScanRayCasting<float, 2>;
+template class ScanRayCasting<float, 3>;
+template class ScanRayCasting<double, 2>;
+template class ScanRayCasting<double, 3>;
+
+}  // namespace core
+}  // namespace romea
@@ -13,13 +13,25 @@
 // limitations under the License.
 
 
+// std
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
 // romea
 #include "romea_core_common/geodesy/ECEFConverter.hpp"
 #include "romea_core_common/geodesy/EarthEllipsoid.hpp"
+#include "romea_core_common/concurrency/ParallelFor.hpp"
+#include "romea_core_common/math/Trigonometry.hpp"
 
 namespace
 {
 const double EPSILON = 1e-11;
+const size_t MINIMAL_NUMBER_OF_POSITIONS_PER_THREAD = 16384;
+
+// Positions are converted by blocks small enough to stay on the stack
+constexpr int BLOCK_SIZE = 64;
+using Block = Eigen::Array<double, Eigen::Dynamic, 1, Eigen::ColMajor, BLOCK_SIZE, 1>;
 }
 
 namespace romea
@@ -29,10 +41,24 @@ namespace core
 
 //--------------------------------------------------------------------------
 ECEFConverter::ECEFConverter(const EarthEllipsoid & earthEllipsoid)
-: ellipsoid_(earthEllipsoid)
+: ellipsoid_(earthEllipsoid),
+  wgs84ConversionMethod_(WGS84ConversionMethod::FIXED_POINT),
+  maximalNumberOfThreads_(getDefaultNumberOfThreads())
 {
 }
 
+//--------------------------------------------------------------------------
+void ECEFConverter::setWGS84ConversionMethod(const WGS84ConversionMethod & method)
+{
+  wgs84ConversionMethod_ = method;
+}
+
+//--------------------------------------------------------------------------
+void ECEFConverter::setMaximalNumberOfThreads(const size_t & numberOfThreads)
+{
+  maximalNumberOfThreads_ = std::max(size_t(1), numberOfThreads);
+}
+
 //--------------------------------------------------------------------------
 Eigen::Vector3d ECEFConverter::toECEF(const GeodeticCoordinates & geodeticCoordinates) const
 {
@@ -51,6 +77,17 @@ Eigen::Vector3d ECEFConverter::toECEF(const GeodeticCoordinates & geodeticCoordi
 
 //--------------------------------------------------------------------------
 GeodeticCoordinates ECEFConverter::toWGS84(const Eigen::Vector3d & ecefPosition) const
+{
+  switch (wgs84ConversionMethod_) {
+    case WGS84ConversionMethod::VERMEILLE:
+      return toWGS84ByVermeille_(ecefPosition);
+    default:
+      return toWGS84ByFixedPoint_(ecefPosition);
+  }
+}
+
+//--------------------------------------------------------------------------
+GeodeticCoordinates ECEFConverter::toWGS84ByFixedPoint_(const Eigen::Vector3d & ecefPosition) const
 {
   const double X = ecefPosition[0];
   const double Y = ecefPosition[1];
@@ -84,5 +121,106 @@ GeodeticCoordinates ECEFConverter::toWGS84(const Eigen::Vector3d & ecefPosition)
   return makeGeodeticCoordinates(latitude, longitude, altitude);
 }
 
+//--------------------------------------------------------------------------
+GeodeticCoordinates ECEFConverter::toWGS84ByVermeille_(const Eigen::Vector3d & ecefPosition) const
+{
+  const double X = ecefPosition[0];
+  const double Y = ecefPosition[1];
+  const double Z = ecefPosition[2];
+
+  const double a2 = ellipsoid_.a * ellipsoid_.a;
+  const double e2 = ellipsoid_.e2;
+  const double e4 = e2 * e2;
+
+  // Vermeille notations, r is positive outside evolute of the ellipsoid
+  const double norm = std::sqrt(X * X + Y * Y);
+  const double p = (X * X + Y * Y) / a2;
+  const double q = (1.0 - e2) * Z * Z / a2;
+  const double r = (p + q - e4) / 6.0;
+  const double s = e4 * p * q / (4.0 * r * r * r);
+  const double t = std::cbrt(1.0 + s + std::sqrt(s * (2.0 + s)));
+  const double u = r * (1.0 + t + 1.0 / t);
+  const double v = std::sqrt(u * u + e4 * q);
+  const double w = e2 * (u + v - q) / (2.0 * v);
+  const double k = std::sqrt(u + v + w * w) - w;
+  const double D = k * norm / (k + e2);
+  const double distance = std::sqrt(D * D + Z * Z);
+
+  const double longitude = std::atan2(Y, X);
+  const double latitude = 2.0 * std::atan2(Z, D + distance);
+  const double altitude = (k + e2 - 1.0) / k * distance;
+
+  return makeGeodeticCoordinates(latitude, longitude, altitude);
+}
+
+//--------------------------------------------------------------------------
+void ECEFConverter::toECEF(
+  const GeodeticCoordinatesArray & geodeticCoordinates,
+  Eigen::MatrixX3d & ecefPositions) const
+{
+  const Eigen::Index size = geodeticCoordinates.latitudes.size();
+  if (geodeticCoordinates.longitudes.size() != size ||
+    geodeticCoordinates.altitudes.size() != size)
+  {
+    throw std::invalid_argument(
+            "Latitudes, longitudes and altitudes of geodetic coordinates have different sizes");
+  }
+  ecefPositions.resize(size, 3);
+
+  const size_t numberOfThreads = computeNumberOfThreads(
+    size, MINIMAL_NUMBER_OF_POSITIONS_PER_THREAD, maximalNumberOfThreads_);
+
+  parallelFor(
+    size, numberOfThreads,
+    [&](const size_t & /*threadIndex*/, const size_t & rangeBegin, const size_t & rangeEnd) {
+      Block sinLatitudes, cosLatitudes, sinLongitudes, cosLongitudes, radii;
+      for (size_t begin = rangeBegin; begin < rangeEnd; begin += BLOCK_SIZE) {
+        const Eigen::Index first = static_cast<Eigen::Index>(begin);
+        const Eigen::Index length = static_cast<Eigen::Index>(
+          std::min(rangeEnd - begin, size_t(BLOCK_SIZE)));
+
+        sincos(geodeticCoordinates.latitudes.segment(first, length), sinLatitudes, cosLatitudes);
+        sincos(geodeticCoordinates.longitudes.segment(first, length), sinLongitudes, cosLongitudes);
+        const auto altitudes = geodeticCoordinates.altitudes.segment(first, length);
+
+        // Transversal radius of curvature
+        radii = ellipsoid_.a / (1.0 - ellipsoid_.e2 * sinLatitudes.square()).sqrt();
+
+        ecefPositions.col(0).segment(first, length) =
+          ((radii + altitudes) * cosLatitudes * cosLongitudes).matrix();
+        ecefPositions.col(1).segment(first, length) =
+          ((radii + altitudes) * cosLatitudes * sinLongitudes).matrix();
+        ecefPositions.col(2).segment(first, length) =
+          ((radii * (1.0 - ellipsoid_.e2) + altitudes) * sinLatitudes).matrix();
+      }
+    });
+}
+
+//--------------------------------------------------------------------------
+void ECEFConverter::toWGS84(
+  const Eigen::MatrixX3d & ecefPositions,
+  GeodeticCoordinatesArray & geodeticCoordinates) const
+{
+  const Eigen::Index size = ecefPositions.rows();
+  geodeticCoordinates.latitudes.resize(size);
+  geodeticCoordinates.longitudes.resize(size);
+  geodeticCoordinates.altitudes.resize(size);
+
+  const size_t numberOfThreads = computeNumberOfThreads(
+    size, MINIMAL_NUMBER_OF_POSITIONS_PER_THREAD, maximalNumberOfThreads_);
+
+  parallelFor(
+    size, numberOfThreads,
+    [&](const size_t & /*threadIndex*/, const size_t & rangeBegin, const size_t & rangeEnd) {
+      for (size_t n = rangeBegin; n < rangeEnd; ++n) {
+        const Eigen::Index row = static_cast<Eigen::Index>(n);
+        const GeodeticCoordinates coordinates = toWGS84(ecefPositions.row(row).transpose());
+        geodeticCoordinates.latitudes[row] = coordinates.latitude;
+        geodeticCoordinates.longitudes[row] = coordinates.longitude;
+        geodeticCoordinates.altitudes[row] = coordinates.altitude;
+      }
+    });
+}
+
 }  // namespace core
 }  // namespace romea
@@ -15,11 +15,58 @@
 
 // romea
 #include "romea_core_common/geodesy/ENUConverter.hpp"
+#include "romea_core_common/concurrency/ParallelFor.hpp"
 
 // std
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 
+namespace
+{
+const size_t MINIMAL_NUMBER_OF_POSITIONS_PER_THREAD = 16384;
+
+constexpr int BLOCK_SIZE = 64;
+using Block = Eigen::Array<double, Eigen::Dynamic, 1, Eigen::ColMajor, BLOCK_SIZE, 1>;
+
+//--------------------------------------------------------------------------
+// Positions are copied by blocks before being transformed, so
+// transformedPositions can be positions
+void transformPositions(
+  const Eigen::Affine3d & transform,
+  const Eigen::MatrixX3d & positions,
+  Eigen::MatrixX3d & transformedPositions,
+  const size_t & maximalNumberOfThreads)
+{
+  const Eigen::Index size = positions.rows();
+  transformedPositions.resize(size, 3);
+
+  const size_t numberOfThreads = romea::core::computeNumberOfThreads(
+    size, MINIMAL_NUMBER_OF_POSITIONS_PER_THREAD, maximalNumberOfThreads);
+
+  romea::core::parallelFor(
+    size, numberOfThreads,
+    [&](const size_t & /*threadIndex*/, const size_t & rangeBegin, const size_t & rangeEnd) {
+      Block x, y, z;
+      for (size_t begin = rangeBegin; begin < rangeEnd; begin += BLOCK_SIZE) {
+        const Eigen::Index first = static_cast<Eigen::Index>(begin);
+        const Eigen::Index length = static_cast<Eigen::Index>(
+          std::min(rangeEnd - begin, size_t(BLOCK_SIZE)));
+
+        x = positions.col(0).segment(first, length).array();
+        y = positions.col(1).segment(first, length).array();
+        z = positions.col(2).segment(first, length).array();
+        for (Eigen::Index i = 0; i < 3; ++i) {
+          transformedPositions.col(i).segment(first, length) =
+            (transform.linear()(i, 0) * x + transform.linear()(i, 1) * y +
+            transform.linear()(i, 2) * z + transform.translation()[i]).matrix();
+        }
+      }
+    });
+}
+
+}  // namespace
+
 namespace romea
 {
 namespace core
@@ -30,6 +77,8 @@ ENUConverter::ENUConverter()
 : ecefConverter_(),
   wgs84Anchor_(),
   enu2ecef_(Eigen::Affine3d::Identity()),
+  ecef2enu_(Eigen::Affine3d::Identity()),
+  maximalNumberOfThreads_(getDefaultNumberOfThreads()),
   isAnchored_(false)
 {
 }
@@ -72,6 +121,10 @@ void ENUConverter::setAnchor(const GeodeticCoordinates & anchor)
   enu2ecef_.linear().col(2) << std::cos(latitude) * std::cos(longitude), std::cos(latitude) * sin(
     longitude), sin(latitude);
 
+  // Rotation is orthonormal, inverse is cached for ECEF to ENU conversions
+  ecef2enu_.linear() = enu2ecef_.linear().transpose();
+  ecef2enu_.translation() = -(ecef2enu_.linear() * enu2ecef_.translation());
+
   isAnchored_ = true;
 }
 
@@ -108,7 +161,7 @@ Eigen::Vector3d ENUConverter::toENU(const Eigen::Vector3d & ecefCoordinates)cons
 {
   assert(isAnchored_);
 
-  return enu2ecef_.inverse() * ecefCoordinates;
+  return ecef2enu_ * ecefCoordinates;
 }
 
 //--------------------------------------------------------------------------
@@ -137,8 +190,54 @@ const Eigen::Affine3d & ENUConverter::getEnuToEcefTransform() const
 void ENUConverter::reset()
 {
   enu2ecef_ = Eigen::Affine3d::Identity();
+  ecef2enu_ = Eigen::Affine3d::Identity();
   isAnchored_ = false;
 }
 
+//--------------------------------------------------------------------------
+void ENUConverter::setMaximalNumberOfThreads(const size_t & numberOfThreads)
+{
+  maximalNumberOfThreads_ = std::max(size_t(1), numberOfThreads);
+  ecefConverter_.setMaximalNumberOfThreads(numberOfThreads);
+}
+
+//--------------------------------------------------------------------------
+void ENUConverter::toWGS84(
+  const Eigen::MatrixX3d & enuPositions,
+  GeodeticCoordinatesArray & geodeticCoordinates) const
+{
+  Eigen::MatrixX3d ecefPositions;
+  toECEF(enuPositions, ecefPositions);
+  ecefConverter_.toWGS84(ecefPositions, geodeticCoordinates);
+}
+
+//--------------------------------------------------------------------------
+void ENUConverter::toECEF(
+  const Eigen::MatrixX3d & enuPositions,
+  Eigen::MatrixX3d & ecefPositions) const
+{
+  assert(isAnchored_);
+  transformPositions(enu2ecef_, enuPositions, ecefPositions, maximalNumberOfThreads_);
+}
+
+//--------------------------------------------------------------------------
+void ENUConverter::toENU(
+  const GeodeticCoordinatesArray & geodeticCoordinates,
+  Eigen::MatrixX3d & enuPositions) const
+{
+  assert(isAnchored_);
+  ecefConverter_.toECEF(geodeticCoordinates, enuPositions);
+  transformPositions(ecef2enu_, enuPositions, enuPositions, maximalNumberOfThreads_);
+}
+
+//--------------------------------------------------------------------------
+void ENUConverter::toENU(
+  const Eigen::MatrixX3d & ecefPositions,
+  Eigen::MatrixX3d & enuPositions) const
+{
+  assert(isAnchored_);
+  transformPositions(ecef2enu_, ecefPositions, enuPositions, maximalNumberOfThreads_);
+}
+
 }  // namespace core
 }  // namespace romea
@@ -0,0 +1,59 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+// romea
+#include "romea_core_common/geodesy/GeodeticCoordinatesArray.hpp"
+
+// std
+#include <cassert>
+
+namespace romea
+{
+namespace core
+{
+
+//--------------------------------------------------------------------------
+GeodeticCoordinatesArray makeGeodeticCoordinatesArray(
+  const std::vector<GeodeticCoordinates> & geodeticCoordinates)
+{
+  const Eigen::Index size = static_cast<Eigen::Index>(geodeticCoordinates.size());
+
+  GeodeticCoordinatesArray geodeticCoordinatesArray;
+  geodeticCoordinatesArray.latitudes.resize(size);
+  geodeticCoordinatesArray.longitudes.resize(size);
+  geodeticCoordinatesArray.altitudes.resize(size);
+  for (Eigen::Index n = 0; n < size; ++n) {
+    geodeticCoordinatesArray.latitudes[n] = geodeticCoordinates[n].latitude;
+    geodeticCoordinatesArray.longitudes[n] = geodeticCoordinates[n].longitude;
+    geodeticCoordinatesArray.altitudes[n] = geodeticCoordinates[n].altitude;
+  }
+  return geodeticCoordinatesArray;
+}
+
+//--------------------------------------------------------------------------
+GeodeticCoordinates getGeodeticCoordinates(
+  const GeodeticCoordinatesArray & geodeticCoordinatesArray,
+  const size_t & index)
+{
+  assert(index < size_t(geodeticCoordinatesArray.latitudes.size()));
+  return makeGeodeticCoordinates(
+    geodeticCoordinatesArray.latitudes[index],
+    geodeticCoordinatesArray.longitudes[index],
+    geodeticCoordinatesArray.altitudes[index]);
+}
+
+}  // namespace core
+}  // namespace romea
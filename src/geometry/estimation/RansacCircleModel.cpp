@@ -0,0 +1,204 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// std
+#include <cmath>
+#include <limits>
+#include <vector>
+
+// romea
+#include "romea_core_common/geometry/estimation/RansacCircleModel.hpp"
+
+namespace romea
+{
+namespace core
+{
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+RansacCircleModel<PointType>::RansacCircleModel()
+: RansacPrimitiveModel<PointType>(3),
+  minimalRadius_(0),
+  maximalRadius_(std::numeric_limits<Scalar>::max()),
+  center_(VectorType::Zero()),
+  radius_(0),
+  bestCenter_(VectorType::Zero()),
+  bestRadius_(0),
+  leastSquares_(3)
+{
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+void RansacCircleModel<PointType>::setRadiusRange(
+  const Scalar & minimalRadius,
+  const Scalar & maximalRadius)
+{
+  assert(minimalRadius <= maximalRadius);
+  minimalRadius_ = minimalRadius;
+  maximalRadius_ = maximalRadius;
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+typename PointType::Scalar RansacCircleModel<PointType>::computeSquareError_(
+  const VectorType & center,
+  const Scalar & radius,
+  const size_t & pointIndex) const
+{
+  Scalar error = (this->getPoint_(pointIndex) - center).norm() - radius;
+  return error * error;
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+bool RansacCircleModel<PointType>::draw(const double & /*modelDeviationError*/)
+{
+  this->drawSample_();
+
+  // Circumscribed circle of the three drawn points
+  const VectorType p1 = this->getPoint_(this->sampleIndexes_[0]);
+  const VectorType a = this->getPoint_(this->sampleIndexes_[1]) - p1;
+  const VectorType b = this->getPoint_(this->sampleIndexes_[2]) - p1;
+
+  Scalar determinant = 2 * (a.x() * b.y() - a.y() * b.x());
+  if (std::abs(determinant) < std::numeric_limits<Scalar>::epsilon()) {
+    return false;
+  }
+
+  Scalar squareNormA = a.squaredNorm();
+  Scalar squareNormB = b.squaredNorm();
+  VectorType offset((b.y() * squareNormA - a.y() * squareNormB) / determinant,
+    (a.x() * squareNormB - b.x() * squareNormA) / determinant);
+
+  center_ = p1 + offset;
+  radius_ = offset.norm();
+  return radius_ >= minimalRadius_ && radius_ <= maximalRadius_;
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+size_t RansacCircleModel<PointType>::countInliers(const double & modelDeviationError)
+{
+  this->inliers_.clear();
+
+  double sumOfSquareErrors = 0;
+  Scalar threshold = 9 * modelDeviationError * modelDeviationError;
+  for (size_t n = 0, N = this->points_->size(); n < N; ++n) {
+    Scalar squareError = computeSquareError_(center_, radius_, n);
+    if (squareError < threshold) {
+      this->inliers_.push_back(n);
+      sumOfSquareErrors += squareError;
+    }
+  }
+
+  if (this->backupInliers_(sumOfSquareErrors)) {
+    bestCenter_ = center_;
+    bestRadius_ = radius_;
+  }
+
+  return this->bestInliers_.size();
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+void RansacCircleModel<PointType>::refine()
+{
+  const std::vector<size_t> & inliers = this->bestInliers_;
+
+  // Geometric fit : minimize sum of (|p - center| - radius)^2
+  VectorType center = bestCenter_;
+  Scalar radius = bestRadius_;
+
+  leastSquares_.setDataSize(inliers.size());
+  auto & J = leastSquares_.getJ();
+  auto & Y = leastSquares_.getY();
+
+  for (size_t iteration = 0; iteration < this->REFINEMENT_MAXIMAL_NUMBER_OF_ITERATIONS;
+    ++iteration)
+  {
+    for (size_t n = 0, N = inliers.size(); n < N; ++n) {
+      const VectorType offset = this->getPoint_(inliers[n]) - center;
+      const Scalar distance = offset.norm();
+      if (distance > std::numeric_limits<Scalar>::epsilon()) {
+        J(n, 0) = -offset.x() / distance;
+        J(n, 1) = -offset.y() / distance;
+        J(n, 2) = -1;
+        Y(n) = radius - distance;
+      } else {
+        J.row(n).setZero();
+        Y(n) = 0;
+      }
+    }
+
+    Eigen::Matrix<Scalar, 3, 1> delta = leastSquares_.estimateUsingCholeskyDecomposition();
+    if (!delta.allFinite()) {
+      return;
+    }
+
+    center += delta.template head<2>();
+    radius += delta(2);
+
+    if (delta.norm() < this->REFINEMENT_EPSILON) {
+      break;
+    }
+  }
+
+  bestCenter_ = center;
+  bestRadius_ = radius;
+
+  double sumOfSquareErrors = 0;
+  for (const size_t & index : inliers) {
+    sumOfSquareErrors += computeSquareError_(bestCenter_, bestRadius_, index);
+  }
+  this->bestRootMeanSquareError_ = std::sqrt(sumOfSquareErrors / double(inliers.size()));
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+const typename RansacCircleModel<PointType>::VectorType &
+RansacCircleModel<PointType>::getCenter() const
+{
+  return bestCenter_;
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+const typename PointType::Scalar & RansacCircleModel<PointType>::getRadius() const
+{
+  return bestRadius_;
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+typename RansacCircleModel<PointType>::Parameters RansacCircleModel<PointType>::getParameters() const
+{
+  return {bestCenter_, bestRadius_};
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+Circle RansacCircleModel<PointType>::getCircle() const
+{
+  return Circle(bestCenter_.template cast<double>(), double(bestRadius_));
+}
+
+template class RansacCircleModel<Eigen::Vector2f>;
+template class RansacCircleModel<Eigen::Vector2d>;
+template class RansacCircleModel<HomogeneousCoordinates2f>;
+template class RansacCircleModel<HomogeneousCoordinates2d>;
+
+}  // namespace core
+}  // namespace romea
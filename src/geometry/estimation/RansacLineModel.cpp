@@ -0,0 +1,173 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// std
+#include <cmath>
+#include <limits>
+#include <vector>
+
+// romea
+#include "romea_core_common/geometry/estimation/RansacLineModel.hpp"
+
+namespace romea
+{
+namespace core
+{
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+RansacLineModel<PointType>::RansacLineModel()
+: RansacPrimitiveModel<PointType>(2),
+  normal_(VectorType::Zero()),
+  distance_(0),
+  bestNormal_(VectorType::Zero()),
+  bestDistance_(0),
+  leastSquares_(2)
+{
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+typename PointType::Scalar RansacLineModel<PointType>::computeSquareError_(
+  const VectorType & normal,
+  const Scalar & distance,
+  const size_t & pointIndex) const
+{
+  Scalar error = normal.dot(this->getPoint_(pointIndex)) - distance;
+  return error * error;
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+bool RansacLineModel<PointType>::draw(const double & /*modelDeviationError*/)
+{
+  this->drawSample_();
+
+  const VectorType p1 = this->getPoint_(this->sampleIndexes_[0]);
+  const VectorType p2 = this->getPoint_(this->sampleIndexes_[1]);
+  const VectorType direction = p2 - p1;
+
+  Scalar norm = direction.norm();
+  if (norm < std::numeric_limits<Scalar>::epsilon()) {
+    return false;
+  }
+
+  normal_ = VectorType(-direction.y(), direction.x()) / norm;
+  distance_ = normal_.dot(p1);
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+size_t RansacLineModel<PointType>::countInliers(const double & modelDeviationError)
+{
+  this->inliers_.clear();
+
+  double sumOfSquareErrors = 0;
+  Scalar threshold = 9 * modelDeviationError * modelDeviationError;
+  for (size_t n = 0, N = this->points_->size(); n < N; ++n) {
+    Scalar squareError = computeSquareError_(normal_, distance_, n);
+    if (squareError < threshold) {
+      this->inliers_.push_back(n);
+      sumOfSquareErrors += squareError;
+    }
+  }
+
+  if (this->backupInliers_(sumOfSquareErrors)) {
+    bestNormal_ = normal_;
+    bestDistance_ = distance_;
+  }
+
+  return this->bestInliers_.size();
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+void RansacLineModel<PointType>::refine()
+{
+  const std::vector<size_t> & inliers = this->bestInliers_;
+
+  // Points are centered on inliers mean to decorrelate angle and distance
+  const VectorType mean = this->computeInliersMean_();
+  VectorType normal = bestNormal_;
+  Scalar distance = bestDistance_ - normal.dot(mean);
+
+  leastSquares_.setDataSize(inliers.size());
+  auto & J = leastSquares_.getJ();
+  auto & Y = leastSquares_.getY();
+
+  for (size_t iteration = 0; iteration < this->REFINEMENT_MAXIMAL_NUMBER_OF_ITERATIONS;
+    ++iteration)
+  {
+    const VectorType tangent(-normal.y(), normal.x());
+    for (size_t n = 0, N = inliers.size(); n < N; ++n) {
+      const VectorType point = this->getPoint_(inliers[n]) - mean;
+      J(n, 0) = tangent.dot(point);
+      J(n, 1) = -1;
+      Y(n) = distance - normal.dot(point);
+    }
+
+    Eigen::Matrix<Scalar, 2, 1> delta = leastSquares_.estimateUsingCholeskyDecomposition();
+    if (!delta.allFinite()) {
+      return;
+    }
+
+    normal = std::cos(delta(0)) * normal + std::sin(delta(0)) * tangent;
+    distance += delta(1);
+
+    if (delta.norm() < this->REFINEMENT_EPSILON) {
+      break;
+    }
+  }
+
+  bestNormal_ = normal;
+  bestDistance_ = distance + normal.dot(mean);
+
+  double sumOfSquareErrors = 0;
+  for (const size_t & index : inliers) {
+    sumOfSquareErrors += computeSquareError_(bestNormal_, bestDistance_, index);
+  }
+  this->bestRootMeanSquareError_ = std::sqrt(sumOfSquareErrors / double(inliers.size()));
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+const typename RansacLineModel<PointType>::VectorType &
+RansacLineModel<PointType>::getNormal() const
+{
+  return bestNormal_;
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+const typename PointType::Scalar & RansacLineModel<PointType>::getDistanceToOrigin() const
+{
+  return bestDistance_;
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+typename RansacLineModel<PointType>::Parameters RansacLineModel<PointType>::getParameters() const
+{
+  return {bestNormal_, bestDistance_};
+}
+
+template class RansacLineModel<Eigen::Vector2f>;
+template class RansacLineModel<Eigen::Vector2d>;
+template class RansacLineModel<HomogeneousCoordinates2f>;
+template class RansacLineModel<HomogeneousCoordinates2d>;
+
+}  // namespace core
+}  // namespace romea
@@ -0,0 +1,181 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// Eigen
+#include <Eigen/Geometry>
+
+// std
+#include <cmath>
+#include <limits>
+#include <vector>
+
+// romea
+#include "romea_core_common/geometry/estimation/RansacPlaneModel.hpp"
+
+namespace romea
+{
+namespace core
+{
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+RansacPlaneModel<PointType>::RansacPlaneModel()
+: RansacPrimitiveModel<PointType>(3),
+  normal_(VectorType::Zero()),
+  distance_(0),
+  bestNormal_(VectorType::Zero()),
+  bestDistance_(0),
+  leastSquares_(3)
+{
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+typename PointType::Scalar RansacPlaneModel<PointType>::computeSquareError_(
+  const VectorType & normal,
+  const Scalar & distance,
+  const size_t & pointIndex) const
+{
+  Scalar error = normal.dot(this->getPoint_(pointIndex)) - distance;
+  return error * error;
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+bool RansacPlaneModel<PointType>::draw(const double & /*modelDeviationError*/)
+{
+  this->drawSample_();
+
+  const VectorType p1 = this->getPoint_(this->sampleIndexes_[0]);
+  const VectorType p2 = this->getPoint_(this->sampleIndexes_[1]);
+  const VectorType p3 = this->getPoint_(this->sampleIndexes_[2]);
+  const VectorType normal = (p2 - p1).cross(p3 - p1);
+
+  // Reject collinear samples
+  Scalar norm = normal.norm();
+  if (norm < std::numeric_limits<Scalar>::epsilon()) {
+    return false;
+  }
+
+  normal_ = normal / norm;
+  distance_ = normal_.dot(p1);
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+size_t RansacPlaneModel<PointType>::countInliers(const double & modelDeviationError)
+{
+  this->inliers_.clear();
+
+  double sumOfSquareErrors = 0;
+  Scalar threshold = 9 * modelDeviationError * modelDeviationError;
+  for (size_t n = 0, N = this->points_->size(); n < N; ++n) {
+    Scalar squareError = computeSquareError_(normal_, distance_, n);
+    if (squareError < threshold) {
+      this->inliers_.push_back(n);
+      sumOfSquareErrors += squareError;
+    }
+  }
+
+  if (this->backupInliers_(sumOfSquareErrors)) {
+    bestNormal_ = normal_;
+    bestDistance_ = distance_;
+  }
+
+  return this->bestInliers_.size();
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+void RansacPlaneModel<PointType>::refine()
+{
+  const std::vector<size_t> & inliers = this->bestInliers_;
+
+  // Points are centered on inliers mean to decorrelate normal and distance
+  const VectorType mean = this->computeInliersMean_();
+  VectorType normal = bestNormal_;
+  Scalar distance = bestDistance_ - normal.dot(mean);
+
+  leastSquares_.setDataSize(inliers.size());
+  auto & J = leastSquares_.getJ();
+  auto & Y = leastSquares_.getY();
+
+  for (size_t iteration = 0; iteration < this->REFINEMENT_MAXIMAL_NUMBER_OF_ITERATIONS;
+    ++iteration)
+  {
+    // Normal is updated in its tangent plane
+    const VectorType tangent1 = normal.unitOrthogonal();
+    const VectorType tangent2 = normal.cross(tangent1);
+    for (size_t n = 0, N = inliers.size(); n < N; ++n) {
+      const VectorType point = this->getPoint_(inliers[n]) - mean;
+      J(n, 0) = tangent1.dot(point);
+      J(n, 1) = tangent2.dot(point);
+      J(n, 2) = -1;
+      Y(n) = distance - normal.dot(point);
+    }
+
+    Eigen::Matrix<Scalar, 3, 1> delta = leastSquares_.estimateUsingCholeskyDecomposition();
+    if (!delta.allFinite()) {
+      return;
+    }
+
+    normal = (normal + delta(0) * tangent1 + delta(1) * tangent2).normalized();
+    distance += delta(2);
+
+    if (delta.norm() < this->REFINEMENT_EPSILON) {
+      break;
+    }
+  }
+
+  bestNormal_ = normal;
+  bestDistance_ = distance + normal.dot(mean);
+
+  double sumOfSquareErrors = 0;
+  for (const size_t & index : inliers) {
+    sumOfSquareErrors += computeSquareError_(bestNormal_, bestDistance_, index);
+  }
+  this->bestRootMeanSquareError_ = std::sqrt(sumOfSquareErrors / double(inliers.size()));
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+const typename RansacPlaneModel<PointType>::VectorType &
+RansacPlaneModel<PointType>::getNormal() const
+{
+  return bestNormal_;
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+const typename PointType::Scalar & RansacPlaneModel<PointType>::getDistanceToOrigin() const
+{
+  return bestDistance_;
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+typename RansacPlaneModel<PointType>::Parameters RansacPlaneModel<PointType>::getParameters() const
+{
+  return {bestNormal_, bestDistance_};
+}
+
+template class RansacPlaneModel<Eigen::Vector3f>;
+template class RansacPlaneModel<Eigen::Vector3d>;
+template class RansacPlaneModel<HomogeneousCoordinates3f>;
+template class RansacPlaneModel<HomogeneousCoordinates3d>;
+
+}  // namespace core
+}  // namespace romea
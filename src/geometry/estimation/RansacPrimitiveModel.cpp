@@ -0,0 +1,184 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// std
+#include <cmath>
+#include <cassert>
+#include <limits>
+#include <vector>
+#include <algorithm>
+#include <random>
+
+// romea
+#include "romea_core_common/geometry/estimation/RansacPrimitiveModel.hpp"
+
+namespace romea
+{
+namespace core
+{
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+RansacPrimitiveModel<PointType>::RansacPrimitiveModel(const size_t & numberOfPointsToDrawModel)
+: points_(nullptr),
+  numberOfPointsToDrawModel_(numberOfPointsToDrawModel),
+  minimalNumberOfInliers_(2 * numberOfPointsToDrawModel),
+  sampleIndexes_(numberOfPointsToDrawModel),
+  inliers_(),
+  bestInliers_(),
+  bestRootMeanSquareError_(std::numeric_limits<double>::max()),
+  randomGenerator_()
+{
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+void RansacPrimitiveModel<PointType>::loadPointSet(const PointSet<PointType> * points)
+{
+  assert(points);
+  points_ = points;
+
+  if (inliers_.capacity() < points->size()) {
+    inliers_.reserve(points->size());
+    bestInliers_.reserve(points->size());
+  }
+
+  // Clear data compute during the last estimation
+  inliers_.clear();
+  bestInliers_.clear();
+  bestRootMeanSquareError_ = std::numeric_limits<double>::max();
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+void RansacPrimitiveModel<PointType>::setMinimalNumberOfInliers(
+  const size_t & minimalNumberOfInliers)
+{
+  assert(minimalNumberOfInliers > numberOfPointsToDrawModel_);
+  minimalNumberOfInliers_ = minimalNumberOfInliers;
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+void RansacPrimitiveModel<PointType>::setSeed(const std::uint64_t & seed)
+{
+  randomGenerator_.seed(seed);
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+size_t RansacPrimitiveModel<PointType>::getNumberOfPoints() const
+{
+  return points_ ? points_->size() : 0;
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+size_t RansacPrimitiveModel<PointType>::getNumberOfPointsToDrawModel() const
+{
+  return numberOfPointsToDrawModel_;
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+size_t RansacPrimitiveModel<PointType>::getMinimalNumberOfInliers() const
+{
+  return minimalNumberOfInliers_;
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+double RansacPrimitiveModel<PointType>::getRootMeanSquareError() const
+{
+  return bestRootMeanSquareError_;
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+const std::vector<size_t> & RansacPrimitiveModel<PointType>::getInliers() const
+{
+  return bestInliers_;
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+void RansacPrimitiveModel<PointType>::drawSample_()
+{
+  assert(points_->size() > numberOfPointsToDrawModel_);
+  std::uniform_int_distribution<size_t> distribution(0, points_->size() - 1);
+
+  // Draw distinct point indexes
+  for (size_t n = 0; n < numberOfPointsToDrawModel_; ++n) {
+    auto itEnd = std::begin(sampleIndexes_) + n;
+    do {
+      sampleIndexes_[n] = distribution(randomGenerator_);
+    } while (std::find(std::begin(sampleIndexes_), itEnd, sampleIndexes_[n]) != itEnd);
+  }
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+typename RansacPrimitiveModel<PointType>::VectorType
+RansacPrimitiveModel<PointType>::getPoint_(const size_t & pointIndex) const
+{
+  return (*points_)[pointIndex].template head<CARTESIAN_DIM>();
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+typename RansacPrimitiveModel<PointType>::VectorType
+RansacPrimitiveModel<PointType>::computeInliersMean_() const
+{
+  VectorType mean = VectorType::Zero();
+  for (const size_t & index : bestInliers_) {
+    mean += getPoint_(index);
+  }
+  return mean / Scalar(bestInliers_.size());
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+bool RansacPrimitiveModel<PointType>::backupInliers_(const double & sumOfSquareErrors)
+{
+  if (inliers_.size() < minimalNumberOfInliers_) {
+    return false;
+  }
+
+  double rootMeanSquareError = std::sqrt(sumOfSquareErrors / double(inliers_.size()));
+
+  if (inliers_.size() > bestInliers_.size() ||
+    (inliers_.size() == bestInliers_.size() &&
+    rootMeanSquareError < bestRootMeanSquareError_))
+  {
+    std::swap(inliers_, bestInliers_);
+    bestRootMeanSquareError_ = rootMeanSquareError;
+    return true;
+  }
+
+  return false;
+}
+
+template class RansacPrimitiveModel<Eigen::Vector2f>;
+template class RansacPrimitiveModel<Eigen::Vector2d>;
+template class RansacPrimitiveModel<Eigen::Vector3f>;
+template class RansacPrimitiveModel<Eigen::Vector3d>;
+
+template class RansacPrimitiveModel<HomogeneousCoordinates2f>;
+template class RansacPrimitiveModel<HomogeneousCoordinates2d>;
+template class RansacPrimitiveModel<HomogeneousCoordinates3f>;
+template class RansacPrimitiveModel<HomogeneousCoordinates3d>;
+
+}  // namespace core
+}  // namespace romea
@@ -0,0 +1,222 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+// std
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+// romea
+#include "romea_core_common/concurrency/ParallelFor.hpp"
+
+// local
+#include "romea_core_common/pointset/algorithms/BoundingBoxCropping.hpp"
+
+namespace romea
+{
+namespace core
+{
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+BoundingBoxCropping<PointType>::BoundingBoxCropping()
+: boxes_(),
+  negative_(false),
+  maximalNumberOfThreads_(getDefaultNumberOfThreads()),
+  mask_()
+{
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+void BoundingBoxCropping<PointType>::addBox(const AABBType & box)
+{
+  boxes_.push_back({box.getCenterPosition(), box.getHalfWidthExtents(),
+      RotationType::Identity(), true});
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+void BoundingBoxCropping<PointType>::addBox(const OBBType & box)
+{
+  boxes_.push_back({box.getCenterPosition(), box.getHalfWidthExtents(),
+      box.getRotationMatrix().transpose(), false});
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+void BoundingBoxCropping<PointType>::clearBoxes()
+{
+  boxes_.clear();
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+size_t BoundingBoxCropping<PointType>::getNumberOfBoxes() const
+{
+  return boxes_.size();
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+void BoundingBoxCropping<PointType>::setNegative(const bool & negative)
+{
+  negative_ = negative;
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+void BoundingBoxCropping<PointType>::setMaximalNumberOfThreads(
+  const size_t & maximalNumberOfThreads)
+{
+  maximalNumberOfThreads_ = std::max(size_t(1), maximalNumberOfThreads);
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+void BoundingBoxCropping<PointType>::computeMask(
+  const PointSetType & points,
+  std::vector<std::uint8_t> & mask) const
+{
+  mask.resize(points.size());
+
+  // Thread ranges are rounded to blocks
+  const size_t numberOfBlocks = (points.size() + BLOCK_SIZE - 1) / BLOCK_SIZE;
+  const size_t numberOfThreads = computeNumberOfThreads(
+    points.size(), MINIMAL_NUMBER_OF_POINTS_PER_THREAD, maximalNumberOfThreads_);
+
+  parallelFor(
+    numberOfBlocks, numberOfThreads,
+    [&](const size_t & /*threadIndex*/, const size_t & beginBlock, const size_t & endBlock) {
+      for (size_t block = beginBlock; block < endBlock; ++block) {
+        const size_t begin = block * BLOCK_SIZE;
+        const size_t end = std::min(begin + BLOCK_SIZE, points.size());
+        computeBlockMask_(points, begin, end, mask.data() + begin);
+      }
+    });
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+void BoundingBoxCropping<PointType>::computeKeptPointIndexes(
+  const PointSetType & points,
+  std::vector<size_t> & keptPointIndexes)
+{
+  computeMask(points, mask_);
+
+  keptPointIndexes.clear();
+  for (size_t n = 0; n < points.size(); ++n) {
+    if (mask_[n]) {
+      keptPointIndexes.push_back(n);
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+void BoundingBoxCropping<PointType>::crop(
+  const PointSetType & points,
+  PointSetType & croppedPoints)
+{
+  computeMask(points, mask_);
+
+  croppedPoints.clear();
+  croppedPoints.reserve(std::count(std::begin(mask_), std::end(mask_), 1));
+  for (size_t n = 0; n < points.size(); ++n) {
+    if (mask_[n]) {
+      croppedPoints.push_back(points[n]);
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+void BoundingBoxCropping<PointType>::crop(PointSetType & points)
+{
+  computeMask(points, mask_);
+
+  size_t numberOfKeptPoints = 0;
+  for (size_t n = 0; n < points.size(); ++n) {
+    if (mask_[n]) {
+      points[numberOfKeptPoints++] = points[n];
+    }
+  }
+  points.resize(numberOfKeptPoints);
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+void BoundingBoxCropping<PointType>::computeBlockMask_(
+  const PointSetType & points,
+  const size_t & begin,
+  const size_t & end,
+  std::uint8_t * mask) const
+{
+  // Structure of arrays copy of block coordinates, padded with zeros
+  Block coordinates[CARTESIAN_DIM];
+  const int size = static_cast<int>(end - begin);
+  for (size_t i = 0; i < CARTESIAN_DIM; ++i) {
+    for (int k = 0; k < size; ++k) {
+      coordinates[i][k] = points[begin + k][i];
+    }
+    coordinates[i].tail(BLOCK_SIZE - size).setZero();
+  }
+
+  Block centeredCoordinates[CARTESIAN_DIM];
+  Block overflow;
+  Block minimalOverflow = Block::Constant(std::numeric_limits<Scalar>::infinity());
+  for (const Box & box : boxes_) {
+    for (size_t i = 0; i < CARTESIAN_DIM; ++i) {
+      centeredCoordinates[i] = coordinates[i] - box.centerPosition[i];
+    }
+
+    for (size_t i = 0; i < CARTESIAN_DIM; ++i) {
+      Block localCoordinates;
+      if (box.isAxisAligned) {
+        localCoordinates = centeredCoordinates[i];
+      } else {
+        localCoordinates = box.inverseRotation(i, 0) * centeredCoordinates[0];
+        for (size_t j = 1; j < CARTESIAN_DIM; ++j) {
+          localCoordinates += box.inverseRotation(i, j) * centeredCoordinates[j];
+        }
+      }
+
+      if (i == 0) {
+        overflow = localCoordinates.abs() - box.halfWidthExtents[i];
+      } else {
+        overflow = overflow.max(localCoordinates.abs() - box.halfWidthExtents[i]);
+      }
+    }
+    minimalOverflow = minimalOverflow.min(overflow);
+  }
+
+  for (int k = 0; k < size; ++k) {
+    mask[k] = (minimalOverflow[k] <= 0) != negative_;
+  }
+}
+
+template class BoundingBoxCropping<Eigen::Vector2f>;
+template class BoundingBoxCropping<Eigen::Vector2d>;
+template class BoundingBoxCropping<Eigen::Vector3f>;
+template class BoundingBoxCropping<Eigen::Vector3d>;
+
+template class BoundingBoxCropping<HomogeneousCoordinates2f>;
+template class BoundingBoxCropping<HomogeneousCoordinates2d>;
+template class BoundingBoxCropping<HomogeneousCoordinates3f>;
+template class BoundingBoxCropping<HomogeneousCoordinates3d>;
+
+}  // namespace core
+}  // namespace romea
@@ -0,0 +1,287 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+// Eigen
+#include <Eigen/Eigenvalues>
+
+// std
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+// romea
+#include "romea_core_common/math/CovarianceAccumulator.hpp"
+
+// local
+#include "romea_core_common/pointset/algorithms/BoundingBoxFitting.hpp"
+
+namespace
+{
+
+//-----------------------------------------------------------------------------
+template<typename Vector2>
+typename Vector2::Scalar cross(const Vector2 & o, const Vector2 & a, const Vector2 & b)
+{
+  return (a.x() - o.x()) * (b.y() - o.y()) - (a.y() - o.y()) * (b.x() - o.x());
+}
+
+}  // namespace
+
+namespace romea
+{
+namespace core
+{
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+BoundingBoxFitting<PointType>::BoundingBoxFitting()
+: planarPoints_(),
+  convexHull_()
+{
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+typename BoundingBoxFitting<PointType>::AABBType
+BoundingBoxFitting<PointType>::fitAxisAlignedBoundingBox(const PointSetType & points) const
+{
+  static_assert(sizeof(PointType) == POINT_SIZE * sizeof(Scalar), "points must be packed");
+  assert(!points.empty());
+
+  // Blocks of points are reduced elementwise, coordinate i of block point k
+  // being accumulated at k * POINT_SIZE + i
+  constexpr int BLOCK_SIZE = NUMBER_OF_POINTS_PER_BLOCK * POINT_SIZE;
+  using Block = Eigen::Array<Scalar, BLOCK_SIZE, 1>;
+
+  const size_t numberOfBlocks = points.size() / NUMBER_OF_POINTS_PER_BLOCK;
+  Block blockLower = Block::Constant(std::numeric_limits<Scalar>::max());
+  Block blockUpper = Block::Constant(std::numeric_limits<Scalar>::lowest());
+  for (size_t n = 0; n < numberOfBlocks; ++n) {
+    Eigen::Map<const Block> block(points[n * NUMBER_OF_POINTS_PER_BLOCK].data());
+    blockLower = blockLower.min(block);
+    blockUpper = blockUpper.max(block);
+  }
+
+  VectorType lower = VectorType::Constant(std::numeric_limits<Scalar>::max());
+  VectorType upper = VectorType::Constant(std::numeric_limits<Scalar>::lowest());
+  for (int k = 0; k < NUMBER_OF_POINTS_PER_BLOCK; ++k) {
+    lower = lower.cwiseMin(blockLower.template segment<CARTESIAN_DIM>(k * POINT_SIZE).matrix());
+    upper = upper.cwiseMax(blockUpper.template segment<CARTESIAN_DIM>(k * POINT_SIZE).matrix());
+  }
+
+  for (size_t n = numberOfBlocks * NUMBER_OF_POINTS_PER_BLOCK; n < points.size(); ++n) {
+    lower = lower.cwiseMin(points[n].template head<CARTESIAN_DIM>());
+    upper = upper.cwiseMax(points[n].template head<CARTESIAN_DIM>());
+  }
+
+  return AABBType((lower + upper) / 2, (upper - lower) / 2);
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+typename BoundingBoxFitting<PointType>::OBBType
+BoundingBoxFitting<PointType>::fitOrientedBoundingBox(const PointSetType & points)
+{
+  assert(!points.empty());
+
+  if constexpr (CARTESIAN_DIM == 2) {
+    planarPoints_.resize(points.size());
+    for (size_t n = 0; n < points.size(); ++n) {
+      planarPoints_[n] = points[n].template head<2>();
+    }
+    const Rectangle rectangle = fitRectangle_();
+    return OBBType(rectangle.centerPosition, rectangle.halfWidthExtents, rectangle.rotation);
+  } else {
+    CovarianceAccumulator<Scalar, 3> covarianceAccumulator;
+    for (const PointType & point : points) {
+      covarianceAccumulator.add(point.template head<3>());
+    }
+
+    // Principal axes in a right handed frame
+    Eigen::SelfAdjointEigenSolver<RotationType> eigenSolver(covarianceAccumulator.getCoMoment());
+    RotationType axes = eigenSolver.eigenvectors();
+    if (axes.determinant() < 0) {
+      axes.col(0) = -axes.col(0);
+    }
+
+    Scalar minimalVolume = std::numeric_limits<Scalar>::max();
+    VectorType centerPosition, halfWidthExtents;
+    RotationType rotation = axes;
+
+    // Each pass refines the frame by fitting rectangles in the planes
+    // orthogonal to its axes, until the volume stops decreasing
+    for (int pass = 0; pass < MAXIMAL_NUMBER_OF_REFINEMENT_PASSES; ++pass) {
+      const Scalar previousMinimalVolume = minimalVolume;
+      axes = rotation;
+      for (size_t k = 0; k < 3; ++k) {
+        // Points are projected on plane (axis i, axis j) orthogonal to axis k
+        const VectorType axisI = axes.col((k + 1) % 3);
+        const VectorType axisJ = axes.col((k + 2) % 3);
+        const VectorType axisK = axes.col(k);
+        Scalar lowerK = std::numeric_limits<Scalar>::max();
+        Scalar upperK = std::numeric_limits<Scalar>::lowest();
+
+        // Convex hull computation removes duplicated planar points
+        planarPoints_.resize(points.size());
+        for (size_t n = 0; n < points.size(); ++n) {
+          const VectorType point = points[n].template head<3>();
+          planarPoints_[n] = Vector2(axisI.dot(point), axisJ.dot(point));
+          lowerK = std::min(lowerK, axisK.dot(point));
+          upperK = std::max(upperK, axisK.dot(point));
+        }
+
+        const Rectangle rectangle = fitRectangle_();
+        const Scalar volume = rectangle.halfWidthExtents.prod() * (upperK - lowerK);
+        if (volume < minimalVolume) {
+          minimalVolume = volume;
+          rotation.col(0) = axisI * rectangle.rotation(0, 0) + axisJ * rectangle.rotation(1, 0);
+          rotation.col(1) = axisI * rectangle.rotation(0, 1) + axisJ * rectangle.rotation(1, 1);
+          rotation.col(2) = axisK;
+          centerPosition = axisI * rectangle.centerPosition.x() +
+            axisJ * rectangle.centerPosition.y() + axisK * (lowerK + upperK) / 2;
+          halfWidthExtents << rectangle.halfWidthExtents, (upperK - lowerK) / 2;
+        }
+      }
+
+      if (!(minimalVolume < previousMinimalVolume * (1 - REFINEMENT_TOLERANCE))) {
+        break;
+      }
+    }
+    return OBBType(centerPosition, halfWidthExtents, rotation);
+  }
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+void BoundingBoxFitting<PointType>::computeConvexHull_()
+{
+  // Andrew monotone chain
+  std::sort(std::begin(planarPoints_), std::end(planarPoints_),
+    [](const Vector2 & p1, const Vector2 & p2) {
+      return p1.x() < p2.x() || (p1.x() == p2.x() && p1.y() < p2.y());
+    });
+  planarPoints_.erase(std::unique(std::begin(planarPoints_), std::end(planarPoints_)),
+    std::end(planarPoints_));
+
+  const size_t numberOfPoints = planarPoints_.size();
+  if (numberOfPoints < 3) {
+    convexHull_.assign(std::begin(planarPoints_), std::end(planarPoints_));
+    return;
+  }
+
+  convexHull_.resize(2 * numberOfPoints);
+  size_t size = 0;
+  for (size_t n = 0; n < numberOfPoints; ++n) {
+    while (size >= 2 &&
+      cross(convexHull_[size - 2], convexHull_[size - 1], planarPoints_[n]) <= 0)
+    {
+      --size;
+    }
+    convexHull_[size++] = planarPoints_[n];
+  }
+
+  for (size_t n = numberOfPoints - 1, lowerHullSize = size + 1; n-- > 0; ) {
+    while (size >= lowerHullSize &&
+      cross(convexHull_[size - 2], convexHull_[size - 1], planarPoints_[n]) <= 0)
+    {
+      --size;
+    }
+    convexHull_[size++] = planarPoints_[n];
+  }
+
+  // Last point is the first one
+  convexHull_.resize(size - 1);
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+typename BoundingBoxFitting<PointType>::Rectangle
+BoundingBoxFitting<PointType>::fitRectangle_()
+{
+  computeConvexHull_();
+  const size_t size = convexHull_.size();
+
+  Rectangle rectangle;
+  rectangle.rotation.setIdentity();
+  rectangle.halfWidthExtents.setZero();
+  if (size == 1) {
+    rectangle.centerPosition = convexHull_[0];
+    return rectangle;
+  }
+  if (size == 2) {
+    // Collinear points, rectangle is a segment
+    const Vector2 edge = convexHull_[1] - convexHull_[0];
+    rectangle.centerPosition = (convexHull_[0] + convexHull_[1]) / 2;
+    rectangle.halfWidthExtents.x() = edge.norm() / 2;
+    rectangle.rotation.col(0) = edge.normalized();
+    rectangle.rotation.col(1) = Vector2(-edge.y(), edge.x()).normalized();
+    return rectangle;
+  }
+
+  // Rotating calipers, for each hull edge i the farthest points along the
+  // edge (a), backward (c) and away from it (b) only move forward
+  auto next = [size](const size_t & index) {return index + 1 == size ? 0 : index + 1;};
+  Scalar minimalArea = std::numeric_limits<Scalar>::max();
+  size_t a = 0, b = 0, c = 0;
+  for (size_t i = 0; i < size; ++i) {
+    const Vector2 & origin = convexHull_[i];
+    const Vector2 u = (convexHull_[next(i)] - origin).normalized();
+    const Vector2 v(-u.y(), u.x());
+
+    while ((convexHull_[next(a)] - convexHull_[a]).dot(u) > 0) {
+      a = next(a);
+    }
+    if (i == 0) {
+      b = a;
+    }
+    while ((convexHull_[next(b)] - convexHull_[b]).dot(v) > 0) {
+      b = next(b);
+    }
+    if (i == 0) {
+      c = b;
+    }
+    while ((convexHull_[next(c)] - convexHull_[c]).dot(u) < 0) {
+      c = next(c);
+    }
+
+    const Scalar upperU = (convexHull_[a] - origin).dot(u);
+    const Scalar lowerU = (convexHull_[c] - origin).dot(u);
+    const Scalar upperV = (convexHull_[b] - origin).dot(v);
+    const Scalar area = (upperU - lowerU) * upperV;
+    if (area < minimalArea) {
+      minimalArea = area;
+      rectangle.centerPosition = origin + u * (lowerU + upperU) / 2 + v * upperV / 2;
+      rectangle.halfWidthExtents = Vector2(upperU - lowerU, upperV) / 2;
+      rectangle.rotation.col(0) = u;
+      rectangle.rotation.col(1) = v;
+    }
+  }
+
+  return rectangle;
+}
+
+template class BoundingBoxFitting<Eigen::Vector2f>;
+template class BoundingBoxFitting<Eigen::Vector2d>;
+template class BoundingBoxFitting<Eigen::Vector3f>;
+template class BoundingBoxFitting<Eigen::Vector3d>;
+
+template class BoundingBoxFitting<HomogeneousCoordinates2f>;
+template class BoundingBoxFitting<HomogeneousCoordinates2d>;
+template class BoundingBoxFitting<HomogeneousCoordinates3f>;
+template class BoundingBoxFitting<HomogeneousCoordinates3d>;
+
+}  // namespace core
+}  // namespace romea
@@ -46,6 +46,7 @@ NormalAndCurvatureEstimation<PointType>::NormalAndCurvatureEstimation(
 : numberOfNeighborPoints_(numberOfNeighborPoints),
   neighborIndexes_(numberOfNeighborPoints_),
   neighborSquareDistances_(numberOfNeighborPoints_),
+  accumulator_(),
   eigenSolver_(),
   eigenValues_(EigenValuesType::Zero()),
   eigenVectors_(EigenVectorsType::Zero())
@@ -60,42 +61,19 @@ NormalAndCurvatureEstimation<PointType>::planeEstimation_(
   const KdTreeType & pointsKdTree,
   const size_t & pointIndex)
 {
-  using CovarianceMatrixType = Eigen::Matrix<Scalar, POINT_SIZE, POINT_SIZE>;
-
   pointsKdTree.findNearestNeighbors(
     points[pointIndex],
     numberOfNeighborPoints_,
     neighborIndexes_,
     neighborSquareDistances_);
 
-  //    //Single passe covariance computation
-  //    PointType mean = PointType::Zero();
-  //    SquareMatrix covariance = SquareMatrix::Zero();
-
-  //    for(size_t i=0;i<numberOfNeighborPoints_;++i){
-  //      mean+=points[neighborIndexes[i]];
-  //      covariance+=points[neighborIndexes[i]]*
-  //          points[neighborIndexes[i]].transpose();
-  //    }
-  //    covariance -= mean*mean.transpose()/float(numberOfNeighborPoints_);
-  //    covariance /= float(numberOfNeighborPoints_);
-
-
-  // Two passes covariance computation
-  PointType mean = PointType::Zero();
-  for (size_t i = 0; i < numberOfNeighborPoints_; ++i) {
-    mean += points[neighborIndexes_[i]];
-  }
-  mean /= Scalar(numberOfNeighborPoints_);
-
-  CovarianceMatrixType covariance = CovarianceMatrixType::Zero();
+  // Single pass covariance computation
+  accumulator_.reset();
   for (size_t i = 0; i < numberOfNeighborPoints_; ++i) {
-    covariance += (points[neighborIndexes_[i]] - mean) *
-      (points[neighborIndexes_[i]] - mean).transpose();
+    accumulator_.add(points[neighborIndexes_[i]].template head<CARTESIAN_DIM>());
   }
-  covariance /= Scalar(numberOfNeighborPoints_);
 
-  eigenSolver_.compute(covariance.block(0, 0, CARTESIAN_DIM, CARTESIAN_DIM));
+  eigenSolver_.compute(accumulator_.getCovariance());
   eigenValues_ = eigenSolver_.eigenvalues();
   eigenVectors_ = eigenSolver_.eigenvectors();
 }
@@ -0,0 +1,362 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+// std
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <utility>
+#include <vector>
+
+// romea
+#include "romea_core_common/concurrency/ParallelFor.hpp"
+
+// local
+#include "romea_core_common/pointset/algorithms/VoxelGridFilter.hpp"
+
+namespace romea
+{
+namespace core
+{
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+VoxelGridFilter<PointType>::VoxelGridFilter(
+  const Scalar & voxelSize,
+  const Mode & mode)
+: voxelSize_(voxelSize),
+  mode_(mode),
+  maximalNumberOfThreads_(getDefaultNumberOfThreads()),
+  numberOfThreads_(1),
+  gridIndexMapping_(),
+  keyStrides_(),
+  maximalKey_(0),
+  keyIndexes_(),
+  sortedKeyIndexes_(),
+  histograms_(),
+  threadNumberOfVoxels_(),
+  filteredPointIndexes_()
+{
+  assert(voxelSize > 0);
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+void VoxelGridFilter<PointType>::setVoxelSize(const Scalar & voxelSize)
+{
+  assert(voxelSize > 0);
+  voxelSize_ = voxelSize;
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+const typename VoxelGridFilter<PointType>::Scalar &
+VoxelGridFilter<PointType>::getVoxelSize() const
+{
+  return voxelSize_;
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+void VoxelGridFilter<PointType>::setMode(const Mode & mode)
+{
+  mode_ = mode;
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+const typename VoxelGridFilter<PointType>::Mode &
+VoxelGridFilter<PointType>::getMode() const
+{
+  return mode_;
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+void VoxelGridFilter<PointType>::setMaximalNumberOfThreads(const size_t & maximalNumberOfThreads)
+{
+  maximalNumberOfThreads_ = std::max(size_t(1), maximalNumberOfThreads);
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+const std::vector<size_t> & VoxelGridFilter<PointType>::getFilteredPointIndexes() const
+{
+  return filteredPointIndexes_;
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+const typename VoxelGridFilter<PointType>::GridIndexMappingType &
+VoxelGridFilter<PointType>::getGridIndexMapping() const
+{
+  return gridIndexMapping_;
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+void VoxelGridFilter<PointType>::filter(
+  const PointSetType & points,
+  PointSetType & filteredPoints)
+{
+  filteredPoints.clear();
+  filteredPointIndexes_.clear();
+  if (points.empty()) {
+    return;
+  }
+
+  numberOfThreads_ = computeNumberOfThreads(
+    points.size(), MINIMAL_NUMBER_OF_POINTS_PER_THREAD, maximalNumberOfThreads_);
+
+  initGridIndexMapping_(points);
+  computeKeys_(points);
+  radixSort_();
+  reduceVoxels_(points, filteredPoints);
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+void VoxelGridFilter<PointType>::initGridIndexMapping_(const PointSetType & points)
+{
+  using VectorType = typename GridIndexMappingType::PointType;
+  VectorOfEigenVector<VectorType> threadMinimalPositions(numberOfThreads_);
+  VectorOfEigenVector<VectorType> threadMaximalPositions(numberOfThreads_);
+
+  parallelFor(
+    points.size(), numberOfThreads_,
+    [&](const size_t & threadIndex, const size_t & begin, const size_t & end) {
+      VectorType minimalPosition = VectorType::Constant(std::numeric_limits<Scalar>::max());
+      VectorType maximalPosition = VectorType::Constant(std::numeric_limits<Scalar>::lowest());
+      for (size_t n = begin; n < end; ++n) {
+        const auto position = points[n].template head<CARTESIAN_DIM>();
+        minimalPosition = minimalPosition.cwiseMin(position);
+        maximalPosition = maximalPosition.cwiseMax(position);
+      }
+      threadMinimalPositions[threadIndex] = minimalPosition;
+      threadMaximalPositions[threadIndex] = maximalPosition;
+    });
+
+  VectorType minimalPosition = threadMinimalPositions[0];
+  VectorType maximalPosition = threadMaximalPositions[0];
+  for (size_t n = 1; n < numberOfThreads_; ++n) {
+    minimalPosition = minimalPosition.cwiseMin(threadMinimalPositions[n]);
+    maximalPosition = maximalPosition.cwiseMax(threadMaximalPositions[n]);
+  }
+
+  gridIndexMapping_ = GridIndexMappingType(
+    typename GridIndexMappingType::IntervalType(minimalPosition, maximalPosition), voxelSize_);
+
+  // voxel keys are linear indexes of cells in a row major grid
+  const auto & numberOfCells = gridIndexMapping_.getNumberOfCellsAlongAxes();
+  std::uint64_t stride = 1;
+  for (size_t i = 0; i < CARTESIAN_DIM; ++i) {
+    keyStrides_[i] = stride;
+    assert(numberOfCells[i] <= std::numeric_limits<std::uint64_t>::max() / stride);
+    stride *= numberOfCells[i];
+  }
+  maximalKey_ = stride - 1;
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+void VoxelGridFilter<PointType>::computeKeys_(const PointSetType & points)
+{
+  keyIndexes_.resize(points.size());
+  parallelFor(
+    points.size(), numberOfThreads_,
+    [&](const size_t & /*threadIndex*/, const size_t & begin, const size_t & end) {
+      for (size_t n = begin; n < end; ++n) {
+        const auto cellIndexes = gridIndexMapping_.computeCellIndexes(
+          points[n].template head<CARTESIAN_DIM>());
+        keyIndexes_[n].key = cellIndexes.template cast<std::uint64_t>().dot(keyStrides_);
+        keyIndexes_[n].index = n;
+      }
+    });
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+void VoxelGridFilter<PointType>::radixSort_()
+{
+  const size_t numberOfPoints = keyIndexes_.size();
+  sortedKeyIndexes_.resize(numberOfPoints);
+  histograms_.resize(numberOfThreads_ * RADIX_SIZE);
+
+  int numberOfBits = 0;
+  while (numberOfBits < 64 && (maximalKey_ >> numberOfBits) != 0) {
+    ++numberOfBits;
+  }
+
+  // least significant digit first, each pass being stable the final order
+  // of points inside a voxel is their order in input point set
+  for (int shift = 0; shift < numberOfBits; shift += RADIX_BITS) {
+    std::fill(histograms_.begin(), histograms_.end(), 0);
+    parallelFor(
+      numberOfPoints, numberOfThreads_,
+      [&](const size_t & threadIndex, const size_t & begin, const size_t & end) {
+        size_t * histogram = histograms_.data() + threadIndex * RADIX_SIZE;
+        for (size_t n = begin; n < end; ++n) {
+          ++histogram[(keyIndexes_[n].key >> shift) & (RADIX_SIZE - 1)];
+        }
+      });
+
+    // scatter offsets are ordered by digit then by thread range
+    bool isSingleDigit = false;
+    size_t offset = 0;
+    for (size_t digit = 0; digit < RADIX_SIZE; ++digit) {
+      const size_t digitBegin = offset;
+      for (size_t threadIndex = 0; threadIndex < numberOfThreads_; ++threadIndex) {
+        size_t & count = histograms_[threadIndex * RADIX_SIZE + digit];
+        offset += count;
+        count = offset - count;
+      }
+      isSingleDigit |= offset - digitBegin == numberOfPoints;
+    }
+
+    if (isSingleDigit) {
+      continue;
+    }
+
+    parallelFor(
+      numberOfPoints, numberOfThreads_,
+      [&](const size_t & threadIndex, const size_t & begin, const size_t & end) {
+        size_t * offsets = histograms_.data() + threadIndex * RADIX_SIZE;
+        for (size_t n = begin; n < end; ++n) {
+          sortedKeyIndexes_[offsets[(keyIndexes_[n].key >> shift) & (RADIX_SIZE - 1)]++] =
+          keyIndexes_[n];
+        }
+      });
+
+    std::swap(keyIndexes_, sortedKeyIndexes_);
+  }
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+size_t VoxelGridFilter<PointType>::findVoxelBegin_(const size_t & index) const
+{
+  size_t n = index;
+  while (n > 0 && n < keyIndexes_.size() && keyIndexes_[n].key == keyIndexes_[n - 1].key) {
+    ++n;
+  }
+  return n;
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+void VoxelGridFilter<PointType>::reduceVoxels_(
+  const PointSetType & points,
+  PointSetType & filteredPoints)
+{
+  // Each thread reduces the voxels beginning in its range
+  const size_t numberOfPoints = keyIndexes_.size();
+  threadNumberOfVoxels_.assign(numberOfThreads_ + 1, 0);
+  parallelFor(
+    numberOfPoints, numberOfThreads_,
+    [&](const size_t & threadIndex, const size_t & begin, const size_t & end) {
+      size_t numberOfVoxels = 0;
+      for (size_t n = begin; n < end; ++n) {
+        numberOfVoxels += n == 0 || keyIndexes_[n].key != keyIndexes_[n - 1].key;
+      }
+      threadNumberOfVoxels_[threadIndex + 1] = numberOfVoxels;
+    });
+
+  for (size_t n = 0; n < numberOfThreads_; ++n) {
+    threadNumberOfVoxels_[n + 1] += threadNumberOfVoxels_[n];
+  }
+
+  filteredPoints.resize(threadNumberOfVoxels_.back());
+  filteredPointIndexes_.resize(threadNumberOfVoxels_.back());
+  parallelFor(
+    numberOfPoints, numberOfThreads_,
+    [&](const size_t & threadIndex, const size_t & begin, const size_t & end) {
+      size_t voxelIndex = threadNumberOfVoxels_[threadIndex];
+      size_t voxelBegin = findVoxelBegin_(begin);
+      while (voxelBegin < end) {
+        size_t voxelEnd = voxelBegin + 1;
+        while (voxelEnd < numberOfPoints &&
+        keyIndexes_[voxelEnd].key == keyIndexes_[voxelBegin].key)
+        {
+          ++voxelEnd;
+        }
+
+        filteredPointIndexes_[voxelIndex] =
+        reduceVoxel_(points, voxelBegin, voxelEnd, filteredPoints[voxelIndex]);
+        ++voxelIndex;
+        voxelBegin = voxelEnd;
+      }
+    });
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+size_t VoxelGridFilter<PointType>::reduceVoxel_(
+  const PointSetType & points,
+  const size_t & begin,
+  const size_t & end,
+  PointType & filteredPoint) const
+{
+  const size_t firstIndex = keyIndexes_[begin].index;
+
+  switch (mode_) {
+    case Mode::CENTROID:
+      {
+        filteredPoint = points[firstIndex];
+        for (size_t n = begin + 1; n < end; ++n) {
+          filteredPoint += points[keyIndexes_[n].index];
+        }
+        filteredPoint /= Scalar(end - begin);
+        return firstIndex;
+      }
+    case Mode::CLOSEST_TO_CENTER:
+      {
+        const auto center = gridIndexMapping_.computeCellCenterPosition(
+          gridIndexMapping_.computeCellIndexes(points[firstIndex].template head<CARTESIAN_DIM>()));
+
+        size_t closestIndex = firstIndex;
+        Scalar closestSquaredDistance =
+          (points[firstIndex].template head<CARTESIAN_DIM>() - center).squaredNorm();
+        for (size_t n = begin + 1; n < end; ++n) {
+          const size_t index = keyIndexes_[n].index;
+          const Scalar squaredDistance =
+            (points[index].template head<CARTESIAN_DIM>() - center).squaredNorm();
+          if (squaredDistance < closestSquaredDistance) {
+            closestSquaredDistance = squaredDistance;
+            closestIndex = index;
+          }
+        }
+        filteredPoint = points[closestIndex];
+        return closestIndex;
+      }
+    case Mode::FIRST_POINT:
+    default:
+      filteredPoint = points[firstIndex];
+      return firstIndex;
+  }
+}
+
+template class VoxelGridFilter<Eigen::Vector2f>;
+template class VoxelGridFilter<Eigen::Vector2d>;
+template class VoxelGridFilter<Eigen::Vector3f>;
+template class VoxelGridFilter<Eigen::Vector3d>;
+
+template class VoxelGridFilter<HomogeneousCoordinates2f>;
+template class VoxelGridFilter<HomogeneousCoordinates2d>;
+template class VoxelGridFilter<HomogeneousCoordinates3f>;
+template class VoxelGridFilter<HomogeneousCoordinates3d>;
+
+}  // namespace core
+}  // namespace romea
@@ -124,6 +124,13 @@ LeastSquares<RealType>::getW() const
   return W_;
 }
 
+//-----------------------------------------------------------------------------
+template<typename RealType>
+size_t LeastSquares<RealType>::getDataSize() const
+{
+  return size_t(dataSize_);
+}
+
 //-----------------------------------------------------------------------------
 template<typename RealType>
 void
@@ -190,7 +197,43 @@ typename LeastSquares<RealType>::Vector LeastSquares<RealType>::estimateUsingSVD
   computeJTJ_();
   computeJTY_();
 
-  Eigen::JacobiSVD<Matrix> svd(JtJ_, Eigen::ComputeThinU | Eigen::ComputeThinV);
+  invertJtJUsingSVD_(JtJ_);
+  return Ac_ * inverseJtJ_ * JtY_ + Bc_;
+}
+
+//-----------------------------------------------------------------------------
+template<typename RealType>
+typename LeastSquares<RealType>::Vector
+LeastSquares<RealType>::estimateUsingDampedCholeskyDecomposition(
+  const RealType & damping,
+  const bool & computeNormalEquations)
+{
+  if (computeNormalEquations) {
+    computeJTJ_();
+    computeJTY_();
+  }
+
+  Matrix dampedJtJ = JtJ_;
+  dampedJtJ.diagonal() *= 1 + damping;
+
+  Eigen::LDLT<Matrix> ldlt(dampedJtJ);
+  const auto & D = ldlt.vectorD();
+  if (ldlt.info() == Eigen::Success && ldlt.isPositive() &&
+    D.minCoeff() > std::numeric_limits<RealType>::epsilon() * D.maxCoeff())
+  {
+    inverseJtJ_ = ldlt.solve(Matrix::Identity(estimateSize_, estimateSize_));
+  } else {
+    invertJtJUsingSVD_(dampedJtJ);
+  }
+
+  return Ac_ * inverseJtJ_ * JtY_ + Bc_;
+}
+
+//-----------------------------------------------------------------------------
+template<typename RealType>
+void LeastSquares<RealType>::invertJtJUsingSVD_(const Matrix & JtJ)
+{
+  Eigen::JacobiSVD<Matrix> svd(JtJ, Eigen::ComputeThinU | Eigen::ComputeThinV);
   inverseJtJ_ = svd.singularValues().asDiagonal();
   for (int n = 0; n < estimateSize_; n++) {
     if (inverseJtJ_(n, n) > std::numeric_limits<RealType>::epsilon()) {
@@ -199,8 +242,6 @@ typename LeastSquares<RealType>::Vector LeastSquares<RealType>::estimateUsingSVD
   }
 
   inverseJtJ_ = svd.matrixV() * inverseJtJ_ * svd.matrixU().transpose();
-
-  return Ac_ * inverseJtJ_ * JtY_ + Bc_;
 }
 
 //-----------------------------------------------------------------------------
@@ -219,37 +260,27 @@ typename LeastSquares<RealType>::Matrix LeastSquares<RealType>::computeEstimateC
   return Ac_.transpose() * inverseJtJ_ * Ac_ * dataVariance;
 }
 
-// TODO(Jean) paralléliser les trois fonctions ci dessous
 //-----------------------------------------------------------------------------
 template<typename RealType>
 void LeastSquares<RealType>::weightJAndY_()
 {
   Y_.head(dataSize_).array() *= W_.head(dataSize_).array();
-
-  for (int i = 0; i < estimateSize_; ++i) {
-    J_.col(i).head(dataSize_).array() *= W_.head(dataSize_).array();
-  }
+  J_.topRows(dataSize_).array().colwise() *= W_.head(dataSize_).array();
 }
 
 //-----------------------------------------------------------------------------
 template<typename RealType>
 void LeastSquares<RealType>::computeJTJ_()
 {
-  for (int i = 0; i < estimateSize_; ++i) {
-    for (int j = i; j < estimateSize_; ++j) {
-      JtJ_(i, j) = JtJ_(j, i) = J_.col(i).head(dataSize_).
-        dot(J_.col(j).head(dataSize_));
-    }
-  }
+  // Blocked product is far more cache friendly than column dot products
+  JtJ_.noalias() = J_.topRows(dataSize_).transpose() * J_.topRows(dataSize_);
 }
 
 //-----------------------------------------------------------------------------
 template<typename RealType>
 void LeastSquares<RealType>::computeJTY_()
 {
-  for (int i = 0; i < estimateSize_; ++i) {
-    JtY_(i) = J_.col(i).head(dataSize_).dot(Y_.head(dataSize_));
-  }
+  JtY_.noalias() = J_.topRows(dataSize_).transpose() * Y_.head(dataSize_);
 }
 
 //-----------------------------------------------------------------------------
@@ -18,6 +18,7 @@
 
 // std
 #include <algorithm>
+#include <cmath>
 
 namespace romea
 {
@@ -26,16 +27,51 @@ namespace core
 
 //----------------------------------------------------------------------------
 template<typename RealType>
-MEstimator<RealType>::MEstimator(RealType dataNoiseStd)
+MEstimator<RealType>::MEstimator(RealType dataNoiseStd, Kernel kernel)
 : dataSize_(0),
   dataNoiseStd_(dataNoiseStd),
+  kernel_(kernel),
+  approximateMedianMinimalDataSize_(std::numeric_limits<size_t>::max()),
+  minimum_(0),
+  maximum_(0),
   sortedVector_(),
-  normalizedResiduals_(),
   weights_(),
-  ones_()
+  histogram_(NUMBER_OF_HISTOGRAM_BINS)
 {
 }
 
+//----------------------------------------------------------------------------
+template<typename RealType>
+void
+MEstimator<RealType>::setDataNoiseStd(const RealType & dataNoiseStd)
+{
+  dataNoiseStd_ = dataNoiseStd;
+}
+
+//----------------------------------------------------------------------------
+template<typename RealType>
+void
+MEstimator<RealType>::setKernel(const Kernel & kernel)
+{
+  kernel_ = kernel;
+}
+
+//----------------------------------------------------------------------------
+template<typename RealType>
+void
+MEstimator<RealType>::enableApproximateMedian(const size_t & minimalDataSize)
+{
+  approximateMedianMinimalDataSize_ = minimalDataSize;
+}
+
+//----------------------------------------------------------------------------
+template<typename RealType>
+void
+MEstimator<RealType>::disableApproximateMedian()
+{
+  approximateMedianMinimalDataSize_ = std::numeric_limits<size_t>::max();
+}
+
 //----------------------------------------------------------------------------
 template<typename RealType>
 void
@@ -43,19 +79,15 @@ MEstimator<RealType>::allocate_(const int & dataSize)
 {
   dataSize_ = dataSize;
 
-  if (sortedVector_.rows() < dataSize) {
-    sortedVector_.resize(dataSize_);
-    normalizedResiduals_.resize(dataSize_);
+  if (weights_.rows() < dataSize) {
     weights_.resize(dataSize_);
-    ones_.resize(dataSize_);
-    ones_.setConstant(RealType(1.0));
   }
 }
 
 //----------------------------------------------------------------------------
 template<typename RealType>
 RealType
-MEstimator<RealType>::computeWeights(const Vector & residuals)
+MEstimator<RealType>::computeWeights(const Eigen::Ref<const Vector> & residuals)
 {
   return computeWeights(residuals, 0);
 }
@@ -64,7 +96,7 @@ MEstimator<RealType>::computeWeights(const Vector & residuals)
 template<typename RealType>
 RealType
 MEstimator<RealType>::computeWeights(
-  const Vector & residuals,
+  const Eigen::Ref<const Vector> & residuals,
   const size_t & numberOfDiscardedData)
 {
   assert(int(numberOfDiscardedData) <= residuals.rows());
@@ -72,32 +104,162 @@ MEstimator<RealType>::computeWeights(
   allocate_(static_cast<int>(residuals.rows()));
   int numberOfAvailableData = dataSize_ - int(numberOfDiscardedData);
 
-  // Compute median
-  sortedVector_.head(dataSize_).noalias() = residuals;
-  RealType * itBegin = sortedVector_.data();
-  RealType * itMedian = itBegin + numberOfAvailableData / 2;
-  RealType * itEnd = itBegin + dataSize_;
-  std::nth_element(itBegin, itMedian, itEnd);
+  RealType median = computeMedian_(residuals, numberOfAvailableData);
+  RealType mad = std::max(
+    RealType(1.4826) * computeMedianAbsoluteDeviation_(residuals, median, numberOfAvailableData),
+    dataNoiseStd_);
 
-  // Compute MAD
-  normalizedResiduals_.head(dataSize_).array() = (residuals.array() - (*itMedian)).abs();
-  sortedVector_.head(dataSize_) = normalizedResiduals_.head(dataSize_);
-  std::nth_element(itBegin, itMedian, itEnd);
+  return computeWeights_(residuals, median, mad, numberOfDiscardedData);
+}
 
-  RealType mad = std::max(RealType(1.4826) * (*itMedian), dataNoiseStd_);
+//----------------------------------------------------------------------------
+template<typename RealType>
+RealType
+MEstimator<RealType>::computeWeightsOfDistances(const Eigen::Ref<const Vector> & distances)
+{
+  assert((distances.array() >= 0).all());
+
+  allocate_(static_cast<int>(distances.rows()));
+
+  // Absolute deviations to zero are distances themselves
+  RealType mad = std::max(
+    RealType(1.4826) * computeMedian_(distances, dataSize_),
+    dataNoiseStd_);
+
+  return computeWeights_(distances, RealType(0), mad, 0);
+}
+
+//----------------------------------------------------------------------------
+template<typename RealType>
+RealType
+MEstimator<RealType>::computeWeights_(
+  const Eigen::Ref<const Vector> & residuals,
+  const RealType & center,
+  const RealType & mad,
+  const size_t & numberOfDiscardedData)
+{
+  int numberOfAvailableData = dataSize_ - int(numberOfDiscardedData);
 
-  // Huber weighting
-  mad = RealType(1.2107) * mad;
-  weights_.head(dataSize_).array() =
-    (normalizedResiduals_.head(dataSize_).array() / mad).
-    inverse().min(ones_.head(dataSize_).array());
+  // Kernel tuning constants give 95 percent efficiency on gaussian noise
+  auto absoluteDeviations = (residuals.array() - center).abs();
+  switch (kernel_) {
+    case Kernel::HUBER:
+      weights_.head(dataSize_).array() =
+        (RealType(1.2107) * mad / absoluteDeviations).min(RealType(1));
+      break;
+    case Kernel::CAUCHY:
+      weights_.head(dataSize_).array() =
+        (1 + (absoluteDeviations / (RealType(2.3849) * mad)).square()).inverse();
+      break;
+    case Kernel::TUKEY:
+      weights_.head(dataSize_).array() =
+        (1 - (absoluteDeviations / (RealType(4.6851) * mad)).square()).max(RealType(0)).square();
+      break;
+  }
 
   // Apply weighting only when ratio inliers/outliers are up to 80 percent
   int numberOfInliers =
-    (weights_.array() < ones_.head(dataSize_).array()).sum() - int(numberOfDiscardedData);
+    int((absoluteDeviations > RealType(1.2107) * mad).count()) - int(numberOfDiscardedData);
   return numberOfInliers / RealType(numberOfAvailableData);
 }
 
+//----------------------------------------------------------------------------
+template<typename RealType>
+RealType
+MEstimator<RealType>::computeMedian_(
+  const Eigen::Ref<const Vector> & residuals,
+  const int & numberOfAvailableData)
+{
+  if (size_t(dataSize_) >= approximateMedianMinimalDataSize_) {
+    // Discarded data are set to MESTIMATOR_DISCARDED_VALUE, the greatest value
+    if (numberOfAvailableData == dataSize_) {
+      minimum_ = residuals.minCoeff();
+      maximum_ = residuals.maxCoeff();
+    } else {
+      auto isAvailable = residuals.array() != std::numeric_limits<RealType>::max();
+      minimum_ = residuals.minCoeff();
+      maximum_ = isAvailable.select(residuals.array(), minimum_).maxCoeff();
+    }
+    return computeApproximateQuantile_(
+      residuals, residuals.array(), minimum_, maximum_, numberOfAvailableData / 2);
+  }
+
+  // Discarded values are the greatest ones, they are moved to the end by selection
+  if (sortedVector_.rows() < dataSize_) {
+    sortedVector_.resize(dataSize_);
+  }
+  sortedVector_.head(dataSize_) = residuals;
+  RealType * itBegin = sortedVector_.data();
+  RealType * itMedian = itBegin + numberOfAvailableData / 2;
+  std::nth_element(itBegin, itMedian, itBegin + dataSize_);
+  return *itMedian;
+}
+
+//----------------------------------------------------------------------------
+template<typename RealType>
+RealType
+MEstimator<RealType>::computeMedianAbsoluteDeviation_(
+  const Eigen::Ref<const Vector> & residuals,
+  const RealType & median,
+  const int & numberOfAvailableData)
+{
+  if (size_t(dataSize_) >= approximateMedianMinimalDataSize_) {
+    // Deviation range is deduced from residual range, no extra pass is needed
+    return computeApproximateQuantile_(
+      residuals, (residuals.array() - median).abs(), RealType(0),
+      std::max(maximum_ - median, median - minimum_), numberOfAvailableData / 2);
+  }
+
+  // Sorted vector already holds a permutation of residuals, deviations are
+  // computed in place instead of copying residuals again
+  sortedVector_.head(dataSize_).array() = (sortedVector_.head(dataSize_).array() - median).abs();
+  RealType * itBegin = sortedVector_.data();
+  RealType * itMedian = itBegin + numberOfAvailableData / 2;
+  std::nth_element(itBegin, itMedian, itBegin + dataSize_);
+  return *itMedian;
+}
+
+//----------------------------------------------------------------------------
+template<typename RealType>
+template<typename Derived>
+RealType
+MEstimator<RealType>::computeApproximateQuantile_(
+  const Eigen::Ref<const Vector> & residuals,
+  const Eigen::ArrayBase<Derived> & values,
+  RealType minimum,
+  RealType maximum,
+  const int & rank)
+{
+  // First level locates the bin holding the wanted rank, second level
+  // refines inside this bin, so resolution is range / bins^2
+  int remainingRank = rank;
+  for (int level = 0; level < 2 && maximum > minimum; ++level) {
+    const RealType binWidth = (maximum - minimum) / NUMBER_OF_HISTOGRAM_BINS;
+    const RealType inverseBinWidth = 1 / binWidth;
+    const RealType halfNumberOfBins = RealType(NUMBER_OF_HISTOGRAM_BINS) / 2;
+    std::fill(histogram_.begin(), histogram_.end(), 0);
+    for (int n = 0; n < dataSize_; ++n) {
+      RealType position = (values.coeff(n) - minimum) * inverseBinWidth;
+      // Single comparison keeps branch predictable when most values are out of range
+      if (std::abs(position - halfNumberOfBins) <= halfNumberOfBins &&
+        residuals[n] != std::numeric_limits<RealType>::max())
+      {
+        ++histogram_[std::min(static_cast<int>(position), NUMBER_OF_HISTOGRAM_BINS - 1)];
+      }
+    }
+
+    int bin = 0;
+    while (bin < NUMBER_OF_HISTOGRAM_BINS - 1 && remainingRank >= histogram_[bin]) {
+      remainingRank -= histogram_[bin++];
+    }
+
+    minimum = minimum + bin * binWidth;
+    maximum = minimum + binWidth;
+  }
+
+  return (minimum + maximum) / 2;
+}
+
 template class MEstimator<float>;
 template class MEstimator<double>;
 
@@ -13,12 +13,21 @@
 // limitations under the License.
 
 
+// romea
 #include "romea_core_common/regression/leastsquares/NLSE.hpp"
 
+// std
+#include <algorithm>
+#include <cmath>
+
 namespace
 {
 const double DEFAULT_ALPHA = 0.7;
 const double DEFAULT_ESTIMATE_EPSILON = 0.01;
+const double DEFAULT_INITIAL_DAMPING = 1e-3;
+const double DEFAULT_RELATIVE_COST_EPSILON = 1e-6;
+const double MINIMAL_DAMPING = 1e-9;
+const double MAXIMAL_DAMPING = 1e9;
 }
 
 namespace romea
@@ -43,15 +52,59 @@ NLSE<RealType>::NLSE(const double & estimateEpsilon)
 //-----------------------------------------------------------------------------
 template<typename RealType>
 NLSE<RealType>::NLSE(const double & estimateEpsilon, const RealType & alpha)
-: alpha_(alpha),
+: method_(Method::GAUSS_NEWTON),
+  alpha_(alpha),
+  initialDamping_(DEFAULT_INITIAL_DAMPING),
+  relativeCostEpsilon_(DEFAULT_RELATIVE_COST_EPSILON),
   estimate_(),
   estimateDelta_(),
   estimateCovariance_(),
   estimateEpsilon_(estimateEpsilon),
   numberOfIterations_(0),
   leastSquares_(),
-  rmse_(-1)
+  rmse_(-1),
+  robustKernel_(),
+  mEstimator_(0),
+  weights_(),
+  costHistory_(),
+  iterationDurations_()
+{
+}
+
+//-----------------------------------------------------------------------------
+template<typename RealType>
+void NLSE<RealType>::setMethod(const Method & method)
+{
+  method_ = method;
+}
+
+//-----------------------------------------------------------------------------
+template<typename RealType>
+void NLSE<RealType>::setInitialDamping(const double & initialDamping)
+{
+  initialDamping_ = initialDamping;
+}
+
+//-----------------------------------------------------------------------------
+template<typename RealType>
+void NLSE<RealType>::setRobustKernel(const RobustKernel & kernel)
+{
+  robustKernel_ = kernel;
+  mEstimator_.setKernel(kernel);
+}
+
+//-----------------------------------------------------------------------------
+template<typename RealType>
+void NLSE<RealType>::disableRobustKernel()
 {
+  robustKernel_.reset();
+}
+
+//-----------------------------------------------------------------------------
+template<typename RealType>
+void NLSE<RealType>::setRelativeCostEpsilon(const double & relativeCostEpsilon)
+{
+  relativeCostEpsilon_ = relativeCostEpsilon;
 }
 
 //-----------------------------------------------------------------------------
@@ -62,48 +115,196 @@ bool NLSE<RealType>::estimate(const size_t & maximalNumberOfIterations, const do
   numberOfIterations_ = 0;
   rmse_ = -1;
 
-  // estimate
+  costHistory_.clear();
+  costHistory_.reserve(maximalNumberOfIterations + 1);
+  iterationDurations_.clear();
+  iterationDurations_.reserve(maximalNumberOfIterations);
+  mEstimator_.setDataNoiseStd(RealType(dataStd));
+
+  bool converged = method_ == Method::LEVENBERG_MARQUARDT ?
+    estimateUsingLevenbergMarquardt_(maximalNumberOfIterations) :
+    estimateUsingGaussNewton_(maximalNumberOfIterations);
+
+  if (!converged) {
+    return false;
+  }
+
+  computeJacobianAndY_();
+
+  double dataVar = dataStd * dataStd;
+  const size_t dataSize = leastSquares_.getDataSize();
+  double mse = leastSquares_.getY().head(dataSize).squaredNorm() / dataSize;
+  if (mse > 25 * dataVar) {
+    return false;
+  }
+
+  // Normal equations are refreshed at final estimate for covariance
+  if (robustKernel_) {
+    computeWeights_();
+    weightJacobianAndY_();
+  }
+  leastSquares_.estimateUsingDampedCholeskyDecomposition(0);
+
+  rmse_ = std::sqrt(mse);
+  estimateCovariance_ = leastSquares_.computeEstimateCovariance(dataVar);
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+template<typename RealType>
+bool NLSE<RealType>::estimateUsingGaussNewton_(const size_t & maximalNumberOfIterations)
+{
   while (numberOfIterations_ < maximalNumberOfIterations) {
+    TimePoint start = now();
     computeJacobianAndY_();
+    if (robustKernel_) {
+      computeWeights_();
+    }
 
-    //    std::cout <<" J "<< std::endl;
-    //    std::cout << J << std::endl;
+    double cost = computeCost_();
+    if (!costHistory_.empty() && isConverged_(costHistory_.back(), cost)) {
+      costHistory_.push_back(cost);
+      return true;
+    }
+    costHistory_.push_back(cost);
 
-    //    std::cout << "Y" << std::endl;
-    //    std::cout << Y << std::endl;
+    if (robustKernel_) {
+      weightJacobianAndY_();
+    }
+    estimateDelta_ = RealType(alpha_) * leastSquares_.estimateUsingDampedCholeskyDecomposition(0);
 
-    estimateDelta_ = RealType(0.7) * leastSquares_.estimateUsingSVD();
+    if (estimateDelta_.norm() < estimateEpsilon_) {
+      return true;
+    }
 
-    //    std::cout << " D " << std::endl;
-    //    std::cout <<  estimateDelta_.transpose() << std::endl;
+    estimate_ -= estimateDelta_;
+    iterationDurations_.push_back(duration(now(), start));
+    ++numberOfIterations_;
+  }
+
+  return false;
+}
+
+//-----------------------------------------------------------------------------
+template<typename RealType>
+bool NLSE<RealType>::estimateUsingLevenbergMarquardt_(const size_t & maximalNumberOfIterations)
+{
+  computeJacobianAndY_();
+  if (robustKernel_) {
+    computeWeights_();
+  }
+  double cost = computeCost_();
+  costHistory_.push_back(cost);
+
+  double damping = initialDamping_;
+  bool computeNormalEquations = true;
+  Vector previousEstimate;
+
+  while (numberOfIterations_ < maximalNumberOfIterations) {
+    TimePoint start = now();
+
+    if (computeNormalEquations && robustKernel_) {
+      weightJacobianAndY_();
+    }
+    estimateDelta_ = leastSquares_.estimateUsingDampedCholeskyDecomposition(
+      RealType(damping), computeNormalEquations);
 
     if (estimateDelta_.norm() < estimateEpsilon_) {
-      break;
+      return true;
     }
 
+    // Trial step is evaluated with the weights of current estimate
+    previousEstimate = estimate_;
     estimate_ -= estimateDelta_;
-
-    //    std::cout << " X " << std::endl;
-    //    std::cout <<  estimate_.transpose() << std::endl;
+    computeJacobianAndY_();
+    double trialCost = computeCost_();
 
     ++numberOfIterations_;
-  }
+    if (std::isfinite(trialCost) && trialCost < cost) {
+      double previousCost = cost;
+      if (robustKernel_) {
+        computeWeights_();
+        cost = computeCost_();
+      } else {
+        cost = trialCost;
+      }
 
-  if (numberOfIterations_ == maximalNumberOfIterations) {
-    return false;
+      damping = std::max(damping / 3, MINIMAL_DAMPING);
+      computeNormalEquations = true;
+      costHistory_.push_back(cost);
+      iterationDurations_.push_back(duration(now(), start));
+
+      if (isConverged_(previousCost, trialCost)) {
+        return true;
+      }
+    } else {
+      // Rejected step : normal equations of current estimate are reused
+      estimate_ = previousEstimate;
+      damping *= 10;
+      computeNormalEquations = false;
+      costHistory_.push_back(cost);
+      iterationDurations_.push_back(duration(now(), start));
+
+      if (damping > MAXIMAL_DAMPING) {
+        return false;
+      }
+    }
   }
 
-  computeJacobianAndY_();
+  return false;
+}
 
-  double dataVar = dataStd * dataStd;
-  double mse = leastSquares_.getY().norm() / leastSquares_.getY().rows();
-  if (mse > 25 * dataStd) {
-    return false;
+//-----------------------------------------------------------------------------
+template<typename RealType>
+void NLSE<RealType>::computeWeights_()
+{
+  const size_t dataSize = leastSquares_.getDataSize();
+  mEstimator_.computeWeights(leastSquares_.getY().head(dataSize));
+  weights_ = mEstimator_.getWeights().head(dataSize);
+}
+
+//-----------------------------------------------------------------------------
+template<typename RealType>
+double NLSE<RealType>::computeCost_() const
+{
+  auto Y = leastSquares_.getY().head(leastSquares_.getDataSize());
+  if (robustKernel_) {
+    return double((weights_.array() * Y.array().square()).sum());
+  } else {
+    return double(Y.squaredNorm());
   }
+}
 
-  rmse_ = std::sqrt(mse);
-  estimateCovariance_ = leastSquares_.computeEstimateCovariance(dataVar);
-  return true;
+//-----------------------------------------------------------------------------
+template<typename RealType>
+void NLSE<RealType>::weightJacobianAndY_()
+{
+  // Normal equations weights are given by MEstimator, rows are scaled by their square root
+  const Eigen::Index dataSize = Eigen::Index(leastSquares_.getDataSize());
+  auto sqrtWeights = weights_.array().sqrt();
+  leastSquares_.getY().head(dataSize).array() *= sqrtWeights;
+  leastSquares_.getJ().topRows(dataSize).array().colwise() *= sqrtWeights;
+}
+
+//-----------------------------------------------------------------------------
+template<typename RealType>
+bool NLSE<RealType>::isConverged_(const double & previousCost, const double & cost) const
+{
+  return cost <= previousCost && previousCost - cost <= relativeCostEpsilon_ * previousCost;
+}
+
+//-----------------------------------------------------------------------------
+template<typename RealType>
+const std::vector<double> & NLSE<RealType>::getCostHistory() const
+{
+  return costHistory_;
+}
+
+//-----------------------------------------------------------------------------
+template<typename RealType>
+const std::vector<Duration> & NLSE<RealType>::getIterationDurations() const
+{
+  return iterationDurations_;
 }
 
 //-----------------------------------------------------------------------------
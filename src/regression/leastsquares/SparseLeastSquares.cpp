@@ -0,0 +1,251 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// romea
+#include "romea_core_common/regression/leastsquares/SparseLeastSquares.hpp"
+
+// std
+#include <algorithm>
+#include <limits>
+
+namespace romea
+{
+namespace core
+{
+
+//-----------------------------------------------------------------------------
+template<typename RealType>
+SparseLeastSquares<RealType>::SparseLeastSquares()
+: dataSize_(0),
+  estimateSize_(0),
+  Ac_(),
+  Bc_(),
+  triplets_(),
+  J_(),
+  isJAssembled_(false),
+  Y_(),
+  W_(),
+  JtJ_(),
+  solver_(),
+  analyzedOuterIndexes_(),
+  analyzedInnerIndexes_(),
+  isSolved_(false)
+{
+}
+
+//-----------------------------------------------------------------------------
+template<typename RealType>
+SparseLeastSquares<RealType>::SparseLeastSquares(const size_t & estimateSize)
+: SparseLeastSquares()
+{
+  setEstimateSize(estimateSize);
+}
+
+//-----------------------------------------------------------------------------
+template<typename RealType>
+void SparseLeastSquares<RealType>::setEstimateSize(const size_t & estimateSize)
+{
+  estimateSize_ = int(estimateSize);
+  Ac_.resize(estimateSize_, estimateSize_);
+  Ac_.setIdentity();
+  Bc_ = Vector::Zero(estimateSize_);
+  triplets_.clear();
+  isJAssembled_ = false;
+  isSolved_ = false;
+}
+
+//-----------------------------------------------------------------------------
+template<typename RealType>
+void SparseLeastSquares<RealType>::setDataSize(const size_t & dataSize)
+{
+  assert(estimateSize_ != 0);
+  dataSize_ = int(dataSize);
+  Y_ = Vector::Zero(dataSize_);
+  W_ = Vector::Ones(dataSize_);
+  triplets_.clear();
+  isJAssembled_ = false;
+  isSolved_ = false;
+}
+
+//-----------------------------------------------------------------------------
+template<typename RealType>
+void SparseLeastSquares<RealType>::setPreconditionner(
+  const SparseMatrix & Ac,
+  const Vector & Bc)
+{
+  Ac_ = Ac;
+  Bc_ = Bc;
+}
+
+//-----------------------------------------------------------------------------
+template<typename RealType>
+void SparseLeastSquares<RealType>::setPreconditionner(const SparseMatrix & Ac)
+{
+  setPreconditionner(Ac, Vector::Zero(estimateSize_));
+}
+
+//-----------------------------------------------------------------------------
+template<typename RealType>
+const typename SparseLeastSquares<RealType>::SparseMatrix &
+SparseLeastSquares<RealType>::getJ()
+{
+  assembleJ_();
+  return J_;
+}
+
+//-----------------------------------------------------------------------------
+template<typename RealType>
+typename SparseLeastSquares<RealType>::Vector &
+SparseLeastSquares<RealType>::getY()
+{
+  return Y_;
+}
+
+//-----------------------------------------------------------------------------
+template<typename RealType>
+const typename SparseLeastSquares<RealType>::Vector &
+SparseLeastSquares<RealType>::getY() const
+{
+  return Y_;
+}
+
+//-----------------------------------------------------------------------------
+template<typename RealType>
+typename SparseLeastSquares<RealType>::Vector &
+SparseLeastSquares<RealType>::getW()
+{
+  return W_;
+}
+
+//-----------------------------------------------------------------------------
+template<typename RealType>
+const typename SparseLeastSquares<RealType>::Vector &
+SparseLeastSquares<RealType>::getW() const
+{
+  return W_;
+}
+
+//-----------------------------------------------------------------------------
+template<typename RealType>
+bool SparseLeastSquares<RealType>::isSolved() const
+{
+  return isSolved_;
+}
+
+//-----------------------------------------------------------------------------
+template<typename RealType>
+typename SparseLeastSquares<RealType>::Vector
+SparseLeastSquares<RealType>::estimateUsingCholeskyDecomposition()
+{
+  assembleJ_();
+  return solve_(J_, Y_);
+}
+
+//-----------------------------------------------------------------------------
+template<typename RealType>
+typename SparseLeastSquares<RealType>::Vector
+SparseLeastSquares<RealType>::weightedEstimate()
+{
+  assembleJ_();
+  SparseMatrix weightedJ = W_.asDiagonal() * J_;
+  return solve_(weightedJ, W_.cwiseProduct(Y_));
+}
+
+//-----------------------------------------------------------------------------
+template<typename RealType>
+typename SparseLeastSquares<RealType>::Matrix
+SparseLeastSquares<RealType>::computeEstimateCovariance(const RealType & dataVariance)
+{
+  return computeEstimateCovarianceBlock(0, size_t(estimateSize_), dataVariance);
+}
+
+//-----------------------------------------------------------------------------
+template<typename RealType>
+typename SparseLeastSquares<RealType>::Matrix
+SparseLeastSquares<RealType>::computeEstimateCovarianceBlock(
+  const size_t & index,
+  const size_t & size,
+  const RealType & dataVariance)
+{
+  assert(isSolved_);
+  assert(int(index + size) <= estimateSize_);
+
+  // Block of Act inverse(JtJ) Ac, only the needed columns of inverse are solved
+  Matrix Ac = Ac_.middleCols(int(index), int(size));
+  Matrix inverseJtJAc = solver_.solve(Ac);
+  return Ac.transpose() * inverseJtJAc * dataVariance;
+}
+
+//-----------------------------------------------------------------------------
+template<typename RealType>
+void SparseLeastSquares<RealType>::assembleJ_()
+{
+  if (!isJAssembled_) {
+    // Blocks added at the same place are summed
+    J_.resize(dataSize_, estimateSize_);
+    J_.setFromTriplets(triplets_.begin(), triplets_.end());
+    isJAssembled_ = true;
+  }
+}
+
+//-----------------------------------------------------------------------------
+template<typename RealType>
+bool SparseLeastSquares<RealType>::hasAnalyzedPattern_() const
+{
+  if (analyzedOuterIndexes_.size() != size_t(JtJ_.outerSize() + 1) ||
+    analyzedInnerIndexes_.size() != size_t(JtJ_.nonZeros()))
+  {
+    return false;
+  }
+
+  const auto * outerIndexes = JtJ_.outerIndexPtr();
+  const auto * innerIndexes = JtJ_.innerIndexPtr();
+  return std::equal(analyzedOuterIndexes_.begin(), analyzedOuterIndexes_.end(), outerIndexes) &&
+         std::equal(analyzedInnerIndexes_.begin(), analyzedInnerIndexes_.end(), innerIndexes);
+}
+
+//-----------------------------------------------------------------------------
+template<typename RealType>
+typename SparseLeastSquares<RealType>::Vector
+SparseLeastSquares<RealType>::solve_(const SparseMatrix & J, const Vector & Y)
+{
+  const SparseMatrix Jt = J.transpose();
+  JtJ_ = Jt * J;
+
+  // Symbolic analysis is only redone when sparsity pattern changes
+  if (!hasAnalyzedPattern_()) {
+    solver_.analyzePattern(JtJ_);
+    const auto * outerIndexes = JtJ_.outerIndexPtr();
+    const auto * innerIndexes = JtJ_.innerIndexPtr();
+    analyzedOuterIndexes_.assign(outerIndexes, outerIndexes + JtJ_.outerSize() + 1);
+    analyzedInnerIndexes_.assign(innerIndexes, innerIndexes + JtJ_.nonZeros());
+  }
+  solver_.factorize(JtJ_);
+
+  isSolved_ = solver_.info() == Eigen::Success;
+  if (!isSolved_) {
+    return Vector::Constant(estimateSize_, std::numeric_limits<RealType>::quiet_NaN());
+  }
+
+  Vector JtY = Jt * Y;
+  return Ac_ * solver_.solve(JtY) + Bc_;
+}
+
+//-----------------------------------------------------------------------------
+template class SparseLeastSquares<float>;
+template class SparseLeastSquares<double>;
+
+}  // namespace core
+}  // namespace romea
@@ -26,5 +26,10 @@ RansacModel::RansacModel()
 {
 }
 
+//-----------------------------------------------------------------------------
+void RansacModel::setSeed(const std::uint64_t & /*seed*/)
+{
+}
+
 }  // namespace core
 }  // namespace romea
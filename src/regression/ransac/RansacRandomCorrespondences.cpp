@@ -33,11 +33,18 @@ RansacRandomCorrespondences<PointType>::RansacRandomCorrespondences()
   scale_(PointType::Zero()),
   weights_(),
   cumSumWeights_(),
-  randomGenerator_(),
-  uniformDistribution_(0.0, 1.0)
+  randomGenerator_()
 {
 }
 
+//-----------------------------------------------------------------------------
+template<class PointType>
+void
+RansacRandomCorrespondences<PointType>::setSeed(const std::uint64_t & seed)
+{
+  randomGenerator_.seed(seed);
+}
+
 //-----------------------------------------------------------------------------
 template<class PointType>
 void
@@ -74,7 +81,7 @@ RansacRandomCorrespondences<PointType>::drawPoints(
     double * I = std::lower_bound(
       cumSumWeights_.data(),
       cumSumWeights_.data() + cumSumWeights_.size(),
-      uniformDistribution_(randomGenerator_));
+      generateUniform<double>(randomGenerator_));
 
     size_t index = size_t(std::distance(cumSumWeights_.data(), I));
     randomCorrespondences[n - 1] = correspondences[index];
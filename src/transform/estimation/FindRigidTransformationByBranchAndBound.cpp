@@ -0,0 +1,345 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+// Eigen
+#include <Eigen/Geometry>
+
+// std
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+// romea
+#include "romea_core_common/transform/estimation/FindRigidTransformationByBranchAndBound.hpp"
+#include "romea_core_common/concurrency/ParallelFor.hpp"
+
+namespace
+{
+constexpr double PI = 3.14159265358979323846;
+const double DEFAULT_LINEAR_SEARCH_HALF_WIDTH = 1.;
+const double DEFAULT_ANGULAR_SEARCH_HALF_WIDTH = PI / 6;
+const double DEFAULT_MINIMAL_SCORE = 0.5;
+const size_t DEFAULT_NUMBER_OF_PYRAMID_LEVELS = 7;
+}
+
+namespace romea
+{
+namespace core
+{
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+FindRigidTransformationByBranchAndBound<PointType>::FindRigidTransformationByBranchAndBound()
+: linearSearchHalfWidth_(DEFAULT_LINEAR_SEARCH_HALF_WIDTH),
+  angularSearchHalfWidth_(DEFAULT_ANGULAR_SEARCH_HALF_WIDTH),
+  minimalScore_(DEFAULT_MINIMAL_SCORE),
+  maximalNumberOfThreads_(getDefaultNumberOfThreads()),
+  likelihoodGrid_(nullptr),
+  gridIndexMapping_(nullptr),
+  pyramid_(DEFAULT_NUMBER_OF_PYRAMID_LEVELS),
+  linearSearchHalfSize_(0),
+  transformation_(TransformationMatrixType::Identity()),
+  score_(0)
+{
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+void FindRigidTransformationByBranchAndBound<PointType>::setLinearSearchWindow(
+  const Scalar & halfWidth)
+{
+  linearSearchHalfWidth_ = halfWidth;
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+void FindRigidTransformationByBranchAndBound<PointType>::setAngularSearchWindow(
+  const Scalar & halfWidth)
+{
+  angularSearchHalfWidth_ = halfWidth;
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+void FindRigidTransformationByBranchAndBound<PointType>::setMinimalScore(
+  const Scalar & minimalScore)
+{
+  minimalScore_ = minimalScore;
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+void FindRigidTransformationByBranchAndBound<PointType>::setNumberOfPyramidLevels(
+  const size_t & numberOfLevels)
+{
+  pyramid_ = GridPyramid<Scalar, 2, MaxPooling>(numberOfLevels);
+  pyramid_.setMaximalNumberOfThreads(maximalNumberOfThreads_);
+  if (likelihoodGrid_ != nullptr) {
+    pyramid_.build(*likelihoodGrid_);
+  }
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+void FindRigidTransformationByBranchAndBound<PointType>::setMaximalNumberOfThreads(
+  const size_t & maximalNumberOfThreads)
+{
+  maximalNumberOfThreads_ = std::max(size_t(1), maximalNumberOfThreads);
+  pyramid_.setMaximalNumberOfThreads(maximalNumberOfThreads_);
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+void FindRigidTransformationByBranchAndBound<PointType>::setLikelihoodGrid(
+  const LikelihoodGrid & likelihoodGrid,
+  const GridIndexMappingType & gridIndexMapping)
+{
+  assert(likelihoodGrid.getNumberOfCellsAlongAxes() ==
+    gridIndexMapping.getNumberOfCellsAlongAxes());
+  likelihoodGrid_ = &likelihoodGrid;
+  gridIndexMapping_ = &gridIndexMapping;
+  pyramid_.build(likelihoodGrid);
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+void FindRigidTransformationByBranchAndBound<PointType>::updateLikelihoodGrid(
+  const typename LikelihoodGrid::CellIndexes & firstCellIndexes,
+  const typename LikelihoodGrid::CellIndexes & lastCellIndexes)
+{
+  pyramid_.markDirtyCells(firstCellIndexes, lastCellIndexes);
+  pyramid_.refresh();
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+bool FindRigidTransformationByBranchAndBound<PointType>::find(
+  const PointSet<PointType> & scanPoints,
+  const TransformationMatrixType & guessTransformation)
+{
+  assert(likelihoodGrid_ != nullptr);
+  assert(!scanPoints.empty());
+  score_ = 0;
+
+  const Scalar resolution = gridIndexMapping_->getCellResolution();
+  const Eigen::Matrix<Scalar, 2, 1> gridOrigin(
+    gridIndexMapping_->getCellCentersPositionAlong(0).front() - resolution / 2,
+    gridIndexMapping_->getCellCentersPositionAlong(1).front() - resolution / 2);
+  linearSearchHalfSize_ = static_cast<int>(std::ceil(linearSearchHalfWidth_ / resolution));
+
+  // Angular step for which farthest point moves by about one cell
+  Scalar maximalRange = 0;
+  for (const PointType & point : scanPoints) {
+    maximalRange = std::max(maximalRange, point.template head<2>().norm());
+  }
+
+  int angularSearchHalfSize = 0;
+  Scalar angularStep = 0;
+  if (angularSearchHalfWidth_ > 0) {
+    angularStep = maximalRange > resolution ?
+      std::acos(1 - resolution * resolution / (2 * maximalRange * maximalRange)) :
+      angularSearchHalfWidth_;
+    angularSearchHalfSize = static_cast<int>(std::ceil(angularSearchHalfWidth_ / angularStep));
+  }
+  const size_t numberOfSlices = 2 * angularSearchHalfSize + 1;
+
+  const Scalar guessYaw = std::atan2(guessTransformation(1, 0), guessTransformation(0, 0));
+  const Eigen::Matrix<Scalar, 2, 1> guessTranslation =
+    guessTransformation.template block<2, 1>(0, 2);
+
+  // Best candidate of each yaw slice, slices share best score for pruning
+  std::vector<Candidate> bestCandidates(numberOfSlices,
+    Candidate{std::numeric_limits<Scalar>::lowest(), 0, 0});
+  std::atomic<Scalar> sharedBestScore(minimalScore_);
+
+  const size_t topLevel = pyramid_.getNumberOfLevels() - 1;
+  const int topLevelBlockSize = 1 << topLevel;
+
+  const size_t numberOfThreads = computeNumberOfThreads(
+    numberOfSlices, MINIMAL_NUMBER_OF_SLICES_PER_THREAD, maximalNumberOfThreads_);
+
+  parallelFor(
+    numberOfSlices, numberOfThreads,
+    [&](const size_t & /*threadIndex*/, const size_t & begin, const size_t & end) {
+      // Candidates of each level, a level having at most 4 children of the
+      // candidate being explored at the upper level
+      ScanCells scanCells(scanPoints.size());
+      std::vector<Candidates> levelCandidates(topLevel + 1);
+      for (size_t level = 0; level < topLevel; ++level) {
+        levelCandidates[level].reserve(4);
+      }
+      Candidates & candidates = levelCandidates[topLevel];
+      for (size_t slice = begin; slice < end; ++slice) {
+        // Rotated scan is discretized once per slice
+        const Scalar yaw = guessYaw + (int(slice) - angularSearchHalfSize) * angularStep;
+        const Eigen::Matrix<Scalar, 2, 2> rotation = Eigen::Rotation2D<Scalar>(yaw).matrix();
+        for (size_t n = 0; n < scanPoints.size(); ++n) {
+          const Eigen::Matrix<Scalar, 2, 1> position =
+            rotation * scanPoints[n].template head<2>() + guessTranslation - gridOrigin;
+          scanCells[n] = (position / resolution).array().floor().template cast<int>();
+        }
+
+        candidates.clear();
+        for (int y = -linearSearchHalfSize_; y <= linearSearchHalfSize_; y += topLevelBlockSize) {
+          for (int x = -linearSearchHalfSize_; x <= linearSearchHalfSize_; x += topLevelBlockSize) {
+            candidates.push_back({computeScoreBound_(scanCells, topLevel, x, y), x, y});
+          }
+        }
+        sortCandidates_(candidates);
+        branchAndBound_(
+          scanCells, topLevel, levelCandidates, bestCandidates[slice], sharedBestScore);
+      }
+    });
+
+  // Highest score, first slice wins in case of equality
+  size_t bestSlice = numberOfSlices;
+  for (size_t slice = 0; slice < numberOfSlices; ++slice) {
+    if (bestCandidates[slice].score >= minimalScore_ &&
+      (bestSlice == numberOfSlices || bestCandidates[slice].score > score_))
+    {
+      bestSlice = slice;
+      score_ = bestCandidates[slice].score;
+    }
+  }
+
+  if (bestSlice == numberOfSlices) {
+    return false;
+  }
+
+  const Candidate & bestCandidate = bestCandidates[bestSlice];
+  const Scalar yaw = guessYaw + (int(bestSlice) - angularSearchHalfSize) * angularStep;
+  transformation_ = TransformationMatrixType::Identity();
+  transformation_.template block<2, 2>(0, 0) = Eigen::Rotation2D<Scalar>(yaw).matrix();
+  transformation_.template block<2, 1>(0, 2) = guessTranslation +
+    resolution * Eigen::Matrix<Scalar, 2, 1>(bestCandidate.xOffset, bestCandidate.yOffset);
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+typename FindRigidTransformationByBranchAndBound<PointType>::Scalar
+FindRigidTransformationByBranchAndBound<PointType>::computeScoreBound_(
+  const ScanCells & scanCells,
+  const size_t & level,
+  const int & xOffset,
+  const int & yOffset) const
+{
+  const LikelihoodGrid & grid = pyramid_.getLevel(level);
+  const int numberOfCellsAlongX = static_cast<int>(likelihoodGrid_->getNumberOfCellsAlongAxes()[0]);
+  const int numberOfCellsAlongY = static_cast<int>(likelihoodGrid_->getNumberOfCellsAlongAxes()[1]);
+  const int blockSize = 1 << level;
+
+  // Base cells [first, last] seen by a scan cell for all block translations
+  // are covered by at most 2x2 cells of the pyramid level
+  Scalar score = 0;
+  for (const Eigen::Vector2i & scanCell : scanCells) {
+    const int firstX = scanCell.x() + xOffset;
+    const int firstY = scanCell.y() + yOffset;
+    const int lastX = firstX + blockSize - 1;
+    const int lastY = firstY + blockSize - 1;
+    if (lastX < 0 || lastY < 0 || firstX >= numberOfCellsAlongX || firstY >= numberOfCellsAlongY) {
+      continue;
+    }
+
+    const size_t x0 = size_t(std::max(firstX, 0)) >> level;
+    const size_t y0 = size_t(std::max(firstY, 0)) >> level;
+    const size_t x1 = size_t(std::min(lastX, numberOfCellsAlongX - 1)) >> level;
+    const size_t y1 = size_t(std::min(lastY, numberOfCellsAlongY - 1)) >> level;
+    const Scalar * row0 = grid.getRow(y0);
+    const Scalar * row1 = grid.getRow(y1);
+    score += std::max(std::max(row0[x0], row0[x1]), std::max(row1[x0], row1[x1]));
+  }
+
+  return score / scanCells.size();
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+void FindRigidTransformationByBranchAndBound<PointType>::branchAndBound_(
+  const ScanCells & scanCells,
+  const size_t & level,
+  std::vector<Candidates> & levelCandidates,
+  Candidate & bestCandidate,
+  std::atomic<Scalar> & sharedBestScore) const
+{
+  for (const Candidate & candidate : levelCandidates[level]) {
+    // Candidates are sorted, remaining ones cannot do better
+    if (candidate.score <= bestCandidate.score ||
+      candidate.score < sharedBestScore.load(std::memory_order_relaxed))
+    {
+      return;
+    }
+
+    if (level == 0) {
+      bestCandidate = candidate;
+      Scalar sharedScore = sharedBestScore.load(std::memory_order_relaxed);
+      while (candidate.score > sharedScore &&
+        !sharedBestScore.compare_exchange_weak(sharedScore, candidate.score)) {}
+      return;
+    }
+
+    const int childBlockSize = 1 << (level - 1);
+    Candidates & children = levelCandidates[level - 1];
+    children.clear();
+    for (int y = 0; y < 2; ++y) {
+      for (int x = 0; x < 2; ++x) {
+        const int xOffset = candidate.xOffset + x * childBlockSize;
+        const int yOffset = candidate.yOffset + y * childBlockSize;
+        if (xOffset <= linearSearchHalfSize_ && yOffset <= linearSearchHalfSize_) {
+          children.push_back({computeScoreBound_(scanCells, level - 1, xOffset, yOffset),
+              xOffset, yOffset});
+        }
+      }
+    }
+    sortCandidates_(children);
+    branchAndBound_(scanCells, level - 1, levelCandidates, bestCandidate, sharedBestScore);
+  }
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+void FindRigidTransformationByBranchAndBound<PointType>::sortCandidates_(
+  Candidates & candidates)
+{
+  std::sort(std::begin(candidates), std::end(candidates),
+    [](const Candidate & c1, const Candidate & c2) {return c1.score > c2.score;});
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+const typename FindRigidTransformationByBranchAndBound<PointType>::TransformationMatrixType &
+FindRigidTransformationByBranchAndBound<PointType>::getTransformation() const
+{
+  return transformation_;
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+const typename FindRigidTransformationByBranchAndBound<PointType>::Scalar &
+FindRigidTransformationByBranchAndBound<PointType>::getScore() const
+{
+  return score_;
+}
+
+template class FindRigidTransformationByBranchAndBound<Eigen::Vector2f>;
+template class FindRigidTransformationByBranchAndBound<Eigen::Vector2d>;
+template class FindRigidTransformationByBranchAndBound<HomogeneousCoordinates2f>;
+template class FindRigidTransformationByBranchAndBound<HomogeneousCoordinates2d>;
+
+}  // namespace core
+}  // namespace romea
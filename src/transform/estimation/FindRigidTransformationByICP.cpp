@@ -14,6 +14,7 @@
 
 
 // std
+#include <cmath>
 #include <limits>
 #include <vector>
 
@@ -46,6 +47,12 @@ FindRigidTransformationByICP<PointType>::FindRigidTransformationByICP(
   matchedCorrespondences_(),
   ransacModel_(),
   ransac_(&ransacModel_, pointsPositionStd),
+  mEstimator_(pointsPositionStd),
+  residuals_(),
+  findRigidTransformationByLeastSquares_(),
+  findRigidTransformationBySVD_(),
+  transformation_(TransformationMatrixType::Identity()),
+  rootMeanSquareError_(std::numeric_limits<double>::max()),
   maximalNumberOfIterations_(ICP_MAXIMAL_NUMBER_OF_ITERATIONS),
   transformationEpsilon_(ICP_TRANSFORMATION_EPSILON)
 {
@@ -128,6 +135,7 @@ bool FindRigidTransformationByICP<PointType>::find(
   double bestFittingRMSE = std::numeric_limits<double>::max();
   TransformationMatrixType bestRigidTransformation = TransformationMatrixType::Identity();
   TransformationMatrixType previousEstimatedTransformation = TransformationMatrixType::Identity();
+  transformation_ = TransformationMatrixType::Identity();
 
   size_t n = 0;
   for (; n < maximalNumberOfIterations_; ++n) {
@@ -190,32 +198,31 @@ bool FindRigidTransformationByICP<PointType>::find(
 
       matchedCorrespondences_[n].sourcePointIndex = n;
       matchedCorrespondences_[n].targetPointIndex = n;
+      matchedCorrespondences_[n].weight = 1;
     }
 
-    // Load data in ransac consensus
-    ransacModel_.loadPointSets(&matchedSourcePoints_, &matchedTargetPoints_);
-    ransacModel_.loadCorrespondences(&matchedCorrespondences_, numberOfMatchedPoints);
-
+    // Estimate transformation
+    bool estimated = true;
     switch (estimationMethod) {
       case EstimationMethod::LEAST_SQUARES:
-        ransacModel_.loadTargetNormalSet(&matchedTargetNormals_);
-        break;
       case EstimationMethod::SVD:
-        ransacModel_.loadTargetNormalSet(nullptr);
+        estimated = estimateByConsensus_(estimationMethod);
+        break;
+      case EstimationMethod::ROBUST_LEAST_SQUARES:
+      case EstimationMethod::ROBUST_SVD:
+        estimateByReweighting_(estimationMethod);
         break;
     }
 
-    // Estimate transformation
-    if (ransac_.estimateModel()) {
+    if (estimated) {
       // Difference between consecutive estimated tranformations
       Scalar differenceBetweenTransformations =
-        (ransacModel_.getTransformation() -
-        previousEstimatedTransformation).array().abs().sum();
+        (transformation_ - previousEstimatedTransformation).array().abs().sum();
 
       // Backup best estimate
-      if (ransacModel_.getRootMeanSquareError() < bestFittingRMSE) {
-        bestRigidTransformation = ransacModel_.getTransformation();
-        bestFittingRMSE = ransacModel_.getRootMeanSquareError();
+      if (rootMeanSquareError_ < bestFittingRMSE) {
+        bestRigidTransformation = transformation_;
+        bestFittingRMSE = rootMeanSquareError_;
       }
 
       // Break loop ?
@@ -224,7 +231,7 @@ bool FindRigidTransformationByICP<PointType>::find(
       }
 
       // Backup current estimation
-      previousEstimatedTransformation = ransacModel_.getTransformation();
+      previousEstimatedTransformation = transformation_;
     }
   }
 
@@ -236,7 +243,105 @@ template<class PointType>
 const typename FindRigidTransformationByICP<PointType>::TransformationMatrixType &
 FindRigidTransformationByICP<PointType>::getTransformation()const
 {
-  return ransacModel_.getTransformation();
+  return transformation_;
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+bool FindRigidTransformationByICP<PointType>::estimateByConsensus_(
+  EstimationMethod estimationMethod)
+{
+  // Load data in ransac consensus
+  ransacModel_.loadPointSets(&matchedSourcePoints_, &matchedTargetPoints_);
+  ransacModel_.loadCorrespondences(&matchedCorrespondences_, matchedCorrespondences_.size());
+
+  if (estimationMethod == EstimationMethod::LEAST_SQUARES) {
+    ransacModel_.loadTargetNormalSet(&matchedTargetNormals_);
+  } else {
+    ransacModel_.loadTargetNormalSet(nullptr);
+  }
+
+  if (!ransac_.estimateModel()) {
+    return false;
+  }
+
+  transformation_ = ransacModel_.getTransformation();
+  rootMeanSquareError_ = ransacModel_.getRootMeanSquareError();
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+void FindRigidTransformationByICP<PointType>::estimateByReweighting_(
+  EstimationMethod estimationMethod)
+{
+  // One reweighting step per ICP iteration, residuals are given by previous estimate
+  reweightCorrespondences_(estimationMethod);
+
+  if (estimationMethod == EstimationMethod::ROBUST_LEAST_SQUARES) {
+    transformation_ = findRigidTransformationByLeastSquares_.find(
+      matchedSourcePoints_, matchedTargetPoints_, matchedTargetNormals_, matchedCorrespondences_);
+  } else {
+    transformation_ = findRigidTransformationBySVD_.find(
+      matchedSourcePoints_, matchedTargetPoints_, matchedCorrespondences_);
+  }
+
+  rootMeanSquareError_ = computeRootMeanSquareError_();
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+void FindRigidTransformationByICP<PointType>::reweightCorrespondences_(
+  EstimationMethod estimationMethod)
+{
+  const size_t numberOfMatchedPoints = matchedCorrespondences_.size();
+  residuals_.resize(static_cast<Eigen::Index>(numberOfMatchedPoints));
+
+  PointType projectedSourcePoint;
+  for (size_t n = 0; n < numberOfMatchedPoints; ++n) {
+    projection(transformation_, matchedSourcePoints_[n], projectedSourcePoint);
+    if (estimationMethod == EstimationMethod::ROBUST_LEAST_SQUARES) {
+      residuals_[n] = (matchedTargetPoints_[n] - projectedSourcePoint).dot(
+        matchedTargetNormals_[n]);
+    } else {
+      residuals_[n] = (matchedTargetPoints_[n] - projectedSourcePoint).norm();
+    }
+  }
+
+  // Point to point distances are non negative, best correspondences being
+  // those close to zero whatever the median distance
+  if (estimationMethod == EstimationMethod::ROBUST_LEAST_SQUARES) {
+    mEstimator_.computeWeights(residuals_);
+  } else {
+    mEstimator_.computeWeightsOfDistances(residuals_);
+  }
+
+  for (size_t n = 0; n < numberOfMatchedPoints; ++n) {
+    matchedCorrespondences_[n].weight = mEstimator_.getWeights()[n];
+  }
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+double FindRigidTransformationByICP<PointType>::computeRootMeanSquareError_() const
+{
+  // Point to point error weighted by correspondence weights
+  double weightedSquareErrorSum = 0;
+  double weightSum = 0;
+  PointType projectedSourcePoint;
+  for (size_t n = 0, N = matchedCorrespondences_.size(); n < N; ++n) {
+    projection(transformation_, matchedSourcePoints_[n], projectedSourcePoint);
+    const double & weight = matchedCorrespondences_[n].weight;
+    weightedSquareErrorSum +=
+      weight * (matchedTargetPoints_[n] - projectedSourcePoint).squaredNorm();
+    weightSum += weight;
+  }
+
+  // No matched or no weighted correspondence, estimate can not be trusted
+  if (weightSum == 0) {
+    return std::numeric_limits<double>::max();
+  }
+  return std::sqrt(weightedSquareErrorSum / weightSum);
 }
 
 template class FindRigidTransformationByICP<Eigen::Vector2f>;
@@ -14,11 +14,13 @@
 
 
 // std
+#include <algorithm>
 #include <limits>
 #include <vector>
 
 // romea
 #include "romea_core_common/transform/estimation/FindRigidTransformationByLeastSquares.hpp"
+#include "romea_core_common/concurrency/ParallelFor.hpp"
 
 namespace romea
 {
@@ -28,13 +30,19 @@ namespace core
 //-----------------------------------------------------------------------------
 template<class PointType>
 FindRigidTransformationByLeastSquares<PointType>::FindRigidTransformationByLeastSquares()
-: leastSquares_()
+: leastSquares_(),
+  threadLeastSquares_(),
+  maximalNumberOfThreads_(getDefaultNumberOfThreads())
 {
-  if (CARTESIAN_DIM == 2) {
-    leastSquares_.setEstimateSize(3);
-  } else {
-    leastSquares_.setEstimateSize(6);
-  }
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+void
+FindRigidTransformationByLeastSquares<PointType>::setMaximalNumberOfThreads(
+  const size_t & maximalNumberOfThreads)
+{
+  maximalNumberOfThreads_ = std::max(size_t(1), maximalNumberOfThreads);
 }
 
 //-----------------------------------------------------------------------------
@@ -53,77 +61,84 @@ FindRigidTransformationByLeastSquares<PointType>::setPreconditioner(
     std::numeric_limits<Scalar>::epsilon());
 
   Scalar scale = targetPoints.getPreconditioningMatrix()(0, 0);
-  Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> Ac;
-
-  if (CARTESIAN_DIM == 2) {
-    Ac = Eigen::Matrix<Scalar, 3, 3>::Identity();
-  } else {
-    Ac = Eigen::Matrix<Scalar, 6, 6>::Identity();
-  }
+  Eigen::Matrix<Scalar, ESTIMATE_SIZE, ESTIMATE_SIZE> Ac =
+    Eigen::Matrix<Scalar, ESTIMATE_SIZE, ESTIMATE_SIZE>::Identity();
 
-  Ac.block(0, 0, CARTESIAN_DIM, CARTESIAN_DIM) /= scale;
+  Ac.template block<CARTESIAN_DIM, CARTESIAN_DIM>(0, 0) /= scale;
   leastSquares_.setPreconditionner(Ac);
 }
 
-// TODO(jean) a factoriser
 //-----------------------------------------------------------------------------
 template<class PointType>
-typename FindRigidTransformationByLeastSquares<PointType>::TransformationMatrixType
-FindRigidTransformationByLeastSquares<PointType>::estimate_(
-  const PointSet<PointType> & sourcePoints,
-  const PointSet<PointType> & targetPoints,
-  const NormalSet<PointType> & targetPointsNormals,
-  const std::vector<Correspondence> & correspondences)
+template<typename RowFunction>
+void
+FindRigidTransformationByLeastSquares<PointType>::buildNormalEquations_(
+  const size_t & numberOfRows,
+  RowFunction && rowFunction)
 {
-  // Allocate least squares matrices
-  size_t numberOfPoints = correspondences.size();
-  leastSquares_.setDataSize(numberOfPoints);
-
-  // Compute Jacobian and residuals
-  auto & J = leastSquares_.getJ();
-  auto & Y = leastSquares_.getY();
-
-  Eigen::Matrix<Scalar, CARTESIAN_DIM + 1, CARTESIAN_DIM + 1> transformationMatrix =
-    Eigen::Matrix<Scalar, CARTESIAN_DIM + 1, CARTESIAN_DIM + 1>::Identity();
+  // Each thread accumulates its own normal equations, they are merged in
+  // thread order so result does not depend on thread scheduling
+  size_t numberOfThreads = computeNumberOfThreads(
+    numberOfRows, MINIMAL_NUMBER_OF_ROWS_PER_THREAD, maximalNumberOfThreads_);
+  threadLeastSquares_.resize(numberOfThreads);
+
+  parallelFor(
+    numberOfRows, numberOfThreads,
+    [&](const size_t & threadIndex, const size_t & begin, const size_t & end) {
+      LeastSquares<Scalar, ESTIMATE_SIZE> & leastSquares = threadLeastSquares_[threadIndex];
+      leastSquares.reset();
+      for (size_t n = begin; n < end; ++n) {
+        rowFunction(leastSquares, n);
+      }
+    });
+
+  leastSquares_.reset();
+  for (const auto & leastSquares : threadLeastSquares_) {
+    leastSquares_.merge(leastSquares);
+  }
+}
 
-  if (CARTESIAN_DIM == 2) {
-    for (size_t n = 0; n < numberOfPoints; ++n) {
-      const Correspondence & correspondence = correspondences[n];
-      const PointType & sourcePoint = sourcePoints[correspondence.sourcePointIndex];
-      const PointType & targetPoint = targetPoints[correspondence.targetPointIndex];
-      const PointType & targetPointNormal = targetPointsNormals[correspondence.targetPointIndex];
+//-----------------------------------------------------------------------------
+template<class PointType>
+void
+FindRigidTransformationByLeastSquares<PointType>::addPointToPlaneRow_(
+  LeastSquares<Scalar, ESTIMATE_SIZE> & leastSquares,
+  const PointType & sourcePoint,
+  const PointType & targetPoint,
+  const PointType & targetPointNormal,
+  const Scalar & weight)
+{
+  EstimateVector jacobianRow;
+  if constexpr (CARTESIAN_DIM == 2) {
+    jacobianRow(0) = targetPointNormal(0);
+    jacobianRow(1) = targetPointNormal(1);
+    jacobianRow(2) = sourcePoint(0) * targetPointNormal(1) - sourcePoint(1) * targetPointNormal(0);
+  } else {
+    jacobianRow(0) = targetPointNormal(0);
+    jacobianRow(1) = targetPointNormal(1);
+    jacobianRow(2) = targetPointNormal(2);
+    jacobianRow(3) = sourcePoint(1) * targetPointNormal(2) - sourcePoint(2) * targetPointNormal(1);
+    jacobianRow(4) = sourcePoint(2) * targetPointNormal(0) - sourcePoint(0) * targetPointNormal(2);
+    jacobianRow(5) = sourcePoint(0) * targetPointNormal(1) - sourcePoint(1) * targetPointNormal(0);
+  }
 
-      J(n, 0) = targetPointNormal(0);
-      J(n, 1) = targetPointNormal(1);
-      J(n, 2) = sourcePoint(0) * targetPointNormal(1) - sourcePoint(1) * targetPointNormal(0);
-      Y(n) = (targetPoint - sourcePoint).dot(targetPointNormal);
-    }
+  leastSquares.addRow(jacobianRow, (targetPoint - sourcePoint).dot(targetPointNormal), weight);
+}
 
-    Eigen::Matrix<Scalar, 3, 1> estimate = leastSquares_.estimateUsingSVD();
+//-----------------------------------------------------------------------------
+template<class PointType>
+typename FindRigidTransformationByLeastSquares<PointType>::TransformationMatrixType
+FindRigidTransformationByLeastSquares<PointType>::toTransformationMatrix_(
+  const EstimateVector & estimate) const
+{
+  TransformationMatrixType transformationMatrix = TransformationMatrixType::Identity();
 
+  if constexpr (CARTESIAN_DIM == 2) {
     transformationMatrix(0, 1) = -estimate(2);
     transformationMatrix(1, 0) = estimate(2);
     transformationMatrix(0, 2) = estimate(0);
     transformationMatrix(1, 2) = estimate(1);
-
   } else {
-    for (size_t n = 0; n < numberOfPoints; ++n) {
-      const Correspondence & correspondence = correspondences[n];
-      const PointType & sourcePoint = sourcePoints[correspondence.sourcePointIndex];
-      const PointType & targetPoint = targetPoints[correspondence.targetPointIndex];
-      const PointType & targetPointNormal = targetPointsNormals[correspondence.targetPointIndex];
-
-      J(n, 0) = targetPointNormal(0);
-      J(n, 1) = targetPointNormal(1);
-      J(n, 2) = targetPointNormal(2);
-      J(n, 3) = sourcePoint(1) * targetPointNormal(2) - sourcePoint(2) * targetPointNormal(1);
-      J(n, 4) = sourcePoint(2) * targetPointNormal(0) - sourcePoint(0) * targetPointNormal(2);
-      J(n, 5) = sourcePoint(0) * targetPointNormal(1) - sourcePoint(1) * targetPointNormal(0);
-      Y(n) = (targetPoint - sourcePoint).dot(targetPointNormal);
-    }
-
-    Eigen::Matrix<Scalar, 6, 1> estimate = leastSquares_.estimateUsingSVD();
-
     transformationMatrix(0, 1) = -estimate(5);
     transformationMatrix(1, 0) = estimate(5);
     transformationMatrix(0, 2) = estimate(4);
@@ -134,9 +149,34 @@ FindRigidTransformationByLeastSquares<PointType>::estimate_(
     transformationMatrix(1, 3) = estimate(1);
     transformationMatrix(2, 3) = estimate(2);
   }
+
   return transformationMatrix;
 }
 
+//-----------------------------------------------------------------------------
+template<class PointType>
+typename FindRigidTransformationByLeastSquares<PointType>::TransformationMatrixType
+FindRigidTransformationByLeastSquares<PointType>::estimate_(
+  const PointSet<PointType> & sourcePoints,
+  const PointSet<PointType> & targetPoints,
+  const NormalSet<PointType> & targetPointsNormals,
+  const std::vector<Correspondence> & correspondences)
+{
+  buildNormalEquations_(
+    correspondences.size(),
+    [&](LeastSquares<Scalar, ESTIMATE_SIZE> & leastSquares, const size_t & n) {
+      const Correspondence & correspondence = correspondences[n];
+      addPointToPlaneRow_(
+        leastSquares,
+        sourcePoints[correspondence.sourcePointIndex],
+        targetPoints[correspondence.targetPointIndex],
+        targetPointsNormals[correspondence.targetPointIndex],
+        Scalar(correspondence.weight));
+    });
+
+  return toTransformationMatrix_(leastSquares_.estimateUsingSVD());
+}
+
 //-----------------------------------------------------------------------------
 template<class PointType>
 typename FindRigidTransformationByLeastSquares<PointType>::TransformationMatrixType
@@ -147,65 +187,14 @@ FindRigidTransformationByLeastSquares<PointType>::estimate_(
 {
   assert(sourcePoints.size() == targetPoints.size());
 
-  // Allocate least squares matrices
-  size_t numberOfPoints = sourcePoints.size();
-  leastSquares_.setDataSize(numberOfPoints);
-
-  // Compute Jacobian and residuals
-  auto & J = leastSquares_.getJ();
-  auto & Y = leastSquares_.getY();
-
-  Eigen::Matrix<Scalar, CARTESIAN_DIM + 1, CARTESIAN_DIM + 1> transformationMatrix =
-    Eigen::Matrix<Scalar, CARTESIAN_DIM + 1, CARTESIAN_DIM + 1>::Identity();
+  buildNormalEquations_(
+    sourcePoints.size(),
+    [&](LeastSquares<Scalar, ESTIMATE_SIZE> & leastSquares, const size_t & n) {
+      addPointToPlaneRow_(
+        leastSquares, sourcePoints[n], targetPoints[n], targetPointsNormals[n], 1);
+    });
 
-  if (CARTESIAN_DIM == 2) {
-    for (size_t n = 0; n < numberOfPoints; ++n) {
-      const PointType & sourcePoint = sourcePoints[n];
-      const PointType & targetPoint = targetPoints[n];
-      const PointType & targetPointNormal = targetPointsNormals[n];
-
-      J(n, 0) = targetPointNormal(0);
-      J(n, 1) = targetPointNormal(1);
-      J(n, 2) = sourcePoint(0) * targetPointNormal(1) - sourcePoint(1) * targetPointNormal(0);
-      Y(n) = (targetPoint - sourcePoint).dot(targetPointNormal);
-    }
-
-    Eigen::Matrix<Scalar, 3, 1> estimate = leastSquares_.estimateUsingSVD();
-
-    transformationMatrix(0, 1) = -estimate(2);
-    transformationMatrix(1, 0) = estimate(2);
-    transformationMatrix(0, 2) = estimate(0);
-    transformationMatrix(1, 2) = estimate(1);
-
-  } else {
-    for (size_t n = 0; n < numberOfPoints; ++n) {
-      const PointType & sourcePoint = sourcePoints[n];
-      const PointType & targetPoint = targetPoints[n];
-      const PointType & targetPointNormal = targetPointsNormals[n];
-
-      J(n, 0) = targetPointNormal(0);
-      J(n, 1) = targetPointNormal(1);
-      J(n, 2) = targetPointNormal(2);
-      J(n, 3) = sourcePoint(1) * targetPointNormal(2) - sourcePoint(2) * targetPointNormal(1);
-      J(n, 4) = sourcePoint(2) * targetPointNormal(0) - sourcePoint(0) * targetPointNormal(2);
-      J(n, 5) = sourcePoint(0) * targetPointNormal(1) - sourcePoint(1) * targetPointNormal(0);
-      Y(n) = (targetPoint - sourcePoint).dot(targetPointNormal);
-    }
-
-    Eigen::Matrix<Scalar, 6, 1> estimate = leastSquares_.estimateUsingSVD();
-
-    transformationMatrix(0, 1) = -estimate(5);
-    transformationMatrix(1, 0) = estimate(5);
-    transformationMatrix(0, 2) = estimate(4);
-    transformationMatrix(2, 0) = -estimate(4);
-    transformationMatrix(1, 2) = -estimate(3);
-    transformationMatrix(2, 1) = estimate(3);
-    transformationMatrix(0, 3) = estimate(0);
-    transformationMatrix(1, 3) = estimate(1);
-    transformationMatrix(2, 3) = estimate(2);
-  }
-
-  return transformationMatrix;
+  return toTransformationMatrix_(leastSquares_.estimateUsingSVD());
 }
 
 //-----------------------------------------------------------------------------
@@ -18,7 +18,6 @@
 
 // romea
 #include "romea_core_common/transform/estimation/FindRigidTransformationBySVD.hpp"
-#include "romea_core_common/containers/Eigen/EigenContainers.hpp"
 
 namespace romea
 {
@@ -28,6 +27,7 @@ namespace core
 //-----------------------------------------------------------------------------
 template<class PointType>
 FindRigidTransformationBySVD<PointType>::FindRigidTransformationBySVD()
+: accumulator_()
 {
 }
 
@@ -86,48 +86,14 @@ FindRigidTransformationBySVD<PointType>::estimate_(
   const PointSet<PointType> & targetPoints,
   const std::vector<Correspondence> & correspondences)
 {
-  // TODO(jean)  changer un calcul single pass
-  // Compute mean
-  PointType sourceMean = PointType::Zero();
-  PointType targetMean = PointType::Zero();
-  for (size_t n = 0, N = correspondences.size(); n < N; ++n) {
-    const size_t & sourceIndex = correspondences[n].sourcePointIndex;
-    const size_t & targetIndex = correspondences[n].targetPointIndex;
-    sourceMean += sourcePoints[sourceIndex];
-    targetMean += targetPoints[targetIndex];
+  accumulator_.reset();
+  for (const Correspondence & correspondence : correspondences) {
+    accumulator_.add(
+      sourcePoints[correspondence.sourcePointIndex].template head<CARTESIAN_DIM>(),
+      targetPoints[correspondence.targetPointIndex].template head<CARTESIAN_DIM>(),
+      Scalar(correspondence.weight));
   }
-  sourceMean /= Scalar(correspondences.size());
-  targetMean /= Scalar(correspondences.size());
-
-  // Compute covariance
-  Eigen::Matrix<Scalar, POINT_SIZE, POINT_SIZE> cov =
-    Eigen::Matrix<Scalar, POINT_SIZE, POINT_SIZE>::Zero();
-
-  for (size_t n = 0; n < correspondences.size(); ++n) {
-    const size_t & sourceIndex = correspondences[n].sourcePointIndex;
-    const size_t & targetIndex = correspondences[n].targetPointIndex;
-    cov += (sourcePoints[sourceIndex] - sourceMean) *
-      (targetPoints[targetIndex] - targetMean).transpose();
-  }
-
-  Eigen::JacobiSVD<Eigen::Matrix<Scalar, -1, -1>>
-  svd(cov.block(0, 0, CARTESIAN_DIM, CARTESIAN_DIM), Eigen::ComputeThinU | Eigen::ComputeThinV);
-
-  Eigen::Matrix<Scalar, -1, -1> u = svd.matrixU();
-  Eigen::Matrix<Scalar, -1, -1> v = svd.matrixV();
-
-  //      if (u.determinant () * v.determinant () < 0)
-  //      {
-  //        for (int x = 0; x < d; ++x)
-  //          v (x, d) *= -1;
-  //      }
-
-  // Compute translation
-  TransformationMatrixType H = TransformationMatrixType::Identity();
-  H.block(0, 0, CARTESIAN_DIM, CARTESIAN_DIM) = v * u.transpose();
-  H.block(0, CARTESIAN_DIM, POINT_SIZE, 1) += targetMean -
-    H.block(0, 0, POINT_SIZE, POINT_SIZE) * sourceMean;
-  return H;
+  return toTransformationMatrix_(accumulator_);
 }
 
 //-----------------------------------------------------------------------------
@@ -139,38 +105,37 @@ FindRigidTransformationBySVD<PointType>::estimate_(
 {
   assert(sourcePoints.size() == targetPoints.size());
 
-  // TODO(jean)  changer un calcul single pass
-
-  // Compute mean
-  PointType sourceMean = mean(sourcePoints);
-  PointType targetMean = mean(targetPoints);
-
-  // Compute covariance
-  Eigen::Matrix<Scalar, POINT_SIZE, POINT_SIZE> cov =
-    Eigen::Matrix<Scalar, POINT_SIZE, POINT_SIZE>::Zero();
-
-  for (size_t n = 0; n < sourcePoints.size(); ++n) {
-    cov += (sourcePoints[n] - sourceMean) *
-      (targetPoints[n] - targetMean).transpose();
+  accumulator_.reset();
+  for (size_t n = 0, N = sourcePoints.size(); n < N; ++n) {
+    accumulator_.add(
+      sourcePoints[n].template head<CARTESIAN_DIM>(),
+      targetPoints[n].template head<CARTESIAN_DIM>());
   }
+  return toTransformationMatrix_(accumulator_);
+}
 
-  Eigen::JacobiSVD<Eigen::Matrix<Scalar, -1, -1>>
-  svd(cov.block(0, 0, CARTESIAN_DIM, CARTESIAN_DIM), Eigen::ComputeThinU | Eigen::ComputeThinV);
+//-----------------------------------------------------------------------------
+template<class PointType>
+typename FindRigidTransformationBySVD<PointType>::TransformationMatrixType
+FindRigidTransformationBySVD<PointType>::toTransformationMatrix_(
+  const CovarianceAccumulatorType & accumulator) const
+{
+  using MatrixType = typename CovarianceAccumulatorType::Matrix;
 
-  Eigen::Matrix<Scalar, -1, -1> u = svd.matrixU();
-  Eigen::Matrix<Scalar, -1, -1> v = svd.matrixV();
+  Eigen::JacobiSVD<MatrixType> svd(
+    accumulator.getCoMoment(), Eigen::ComputeFullU | Eigen::ComputeFullV);
 
-  //      if (u.determinant () * v.determinant () < 0)
-  //      {
-  //        for (int x = 0; x < d; ++x)
-  //          v (x, d) *= -1;
-  //      }
+  // Reflection is turned into rotation by flipping the axis associated to
+  // the smallest singular value (Umeyama)
+  MatrixType v = svd.matrixV();
+  if ((v * svd.matrixU().transpose()).determinant() < 0) {
+    v.col(CARTESIAN_DIM - 1) *= -1;
+  }
 
-  // Compute translation
   TransformationMatrixType H = TransformationMatrixType::Identity();
-  H.block(0, 0, CARTESIAN_DIM, CARTESIAN_DIM) = v * u.transpose();
-  H.block(0, CARTESIAN_DIM, POINT_SIZE, 1) += targetMean -
-    H.block(0, 0, POINT_SIZE, POINT_SIZE) * sourceMean;
+  H.template block<CARTESIAN_DIM, CARTESIAN_DIM>(0, 0) = v * svd.matrixU().transpose();
+  H.template block<CARTESIAN_DIM, 1>(0, CARTESIAN_DIM) = accumulator.getSecondMean() -
+    H.template block<CARTESIAN_DIM, CARTESIAN_DIM>(0, 0) * accumulator.getFirstMean();
   return H;
 }
 
@@ -32,7 +32,8 @@ namespace core
 //-----------------------------------------------------------------------------
 template<class PointType>
 RansacRigidTransformationModel<PointType>::RansacRigidTransformationModel()
-: sourcePoints_(nullptr),
+: RansacModel(),
+  sourcePoints_(nullptr),
   targetPoints_(nullptr),
   targetNormals_(nullptr),
   correspondences_(nullptr),
@@ -349,6 +350,13 @@ double RansacRigidTransformationModel<PointType>::getRootMeanSquareError() const
   return bestRootMeanSquareError_;
 }
 
+//-----------------------------------------------------------------------------
+template<class PointType>
+void RansacRigidTransformationModel<PointType>::setSeed(const std::uint64_t & seed)
+{
+  randomCorrespondences_.setSeed(seed);
+}
+
 //-----------------------------------------------------------------------------
 template<class PointType>
 const typename RansacRigidTransformationModel<PointType>::TransformationMatrixType &
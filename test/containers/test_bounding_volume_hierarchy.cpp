@@ -0,0 +1,343 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+// gtest
+#include <gtest/gtest.h>
+
+// Eigen
+#include <Eigen/Geometry>
+
+// std
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+// romea
+#include "romea_core_common/containers/boundingbox/BoundingVolumeHierarchy.hpp"
+#include "romea_core_common/math/RandomGenerator.hpp"
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+struct RandomBoxes
+{
+  using AABBType = romea::core::AxisAlignedBoundingBox<Scalar, DIM>;
+  using OBBType = romea::core::OrientedBoundingBox<Scalar, DIM>;
+  using PointType = Eigen::Matrix<Scalar, DIM, 1>;
+
+  // Boxes are inserted alternately, box index n is aabbs[n/2] or obbs[n/2]
+  std::vector<AABBType> aabbs;
+  std::vector<OBBType> obbs;
+
+  bool isInside(const size_t & index, const PointType & point) const
+  {
+    return index % 2 == 0 ? aabbs[index / 2].isInside(point) : obbs[index / 2].isInside(point);
+  }
+
+  // Local frame slab test
+  bool intersectRay(
+    const size_t & index,
+    const PointType & origin,
+    const PointType & direction,
+    Scalar & entry) const
+  {
+    Eigen::Matrix<Scalar, DIM, DIM> rotation = Eigen::Matrix<Scalar, DIM, DIM>::Identity();
+    PointType center, halfWidthExtents;
+    if (index % 2 == 0) {
+      center = aabbs[index / 2].getCenterPosition();
+      halfWidthExtents = aabbs[index / 2].getHalfWidthExtents();
+    } else {
+      center = obbs[index / 2].getCenterPosition();
+      halfWidthExtents = obbs[index / 2].getHalfWidthExtents();
+      rotation = obbs[index / 2].getRotationMatrix();
+    }
+    const PointType localOrigin = rotation.transpose() * (origin - center);
+    const PointType localDirection = rotation.transpose() * direction;
+    entry = 0;
+    Scalar exit = std::numeric_limits<Scalar>::max();
+    for (size_t i = 0; i < DIM; ++i) {
+      Scalar t1 = (-halfWidthExtents[i] - localOrigin[i]) / localDirection[i];
+      Scalar t2 = (halfWidthExtents[i] - localOrigin[i]) / localDirection[i];
+      entry = std::max(entry, std::min(t1, t2));
+      exit = std::min(exit, std::max(t1, t2));
+    }
+    return entry <= exit;
+  }
+};
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+Eigen::Matrix<Scalar, DIM, 1> makeRandomPoint(
+  romea::core::RandomGenerator & generator,
+  const Scalar & range)
+{
+  Eigen::Matrix<Scalar, DIM, 1> point;
+  for (size_t i = 0; i < DIM; ++i) {
+    point[i] = range * (2 * romea::core::generateUniform<Scalar>(generator) - 1);
+  }
+  return point;
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+Eigen::Matrix<Scalar, DIM, DIM> makeRandomRotation(romea::core::RandomGenerator & generator)
+{
+  const Scalar angle = 2 * M_PI * romea::core::generateUniform<Scalar>(generator);
+  if constexpr (DIM == 2) {
+    return Eigen::Rotation2D<Scalar>(angle).matrix();
+  } else {
+    Eigen::Matrix<Scalar, 3, 1> axis;
+    romea::core::generateStandardNormals(generator, axis.data(), 3);
+    return Eigen::AngleAxis<Scalar>(angle, axis.normalized()).matrix();
+  }
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+RandomBoxes<Scalar, DIM> makeRandomBoxes(
+  const size_t & numberOfBoxes,
+  romea::core::RandomGenerator & generator,
+  romea::core::BoundingVolumeHierarchy<Scalar, DIM> & bvh)
+{
+  using PointType = Eigen::Matrix<Scalar, DIM, 1>;
+  RandomBoxes<Scalar, DIM> boxes;
+  for (size_t n = 0; n < numberOfBoxes; ++n) {
+    const PointType center = makeRandomPoint<Scalar, DIM>(generator, 50);
+    const PointType halfWidthExtents =
+      makeRandomPoint<Scalar, DIM>(generator, 1.5).cwiseAbs().array() + 0.1;
+    if (n % 2 == 0) {
+      boxes.aabbs.emplace_back(center, halfWidthExtents);
+      EXPECT_EQ(bvh.addBox(boxes.aabbs.back()), n);
+    } else {
+      boxes.obbs.emplace_back(center, halfWidthExtents,
+        makeRandomRotation<Scalar, DIM>(generator));
+      EXPECT_EQ(bvh.addBox(boxes.obbs.back()), n);
+    }
+  }
+  bvh.build();
+  return boxes;
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+void testPointQueries()
+{
+  using PointType = Eigen::Matrix<Scalar, DIM, 1>;
+  const size_t numberOfBoxes = DIM == 2 ? 2000 : 4000;
+
+  romea::core::RandomGenerator generator(DIM);
+  romea::core::BoundingVolumeHierarchy<Scalar, DIM> bvh;
+  bvh.setMaximalNumberOfThreads(4);
+  const auto boxes = makeRandomBoxes<Scalar, DIM>(numberOfBoxes, generator, bvh);
+  EXPECT_EQ(bvh.getNumberOfBoxes(), numberOfBoxes);
+
+  romea::core::PointSet<PointType> points(5000);
+  for (PointType & point : points) {
+    point = makeRandomPoint<Scalar, DIM>(generator, 52);
+  }
+
+  std::vector<size_t> lowestBoxIndexes;
+  bvh.findContainingBoxes(points, lowestBoxIndexes);
+  ASSERT_EQ(lowestBoxIndexes.size(), points.size());
+
+  size_t numberOfContainedPoints = 0;
+  std::vector<size_t> boxIndexes;
+  for (size_t n = 0; n < points.size(); ++n) {
+    std::vector<size_t> expectedBoxIndexes;
+    for (size_t index = 0; index < numberOfBoxes; ++index) {
+      if (boxes.isInside(index, points[n])) {
+        expectedBoxIndexes.push_back(index);
+      }
+    }
+
+    bvh.findBoxesContaining(points[n], boxIndexes);
+    EXPECT_EQ(boxIndexes, expectedBoxIndexes);
+    if (expectedBoxIndexes.empty()) {
+      EXPECT_EQ(lowestBoxIndexes[n], bvh.NO_BOX);
+    } else {
+      EXPECT_EQ(lowestBoxIndexes[n], expectedBoxIndexes.front());
+      ++numberOfContainedPoints;
+    }
+  }
+  EXPECT_GT(numberOfContainedPoints, 50u);
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestBoundingVolumeHierarchy, pointQueries)
+{
+  testPointQueries<float, 2>();
+  testPointQueries<double, 3>();
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+void testOverlapQueries()
+{
+  using PointType = Eigen::Matrix<Scalar, DIM, 1>;
+  using AABBType = romea::core::AxisAlignedBoundingBox<Scalar, DIM>;
+  using OBBType = romea::core::OrientedBoundingBox<Scalar, DIM>;
+
+  romea::core::RandomGenerator generator(10 + DIM);
+  romea::core::BoundingVolumeHierarchy<Scalar, DIM> bvh;
+  const auto boxes = makeRandomBoxes<Scalar, DIM>(1000, generator, bvh);
+
+  for (size_t n = 0; n < 200; ++n) {
+    const PointType center = makeRandomPoint<Scalar, DIM>(generator, 50);
+    const PointType halfWidthExtents =
+      makeRandomPoint<Scalar, DIM>(generator, 4).cwiseAbs().array() + 0.1;
+    const AABBType aabb(center, halfWidthExtents);
+    const OBBType obb(center, halfWidthExtents, makeRandomRotation<Scalar, DIM>(generator));
+
+    // Axis aligned boxes overlap when their intervals overlap
+    std::vector<size_t> aabbOverlaps, obbOverlaps;
+    bvh.findBoxesOverlapping(aabb, aabbOverlaps);
+    bvh.findBoxesOverlapping(obb, obbOverlaps);
+    for (size_t k = 0; k < boxes.aabbs.size(); ++k) {
+      const PointType lower = boxes.aabbs[k].getCenterPosition() -
+        boxes.aabbs[k].getHalfWidthExtents();
+      const PointType upper = boxes.aabbs[k].getCenterPosition() +
+        boxes.aabbs[k].getHalfWidthExtents();
+      const bool overlap = ((lower - center).array() <= halfWidthExtents.array()).all() &&
+        ((center - upper).array() <= halfWidthExtents.array()).all();
+      EXPECT_EQ(std::binary_search(aabbOverlaps.begin(), aabbOverlaps.end(), 2 * k), overlap);
+    }
+
+    // Found boxes must include every box sharing a sampled point with the
+    // query box and be overlapped by its envelope
+    const AABBType envelope = obb.toAxisAlignedBoundingBox();
+    for (size_t m = 0; m < 500; ++m) {
+      PointType point = center;
+      for (size_t i = 0; i < DIM; ++i) {
+        point += obb.getRotationMatrix().col(i) * halfWidthExtents[i] *
+          (2 * romea::core::generateUniform<Scalar>(generator) - 1);
+      }
+      for (size_t index = 0; index < 1000; ++index) {
+        if (boxes.isInside(index, point)) {
+          EXPECT_TRUE(std::binary_search(obbOverlaps.begin(), obbOverlaps.end(), index));
+        }
+      }
+    }
+
+    std::vector<size_t> envelopeOverlaps;
+    bvh.findBoxesOverlapping(envelope, envelopeOverlaps);
+    for (const size_t & index : obbOverlaps) {
+      EXPECT_TRUE(std::binary_search(envelopeOverlaps.begin(), envelopeOverlaps.end(), index));
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestBoundingVolumeHierarchy, overlapQueries)
+{
+  testOverlapQueries<double, 2>();
+  testOverlapQueries<float, 3>();
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+void testRayQueries()
+{
+  using PointType = Eigen::Matrix<Scalar, DIM, 1>;
+  const Scalar maximalDistance = 30;
+
+  romea::core::RandomGenerator generator(20 + DIM);
+  romea::core::BoundingVolumeHierarchy<Scalar, DIM> bvh;
+  bvh.setMaximalNumberOfThreads(4);
+  const auto boxes = makeRandomBoxes<Scalar, DIM>(1000, generator, bvh);
+
+  romea::core::PointSet<PointType> origins(2000), directions(2000);
+  for (size_t n = 0; n < origins.size(); ++n) {
+    origins[n] = makeRandomPoint<Scalar, DIM>(generator, 50);
+    directions[n] = makeRandomPoint<Scalar, DIM>(generator, 1).normalized();
+  }
+  // Axis aligned directions
+  directions[0] = PointType::UnitX();
+  directions[1] = -PointType::UnitY();
+
+  std::vector<size_t> boxIndexes;
+  std::vector<Scalar> distances;
+  bvh.castRays(origins, directions, maximalDistance, boxIndexes, distances);
+
+  size_t numberOfHits = 0;
+  for (size_t n = 0; n < origins.size(); ++n) {
+    size_t expectedBoxIndex = bvh.NO_BOX;
+    Scalar expectedDistance = std::numeric_limits<Scalar>::infinity();
+    for (size_t index = 0; index < 1000; ++index) {
+      Scalar entry;
+      if (boxes.intersectRay(index, origins[n], directions[n], entry) &&
+        entry <= maximalDistance && entry < expectedDistance)
+      {
+        expectedBoxIndex = index;
+        expectedDistance = entry;
+      }
+    }
+
+    if (expectedBoxIndex == bvh.NO_BOX) {
+      EXPECT_EQ(boxIndexes[n], bvh.NO_BOX);
+    } else {
+      // Near ties the hit box may differ, distance may not
+      EXPECT_NEAR(distances[n], expectedDistance, 1e-4);
+      ++numberOfHits;
+    }
+
+    size_t boxIndex;
+    Scalar distance;
+    EXPECT_EQ(bvh.findFirstRayIntersection(
+        origins[n], directions[n], maximalDistance, boxIndex, distance),
+      boxIndexes[n] != bvh.NO_BOX);
+    EXPECT_EQ(boxIndex, boxIndexes[n]);
+  }
+  EXPECT_GT(numberOfHits, 100u);
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestBoundingVolumeHierarchy, rayQueries)
+{
+  testRayQueries<float, 2>();
+  testRayQueries<double, 3>();
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestBoundingVolumeHierarchy, emptyAndDegenerate)
+{
+  romea::core::BoundingVolumeHierarchy3d bvh;
+  bvh.build();
+  std::vector<size_t> boxIndexes;
+  bvh.findBoxesContaining(Eigen::Vector3d::Zero(), boxIndexes);
+  EXPECT_TRUE(boxIndexes.empty());
+
+  // Identical boxes cannot be separated by centers and are split at median
+  for (size_t n = 0; n < 100; ++n) {
+    bvh.addBox(romea::core::AxisAlignedBoundingBox3d(Eigen::Vector3d::Zero(),
+      Eigen::Vector3d::Ones()));
+  }
+  bvh.build();
+  bvh.findBoxesContaining(Eigen::Vector3d(0.5, 0.5, -1), boxIndexes);
+  EXPECT_EQ(boxIndexes.size(), 100u);
+
+  size_t boxIndex;
+  double distance;
+  EXPECT_TRUE(bvh.findFirstRayIntersection(Eigen::Vector3d(-5, 0, 0),
+    Eigen::Vector3d::UnitX(), 10, boxIndex, distance));
+  EXPECT_EQ(boxIndex, 0u);
+  EXPECT_DOUBLE_EQ(distance, 4);
+}
+
+//-----------------------------------------------------------------------------
+int main(int argc, char ** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,268 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+// gtest
+#include <gtest/gtest.h>
+
+// std
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// romea
+#include "romea_core_common/containers/grid/DistanceTransform.hpp"
+#include "romea_core_common/math/RandomGenerator.hpp"
+
+//-----------------------------------------------------------------------------
+template<size_t DIM>
+Eigen::Matrix<size_t, DIM, 1> makeCellIndexes(
+  const size_t & linearIndex,
+  const Eigen::Matrix<size_t, DIM, 1> & numberOfCells)
+{
+  Eigen::Matrix<size_t, DIM, 1> cellIndexes;
+  size_t index = linearIndex;
+  for (size_t i = 0; i < DIM; ++i) {
+    cellIndexes[i] = index % numberOfCells[i];
+    index /= numberOfCells[i];
+  }
+  return cellIndexes;
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM, typename GridType>
+void checkDistances(
+  const GridType & grid,
+  const romea::core::DistanceTransform<Scalar, DIM> & distanceTransform)
+{
+  // Brute force squared distances clamped to maximal distance
+  using CellIndexes = Eigen::Matrix<size_t, DIM, 1>;
+  const CellIndexes & numberOfCells = grid.getNumberOfCellsAlongAxes();
+  const size_t numberOfCellsInGrid = numberOfCells.prod();
+  const Scalar maximalDistance =
+    distanceTransform.getMaximalDistance() / distanceTransform.getCellResolution();
+
+  std::vector<CellIndexes> obstacles;
+  for (size_t n = 0; n < numberOfCellsInGrid; ++n) {
+    if (grid(makeCellIndexes<DIM>(n, numberOfCells))) {
+      obstacles.push_back(makeCellIndexes<DIM>(n, numberOfCells));
+    }
+  }
+
+  size_t numberOfErrors = 0;
+  for (size_t n = 0; n < numberOfCellsInGrid; ++n) {
+    const CellIndexes cellIndexes = makeCellIndexes<DIM>(n, numberOfCells);
+    Scalar expected = std::numeric_limits<Scalar>::infinity();
+    for (const CellIndexes & obstacle : obstacles) {
+      expected = std::min(expected, Scalar(
+          (cellIndexes.template cast<double>() - obstacle.template cast<double>()).squaredNorm()));
+    }
+    expected = std::min(expected, maximalDistance * maximalDistance);
+    numberOfErrors += distanceTransform.getSquaredDistance(cellIndexes) != expected;
+  }
+  EXPECT_EQ(numberOfErrors, 0u);
+}
+
+//-----------------------------------------------------------------------------
+template<size_t DIM, typename GridType>
+void addRandomObstacles(
+  GridType & grid,
+  const size_t & numberOfObstacles,
+  romea::core::RandomGenerator & generator)
+{
+  const auto & numberOfCells = grid.getNumberOfCellsAlongAxes();
+  for (size_t n = 0; n < numberOfObstacles; ++n) {
+    grid(makeCellIndexes<DIM>(generator() % numberOfCells.prod(), numberOfCells)) = 1;
+  }
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+void testCompute(const Eigen::Matrix<size_t, DIM, 1> & numberOfCells)
+{
+  romea::core::RandomGenerator generator(0);
+  romea::core::Grid<std::uint8_t, DIM> grid(numberOfCells);
+  addRandomObstacles<DIM>(grid, 20, generator);
+
+  auto isObstacle = [](const std::uint8_t & value) {return value != 0;};
+
+  romea::core::DistanceTransform<Scalar, DIM> distanceTransform(numberOfCells, 0.1);
+  distanceTransform.setMaximalNumberOfThreads(1);
+  distanceTransform.compute(grid, isObstacle);
+  checkDistances(grid, distanceTransform);
+
+  romea::core::DistanceTransform<Scalar, DIM> clampedDistanceTransform(numberOfCells, 0.1, 0.45);
+  clampedDistanceTransform.setMaximalNumberOfThreads(4);
+  clampedDistanceTransform.compute(grid, isObstacle);
+  checkDistances(grid, clampedDistanceTransform);
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestDistanceTransform, compute)
+{
+  testCompute<float, 2>(Eigen::Matrix<size_t, 2, 1>(40, 30));
+  testCompute<double, 2>(Eigen::Matrix<size_t, 2, 1>(40, 30));
+  testCompute<float, 3>(Eigen::Matrix<size_t, 3, 1>(16, 12, 10));
+  testCompute<double, 3>(Eigen::Matrix<size_t, 3, 1>(16, 12, 10));
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestDistanceTransform, emptyGrid)
+{
+  romea::core::Grid<std::uint8_t, 2> grid(Eigen::Matrix<size_t, 2, 1>(10, 10));
+  romea::core::DistanceTransform2d distanceTransform(grid.getNumberOfCellsAlongAxes(), 0.1, 0.5);
+  distanceTransform.compute(grid, [](const std::uint8_t & value) {return value != 0;});
+  EXPECT_DOUBLE_EQ(distanceTransform.getDistance(Eigen::Matrix<size_t, 2, 1>(3, 4)), 0.5);
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+void testUpdate(const Eigen::Matrix<size_t, DIM, 1> & numberOfCells)
+{
+  using CellIndexes = Eigen::Matrix<size_t, DIM, 1>;
+  romea::core::RandomGenerator generator(1);
+  romea::core::Grid<std::uint8_t, DIM> grid(numberOfCells);
+  addRandomObstacles<DIM>(grid, 30, generator);
+
+  auto isObstacle = [](const std::uint8_t & value) {return value != 0;};
+  romea::core::DistanceTransform<Scalar, DIM> distanceTransform(numberOfCells, 0.1, 0.6);
+  distanceTransform.compute(grid, isObstacle);
+
+  for (size_t iteration = 0; iteration < 5; ++iteration) {
+    // toggle a few neighbour cells
+    CellIndexes center = makeCellIndexes<DIM>(generator() % numberOfCells.prod(), numberOfCells);
+    for (size_t n = 0; n < 4; ++n) {
+      CellIndexes cellIndexes = center;
+      cellIndexes[n % DIM] = std::min(cellIndexes[n % DIM] + n, numberOfCells[n % DIM] - 1);
+      grid(cellIndexes) = !grid(cellIndexes);
+      distanceTransform.markChangedCell(cellIndexes);
+    }
+    distanceTransform.update(grid, isObstacle);
+    checkDistances(grid, distanceTransform);
+  }
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestDistanceTransform, updateChangedCells)
+{
+  testUpdate<float, 2>(Eigen::Matrix<size_t, 2, 1>(50, 40));
+  testUpdate<double, 3>(Eigen::Matrix<size_t, 3, 1>(20, 16, 12));
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+void testTranslate(
+  const Eigen::Matrix<size_t, DIM, 1> & numberOfCells,
+  const std::vector<Eigen::Matrix<int, DIM, 1>> & offsets)
+{
+  romea::core::RandomGenerator generator(2);
+  romea::core::WrappableGrid<std::uint8_t, DIM> grid(numberOfCells);
+  addRandomObstacles<DIM>(grid, 30, generator);
+
+  auto isObstacle = [](const std::uint8_t & value) {return value != 0;};
+  romea::core::DistanceTransform<Scalar, DIM> distanceTransform(numberOfCells, 0.1, 0.5);
+  distanceTransform.compute(grid, isObstacle);
+
+  for (const auto & offset : offsets) {
+    // a changed cell before translation, then new obstacles in vacated cells
+    const auto changedCellIndexes =
+      makeCellIndexes<DIM>(generator() % numberOfCells.prod(), numberOfCells);
+    grid(changedCellIndexes) = 1;
+    distanceTransform.markChangedCell(changedCellIndexes);
+
+    grid.translate(offset, 0);
+    distanceTransform.translate(offset);
+    for (size_t n = 0; n < numberOfCells.prod(); ++n) {
+      const auto cellIndexes = makeCellIndexes<DIM>(n, numberOfCells);
+      bool isVacated = false;
+      for (size_t i = 0; i < DIM; ++i) {
+        isVacated |= offset[i] > 0 ? cellIndexes[i] + offset[i] >= numberOfCells[i] :
+          cellIndexes[i] < size_t(-offset[i]);
+      }
+      if (isVacated && generator() % 8 == 0) {
+        grid(cellIndexes) = 1;
+      }
+    }
+
+    distanceTransform.update(grid, isObstacle);
+    checkDistances(grid, distanceTransform);
+  }
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestDistanceTransform, followWrappableGridTranslation)
+{
+  testTranslate<double, 2>(
+    Eigen::Matrix<size_t, 2, 1>(40, 30),
+    {Eigen::Vector2i(3, 0), Eigen::Vector2i(-2, 5), Eigen::Vector2i(7, -4), Eigen::Vector2i(0, 0),
+      Eigen::Vector2i(45, 1)});
+  testTranslate<float, 3>(
+    Eigen::Matrix<size_t, 3, 1>(16, 12, 10),
+    {Eigen::Vector3i(1, 2, -3), Eigen::Vector3i(-4, 0, 2)});
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestDistanceTransform, inflationLayer)
+{
+  romea::core::Grid<std::uint8_t, 2> grid(Eigen::Matrix<size_t, 2, 1>(21, 21));
+  grid(Eigen::Matrix<size_t, 2, 1>(10, 10)) = 1;
+
+  romea::core::DistanceTransform2d distanceTransform(grid.getNumberOfCellsAlongAxes(), 0.1, 1.);
+  distanceTransform.compute(grid, [](const std::uint8_t & value) {return value != 0;});
+
+  romea::core::Grid<std::uint8_t, 2> costs;
+  distanceTransform.computeInflationLayer(0.2, 0.6, 2., costs);
+  EXPECT_EQ(costs(Eigen::Matrix<size_t, 2, 1>(10, 10)), romea::core::INFLATION_LAYER_LETHAL_COST);
+  EXPECT_EQ(costs(Eigen::Matrix<size_t, 2, 1>(12, 10)),
+    romea::core::INFLATION_LAYER_INSCRIBED_COST);
+  EXPECT_EQ(costs(Eigen::Matrix<size_t, 2, 1>(14, 10)), std::uint8_t(252 * std::exp(-2 * 0.2)));
+  EXPECT_EQ(costs(Eigen::Matrix<size_t, 2, 1>(17, 10)), romea::core::INFLATION_LAYER_FREE_COST);
+  EXPECT_GT(costs(Eigen::Matrix<size_t, 2, 1>(14, 10)), costs(Eigen::Matrix<size_t, 2, 1>(15, 10)));
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestDistanceTransform, inflationLayerInWrappableGrid)
+{
+  const Eigen::Matrix<size_t, 2, 1> numberOfCells(21, 17);
+  romea::core::WrappableGrid<std::uint8_t, 2> grid(numberOfCells);
+  grid(Eigen::Matrix<size_t, 2, 1>(10, 8)) = 1;
+  grid.translate(Eigen::Vector2i(3, -2), 0);
+
+  romea::core::DistanceTransform2d distanceTransform(numberOfCells, 0.1, 1.);
+  distanceTransform.compute(grid, [](const std::uint8_t & value) {return value != 0;});
+
+  romea::core::Grid<std::uint8_t, 2> costs;
+  distanceTransform.computeInflationLayer(0.2, 0.6, 2., costs);
+
+  romea::core::WrappableGrid<std::uint8_t, 2> wrappableCosts(numberOfCells);
+  wrappableCosts.translate(Eigen::Vector2i(3, -2), 0);
+  distanceTransform.computeInflationLayer(0.2, 0.6, 2., wrappableCosts);
+
+  EXPECT_EQ(costs(Eigen::Matrix<size_t, 2, 1>(7, 10)), romea::core::INFLATION_LAYER_LETHAL_COST);
+  for (size_t yi = 0; yi < numberOfCells[1]; ++yi) {
+    for (size_t xi = 0; xi < numberOfCells[0]; ++xi) {
+      const Eigen::Matrix<size_t, 2, 1> cellIndexes(xi, yi);
+      EXPECT_EQ(wrappableCosts(cellIndexes), costs(cellIndexes));
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+int main(int argc, char ** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -16,9 +16,14 @@
 // gtest
 #include <gtest/gtest.h>
 
+// std
+#include <algorithm>
+#include <vector>
+
 // romea
 #include "romea_core_common/containers/grid/GridIndexMapping.hpp"
 #include "romea_core_common/containers/grid/WrappableGrid.hpp"
+#include "romea_core_common/containers/grid/TiledGrid.hpp"
 #include "romea_core_common/containers/grid/RayTracing.hpp"
 
 class TestGridIndexMapping2d : public ::testing::Test
@@ -147,6 +152,37 @@ TEST_F(TestGrid2d, setDefaultValue)
   }
 }
 
+//-----------------------------------------------------------------------------
+TEST_F(TestGrid2d, getRow)
+{
+  const int * row = grid.getRow(2);
+  for (size_t xi = 0; xi < 3; ++xi) {
+    EXPECT_EQ(row[xi], grid(CellIndexes(xi, 2)));
+  }
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestGrid2d, setBoxValue)
+{
+  grid.setValue(CellIndexes(1, 0), CellIndexes(2, 1), -1);
+
+  EXPECT_EQ(grid.count(-1), 4u);
+  EXPECT_EQ(grid(CellIndexes(0, 1)), 3);
+  EXPECT_EQ(grid(CellIndexes(1, 1)), -1);
+  EXPECT_EQ(grid(CellIndexes(2, 0)), -1);
+  EXPECT_EQ(grid(CellIndexes(2, 2)), 8);
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestGrid2d, reductions)
+{
+  EXPECT_EQ(grid.sum(), 36);
+  EXPECT_EQ(grid.minValue(), 0);
+  EXPECT_EQ(grid.maxValue(), 8);
+  EXPECT_EQ(grid.count(4), 1u);
+  EXPECT_EQ(grid.reduce(1, [](const int & a, const int & b) {return a * (b + 1);}), 362880);
+}
+
 //-----------------------------------------------------------------------------
 class TestGrid3d : public ::testing::Test
 {
@@ -191,6 +227,71 @@ TEST_F(TestGrid3d, setDefaultValue)
   }
 }
 
+//-----------------------------------------------------------------------------
+TEST_F(TestGrid3d, getRowAndSlab)
+{
+  const int * row = grid.getRow(1, 2);
+  for (size_t xi = 0; xi < 3; ++xi) {
+    EXPECT_EQ(row[xi], grid(CellIndexes(xi, 1, 2)));
+  }
+
+  const int * slab = grid.getSlab(1);
+  for (size_t n = 0; n < 9; ++n) {
+    EXPECT_EQ(slab[n], grid(CellIndexes(n % 3, n / 3, 1)));
+  }
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestGrid3d, setBoxValue)
+{
+  grid.setValue(CellIndexes(0, 1, 1), CellIndexes(1, 2, 2), -1);
+
+  EXPECT_EQ(grid.count(-1), 8u);
+  EXPECT_EQ(grid(CellIndexes(0, 1, 0)), 3);
+  EXPECT_EQ(grid(CellIndexes(2, 1, 1)), 14);
+  EXPECT_EQ(grid(CellIndexes(1, 2, 2)), -1);
+  EXPECT_EQ(grid.sum(), 351 - 8 - (12 + 13 + 15 + 16 + 21 + 22 + 24 + 25));
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestTiledGrid, matchesGrid)
+{
+  using CellIndexes = romea::core::Grid<int, 3>::CellIndexes;
+
+  // Sizes are not multiple of tile size in order to check padding
+  CellIndexes numberOfCells(11, 5, 9);
+  romea::core::Grid<int, 3> grid(numberOfCells);
+  romea::core::TiledGrid<int, 3, 2> tiledGrid(numberOfCells);
+  EXPECT_EQ(tiledGrid.getNumberOfTilesAlongAxes(), CellIndexes(3, 2, 3));
+  EXPECT_EQ(tiledGrid.getBuffer().size(), 18u * 64u);
+
+  tiledGrid.setValue(-1);
+  int n = 0;
+  for (size_t zi = 0; zi < 9; ++zi) {
+    for (size_t yi = 0; yi < 5; ++yi) {
+      for (size_t xi = 0; xi < 11; ++xi) {
+        grid(CellIndexes(xi, yi, zi)) = n;
+        tiledGrid(CellIndexes(xi, yi, zi)) = n++;
+      }
+    }
+  }
+
+  // Each cell has its own storage
+  EXPECT_EQ(std::count(tiledGrid.getBuffer().begin(), tiledGrid.getBuffer().end(), -1),
+    18 * 64 - 11 * 5 * 9);
+  for (size_t zi = 0; zi < 9; ++zi) {
+    for (size_t yi = 0; yi < 5; ++yi) {
+      for (size_t xi = 0; xi < 11; ++xi) {
+        EXPECT_EQ(tiledGrid(CellIndexes(xi, yi, zi)), grid(CellIndexes(xi, yi, zi)));
+      }
+    }
+  }
+
+  // Cells of a tile are contiguous
+  EXPECT_EQ(tiledGrid.getBuffer()[5], grid(CellIndexes(1, 1, 0)));
+  EXPECT_EQ(tiledGrid.getBuffer()[64], grid(CellIndexes(4, 0, 0)));
+}
+
 //-----------------------------------------------------------------------------
 TEST(TestContainers, testCircularGrid2D)
 {
@@ -279,6 +380,109 @@ TEST_F(TestCircularGrid3D, hasEmptyValuesAfterTranslate)
   }
 }
 
+//-----------------------------------------------------------------------------
+TEST_F(TestCircularGrid3D, translateBackwardAlongZ)
+{
+  grid.translate(CellIndexesOffset(0, 0, -1));
+
+  EXPECT_EQ(grid.getIndexOffsetAlongAxes().z(), 2);
+  for (size_t yi = 0; yi < 3; ++yi) {
+    for (size_t xi = 0; xi < 3; ++xi) {
+      EXPECT_EQ(grid(CellIndexes(xi, yi, 0)), 0);
+      EXPECT_EQ(grid(CellIndexes(xi, yi, 1)), int(xi + 3 * yi));
+      EXPECT_EQ(grid(CellIndexes(xi, yi, 2)), int(xi + 3 * yi + 9));
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestCircularGrid3D, translateMoreThanGridSize)
+{
+  grid.translate(CellIndexesOffset(0, 0, -7), -1);
+
+  EXPECT_EQ(grid.getIndexOffsetAlongAxes().z(), 2);
+  EXPECT_EQ(grid.count(-1), 27u);
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestContainers, wrappableGridSuccessiveTranslations)
+{
+  using CellIndexes = romea::core::WrappableGrid<int, 3>::CellIndexes;
+  using CellIndexesOffset = romea::core::WrappableGrid<int, 3>::CellIndexesOffset;
+
+  // Reference is a plain grid shifted cell by cell
+  const CellIndexes numberOfCells(5, 4, 6);
+  romea::core::WrappableGrid<int, 3> grid(numberOfCells);
+  romea::core::Grid<int, 3> reference(numberOfCells);
+
+  int n = 1;
+  for (size_t zi = 0; zi < 6; ++zi) {
+    for (size_t yi = 0; yi < 4; ++yi) {
+      for (size_t xi = 0; xi < 5; ++xi) {
+        grid(CellIndexes(xi, yi, zi)) = n;
+        reference(CellIndexes(xi, yi, zi)) = n++;
+      }
+    }
+  }
+
+  const std::vector<CellIndexesOffset> offsets = {
+    CellIndexesOffset(1, 0, 0), CellIndexesOffset(-2, 1, -1), CellIndexesOffset(2, -1, 2),
+    CellIndexesOffset(0, -2, -1), CellIndexesOffset(-1, 1, 1), CellIndexesOffset(1, 1, -1)};
+
+  for (const CellIndexesOffset & offset : offsets) {
+    grid.translate(offset);
+
+    romea::core::Grid<int, 3> shifted(numberOfCells);
+    for (size_t zi = 0; zi < 6; ++zi) {
+      for (size_t yi = 0; yi < 4; ++yi) {
+        for (size_t xi = 0; xi < 5; ++xi) {
+          Eigen::Vector3i source = Eigen::Vector3i(xi, yi, zi) + offset;
+          bool isInside = (source.array() >= 0).all() &&
+            (source.array() < numberOfCells.cast<int>().array()).all();
+          shifted(CellIndexes(xi, yi, zi)) = isInside ? reference(source.cast<size_t>()) : 0;
+        }
+      }
+    }
+    reference = shifted;
+
+    for (size_t zi = 0; zi < 6; ++zi) {
+      for (size_t yi = 0; yi < 4; ++yi) {
+        for (size_t xi = 0; xi < 5; ++xi) {
+          EXPECT_EQ(grid(CellIndexes(xi, yi, zi)), reference(CellIndexes(xi, yi, zi)));
+        }
+      }
+    }
+  }
+  EXPECT_EQ(reference.count(0), 120u - 12u);
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestContainers, wrappableGridBoxSetValue)
+{
+  using CellIndexes = romea::core::WrappableGrid<int, 3>::CellIndexes;
+  using CellIndexesOffset = romea::core::WrappableGrid<int, 3>::CellIndexesOffset;
+
+  const CellIndexes numberOfCells(5, 4, 3);
+  romea::core::WrappableGrid<int, 3> grid(numberOfCells);
+  grid.translate(CellIndexesOffset(3, -1, 2));
+
+  // Box is wrapped along every axis in the physical buffer
+  const CellIndexes first(1, 1, 0);
+  const CellIndexes last(4, 2, 1);
+  grid.setValue(first, last, 1);
+
+  for (size_t zi = 0; zi < 3; ++zi) {
+    for (size_t yi = 0; yi < 4; ++yi) {
+      for (size_t xi = 0; xi < 5; ++xi) {
+        const CellIndexes cellIndexes(xi, yi, zi);
+        const bool isInside = (cellIndexes.array() >= first.array()).all() &&
+          (cellIndexes.array() <= last.array()).all();
+        EXPECT_EQ(grid(cellIndexes), isInside ? 1 : 0);
+      }
+    }
+  }
+}
+
 //-----------------------------------------------------------------------------
 int main(int argc, char ** argv)
 {
@@ -0,0 +1,169 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+// gtest
+#include <gtest/gtest.h>
+
+// std
+#include <algorithm>
+#include <limits>
+
+// romea
+#include "romea_core_common/containers/grid/GridPyramid.hpp"
+#include "romea_core_common/math/RandomGenerator.hpp"
+
+//-----------------------------------------------------------------------------
+template<size_t DIM>
+Eigen::Matrix<size_t, DIM, 1> makeCellIndexes(
+  const size_t & linearIndex,
+  const Eigen::Matrix<size_t, DIM, 1> & numberOfCells)
+{
+  Eigen::Matrix<size_t, DIM, 1> cellIndexes;
+  size_t index = linearIndex;
+  for (size_t i = 0; i < DIM; ++i) {
+    cellIndexes[i] = index % numberOfCells[i];
+    index /= numberOfCells[i];
+  }
+  return cellIndexes;
+}
+
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM>
+void fillRandomly(romea::core::Grid<T, DIM> & grid, romea::core::RandomGenerator & generator)
+{
+  for (T & value : grid.getBuffer()) {
+    value = T(romea::core::generateUniform<double>(generator) * 100);
+  }
+}
+
+//-----------------------------------------------------------------------------
+template<typename T, size_t DIM, typename Pooling>
+void checkPyramid(const romea::core::GridPyramid<T, DIM, Pooling> & pyramid)
+{
+  // Each level cell is compared to brute force pooling of the base cells it covers
+  using CellIndexes = Eigen::Matrix<size_t, DIM, 1>;
+  const romea::core::Grid<T, DIM> & base = pyramid.getLevel(0);
+  const CellIndexes & baseNumberOfCells = base.getNumberOfCellsAlongAxes();
+
+  for (size_t level = 1; level < pyramid.getNumberOfLevels(); ++level) {
+    const romea::core::Grid<T, DIM> & grid = pyramid.getLevel(level);
+    const CellIndexes & numberOfCells = grid.getNumberOfCellsAlongAxes();
+    for (size_t i = 0; i < DIM; ++i) {
+      ASSERT_EQ(numberOfCells[i], (baseNumberOfCells[i] + (size_t(1) << level) - 1) >> level);
+    }
+
+    for (size_t n = 0; n < numberOfCells.prod(); ++n) {
+      const CellIndexes cellIndexes = makeCellIndexes<DIM>(n, numberOfCells);
+      T minimum = std::numeric_limits<T>::max();
+      T maximum = std::numeric_limits<T>::lowest();
+      for (size_t m = 0; m < baseNumberOfCells.prod(); ++m) {
+        const CellIndexes baseCellIndexes = makeCellIndexes<DIM>(m, baseNumberOfCells);
+        if (pyramid.computeLevelCellIndexes(baseCellIndexes, level) == cellIndexes) {
+          minimum = std::min(minimum, base(baseCellIndexes));
+          maximum = std::max(maximum, base(baseCellIndexes));
+        }
+      }
+
+      if constexpr (std::is_same<Pooling, romea::core::MaxPooling>::value) {
+        EXPECT_EQ(grid(cellIndexes), maximum);
+      } else if constexpr (std::is_same<Pooling, romea::core::MinPooling>::value) {
+        EXPECT_EQ(grid(cellIndexes), minimum);
+      } else {
+        EXPECT_GE(grid(cellIndexes), minimum - T(1e-4));
+        EXPECT_LE(grid(cellIndexes), maximum + T(1e-4));
+      }
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestGridPyramid, maxPooling2D)
+{
+  romea::core::RandomGenerator generator(1);
+  romea::core::Grid<float, 2> grid(Eigen::Matrix<size_t, 2, 1>(37, 21));
+  fillRandomly(grid, generator);
+
+  romea::core::GridPyramid<float, 2> pyramid(4);
+  pyramid.build(grid);
+  EXPECT_EQ(&pyramid.getLevel(0), &grid);
+  checkPyramid(pyramid);
+  EXPECT_EQ(pyramid.getLevel(3).getNumberOfCellsAlongAxes()[0], 5u);
+  EXPECT_EQ(pyramid.getLevel(3).getNumberOfCellsAlongAxes()[1], 3u);
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestGridPyramid, minPooling3D)
+{
+  romea::core::RandomGenerator generator(2);
+  romea::core::Grid<int, 3> grid(Eigen::Matrix<size_t, 3, 1>(13, 8, 5));
+  fillRandomly(grid, generator);
+
+  romea::core::GridPyramid<int, 3, romea::core::MinPooling> pyramid(3);
+  pyramid.build(grid);
+  checkPyramid(pyramid);
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestGridPyramid, meanPooling)
+{
+  romea::core::Grid<double, 2> grid(Eigen::Matrix<size_t, 2, 1>(4, 3));
+  for (size_t n = 0; n < 12; ++n) {
+    grid.getBuffer()[n] = double(n);
+  }
+
+  romea::core::GridPyramid<double, 2, romea::core::MeanPooling> pyramid(2);
+  pyramid.build(grid);
+  checkPyramid(pyramid);
+
+  // Odd last row is pooled with itself
+  const romea::core::Grid<double, 2> & level = pyramid.getLevel(1);
+  EXPECT_DOUBLE_EQ(level(Eigen::Matrix<size_t, 2, 1>(0, 0)), 2.5);
+  EXPECT_DOUBLE_EQ(level(Eigen::Matrix<size_t, 2, 1>(1, 0)), 4.5);
+  EXPECT_DOUBLE_EQ(level(Eigen::Matrix<size_t, 2, 1>(0, 1)), 8.5);
+  EXPECT_DOUBLE_EQ(level(Eigen::Matrix<size_t, 2, 1>(1, 1)), 10.5);
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestGridPyramid, refreshDirtyCells)
+{
+  romea::core::RandomGenerator generator(3);
+  romea::core::Grid<float, 3> grid(Eigen::Matrix<size_t, 3, 1>(33, 18, 9));
+  fillRandomly(grid, generator);
+
+  romea::core::GridPyramid<float, 3> pyramid(5);
+  pyramid.setMaximalNumberOfThreads(4);
+  pyramid.build(grid);
+
+  // Two distant modifications, refresh of their bounding box must give
+  // the same pyramid as a full build
+  Eigen::Matrix<size_t, 3, 1> first(3, 2, 1), last(6, 4, 1);
+  grid.setValue(first, last, 1000.f);
+  pyramid.markDirtyCells(first, last);
+  grid(Eigen::Matrix<size_t, 3, 1>(32, 17, 8)) = -1000.f;
+  pyramid.markDirtyCells(Eigen::Matrix<size_t, 3, 1>(32, 17, 8),
+    Eigen::Matrix<size_t, 3, 1>(32, 17, 8));
+  pyramid.refresh();
+  checkPyramid(pyramid);
+
+  EXPECT_EQ(pyramid.getLevel(4).maxValue(), 1000.f);
+}
+
+//-----------------------------------------------------------------------------
+int main(int argc, char ** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,150 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// gtest
+#include <gtest/gtest.h>
+
+// std
+#include <cstdint>
+
+// romea
+#include "romea_core_common/containers/grid/OccupancyGrid.hpp"
+
+using OccupancyGrid2d = romea::core::OccupancyGrid<double, 2>;
+
+//-----------------------------------------------------------------------------
+romea::core::VectorOfEigenVector<Eigen::Vector2d> makeWallScan(const double & x)
+{
+  romea::core::VectorOfEigenVector<Eigen::Vector2d> points;
+  for (double y = -2; y <= 2; y += 0.02) {
+    points.emplace_back(x, y);
+  }
+  return points;
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestOccupancyGrid, integrateScan)
+{
+  OccupancyGrid2d occupancyGrid(10, 0.1);
+  auto scan = makeWallScan(3.02);
+
+  occupancyGrid.integrateScan(Eigen::Vector2d::Zero(), scan);
+  EXPECT_NEAR(occupancyGrid.getOccupancyProbability(Eigen::Vector2d(3, 1)), 0.7, 0.01);
+  EXPECT_NEAR(occupancyGrid.getOccupancyProbability(Eigen::Vector2d(1.5, 0.5)), 0.4, 0.01);
+  EXPECT_DOUBLE_EQ(occupancyGrid.getOccupancyProbability(Eigen::Vector2d(4, 0)), 0.5);
+  EXPECT_DOUBLE_EQ(occupancyGrid.getOccupancyProbability(Eigen::Vector2d(-1, 0)), 0.5);
+
+  const romea::core::OccupancyGridStatistics & statistics = occupancyGrid.getStatistics();
+  EXPECT_EQ(statistics.numberOfRays, scan.size());
+  EXPECT_EQ(statistics.numberOfOccupiedCells, 41u);
+  // Triangle between sensor and wall is about 6 square meters
+  EXPECT_GT(statistics.numberOfFreeCells, 550u);
+  EXPECT_LT(statistics.numberOfFreeCells, 700u);
+  EXPECT_GT(statistics.rayCastingDuration.count(), 0);
+
+  // Log odds are clamped
+  for (size_t n = 0; n < 50; ++n) {
+    occupancyGrid.integrateScan(Eigen::Vector2d::Zero(), scan);
+  }
+  EXPECT_NEAR(occupancyGrid.getOccupancyProbability(Eigen::Vector2d(3, 1)), 0.97, 0.001);
+  EXPECT_NEAR(occupancyGrid.getOccupancyProbability(Eigen::Vector2d(1.5, 0.5)), 0.12, 0.001);
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestOccupancyGrid, clampingKeepsStoredLogOdds)
+{
+  OccupancyGrid2d occupancyGrid(10, 0.1);
+  occupancyGrid.integrateScan(Eigen::Vector2d::Zero(), makeWallScan(3.02));
+  const double hitLogOdds = occupancyGrid.getLogOdds(Eigen::Vector2d(3, 1));
+  const double missLogOdds = occupancyGrid.getLogOdds(Eigen::Vector2d(1.5, 0.5));
+
+  // Wider bounds change the fixed point scale
+  occupancyGrid.setClampingProbabilities(0.01, 0.999);
+  EXPECT_NEAR(occupancyGrid.getLogOdds(Eigen::Vector2d(3, 1)), hitLogOdds, 1e-3);
+  EXPECT_NEAR(occupancyGrid.getLogOdds(Eigen::Vector2d(1.5, 0.5)), missLogOdds, 1e-3);
+  EXPECT_DOUBLE_EQ(occupancyGrid.getOccupancyProbability(Eigen::Vector2d(4, 0)), 0.5);
+
+  // Narrower bounds clamp stored cells
+  occupancyGrid.setClampingProbabilities(0.45, 0.6);
+  EXPECT_NEAR(occupancyGrid.getOccupancyProbability(Eigen::Vector2d(3, 1)), 0.6, 1e-3);
+  EXPECT_NEAR(occupancyGrid.getOccupancyProbability(Eigen::Vector2d(1.5, 0.5)), 0.45, 1e-3);
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestOccupancyGrid, rolling)
+{
+  OccupancyGrid2d occupancyGrid(5, 0.1);
+  occupancyGrid.integrateScan(Eigen::Vector2d::Zero(), makeWallScan(3.02));
+
+  // Map content stays at the same world position
+  occupancyGrid.moveTo(Eigen::Vector2d(1.04, -0.53));
+  EXPECT_TRUE(occupancyGrid.getCenterPosition().isApprox(Eigen::Vector2d(1.0, -0.5)));
+  EXPECT_NEAR(occupancyGrid.getOccupancyProbability(Eigen::Vector2d(3, 1)), 0.7, 0.01);
+  EXPECT_NEAR(occupancyGrid.getOccupancyProbability(Eigen::Vector2d(1.5, 0.5)), 0.4, 0.01);
+  EXPECT_DOUBLE_EQ(occupancyGrid.getOccupancyProbability(Eigen::Vector2d(5.5, -4)), 0.5);
+  EXPECT_FALSE(occupancyGrid.isInside(Eigen::Vector2d(-4.6, 0)));
+
+  // Integration in moved grid
+  occupancyGrid.integrateScan(Eigen::Vector2d(1, 0), makeWallScan(5.02));
+  EXPECT_NEAR(occupancyGrid.getOccupancyProbability(Eigen::Vector2d(5, 1)), 0.7, 0.01);
+
+  occupancyGrid.moveTo(Eigen::Vector2d(-20, 0));
+  EXPECT_EQ(occupancyGrid.getGrid().count(0), occupancyGrid.getGrid().getBuffer().size());
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestOccupancyGrid, raysAreTruncated)
+{
+  OccupancyGrid2d occupancyGrid(5, 0.1);
+  occupancyGrid.setMaximalSensorRange(2);
+  occupancyGrid.integrateScan(Eigen::Vector2d::Zero(), makeWallScan(3.02));
+  EXPECT_EQ(occupancyGrid.getStatistics().numberOfOccupiedCells, 0u);
+  EXPECT_NEAR(occupancyGrid.getOccupancyProbability(Eigen::Vector2d(1.5, 0)), 0.4, 0.01);
+  EXPECT_DOUBLE_EQ(occupancyGrid.getOccupancyProbability(Eigen::Vector2d(2.5, 0)), 0.5);
+
+  // Points outside the grid are only used for free space
+  occupancyGrid.setMaximalSensorRange(100);
+  occupancyGrid.integrateScan(Eigen::Vector2d::Zero(), makeWallScan(20));
+  EXPECT_EQ(occupancyGrid.getStatistics().numberOfOccupiedCells, 0u);
+  EXPECT_NEAR(occupancyGrid.getOccupancyProbability(Eigen::Vector2d(4.5, 0)), 0.4, 0.01);
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestOccupancyGrid, int8Cells3d)
+{
+  romea::core::OccupancyGrid<float, 3, std::int8_t> occupancyGrid(4, 0.2);
+  occupancyGrid.setMaximalNumberOfThreads(2);
+
+  romea::core::VectorOfEigenVector<Eigen::Vector3f> scan;
+  for (float y = -1; y <= 1; y += 0.05f) {
+    for (float z = -1; z <= 1; z += 0.05f) {
+      scan.emplace_back(2.1f, y, z);
+    }
+  }
+
+  for (size_t n = 0; n < 3; ++n) {
+    occupancyGrid.integrateScan(Eigen::Vector3f(0.f, 0.f, 0.f), scan);
+  }
+  EXPECT_GT(occupancyGrid.getOccupancyProbability(Eigen::Vector3f(2.1f, 0.5f, -0.5f)), 0.9);
+  EXPECT_LT(occupancyGrid.getOccupancyProbability(Eigen::Vector3f(1.f, 0.2f, 0.1f)), 0.3);
+  EXPECT_EQ(occupancyGrid.getOccupancyProbability(Eigen::Vector3f(-1.f, 0.f, 0.f)), 0.5);
+}
+
+//-----------------------------------------------------------------------------
+int main(int argc, char ** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
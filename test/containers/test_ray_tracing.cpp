@@ -19,12 +19,17 @@
 // std
 #include <iostream>
 #include <chrono>
+#include <set>
+#include <tuple>
+#include <type_traits>
 
 
 // romea
 #include "romea_core_common/containers/grid/GridIndexMapping.hpp"
 #include "romea_core_common/containers/grid/WrappableGrid.hpp"
 #include "romea_core_common/containers/grid/RayTracing.hpp"
+#include "romea_core_common/containers/grid/ScanRayCasting.hpp"
+#include "romea_core_common/math/RandomGenerator.hpp"
 
 
 //-----------------------------------------------------------------------------
@@ -141,6 +146,205 @@ TEST(TestContainers, testRayCasting3d)
   EXPECT_EQ(endPointIndexes.z(), ray.back().z());
 }
 
+//-----------------------------------------------------------------------------
+template<typename CellIndexes>
+std::tuple<size_t, size_t, size_t> toTuple(const CellIndexes & cellIndexes)
+{
+  return {cellIndexes[0], cellIndexes[1], cellIndexes.size() == 3 ? cellIndexes[2] : 0};
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+void testScanRayCasting(
+  const size_t & numberOfThreads,
+  const bool & endPointsOnCellBorders = false)
+{
+  using PointType = typename romea::core::ScanRayCasting<Scalar, DIM>::PointType;
+  using CellIndexes = typename romea::core::ScanRayCasting<Scalar, DIM>::CellIndexes;
+  using Cell = std::tuple<size_t, size_t, size_t>;
+
+  romea::core::GridIndexMapping<Scalar, DIM> gridIndexMapping(10., 0.1);
+  romea::core::RandomGenerator generator(0);
+  const PointType originPoint = PointType::Constant(0.42);
+  romea::core::VectorOfEigenVector<PointType> endPoints(500);
+  for (PointType & endPoint : endPoints) {
+    for (size_t n = 0; n < DIM; ++n) {
+      endPoint[n] = 9 * (2 * romea::core::generateUniform<Scalar>(generator) - 1);
+    }
+    if (endPointsOnCellBorders) {
+      // Lower corner of the end cell, a border along each axis
+      const CellIndexes cellIndexes = gridIndexMapping.computeCellIndexes(endPoint);
+      endPoint = gridIndexMapping.computeCellCenterPosition(cellIndexes) -
+        PointType::Constant(gridIndexMapping.getCellResolution() / 2);
+    }
+  }
+  endPoints.push_back(endPoints.front());
+
+  // Reference is given by casting rays one by one
+  romea::core::RayCasting<Scalar, DIM> rayCasting(&gridIndexMapping);
+  std::multiset<Cell> expectedVisitedCells;
+  std::set<Cell> expectedOccupiedCells;
+  std::set<Cell> expectedCrossedCells;
+  for (const PointType & endPoint : endPoints) {
+    romea::core::VectorOfEigenVector<CellIndexes> ray = rayCasting.cast(originPoint, endPoint);
+    for (size_t n = 0; n < ray.size(); ++n) {
+      expectedVisitedCells.insert(toTuple(ray[n]));
+      if (n + 1 < ray.size()) {
+        expectedCrossedCells.insert(toTuple(ray[n]));
+      }
+    }
+    expectedOccupiedCells.insert(toTuple(ray.back()));
+  }
+
+  romea::core::ScanRayCasting<Scalar, DIM> scanRayCasting(&gridIndexMapping);
+  scanRayCasting.setMaximalNumberOfThreads(numberOfThreads);
+  EXPECT_EQ(scanRayCasting.computeNumberOfThreads(endPoints.size()), numberOfThreads);
+
+  std::vector<std::multiset<Cell>> threadVisitedCells(numberOfThreads);
+  std::vector<size_t> threadNumberOfEndCells(numberOfThreads, 0);
+  scanRayCasting.cast(
+    originPoint, endPoints,
+    [&](const size_t & threadIndex, const CellIndexes & cellIndexes, const bool & isHitCell) {
+      threadVisitedCells[threadIndex].insert(toTuple(cellIndexes));
+      threadNumberOfEndCells[threadIndex] += isHitCell;
+    });
+
+  std::multiset<Cell> visitedCells;
+  size_t numberOfEndCells = 0;
+  for (size_t n = 0; n < numberOfThreads; ++n) {
+    visitedCells.insert(threadVisitedCells[n].begin(), threadVisitedCells[n].end());
+    numberOfEndCells += threadNumberOfEndCells[n];
+  }
+  EXPECT_EQ(visitedCells, expectedVisitedCells);
+  EXPECT_EQ(numberOfEndCells, endPoints.size());
+
+  // Each cell is given once
+  scanRayCasting.computeFreeAndOccupiedCells(originPoint, endPoints);
+  std::set<Cell> occupiedCells;
+  for (const CellIndexes & cellIndexes : scanRayCasting.getOccupiedCells()) {
+    EXPECT_TRUE(occupiedCells.insert(toTuple(cellIndexes)).second);
+  }
+  std::set<Cell> freeCells;
+  for (const CellIndexes & cellIndexes : scanRayCasting.getFreeCells()) {
+    EXPECT_TRUE(freeCells.insert(toTuple(cellIndexes)).second);
+    EXPECT_EQ(occupiedCells.count(toTuple(cellIndexes)), 0u);
+  }
+
+  EXPECT_EQ(occupiedCells, expectedOccupiedCells);
+  for (const Cell & cell : expectedOccupiedCells) {
+    expectedCrossedCells.erase(cell);
+  }
+  EXPECT_EQ(freeCells, expectedCrossedCells);
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestContainers, testScanRayCasting2d)
+{
+  testScanRayCasting<double, 2>(1);
+  testScanRayCasting<float, 2>(4);
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestContainers, testScanRayCasting3d)
+{
+  testScanRayCasting<double, 3>(1);
+  testScanRayCasting<float, 3>(4);
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestContainers, testScanRayCastingEndPointsOnCellBorders)
+{
+  testScanRayCasting<double, 2>(1, true);
+  testScanRayCasting<float, 2>(4, true);
+  testScanRayCasting<double, 3>(1, true);
+  testScanRayCasting<float, 3>(4, true);
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+void testRayCastingMatchesFloatingPointTraversal()
+{
+  using PointType = typename romea::core::RayCasting<Scalar, DIM>::PointType;
+  using CellIndexes = typename romea::core::RayCasting<Scalar, DIM>::CellIndexes;
+
+  romea::core::GridIndexMapping<Scalar, DIM> gridIndexMapping(10., 0.1);
+  romea::core::RayCasting<Scalar, DIM> rayCasting(&gridIndexMapping);
+  romea::core::RandomGenerator generator(1);
+
+  // Crossing parameters closer than tolerance are ties, their order may differ
+  const long double tolerance = std::is_same<Scalar, float>::value ? 1e-5 : 1e-10;
+  const long double resolution = gridIndexMapping.getCellResolution();
+
+  size_t numberOfComparedRays = 0;
+  for (size_t r = 0; r < 2000; ++r) {
+    PointType originPoint, endPoint;
+    for (size_t n = 0; n < DIM; ++n) {
+      originPoint[n] = 9 * (2 * romea::core::generateUniform<Scalar>(generator) - 1);
+      endPoint[n] = 9 * (2 * romea::core::generateUniform<Scalar>(generator) - 1);
+    }
+    if (r % 10 == 0) {
+      // axis aligned rays
+      endPoint[r % DIM] = originPoint[r % DIM];
+    }
+
+    romea::core::VectorOfEigenVector<CellIndexes> ray = rayCasting.cast(originPoint, endPoint);
+    ASSERT_EQ(ray.size(), rayCasting.computeRayNumberOfCells());
+    EXPECT_EQ(ray.front(), rayCasting.getOriginPointIndexes());
+    EXPECT_EQ(ray.back(), rayCasting.getEndPointIndexes());
+
+    // Floating point Amanatides-Woo reference
+    CellIndexes cellIndexes = ray.front();
+    PointType cellCenter = gridIndexMapping.computeCellCenterPosition(cellIndexes);
+    long double tMax[DIM], tDelta[DIM];
+    int step[DIM];
+    for (size_t n = 0; n < DIM; ++n) {
+      long double direction = (long double)endPoint[n] - originPoint[n];
+      step[n] = direction > 0 ? 1 : (direction < 0 ? -1 : 0);
+      long double border = cellCenter[n] + step[n] * resolution / 2;
+      tMax[n] = step[n] ? (border - originPoint[n]) / direction : 1e30L;
+      tDelta[n] = step[n] ? resolution / std::abs(direction) : 1e30L;
+    }
+
+    bool hasTie = false;
+    bool isEqual = true;
+    for (size_t k = 1; k < ray.size(); ++k) {
+      size_t axis = 0;
+      for (size_t n = 1; n < DIM; ++n) {
+        if (!(tMax[axis] < tMax[n])) {
+          axis = n;
+        }
+      }
+      for (size_t n = 0; n < DIM; ++n) {
+        hasTie |= n != axis && std::abs(tMax[n] - tMax[axis]) < tolerance;
+      }
+      cellIndexes[axis] += step[axis];
+      tMax[axis] += tDelta[axis];
+      isEqual &= cellIndexes == ray[k];
+    }
+
+    // Whatever the tie breaking, each step moves to a face neighbour
+    for (size_t k = 1; k < ray.size(); ++k) {
+      EXPECT_EQ((ray[k].template cast<long>() - ray[k - 1].template cast<long>()).cwiseAbs().sum(),
+        1);
+    }
+
+    if (!hasTie) {
+      EXPECT_TRUE(isEqual);
+      ++numberOfComparedRays;
+    }
+  }
+  EXPECT_GT(numberOfComparedRays, 1500u);
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestContainers, testRayCastingMatchesFloatingPointTraversal)
+{
+  testRayCastingMatchesFloatingPointTraversal<float, 2>();
+  testRayCastingMatchesFloatingPointTraversal<double, 2>();
+  testRayCastingMatchesFloatingPointTraversal<float, 3>();
+  testRayCastingMatchesFloatingPointTraversal<double, 3>();
+}
+
 
 ////-----------------------------------------------------------------------------
 // TEST(TestContainers,testRayCasting2dOutRange)
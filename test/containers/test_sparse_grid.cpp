@@ -0,0 +1,185 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// gtest
+#include <gtest/gtest.h>
+
+// std
+#include <algorithm>
+#include <map>
+#include <tuple>
+
+// romea
+#include "romea_core_common/containers/grid/GridIndexMapping.hpp"
+#include "romea_core_common/containers/grid/RayTracing.hpp"
+#include "romea_core_common/containers/grid/Grid.hpp"
+#include "romea_core_common/containers/grid/SparseGrid.hpp"
+#include "romea_core_common/math/RandomGenerator.hpp"
+
+using CellIndexes3 = romea::core::SparseGrid<float, 3>::CellIndexes;
+
+//-----------------------------------------------------------------------------
+TEST(TestSparseGrid, readAndWrite)
+{
+  romea::core::SparseGrid<int, 2, 2> grid(Eigen::Matrix<size_t, 2, 1>(100, 50), -1);
+  using CellIndexes = romea::core::SparseGrid<int, 2, 2>::CellIndexes;
+
+  const auto & constGrid = grid;
+  EXPECT_EQ(constGrid(CellIndexes(10, 20)), -1);
+  EXPECT_EQ(grid.find(CellIndexes(10, 20)), nullptr);
+  EXPECT_EQ(grid.getNumberOfBlocks(), 0u);
+
+  grid(CellIndexes(10, 20)) = 3;
+  grid(CellIndexes(11, 21)) = 4;
+  grid(CellIndexes(99, 49)) = 5;
+  EXPECT_EQ(grid.getNumberOfBlocks(), 2u);
+  EXPECT_EQ(constGrid(CellIndexes(10, 20)), 3);
+  EXPECT_EQ(constGrid(CellIndexes(11, 21)), 4);
+  EXPECT_EQ(constGrid(CellIndexes(99, 49)), 5);
+  EXPECT_EQ(constGrid(CellIndexes(8, 20)), -1);
+
+  size_t numberOfBlocks = 0;
+  grid.forEachBlock([&](const CellIndexes & firstCellIndexes, const auto & cells) {
+      EXPECT_TRUE(firstCellIndexes == CellIndexes(8, 20) ||
+      firstCellIndexes == CellIndexes(96, 48));
+      EXPECT_EQ(cells.size(), 16u);
+      ++numberOfBlocks;
+    });
+  EXPECT_EQ(numberOfBlocks, 2u);
+
+  grid.clear();
+  EXPECT_EQ(grid.getNumberOfBlocks(), 0u);
+  EXPECT_EQ(constGrid(CellIndexes(10, 20)), -1);
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestSparseGrid, matchesReferenceAfterManyInsertionsAndEvictions)
+{
+  // Small blocks in order to stress hash map growth and backward shift deletion
+  romea::core::SparseGrid<int, 3, 1> grid(CellIndexes3::Constant(64), 0);
+  std::map<std::tuple<size_t, size_t, size_t>, int> reference;
+
+  romea::core::RandomGenerator generator(0);
+  auto draw = [&]() {
+      return size_t(romea::core::generateUniform<double>(generator) * 64);
+    };
+
+  for (int n = 1; n <= 5000; ++n) {
+    CellIndexes3 cellIndexes(draw(), draw(), draw());
+    grid(cellIndexes) = n;
+    reference[{cellIndexes.x(), cellIndexes.y(), cellIndexes.z()}] = n;
+  }
+
+  const CellIndexes3 center(32, 32, 32);
+  EXPECT_GT(grid.evictBlocks(center, 16), 0u);
+  grid.forEachBlock([&](const CellIndexes3 & firstCellIndexes, const auto &) {
+      for (size_t axis = 0; axis < 3; ++axis) {
+        EXPECT_GE(firstCellIndexes[axis] + 1 + 16, center[axis]);
+        EXPECT_LE(firstCellIndexes[axis], center[axis] + 16);
+      }
+    });
+
+  const auto & constGrid = grid;
+  for (const auto & [key, value] : reference) {
+    CellIndexes3 cellIndexes(std::get<0>(key), std::get<1>(key), std::get<2>(key));
+    // Blocks of 2 cells along each axis are kept when one of their cells is close enough
+    bool isKept = true;
+    for (size_t axis = 0; axis < 3; ++axis) {
+      long first = long(cellIndexes[axis] & ~size_t(1));
+      long distance = std::max({first - long(center[axis]), long(center[axis]) - first - 1, 0L});
+      isKept &= distance <= 16;
+    }
+    if (isKept) {
+      EXPECT_EQ(constGrid(cellIndexes), value);
+    } else {
+      EXPECT_EQ(constGrid(cellIndexes), 0);
+      EXPECT_EQ(grid.find(cellIndexes), nullptr);
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestSparseGrid, leastRecentlyUsedEviction)
+{
+  romea::core::SparseGrid<float, 3> grid(CellIndexes3::Constant(1000));
+  grid.setMaximalNumberOfBlocks(8);
+
+  for (size_t n = 0; n < 8; ++n) {
+    grid(CellIndexes3(8 * n, 0, 0)) = 1;
+  }
+  EXPECT_EQ(grid.getNumberOfBlocks(), 8u);
+
+  // First block is written again, so blocks 1 and 2 are the least recently used
+  grid(CellIndexes3(0, 0, 0)) = 2;
+  grid(CellIndexes3(0, 8, 0)) = 3;
+  EXPECT_EQ(grid.getNumberOfBlocks(), 7u);
+  EXPECT_NE(grid.find(CellIndexes3(0, 0, 0)), nullptr);
+  EXPECT_EQ(grid.find(CellIndexes3(8, 0, 0)), nullptr);
+  EXPECT_EQ(grid.find(CellIndexes3(16, 0, 0)), nullptr);
+  EXPECT_NE(grid.find(CellIndexes3(24, 0, 0)), nullptr);
+  EXPECT_EQ(*grid.find(CellIndexes3(0, 0, 0)), 2);
+  EXPECT_EQ(*grid.find(CellIndexes3(0, 8, 0)), 3);
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestSparseGrid, largeExtentMapWithRayCasting)
+{
+  // 200m x 200m x 20m at 5cm cannot be allocated densely
+  romea::core::Interval3D<double> extremities(
+    Eigen::Vector3d(-100, -100, -10), Eigen::Vector3d(100, 100, 10));
+  romea::core::GridIndexMapping3d gridIndexMapping(extremities, 0.05);
+  const CellIndexes3 & numberOfCells = gridIndexMapping.getNumberOfCellsAlongAxes();
+  EXPECT_GT(numberOfCells.prod(), 6e9);
+
+  romea::core::SparseGrid<float, 3> grid(numberOfCells);
+  romea::core::RayCasting3d rayCasting(&gridIndexMapping);
+  for (const CellIndexes3 & cellIndexes : rayCasting.cast(
+      Eigen::Vector3d(0, 0, 0), Eigen::Vector3d(30, 20, 5)))
+  {
+    grid(cellIndexes) += 1.f;
+  }
+
+  // Same ray on a small dense grid
+  romea::core::GridIndexMapping3d smallGridIndexMapping(
+    romea::core::Interval3D<double>(Eigen::Vector3d(0, 0, 0), Eigen::Vector3d(31, 21, 6)), 0.05);
+  romea::core::Grid<float, 3> denseGrid(smallGridIndexMapping.getNumberOfCellsAlongAxes());
+  romea::core::RayCasting3d smallRayCasting(&smallGridIndexMapping);
+  for (const CellIndexes3 & cellIndexes : smallRayCasting.cast(
+      Eigen::Vector3d(0, 0, 0), Eigen::Vector3d(30, 20, 5)))
+  {
+    denseGrid(cellIndexes) += 1.f;
+  }
+
+  float sum = 0;
+  grid.forEachBlock([&](const CellIndexes3 &, const auto & cells) {
+      for (const float & cell : cells) {
+        sum += cell;
+      }
+    });
+  EXPECT_EQ(sum, denseGrid.sum());
+  EXPECT_GT(sum, 700);
+  EXPECT_LE(grid.getNumberOfBlocks(), size_t(sum));
+
+  const auto & constGrid = grid;
+  EXPECT_EQ(constGrid(gridIndexMapping.computeCellIndexes(Eigen::Vector3d(15, 10, 2.5))), 1.f);
+  EXPECT_EQ(constGrid(gridIndexMapping.computeCellIndexes(Eigen::Vector3d(15, -10, 2.5))), 0.f);
+}
+
+//-----------------------------------------------------------------------------
+int main(int argc, char ** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -16,14 +16,24 @@
 // gtest
 #include <gtest/gtest.h>
 
+// std
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
 // romea
 #include "romea_core_common/geodesy/ECEFConverter.hpp"
+#include "romea_core_common/math/RandomGenerator.hpp"
+
+using WGS84ConversionMethod = romea::core::ECEFConverter::WGS84ConversionMethod;
 
 inline void checkConversions(
   const romea::core::GeodeticCoordinates & llh,
-  const Eigen::Vector3d & ecef)
+  const Eigen::Vector3d & ecef,
+  const WGS84ConversionMethod & method = WGS84ConversionMethod::FIXED_POINT)
 {
   romea::core::ECEFConverter ecefConverter;
+  ecefConverter.setWGS84ConversionMethod(method);
   Eigen::Vector3d ecefFromLLH = ecefConverter.toECEF(llh);
   romea::core::GeodeticCoordinates llhFromECEF = ecefConverter.toWGS84(ecefFromLLH);
 
@@ -41,6 +51,7 @@ TEST(testECEFConverter, checkConvertionAtClermont)
   auto llh = romea::core::makeGeodeticCoordinates(45.78 / 180 * M_PI, 3.08 / 180 * M_PI, 365);
   Eigen::Vector3d ecef(4449694.95, 239429.10, 4548489.04);
   checkConversions(llh, ecef);
+  checkConversions(llh, ecef, WGS84ConversionMethod::VERMEILLE);
 }
 
 //-----------------------------------------------------------------------------
@@ -49,6 +60,7 @@ TEST(testECEFConverter, checkConvertionAtMelbourne)
   auto llh = romea::core::makeGeodeticCoordinates(-37 / 180. * M_PI, 144.96 / 180. * M_PI, 10.);
   Eigen::Vector3d ecef(-4175633.10, 2928156.31, -3817399.17);
   checkConversions(llh, ecef);
+  checkConversions(llh, ecef, WGS84ConversionMethod::VERMEILLE);
 }
 
 //-----------------------------------------------------------------------------
@@ -57,6 +69,100 @@ TEST(testECEFConverter, checkConvertionAtAnchorage)
   auto llh = romea::core::makeGeodeticCoordinates(61.17 / 180 * M_PI, -150.02 / 180 * M_PI, 31.);
   Eigen::Vector3d ecef(-2670982.26, -1540849.44, 5564529.01);
   checkConversions(llh, ecef);
+  checkConversions(llh, ecef, WGS84ConversionMethod::VERMEILLE);
+}
+
+//-----------------------------------------------------------------------------
+TEST(testECEFConverter, checkBatchConversions)
+{
+  // Enough positions to be split between several threads
+  romea::core::RandomGenerator generator(5);
+  std::vector<romea::core::GeodeticCoordinates> llhs;
+  for (size_t n = 0; n < 50000; ++n) {
+    llhs.push_back(
+      romea::core::makeGeodeticCoordinates(
+        M_PI * (romea::core::generateUniform<double>(generator) - 0.5),
+        M_PI * (2 * romea::core::generateUniform<double>(generator) - 1),
+        1000 * romea::core::generateUniform<double>(generator)));
+  }
+  romea::core::GeodeticCoordinatesArray llhArray = romea::core::makeGeodeticCoordinatesArray(llhs);
+
+  romea::core::ECEFConverter ecefConverter;
+  Eigen::MatrixX3d ecefPositions;
+  ecefConverter.toECEF(llhArray, ecefPositions);
+  ASSERT_EQ(ecefPositions.rows(), Eigen::Index(llhs.size()));
+
+  romea::core::GeodeticCoordinatesArray llhFromECEF;
+  ecefConverter.toWGS84(ecefPositions, llhFromECEF);
+  ASSERT_EQ(llhFromECEF.latitudes.size(), Eigen::Index(llhs.size()));
+
+  for (size_t n = 0; n < llhs.size(); n += 7) {
+    const Eigen::Vector3d ecef = ecefConverter.toECEF(llhs[n]);
+    EXPECT_NEAR((ecefPositions.row(n).transpose() - ecef).norm(), 0, 1e-6);
+
+    const romea::core::GeodeticCoordinates llh = getGeodeticCoordinates(llhFromECEF, n);
+    EXPECT_NEAR(llh.latitude, llhs[n].latitude, 1e-9);
+    EXPECT_NEAR(llh.longitude, llhs[n].longitude, 1e-9);
+    EXPECT_NEAR(llh.altitude, llhs[n].altitude, 1e-3);
+  }
+
+  // Results do not depend on the number of threads
+  Eigen::MatrixX3d ecefPositionsWithOneThread;
+  ecefConverter.setMaximalNumberOfThreads(1);
+  ecefConverter.toECEF(llhArray, ecefPositionsWithOneThread);
+  EXPECT_TRUE(ecefPositionsWithOneThread == ecefPositions);
+
+  // Arrays of different sizes are rejected
+  llhArray.altitudes.conservativeResize(llhArray.altitudes.size() - 1);
+  EXPECT_THROW(ecefConverter.toECEF(llhArray, ecefPositions), std::invalid_argument);
+}
+
+//-----------------------------------------------------------------------------
+TEST(testECEFConverter, checkVermeilleMatchesFixedPoint)
+{
+  romea::core::ECEFConverter fixedPointConverter;
+  romea::core::ECEFConverter vermeilleConverter;
+  vermeilleConverter.setWGS84ConversionMethod(WGS84ConversionMethod::VERMEILLE);
+
+  // From the bottom of oceans to GNSS satellites, poles and equator included
+  romea::core::RandomGenerator generator(6);
+  std::vector<romea::core::GeodeticCoordinates> llhs = {
+    romea::core::makeGeodeticCoordinates(M_PI_2, 0, 100),
+    romea::core::makeGeodeticCoordinates(-M_PI_2, 0, -100),
+    romea::core::makeGeodeticCoordinates(0, 0, 0),
+    romea::core::makeGeodeticCoordinates(0, M_PI_2, 1000)};
+  for (size_t n = 0; n < 10000; ++n) {
+    llhs.push_back(
+      romea::core::makeGeodeticCoordinates(
+        M_PI * (romea::core::generateUniform<double>(generator) - 0.5),
+        M_PI * (2 * romea::core::generateUniform<double>(generator) - 1),
+        -11000 + 2e7 * std::pow(romea::core::generateUniform<double>(generator), 4)));
+  }
+
+  for (const romea::core::GeodeticCoordinates & llh : llhs) {
+    const Eigen::Vector3d ecef = fixedPointConverter.toECEF(llh);
+    const romea::core::GeodeticCoordinates fixedPointLLH = fixedPointConverter.toWGS84(ecef);
+    const romea::core::GeodeticCoordinates vermeilleLLH = vermeilleConverter.toWGS84(ecef);
+    EXPECT_NEAR(vermeilleLLH.latitude, fixedPointLLH.latitude, 1e-9);
+    EXPECT_NEAR(vermeilleLLH.altitude, fixedPointLLH.altitude, 1e-3);
+    EXPECT_NEAR(vermeilleLLH.latitude, llh.latitude, 1e-9);
+    EXPECT_NEAR(vermeilleLLH.altitude, llh.altitude, 1e-3);
+    if (std::abs(llh.latitude) < M_PI_2 - 1e-9) {
+      EXPECT_NEAR(vermeilleLLH.longitude, llh.longitude, 1e-9);
+    }
+  }
+
+  // Batch conversions use selected method
+  romea::core::GeodeticCoordinatesArray llhArray;
+  Eigen::MatrixX3d ecefPositions;
+  vermeilleConverter.toECEF(romea::core::makeGeodeticCoordinatesArray(llhs), ecefPositions);
+  vermeilleConverter.toWGS84(ecefPositions, llhArray);
+  for (size_t n = 0; n < llhs.size(); n += 11) {
+    const romea::core::GeodeticCoordinates llh =
+      vermeilleConverter.toWGS84(ecefPositions.row(n).transpose());
+    EXPECT_EQ(llhArray.latitudes[n], llh.latitude);
+    EXPECT_EQ(llhArray.altitudes[n], llh.altitude);
+  }
 }
 
 //-----------------------------------------------------------------------------
@@ -60,6 +60,36 @@ TEST(testENUConverter, checkConversionPrecision)
     enuConverter3.toENU(llh1) + enuConverter3.toENU(llh2)).norm(), 0.01);
 }
 
+//-----------------------------------------------------------------------------
+TEST(testENUConverter, checkBatchConversions)
+{
+  auto anchor = romea::core::makeGeodeticCoordinates(45.78 / 180 * M_PI, 3.08 / 180 * M_PI, 365);
+  romea::core::ENUConverter enuConverter(anchor);
+
+  Eigen::MatrixX3d enuPositions = 100 * Eigen::MatrixX3d::Random(1000, 3);
+
+  romea::core::GeodeticCoordinatesArray llhs;
+  enuConverter.toWGS84(enuPositions, llhs);
+  Eigen::MatrixX3d enuFromLLH;
+  enuConverter.toENU(llhs, enuFromLLH);
+  EXPECT_NEAR((enuFromLLH - enuPositions).cwiseAbs().maxCoeff(), 0, 1e-6);
+
+  Eigen::MatrixX3d ecefPositions, enuFromECEF;
+  enuConverter.toECEF(enuPositions, ecefPositions);
+  enuConverter.toENU(ecefPositions, enuFromECEF);
+  EXPECT_NEAR((enuFromECEF - enuPositions).cwiseAbs().maxCoeff(), 0, 1e-6);
+
+  for (Eigen::Index n = 0; n < enuPositions.rows(); n += 13) {
+    const Eigen::Vector3d enu = enuPositions.row(n).transpose();
+    EXPECT_NEAR((ecefPositions.row(n).transpose() - enuConverter.toECEF(enu)).norm(), 0, 1e-6);
+
+    const romea::core::GeodeticCoordinates llh = enuConverter.toWGS84(enu);
+    EXPECT_NEAR(llhs.latitudes[n], llh.latitude, 1e-12);
+    EXPECT_NEAR(llhs.longitudes[n], llh.longitude, 1e-12);
+    EXPECT_NEAR(llhs.altitudes[n], llh.altitude, 1e-6);
+  }
+}
+
 ////-----------------------------------------------------------------------------
 // TEST(testGeodesy, testWGS84Distance)
 //{
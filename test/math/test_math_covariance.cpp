@@ -0,0 +1,140 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+// gtest
+#include <gtest/gtest.h>
+
+// romea
+#include "romea_core_common/math/CovarianceAccumulator.hpp"
+#include "romea_core_common/math/RandomGenerator.hpp"
+
+//-----------------------------------------------------------------------------
+class TestCovarianceAccumulator : public ::testing::Test
+{
+public:
+  TestCovarianceAccumulator()
+  : x(3, 1000),
+    y(3, 1000),
+    weights(1000)
+  {
+  }
+
+  void SetUp() override
+  {
+    romea::core::RandomGenerator generator(0);
+    romea::core::generateStandardNormals(generator, x.data(), size_t(x.size()));
+    y = Eigen::Vector3d(1, 2, 3).asDiagonal() * x;
+    y.row(0) += 0.5 * x.row(1);
+    for (int n = 0; n < weights.size(); ++n) {
+      weights[n] = 0.1 + romea::core::generateUniform<double>(generator);
+    }
+  }
+
+  Eigen::Matrix3Xd x;
+  Eigen::Matrix3Xd y;
+  Eigen::VectorXd weights;
+};
+
+//-----------------------------------------------------------------------------
+TEST_F(TestCovarianceAccumulator, MatchesTwoPassesComputation)
+{
+  romea::core::CovarianceAccumulator<double, 3> covariance;
+  romea::core::CrossCovarianceAccumulator<double, 3> crossCovariance;
+  for (int n = 0; n < x.cols(); ++n) {
+    covariance.add(x.col(n));
+    crossCovariance.add(x.col(n), y.col(n));
+  }
+
+  Eigen::Vector3d meanX = x.rowwise().mean();
+  Eigen::Vector3d meanY = y.rowwise().mean();
+  Eigen::Matrix3Xd centeredX = x.colwise() - meanX;
+  Eigen::Matrix3Xd centeredY = y.colwise() - meanY;
+
+  EXPECT_DOUBLE_EQ(covariance.getWeightSum(), 1000);
+  EXPECT_TRUE(covariance.getMean().isApprox(meanX, 1e-12));
+  EXPECT_TRUE(covariance.getCovariance().isApprox(centeredX * centeredX.transpose() / 1000, 1e-12));
+  EXPECT_TRUE(crossCovariance.getFirstMean().isApprox(meanX, 1e-12));
+  EXPECT_TRUE(crossCovariance.getSecondMean().isApprox(meanY, 1e-12));
+  EXPECT_TRUE(crossCovariance.getCoMoment().isApprox(centeredX * centeredY.transpose(), 1e-12));
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestCovarianceAccumulator, Weighted)
+{
+  romea::core::CrossCovarianceAccumulator<double, 3> crossCovariance;
+  for (int n = 0; n < x.cols(); ++n) {
+    crossCovariance.add(x.col(n), y.col(n), weights[n]);
+  }
+
+  double weightSum = weights.sum();
+  Eigen::Vector3d meanX = x * weights / weightSum;
+  Eigen::Vector3d meanY = y * weights / weightSum;
+  Eigen::Matrix3d coMoment = (x.colwise() - meanX) * weights.asDiagonal() *
+    (y.colwise() - meanY).transpose();
+
+  EXPECT_NEAR(crossCovariance.getWeightSum(), weightSum, 1e-9);
+  EXPECT_TRUE(crossCovariance.getFirstMean().isApprox(meanX, 1e-12));
+  EXPECT_TRUE(crossCovariance.getSecondMean().isApprox(meanY, 1e-12));
+  EXPECT_TRUE(crossCovariance.getCoMoment().isApprox(coMoment, 1e-12));
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestCovarianceAccumulator, Merge)
+{
+  romea::core::CrossCovarianceAccumulator<double, 3> all, first, second;
+  for (int n = 0; n < x.cols(); ++n) {
+    all.add(x.col(n), y.col(n), weights[n]);
+    (n < 300 ? first : second).add(x.col(n), y.col(n), weights[n]);
+  }
+  first.merge(second);
+
+  EXPECT_NEAR(first.getWeightSum(), all.getWeightSum(), 1e-9);
+  EXPECT_TRUE(first.getFirstMean().isApprox(all.getFirstMean(), 1e-12));
+  EXPECT_TRUE(first.getSecondMean().isApprox(all.getSecondMean(), 1e-12));
+  EXPECT_TRUE(first.getCrossCovariance().isApprox(all.getCrossCovariance(), 1e-12));
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestCovarianceAccumulator, FarFromOrigin)
+{
+  // Sum of products formula loses all digits of a centimetric spread at 1 km in float
+  Eigen::Vector2f offset(1000.f, -2000.f);
+  romea::core::CovarianceAccumulator<float, 2> covariance;
+  Eigen::Vector2f sum = Eigen::Vector2f::Zero();
+  Eigen::Matrix2f sumOfProducts = Eigen::Matrix2f::Zero();
+  Eigen::Matrix2Xd points(2, x.cols());
+  for (int n = 0; n < x.cols(); ++n) {
+    Eigen::Vector2f point = offset + 0.01f * x.col(n).head<2>().cast<float>();
+    covariance.add(point);
+    sum += point;
+    sumOfProducts += point * point.transpose();
+    points.col(n) = point.cast<double>();
+  }
+
+  Eigen::Matrix2Xd centeredPoints = points.colwise() - points.rowwise().mean();
+  Eigen::Matrix2d expected = centeredPoints * centeredPoints.transpose() / 1000;
+  Eigen::Matrix2f naive = sumOfProducts / 1000 - sum * sum.transpose() / 1000000;
+
+  EXPECT_LT((covariance.getCovariance().cast<double>() - expected).norm(), 1e-6);
+  EXPECT_GT((naive.cast<double>() - expected).norm(), 1e-4);
+}
+
+//-----------------------------------------------------------------------------
+int main(int argc, char ** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,153 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// gtest
+#include <gtest/gtest.h>
+
+// std
+#include <thread>
+#include <vector>
+
+// romea
+#include "romea_core_common/math/RandomGenerator.hpp"
+#include "romea_core_common/math/NormalRandomMatrixGenerator.hpp"
+
+//-----------------------------------------------------------------------------
+TEST(TestRandom, SameSeedGivesSameSequence)
+{
+  romea::core::RandomGenerator generator1(12);
+  romea::core::RandomGenerator generator2(12);
+  romea::core::RandomGenerator generator3(13);
+
+  bool differentFromOtherSeed = false;
+  for (size_t n = 0; n < 100; ++n) {
+    auto value = generator1();
+    EXPECT_EQ(value, generator2());
+    differentFromOtherSeed |= value != generator3();
+  }
+  EXPECT_TRUE(differentFromOtherSeed);
+
+  generator1.seed(12);
+  generator2.seed(12);
+  EXPECT_EQ(generator1(), generator2());
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestRandom, Streams)
+{
+  romea::core::RandomGenerator generator(5);
+  romea::core::RandomGenerator stream0 = generator.split();
+  romea::core::RandomGenerator stream1 = generator.split();
+
+  romea::core::RandomGenerator expectedStream0 = romea::core::makeRandomStream(5, 0);
+  romea::core::RandomGenerator expectedStream1 = romea::core::makeRandomStream(5, 1);
+
+  for (size_t n = 0; n < 100; ++n) {
+    auto value0 = stream0();
+    auto value1 = stream1();
+    EXPECT_NE(value0, value1);
+    EXPECT_EQ(value0, expectedStream0());
+    EXPECT_EQ(value1, expectedStream1());
+  }
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestRandom, ThreadLocalGenerators)
+{
+  std::uint64_t mainValue = romea::core::threadLocalRandomGenerator()();
+  std::uint64_t threadValue = mainValue;
+  std::thread thread([&]() {threadValue = romea::core::threadLocalRandomGenerator()();});
+  thread.join();
+  EXPECT_NE(mainValue, threadValue);
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestRandom, Uniform)
+{
+  romea::core::RandomGenerator generator;
+  double mean = 0;
+  for (size_t n = 0; n < 100000; ++n) {
+    double value = romea::core::generateUniform<double>(generator);
+    EXPECT_GE(value, 0.);
+    EXPECT_LT(value, 1.);
+    mean += value / 100000;
+  }
+  EXPECT_NEAR(mean, 0.5, 0.01);
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar>
+void testStandardNormals(const size_t & size)
+{
+  romea::core::RandomGenerator generator(3);
+  std::vector<Scalar> values(size);
+  romea::core::generateStandardNormals(generator, values.data(), values.size());
+
+  Eigen::Map<Eigen::Array<Scalar, Eigen::Dynamic, 1>> array(values.data(), size);
+  EXPECT_TRUE(array.allFinite());
+  EXPECT_NEAR(array.mean(), 0, 0.01);
+  EXPECT_NEAR((array - array.mean()).square().mean(), 1, 0.02);
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestRandom, StandardNormals)
+{
+  testStandardNormals<float>(100001);
+  testStandardNormals<double>(100001);
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestRandom, NormalRandomMatrixGenerator2D)
+{
+  Eigen::Vector2d mean(1, -2);
+  Eigen::Matrix2d covariance;
+  covariance << 0.5, 0.2, 0.2, 0.3;
+
+  romea::core::NormalRandomMatrixGenerator2D<double> generator(4);
+  generator.init(mean, covariance);
+  Eigen::Matrix<double, 2, Eigen::Dynamic> samples(2, 100000);
+  generator.fill(samples);
+
+  Eigen::Vector2d sampleMean = samples.rowwise().mean();
+  Eigen::Matrix<double, 2, Eigen::Dynamic> centered = samples.colwise() - sampleMean;
+  Eigen::Matrix2d sampleCovariance = centered * centered.transpose() / samples.cols();
+  EXPECT_TRUE(sampleMean.isApprox(mean, 0.01));
+  EXPECT_TRUE(sampleCovariance.isApprox(covariance, 0.02));
+
+  romea::core::NormalRandomMatrixGenerator2D<double> sameSeedGenerator(4);
+  sameSeedGenerator.init(mean, covariance);
+  Eigen::Matrix<double, 2, Eigen::Dynamic> sameSeedSamples(2, 100000);
+  sameSeedGenerator.fill(sameSeedSamples);
+  EXPECT_TRUE(samples == sameSeedSamples);
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestRandom, NormalRandomArrayGenerator)
+{
+  romea::core::NormalRandomArrayGenerator<float> generator;
+  generator.init(3, 0.5);
+  Eigen::ArrayXf samples(100000);
+  generator.fill(samples);
+
+  EXPECT_NEAR(samples.mean(), 3, 0.01);
+  EXPECT_NEAR(std::sqrt((samples - samples.mean()).square().mean()), 0.5, 0.01);
+}
+
+//-----------------------------------------------------------------------------
+int main(int argc, char ** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
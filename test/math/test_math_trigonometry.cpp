@@ -0,0 +1,71 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+// gtest
+#include <gtest/gtest.h>
+
+// std
+#include <cmath>
+
+// romea
+#include "romea_core_common/math/RandomGenerator.hpp"
+#include "romea_core_common/math/Trigonometry.hpp"
+
+//-----------------------------------------------------------------------------
+TEST(TestTrigonometry, SincosMatchesStd)
+{
+  romea::core::RandomGenerator generator(3);
+  Eigen::ArrayXd x(10000);
+  for (Eigen::Index n = 0; n < x.size(); ++n) {
+    const double range = n < 5000 ? M_PI : 1e4;
+    x[n] = range * (2 * romea::core::generateUniform<double>(generator) - 1);
+  }
+
+  Eigen::ArrayXd sines, cosines;
+  romea::core::sincos(x, sines, cosines);
+  ASSERT_EQ(sines.size(), x.size());
+  ASSERT_EQ(cosines.size(), x.size());
+  for (Eigen::Index n = 0; n < x.size(); ++n) {
+    EXPECT_NEAR(sines[n], std::sin(x[n]), 1e-15);
+    EXPECT_NEAR(cosines[n], std::cos(x[n]), 1e-15);
+  }
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestTrigonometry, SincosAtQuadrantBoundaries)
+{
+  using Block = Eigen::Array<double, Eigen::Dynamic, 1, Eigen::ColMajor, 16, 1>;
+
+  Block x(9), sines, cosines;
+  for (Eigen::Index n = 0; n < x.size(); ++n) {
+    x[n] = (n - 4) * M_PI_2;
+  }
+
+  romea::core::sincos(x, sines, cosines);
+  for (Eigen::Index n = 0; n < x.size(); ++n) {
+    EXPECT_NEAR(sines[n], std::sin(x[n]), 1e-15);
+    EXPECT_NEAR(cosines[n], std::cos(x[n]), 1e-15);
+  }
+  EXPECT_DOUBLE_EQ(sines[4], 0);
+  EXPECT_DOUBLE_EQ(cosines[4], 1);
+}
+
+//-----------------------------------------------------------------------------
+int main(int argc, char ** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
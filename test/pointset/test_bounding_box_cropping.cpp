@@ -0,0 +1,173 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+// gtest
+#include <gtest/gtest.h>
+
+// Eigen
+#include <Eigen/Geometry>
+
+// std
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// romea
+#include "romea_core_common/pointset/algorithms/BoundingBoxCropping.hpp"
+#include "romea_core_common/math/RandomGenerator.hpp"
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+romea::core::PointSet<PointType> makeRandomPoints(
+  const size_t & numberOfPoints,
+  romea::core::RandomGenerator & generator)
+{
+  using Scalar = typename PointType::Scalar;
+  romea::core::PointSet<PointType> points(numberOfPoints);
+  for (PointType & point : points) {
+    point = PointType::Ones();
+    for (int i = 0; i < romea::core::PointTraits<PointType>::DIM; ++i) {
+      point[i] = 20 * romea::core::generateUniform<Scalar>(generator) - 10;
+    }
+  }
+  return points;
+}
+
+//-----------------------------------------------------------------------------
+template<typename Scalar, size_t DIM>
+Eigen::Matrix<Scalar, DIM, DIM> makeRandomRotation(romea::core::RandomGenerator & generator)
+{
+  const Scalar angle = 2 * M_PI * romea::core::generateUniform<Scalar>(generator);
+  if constexpr (DIM == 2) {
+    return Eigen::Rotation2D<Scalar>(angle).matrix();
+  } else {
+    Eigen::Matrix<Scalar, 3, 1> axis;
+    romea::core::generateStandardNormals(generator, axis.data(), 3);
+    return Eigen::AngleAxis<Scalar>(angle, axis.normalized()).matrix();
+  }
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+void testCropping(const bool & negative)
+{
+  using Cropping = romea::core::BoundingBoxCropping<PointType>;
+  using Scalar = typename PointType::Scalar;
+  constexpr size_t DIM = Cropping::CARTESIAN_DIM;
+  using VectorType = Eigen::Matrix<Scalar, DIM, 1>;
+
+  romea::core::RandomGenerator generator(negative);
+  const romea::core::PointSet<PointType> points = makeRandomPoints<PointType>(10001, generator);
+
+  // Dozens of random boxes, one out of two being oriented
+  std::vector<typename Cropping::AABBType> aabbs;
+  std::vector<typename Cropping::OBBType> obbs;
+  Cropping cropping;
+  cropping.setNegative(negative);
+  cropping.setMaximalNumberOfThreads(3);
+  for (size_t n = 0; n < 24; ++n) {
+    VectorType center, halfWidthExtents;
+    for (size_t i = 0; i < DIM; ++i) {
+      center[i] = 16 * romea::core::generateUniform<Scalar>(generator) - 8;
+      halfWidthExtents[i] = 0.2 + 1.5 * romea::core::generateUniform<Scalar>(generator);
+    }
+    if (n % 2 == 0) {
+      aabbs.emplace_back(center, halfWidthExtents);
+      cropping.addBox(aabbs.back());
+    } else {
+      obbs.emplace_back(center, halfWidthExtents, makeRandomRotation<Scalar, DIM>(generator));
+      cropping.addBox(obbs.back());
+    }
+  }
+  EXPECT_EQ(cropping.getNumberOfBoxes(), 24u);
+
+  std::vector<size_t> expectedIndexes;
+  for (size_t n = 0; n < points.size(); ++n) {
+    const VectorType point = points[n].template head<DIM>();
+    bool isInside = false;
+    for (const auto & aabb : aabbs) {
+      isInside = isInside || aabb.isInside(point);
+    }
+    for (const auto & obb : obbs) {
+      isInside = isInside || obb.isInside(point);
+    }
+    if (isInside != negative) {
+      expectedIndexes.push_back(n);
+    }
+  }
+  ASSERT_GT(expectedIndexes.size(), 0u);
+  ASSERT_LT(expectedIndexes.size(), points.size());
+
+  std::vector<std::uint8_t> mask;
+  cropping.computeMask(points, mask);
+  ASSERT_EQ(mask.size(), points.size());
+  EXPECT_EQ(size_t(std::count(mask.begin(), mask.end(), 1)), expectedIndexes.size());
+
+  std::vector<size_t> keptPointIndexes;
+  cropping.computeKeptPointIndexes(points, keptPointIndexes);
+  EXPECT_EQ(keptPointIndexes, expectedIndexes);
+
+  romea::core::PointSet<PointType> croppedPoints;
+  cropping.crop(points, croppedPoints);
+  romea::core::PointSet<PointType> inPlaceCroppedPoints = points;
+  cropping.crop(inPlaceCroppedPoints);
+  ASSERT_EQ(croppedPoints.size(), expectedIndexes.size());
+  ASSERT_EQ(inPlaceCroppedPoints.size(), expectedIndexes.size());
+  for (size_t n = 0; n < expectedIndexes.size(); ++n) {
+    EXPECT_EQ(croppedPoints[n], points[expectedIndexes[n]]);
+    EXPECT_EQ(inPlaceCroppedPoints[n], points[expectedIndexes[n]]);
+  }
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestBoundingBoxCropping, keepInsidePoints)
+{
+  testCropping<Eigen::Vector2f>(false);
+  testCropping<Eigen::Vector3d>(false);
+  testCropping<romea::core::HomogeneousCoordinates2d>(false);
+  testCropping<romea::core::HomogeneousCoordinates3f>(false);
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestBoundingBoxCropping, removeInsidePoints)
+{
+  testCropping<Eigen::Vector2d>(true);
+  testCropping<Eigen::Vector3f>(true);
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestBoundingBoxCropping, withoutBoxes)
+{
+  romea::core::RandomGenerator generator(2);
+  romea::core::PointSet<Eigen::Vector3d> points =
+    makeRandomPoints<Eigen::Vector3d>(100, generator);
+
+  romea::core::BoundingBoxCropping<Eigen::Vector3d> cropping;
+  std::vector<size_t> keptPointIndexes;
+  cropping.computeKeptPointIndexes(points, keptPointIndexes);
+  EXPECT_TRUE(keptPointIndexes.empty());
+
+  cropping.setNegative(true);
+  cropping.crop(points);
+  EXPECT_EQ(points.size(), 100u);
+}
+
+//-----------------------------------------------------------------------------
+int main(int argc, char ** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
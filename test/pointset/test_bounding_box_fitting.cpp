@@ -0,0 +1,302 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+// gtest
+#include <gtest/gtest.h>
+
+// Eigen
+#include <Eigen/Geometry>
+
+// std
+#include <cmath>
+#include <initializer_list>
+#include <limits>
+
+// romea
+#include "romea_core_common/pointset/algorithms/BoundingBoxFitting.hpp"
+#include "romea_core_common/math/RandomGenerator.hpp"
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+romea::core::PointSet<PointType> makeRandomPoints(
+  const size_t & numberOfPoints,
+  romea::core::RandomGenerator & generator)
+{
+  using Scalar = typename PointType::Scalar;
+  romea::core::PointSet<PointType> points(numberOfPoints);
+  for (PointType & point : points) {
+    point = PointType::Ones();
+    for (int i = 0; i < romea::core::PointTraits<PointType>::DIM; ++i) {
+      point[i] = 20 * romea::core::generateUniform<Scalar>(generator) - 10;
+    }
+  }
+  return points;
+}
+
+//-----------------------------------------------------------------------------
+// Points uniformly drawn in a rotated box whose corners are also added
+template<class PointType>
+romea::core::PointSet<PointType> makeRotatedBoxPoints(
+  const typename romea::core::BoundingBoxFitting<PointType>::OBBType & box,
+  const size_t & numberOfPoints,
+  romea::core::RandomGenerator & generator)
+{
+  using Scalar = typename PointType::Scalar;
+  constexpr size_t DIM = romea::core::PointTraits<PointType>::DIM;
+  using VectorType = Eigen::Matrix<Scalar, DIM, 1>;
+
+  auto toPoint = [&](const VectorType & local) {
+      PointType point = PointType::Ones();
+      point.template head<DIM>() = box.getCenterPosition() +
+        box.getRotationMatrix() * local.cwiseProduct(box.getHalfWidthExtents());
+      return point;
+    };
+
+  romea::core::PointSet<PointType> points;
+  for (size_t n = 0; n < numberOfPoints; ++n) {
+    VectorType local;
+    for (size_t i = 0; i < DIM; ++i) {
+      local[i] = 2 * romea::core::generateUniform<Scalar>(generator) - 1;
+    }
+    points.push_back(toPoint(local));
+  }
+  for (size_t corner = 0; corner < (size_t(1) << DIM); ++corner) {
+    VectorType local;
+    for (size_t i = 0; i < DIM; ++i) {
+      local[i] = (corner >> i) & 1 ? 1 : -1;
+    }
+    points.push_back(toPoint(local));
+  }
+  return points;
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType, class BoxType>
+void expectAllPointsInside(
+  const romea::core::PointSet<PointType> & points,
+  const BoxType & box,
+  const double & tolerance)
+{
+  constexpr size_t DIM = romea::core::PointTraits<PointType>::DIM;
+  for (const PointType & point : points) {
+    auto local = box.getRotationMatrix().transpose() *
+      (point.template head<DIM>() - box.getCenterPosition());
+    for (size_t i = 0; i < DIM; ++i) {
+      EXPECT_LE(std::abs(local[i]), box.getHalfWidthExtents()[i] + tolerance);
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+void testAxisAlignedBoundingBox()
+{
+  using Scalar = typename PointType::Scalar;
+  constexpr size_t DIM = romea::core::PointTraits<PointType>::DIM;
+
+  romea::core::RandomGenerator generator(1);
+  romea::core::BoundingBoxFitting<PointType> fitting;
+  for (size_t numberOfPoints : std::initializer_list<size_t>{1, 15, 16, 17, 100, 1003}) {
+    auto points = makeRandomPoints<PointType>(numberOfPoints, generator);
+
+    Eigen::Matrix<Scalar, DIM, 1> lower = points[0].template head<DIM>();
+    Eigen::Matrix<Scalar, DIM, 1> upper = points[0].template head<DIM>();
+    for (const PointType & point : points) {
+      lower = lower.cwiseMin(point.template head<DIM>());
+      upper = upper.cwiseMax(point.template head<DIM>());
+    }
+
+    auto aabb = fitting.fitAxisAlignedBoundingBox(points);
+    for (size_t i = 0; i < DIM; ++i) {
+      EXPECT_NEAR(aabb.getCenterPosition()[i], (lower[i] + upper[i]) / 2, 1e-5);
+      EXPECT_NEAR(aabb.getHalfWidthExtents()[i], (upper[i] - lower[i]) / 2, 1e-5);
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestBoundingBoxFitting, AxisAlignedBoundingBoxIsMinMax)
+{
+  testAxisAlignedBoundingBox<Eigen::Vector2f>();
+  testAxisAlignedBoundingBox<Eigen::Vector2d>();
+  testAxisAlignedBoundingBox<Eigen::Vector3f>();
+  testAxisAlignedBoundingBox<Eigen::Vector3d>();
+  testAxisAlignedBoundingBox<romea::core::HomogeneousCoordinates2f>();
+  testAxisAlignedBoundingBox<romea::core::HomogeneousCoordinates3d>();
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+void testOrientedBoundingBox2D()
+{
+  using Scalar = typename PointType::Scalar;
+  using OBBType = typename romea::core::BoundingBoxFitting<PointType>::OBBType;
+
+  romea::core::RandomGenerator generator(2);
+  romea::core::BoundingBoxFitting<PointType> fitting;
+  for (size_t trial = 0; trial < 20; ++trial) {
+    const Scalar angle = 2 * M_PI * romea::core::generateUniform<Scalar>(generator);
+    const OBBType box(
+      Eigen::Matrix<Scalar, 2, 1>(3, -2),
+      Eigen::Matrix<Scalar, 2, 1>(4, 1),
+      Eigen::Rotation2D<Scalar>(angle).matrix());
+    auto points = makeRotatedBoxPoints<PointType>(box, 200, generator);
+
+    auto obb = fitting.fitOrientedBoundingBox(points);
+    expectAllPointsInside(points, obb, 1e-4);
+    EXPECT_NEAR(obb.getHalfWidthExtents().prod(), 4, 1e-3);
+    EXPECT_NEAR(obb.getCenterPosition().x(), 3, 1e-4);
+    EXPECT_NEAR(obb.getCenterPosition().y(), -2, 1e-4);
+    EXPECT_NEAR(obb.getRotationMatrix().determinant(), 1, 1e-5);
+  }
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestBoundingBoxFitting, OrientedBoundingBox2DFitsRotatedRectangle)
+{
+  testOrientedBoundingBox2D<Eigen::Vector2f>();
+  testOrientedBoundingBox2D<Eigen::Vector2d>();
+  testOrientedBoundingBox2D<romea::core::HomogeneousCoordinates2d>();
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestBoundingBoxFitting, OrientedBoundingBox2DIsNotLargerThanAngularSweep)
+{
+  romea::core::RandomGenerator generator(3);
+  romea::core::BoundingBoxFitting<Eigen::Vector2d> fitting;
+  for (size_t trial = 0; trial < 10; ++trial) {
+    auto points = makeRandomPoints<Eigen::Vector2d>(50, generator);
+    auto obb = fitting.fitOrientedBoundingBox(points);
+    expectAllPointsInside(points, obb, 1e-9);
+
+    double minimalArea = std::numeric_limits<double>::max();
+    for (size_t step = 0; step < 9000; ++step) {
+      const Eigen::Rotation2D<double> rotation(step * M_PI / 18000.);
+      Eigen::Vector2d lower = Eigen::Vector2d::Constant(std::numeric_limits<double>::max());
+      Eigen::Vector2d upper = -lower;
+      for (const Eigen::Vector2d & point : points) {
+        const Eigen::Vector2d local = rotation.inverse() * point;
+        lower = lower.cwiseMin(local);
+        upper = upper.cwiseMax(local);
+      }
+      minimalArea = std::min(minimalArea, (upper - lower).prod());
+    }
+
+    EXPECT_LE(4 * obb.getHalfWidthExtents().prod(), minimalArea + 1e-9);
+  }
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+void testOrientedBoundingBox3D()
+{
+  using Scalar = typename PointType::Scalar;
+  using OBBType = typename romea::core::BoundingBoxFitting<PointType>::OBBType;
+
+  romea::core::RandomGenerator generator(4);
+  romea::core::BoundingBoxFitting<PointType> fitting;
+  for (size_t trial = 0; trial < 20; ++trial) {
+    Eigen::Matrix<Scalar, 3, 1> axis;
+    romea::core::generateStandardNormals(generator, axis.data(), 3);
+    const Scalar angle = 2 * M_PI * romea::core::generateUniform<Scalar>(generator);
+    const OBBType box(
+      Eigen::Matrix<Scalar, 3, 1>(1, 2, 3),
+      Eigen::Matrix<Scalar, 3, 1>(4, 2, 0.5),
+      Eigen::AngleAxis<Scalar>(angle, axis.normalized()).matrix());
+    auto points = makeRotatedBoxPoints<PointType>(box, 2000, generator);
+
+    auto obb = fitting.fitOrientedBoundingBox(points);
+    expectAllPointsInside(points, obb, 1e-4);
+    EXPECT_NEAR(obb.getHalfWidthExtents().prod(), 4, 1e-3);
+    EXPECT_NEAR(obb.getCenterPosition().x(), 1, 1e-2);
+    EXPECT_NEAR(obb.getCenterPosition().y(), 2, 1e-2);
+    EXPECT_NEAR(obb.getCenterPosition().z(), 3, 1e-2);
+    EXPECT_NEAR(obb.getRotationMatrix().determinant(), 1, 1e-5);
+  }
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestBoundingBoxFitting, OrientedBoundingBox3DFitsRotatedBox)
+{
+  testOrientedBoundingBox3D<Eigen::Vector3f>();
+  testOrientedBoundingBox3D<Eigen::Vector3d>();
+  testOrientedBoundingBox3D<romea::core::HomogeneousCoordinates3d>();
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestBoundingBoxFitting, DegeneratePointSets)
+{
+  romea::core::BoundingBoxFitting<Eigen::Vector2d> fitting2d;
+
+  romea::core::PointSet<Eigen::Vector2d> single = {Eigen::Vector2d(1, 2), Eigen::Vector2d(1, 2)};
+  auto point = fitting2d.fitOrientedBoundingBox(single);
+  EXPECT_DOUBLE_EQ(point.getCenterPosition().x(), 1);
+  EXPECT_DOUBLE_EQ(point.getCenterPosition().y(), 2);
+  EXPECT_DOUBLE_EQ(point.getHalfWidthExtents().norm(), 0);
+
+  romea::core::PointSet<Eigen::Vector2d> segment;
+  for (size_t n = 0; n <= 10; ++n) {
+    segment.emplace_back(n, 2. * n);
+  }
+  auto line = fitting2d.fitOrientedBoundingBox(segment);
+  EXPECT_NEAR(line.getCenterPosition().x(), 5, 1e-12);
+  EXPECT_NEAR(line.getCenterPosition().y(), 10, 1e-12);
+  EXPECT_NEAR(line.getHalfWidthExtents().x(), 5 * std::sqrt(5.), 1e-12);
+  EXPECT_NEAR(line.getHalfWidthExtents().y(), 0, 1e-12);
+  expectAllPointsInside(segment, line, 1e-12);
+
+  // Flat 3D cluster gives a box of null thickness
+  romea::core::BoundingBoxFitting<Eigen::Vector3d> fitting3d;
+  romea::core::PointSet<Eigen::Vector3d> plane;
+  for (size_t i = 0; i <= 10; ++i) {
+    for (size_t j = 0; j <= 5; ++j) {
+      plane.emplace_back(i, j, 1);
+    }
+  }
+  auto flat = fitting3d.fitOrientedBoundingBox(plane);
+  expectAllPointsInside(plane, flat, 1e-9);
+  EXPECT_NEAR(flat.getHalfWidthExtents().prod(), 0, 1e-9);
+  EXPECT_NEAR(flat.getCenterPosition().z(), 1, 1e-9);
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestBoundingBoxFitting, OrientedBoundingBox3DOfLattice)
+{
+  // Lattice points share their projections on planes orthogonal to lattice
+  // axes, so planar points are deduplicated between projections
+  romea::core::BoundingBoxFitting<Eigen::Vector3d> fitting;
+  romea::core::PointSet<Eigen::Vector3d> lattice;
+  for (size_t i = 0; i < 5; ++i) {
+    for (size_t j = 0; j < 3; ++j) {
+      for (size_t k = 0; k < 2; ++k) {
+        lattice.emplace_back(i, j, k);
+      }
+    }
+  }
+
+  for (size_t trial = 0; trial < 2; ++trial) {
+    auto obb = fitting.fitOrientedBoundingBox(lattice);
+    expectAllPointsInside(lattice, obb, 1e-9);
+    EXPECT_NEAR(obb.getHalfWidthExtents().prod(), 2 * 1 * 0.5, 1e-9);
+  }
+}
+
+//-----------------------------------------------------------------------------
+int main(int argc, char ** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
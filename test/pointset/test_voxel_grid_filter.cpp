@@ -0,0 +1,162 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+// gtest
+#include <gtest/gtest.h>
+
+// std
+#include <limits>
+#include <map>
+#include <tuple>
+#include <vector>
+
+// romea
+#include "romea_core_common/pointset/algorithms/VoxelGridFilter.hpp"
+#include "romea_core_common/math/RandomGenerator.hpp"
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+romea::core::PointSet<PointType> makeRandomPoints(const size_t & numberOfPoints)
+{
+  using Scalar = typename PointType::Scalar;
+  romea::core::RandomGenerator generator(0);
+  romea::core::PointSet<PointType> points(numberOfPoints);
+  for (PointType & point : points) {
+    point = PointType::Ones();
+    for (int i = 0; i < romea::core::PointTraits<PointType>::DIM; ++i) {
+      point[i] = 4 * romea::core::generateUniform<Scalar>(generator) - 1;
+    }
+  }
+  return points;
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+void testVoxelGridFilter(const typename romea::core::VoxelGridFilter<PointType>::Mode & mode)
+{
+  using Scalar = typename PointType::Scalar;
+  using Filter = romea::core::VoxelGridFilter<PointType>;
+  constexpr int DIM = romea::core::PointTraits<PointType>::DIM;
+  using Voxel = std::tuple<size_t, size_t, size_t>;
+
+  romea::core::PointSet<PointType> points = makeRandomPoints<PointType>(20000);
+
+  Filter filter(0.25, mode);
+  filter.setMaximalNumberOfThreads(1);
+  romea::core::PointSet<PointType> filteredPoints;
+  filter.filter(points, filteredPoints);
+
+  // Reference groups points by voxel, voxels being ordered by linear index
+  std::map<Voxel, std::vector<size_t>> voxels;
+  for (size_t n = 0; n < points.size(); ++n) {
+    auto cellIndexes = filter.getGridIndexMapping().computeCellIndexes(
+      points[n].template head<DIM>());
+    voxels[{DIM == 3 ? cellIndexes[DIM - 1] : 0, cellIndexes[1], cellIndexes[0]}].push_back(n);
+  }
+
+  ASSERT_EQ(filteredPoints.size(), voxels.size());
+  ASSERT_EQ(filter.getFilteredPointIndexes().size(), voxels.size());
+
+  size_t voxelIndex = 0;
+  for (const auto & [voxel, indexes] : voxels) {
+    const PointType & filteredPoint = filteredPoints[voxelIndex];
+    const size_t filteredPointIndex = filter.getFilteredPointIndexes()[voxelIndex];
+    if (mode == Filter::Mode::CENTROID) {
+      PointType centroid = PointType::Zero();
+      for (const size_t & index : indexes) {
+        centroid += points[index];
+      }
+      centroid /= Scalar(indexes.size());
+      EXPECT_TRUE(filteredPoint.isApprox(centroid, Scalar(1e-5)));
+      EXPECT_EQ(filteredPointIndex, indexes.front());
+    } else if (mode == Filter::Mode::FIRST_POINT) {
+      EXPECT_EQ(filteredPointIndex, indexes.front());
+      EXPECT_EQ(filteredPoint, points[indexes.front()]);
+    } else {
+      const auto & gridIndexMapping = filter.getGridIndexMapping();
+      auto center = gridIndexMapping.computeCellCenterPosition(
+        gridIndexMapping.computeCellIndexes(points[indexes.front()].template head<DIM>()));
+      Scalar closestSquaredDistance = std::numeric_limits<Scalar>::max();
+      size_t closestIndex = 0;
+      for (const size_t & index : indexes) {
+        Scalar squaredDistance = (points[index].template head<DIM>() - center).squaredNorm();
+        if (squaredDistance < closestSquaredDistance) {
+          closestSquaredDistance = squaredDistance;
+          closestIndex = index;
+        }
+      }
+      EXPECT_EQ(filteredPointIndex, closestIndex);
+      EXPECT_EQ(filteredPoint, points[closestIndex]);
+    }
+    ++voxelIndex;
+  }
+
+  // Output does not depend on number of threads
+  romea::core::PointSet<PointType> parallelFilteredPoints;
+  filter.setMaximalNumberOfThreads(4);
+  filter.filter(points, parallelFilteredPoints);
+  ASSERT_EQ(parallelFilteredPoints.size(), filteredPoints.size());
+  for (size_t n = 0; n < filteredPoints.size(); ++n) {
+    EXPECT_EQ(parallelFilteredPoints[n], filteredPoints[n]);
+  }
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+void testVoxelGridFilter()
+{
+  using Mode = typename romea::core::VoxelGridFilter<PointType>::Mode;
+  testVoxelGridFilter<PointType>(Mode::CENTROID);
+  testVoxelGridFilter<PointType>(Mode::FIRST_POINT);
+  testVoxelGridFilter<PointType>(Mode::CLOSEST_TO_CENTER);
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestVoxelGridFilter, filter2d)
+{
+  testVoxelGridFilter<Eigen::Vector2f>();
+  testVoxelGridFilter<Eigen::Vector2d>();
+  testVoxelGridFilter<romea::core::HomogeneousCoordinates2d>();
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestVoxelGridFilter, filter3d)
+{
+  testVoxelGridFilter<Eigen::Vector3f>();
+  testVoxelGridFilter<Eigen::Vector3d>();
+  testVoxelGridFilter<romea::core::HomogeneousCoordinates3f>();
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestVoxelGridFilter, emptyAndSinglePointSets)
+{
+  romea::core::VoxelGridFilter<Eigen::Vector3d> filter(0.1);
+  romea::core::PointSet<Eigen::Vector3d> filteredPoints(3);
+  filter.filter(romea::core::PointSet<Eigen::Vector3d>(), filteredPoints);
+  EXPECT_TRUE(filteredPoints.empty());
+
+  romea::core::PointSet<Eigen::Vector3d> points(5, Eigen::Vector3d(1, 2, 3));
+  filter.filter(points, filteredPoints);
+  ASSERT_EQ(filteredPoints.size(), 1u);
+  EXPECT_TRUE(filteredPoints[0].isApprox(Eigen::Vector3d(1, 2, 3)));
+}
+
+//-----------------------------------------------------------------------------
+int main(int argc, char ** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
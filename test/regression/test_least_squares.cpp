@@ -0,0 +1,108 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// gtest
+#include <gtest/gtest.h>
+
+// romea
+#include "romea_core_common/math/RandomGenerator.hpp"
+#include "romea_core_common/regression/leastsquares/LeastSquares.hpp"
+
+//-----------------------------------------------------------------------------
+class TestLeastSquares : public ::testing::Test
+{
+public:
+  void SetUp() override
+  {
+    romea::core::RandomGenerator generator(1);
+    J.resize(200, 4);
+    Y.resize(200);
+    for (int n = 0; n < J.rows(); ++n) {
+      for (int i = 0; i < J.cols(); ++i) {
+        J(n, i) = romea::core::generateUniform<double>(generator) - 0.5;
+      }
+    }
+    Y = J * Eigen::Vector4d(1, -2, 3, 0.5);
+    Y += 0.01 * (Eigen::VectorXd::Random(200));
+  }
+
+  Eigen::MatrixXd J;
+  Eigen::VectorXd Y;
+};
+
+//-----------------------------------------------------------------------------
+TEST_F(TestLeastSquares, FixedSizeGivesSameEstimateThanDynamicSize)
+{
+  romea::core::LeastSquares<double> dynamicLeastSquares(4, 200);
+  dynamicLeastSquares.getJ() = J;
+  dynamicLeastSquares.getY() = Y;
+  Eigen::VectorXd expectedEstimate = dynamicLeastSquares.estimateUsingCholeskyDecomposition();
+  Eigen::MatrixXd expectedCovariance = dynamicLeastSquares.computeEstimateCovariance(0.01);
+
+  romea::core::LeastSquares<double, 4> fixedLeastSquares;
+  for (int n = 0; n < J.rows(); ++n) {
+    fixedLeastSquares.addRow(J.row(n).transpose(), Y(n));
+  }
+
+  EXPECT_EQ(fixedLeastSquares.getDataSize(), 200u);
+  EXPECT_TRUE(fixedLeastSquares.estimateUsingCholeskyDecomposition().isApprox(expectedEstimate));
+  EXPECT_TRUE(fixedLeastSquares.computeEstimateCovariance(0.01).isApprox(expectedCovariance));
+  EXPECT_TRUE(fixedLeastSquares.estimateUsingSVD().isApprox(expectedEstimate));
+
+  fixedLeastSquares.reset();
+  EXPECT_EQ(fixedLeastSquares.getDataSize(), 0u);
+  EXPECT_TRUE(fixedLeastSquares.getJtJ().isZero());
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestLeastSquares, FixedSizeWeights)
+{
+  Eigen::VectorXd W = Eigen::VectorXd::LinSpaced(200, 0.1, 2.);
+
+  romea::core::LeastSquares<double> dynamicLeastSquares(4, 200);
+  dynamicLeastSquares.getJ() = J;
+  dynamicLeastSquares.getY() = Y;
+  dynamicLeastSquares.getW() = W.cwiseSqrt();
+  Eigen::VectorXd expectedEstimate = dynamicLeastSquares.weightedEstimate();
+
+  romea::core::LeastSquares<double, 4> fixedLeastSquares;
+  for (int n = 0; n < J.rows(); ++n) {
+    fixedLeastSquares.addRow(J.row(n).transpose(), Y(n), W(n));
+  }
+
+  EXPECT_TRUE(fixedLeastSquares.estimateUsingCholeskyDecomposition().isApprox(expectedEstimate));
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestLeastSquares, FixedSizePreconditioner)
+{
+  romea::core::LeastSquares<double, 4> leastSquares;
+  for (int n = 0; n < J.rows(); ++n) {
+    leastSquares.addRow(J.row(n).transpose(), Y(n));
+  }
+  Eigen::Vector4d estimate = leastSquares.estimateUsingCholeskyDecomposition();
+
+  Eigen::Matrix4d Ac = Eigen::Vector4d(2, 2, 1, 1).asDiagonal();
+  Eigen::Vector4d Bc(0, 0, 1, 1);
+  leastSquares.setPreconditionner(Ac, Bc);
+  EXPECT_TRUE(leastSquares.estimateUsingCholeskyDecomposition().isApprox(Ac * estimate + Bc));
+}
+
+//-----------------------------------------------------------------------------
+int main(int argc, char ** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,165 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+// gtest
+#include <gtest/gtest.h>
+
+// std
+#include <algorithm>
+#include <random>
+
+// romea
+#include "romea_core_common/regression/leastsquares/MEstimator.hpp"
+
+//-----------------------------------------------------------------------------
+class TestMEstimator : public ::testing::Test
+{
+public:
+  TestMEstimator()
+  : residuals(10000)
+  {
+  }
+
+  void SetUp() override
+  {
+    // 80 percent of gaussian inliers around 0.5 and 20 percent of outliers
+    std::mt19937 generator(0);
+    std::normal_distribution<double> noise(0.5, 0.1);
+    std::uniform_real_distribution<double> outlier(5., 10.);
+    for (int n = 0; n < residuals.rows(); ++n) {
+      residuals[n] = n % 5 == 0 ? outlier(generator) : noise(generator);
+    }
+  }
+
+  Eigen::VectorXd residuals;
+};
+
+//-----------------------------------------------------------------------------
+TEST_F(TestMEstimator, HuberWeights)
+{
+  romea::core::MEstimator<double> mEstimator(0.01);
+  double ratio = mEstimator.computeWeights(residuals);
+  const Eigen::VectorXd & weights = mEstimator.getWeights();
+
+  EXPECT_GT(ratio, 0.2);
+  EXPECT_LT(ratio, 0.35);
+  for (int n = 0; n < residuals.rows(); ++n) {
+    EXPECT_GT(weights[n], 0);
+    EXPECT_LE(weights[n], 1);
+    if (n % 5 == 0) {
+      EXPECT_LT(weights[n], 0.05);
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestMEstimator, TukeyRejectsOutliers)
+{
+  romea::core::MEstimator<double> mEstimator(0.01, romea::core::MEstimator<double>::Kernel::TUKEY);
+  mEstimator.computeWeights(residuals);
+  const Eigen::VectorXd & weights = mEstimator.getWeights();
+
+  for (int n = 0; n < residuals.rows(); n += 5) {
+    EXPECT_DOUBLE_EQ(weights[n], 0);
+  }
+  EXPECT_GT(weights[1], 0);
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestMEstimator, CauchyWeightsDecrease)
+{
+  romea::core::MEstimator<double> mEstimator(0.01, romea::core::MEstimator<double>::Kernel::CAUCHY);
+  Eigen::VectorXd sortedResiduals = residuals;
+  std::sort(sortedResiduals.data(), sortedResiduals.data() + residuals.rows());
+  mEstimator.computeWeights(sortedResiduals);
+  const Eigen::VectorXd & weights = mEstimator.getWeights();
+
+  // Weights decrease with the distance to the median
+  for (int n = residuals.rows() / 2; n < residuals.rows() - 1; ++n) {
+    EXPECT_GE(weights[n], weights[n + 1]);
+  }
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestMEstimator, ApproximateMedianMatchesExactOne)
+{
+  for (auto kernel : {romea::core::MEstimator<double>::Kernel::HUBER,
+      romea::core::MEstimator<double>::Kernel::CAUCHY,
+      romea::core::MEstimator<double>::Kernel::TUKEY})
+  {
+    romea::core::MEstimator<double> exact(0.01, kernel);
+    double exactRatio = exact.computeWeights(residuals);
+
+    romea::core::MEstimator<double> approximate(0.01, kernel);
+    approximate.enableApproximateMedian(1000);
+    double approximateRatio = approximate.computeWeights(residuals);
+
+    EXPECT_NEAR(exactRatio, approximateRatio, 1e-3);
+    EXPECT_LT((exact.getWeights() - approximate.getWeights()).cwiseAbs().maxCoeff(), 1e-3);
+  }
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestMEstimator, DiscardedData)
+{
+  const size_t numberOfDiscardedData = 1000;
+  Eigen::VectorXd residualsWithDiscardedValue(residuals.rows() + numberOfDiscardedData);
+  residualsWithDiscardedValue << residuals,
+    Eigen::VectorXd::Constant(numberOfDiscardedData, romea::core::MESTIMATOR_DISCARDED_VALUE_DOUBLE);
+
+  romea::core::MEstimator<double> reference(0.01);
+  double referenceRatio = reference.computeWeights(residuals);
+
+  for (size_t minimalDataSize : {std::numeric_limits<size_t>::max(), size_t(0)}) {
+    romea::core::MEstimator<double> mEstimator(0.01);
+    mEstimator.enableApproximateMedian(minimalDataSize);
+    double ratio = mEstimator.computeWeights(residualsWithDiscardedValue, numberOfDiscardedData);
+
+    EXPECT_NEAR(ratio, referenceRatio, 1e-3);
+    EXPECT_LT(
+      (mEstimator.getWeights().head(residuals.rows()) - reference.getWeights()).cwiseAbs().maxCoeff(),
+      1e-3);
+  }
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestMEstimator, DistancesAreCenteredOnZero)
+{
+  // 40 percent of distances close to zero and 60 percent around one
+  Eigen::VectorXd distances(1000);
+  for (int n = 0; n < distances.rows(); ++n) {
+    distances[n] = n % 5 < 2 ? 0.001 * (n % 5) : 1. + 0.001 * (n % 7);
+  }
+
+  romea::core::MEstimator<double> mEstimator(0.01);
+  mEstimator.computeWeightsOfDistances(distances);
+  const Eigen::VectorXd & weights = mEstimator.getWeights();
+
+  for (int n = 0; n < distances.rows(); ++n) {
+    if (n % 5 < 2) {
+      EXPECT_DOUBLE_EQ(weights[n], 1);
+    } else {
+      EXPECT_LE(weights[n], weights[0]);
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+int main(int argc, char ** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,177 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// gtest
+#include <gtest/gtest.h>
+
+// std
+#include <cmath>
+
+// romea
+#include "romea_core_common/math/RandomGenerator.hpp"
+#include "romea_core_common/regression/leastsquares/NLSE.hpp"
+
+const double NOISE_STD = 0.01;
+
+// Fit y = a * exp(b * x)
+class ExponentialFitting : public romea::core::NLSE<double>
+{
+public:
+  ExponentialFitting(const Eigen::VectorXd & x, const Eigen::VectorXd & y)
+  : NLSE<double>(1e-8),
+    x_(),
+    y_()
+  {
+    leastSquares_.setEstimateSize(2);
+    setData(x, y);
+  }
+
+  void setData(const Eigen::VectorXd & x, const Eigen::VectorXd & y)
+  {
+    x_ = x;
+    y_ = y;
+    leastSquares_.setDataSize(size_t(x.rows()));
+  }
+
+protected:
+  void computeGuess_() override
+  {
+    estimate_ = Eigen::Vector2d(1, 0);
+  }
+
+  void computeJacobianAndY_() override
+  {
+    auto & J = leastSquares_.getJ();
+    auto & Y = leastSquares_.getY();
+    for (int n = 0; n < x_.rows(); ++n) {
+      double e = std::exp(estimate_(1) * x_(n));
+      J(n, 0) = e;
+      J(n, 1) = estimate_(0) * x_(n) * e;
+      Y(n) = estimate_(0) * e - y_(n);
+    }
+  }
+
+private:
+  Eigen::VectorXd x_;
+  Eigen::VectorXd y_;
+};
+
+//-----------------------------------------------------------------------------
+class TestNLSE : public ::testing::Test
+{
+public:
+  void SetUp() override
+  {
+    romea::core::RandomGenerator generator(1);
+    x = Eigen::VectorXd::LinSpaced(100, 0, 2);
+    y.resize(100);
+    romea::core::generateStandardNormals(generator, y.data(), 100);
+    y = (2 * (0.8 * x).array().exp()).matrix() + NOISE_STD * y;
+  }
+
+  Eigen::VectorXd x;
+  Eigen::VectorXd y;
+};
+
+//-----------------------------------------------------------------------------
+TEST_F(TestNLSE, GaussNewton)
+{
+  ExponentialFitting fitting(x, y);
+  ASSERT_TRUE(fitting.estimate(100, NOISE_STD));
+  EXPECT_NEAR(fitting.getEstimate()(0), 2, 0.01);
+  EXPECT_NEAR(fitting.getEstimate()(1), 0.8, 0.01);
+  EXPECT_LT(fitting.getRootMeanSquareError(), 2 * NOISE_STD);
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestNLSE, LevenbergMarquardtNeedsLessIterations)
+{
+  ExponentialFitting gaussNewton(x, y);
+  ASSERT_TRUE(gaussNewton.estimate(100, NOISE_STD));
+
+  ExponentialFitting levenbergMarquardt(x, y);
+  levenbergMarquardt.setMethod(romea::core::NLSE<double>::Method::LEVENBERG_MARQUARDT);
+  ASSERT_TRUE(levenbergMarquardt.estimate(100, NOISE_STD));
+  EXPECT_NEAR(levenbergMarquardt.getEstimate()(0), 2, 0.01);
+  EXPECT_NEAR(levenbergMarquardt.getEstimate()(1), 0.8, 0.01);
+  EXPECT_LT(levenbergMarquardt.getNumberOfIterations(), gaussNewton.getNumberOfIterations());
+  EXPECT_EQ(levenbergMarquardt.getEstimateCovariance().rows(), 2);
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestNLSE, CostHistoryAndDurations)
+{
+  ExponentialFitting fitting(x, y);
+  fitting.setMethod(romea::core::NLSE<double>::Method::LEVENBERG_MARQUARDT);
+  ASSERT_TRUE(fitting.estimate(100, NOISE_STD));
+
+  const auto & costs = fitting.getCostHistory();
+  ASSERT_EQ(costs.size(), fitting.getNumberOfIterations() + 1);
+  EXPECT_EQ(fitting.getIterationDurations().size(), fitting.getNumberOfIterations());
+  for (size_t n = 1; n < costs.size(); ++n) {
+    EXPECT_LE(costs[n], costs[n - 1]);
+  }
+  EXPECT_LT(costs.back(), costs.front());
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestNLSE, RobustKernels)
+{
+  for (int n = 0; n < 100; n += 10) {
+    y(n) += 5;
+  }
+
+  ExponentialFitting leastSquaresFitting(x, y);
+  leastSquaresFitting.setMethod(romea::core::NLSE<double>::Method::LEVENBERG_MARQUARDT);
+  leastSquaresFitting.estimate(100, NOISE_STD);
+  double leastSquaresError = std::abs(leastSquaresFitting.getEstimate()(0) - 2);
+
+  using Kernel = romea::core::NLSE<double>::RobustKernel;
+  for (const Kernel & kernel : {Kernel::HUBER, Kernel::CAUCHY, Kernel::TUKEY}) {
+    ExponentialFitting fitting(x, y);
+    fitting.setMethod(romea::core::NLSE<double>::Method::LEVENBERG_MARQUARDT);
+    fitting.setRobustKernel(kernel);
+    fitting.estimate(100, NOISE_STD);
+    EXPECT_LT(std::abs(fitting.getEstimate()(0) - 2), leastSquaresError);
+    EXPECT_NEAR(fitting.getEstimate()(1), 0.8, 0.05);
+  }
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestNLSE, RootMeanSquareErrorAfterSmallerProblem)
+{
+  ExponentialFitting fitting(x, y);
+  ASSERT_TRUE(fitting.estimate(100, NOISE_STD));
+
+  // Least squares buffers keep their size, stale rows must be ignored
+  romea::core::RandomGenerator generator(2);
+  Eigen::VectorXd noise(50);
+  romea::core::generateStandardNormals(generator, noise.data(), 50);
+  Eigen::VectorXd smallX = x.head(50);
+  Eigen::VectorXd smallY = (2 * (0.8 * smallX).array().exp()).matrix() + 5 * NOISE_STD * noise;
+  fitting.setData(smallX, smallY);
+  ASSERT_TRUE(fitting.estimate(100, 5 * NOISE_STD));
+
+  const Eigen::Vector2d & estimate = fitting.getEstimate();
+  Eigen::ArrayXd residuals = estimate(0) * (estimate(1) * smallX.array()).exp() - smallY.array();
+  EXPECT_NEAR(fitting.getRootMeanSquareError(), std::sqrt(residuals.square().mean()), 1e-9);
+}
+
+//-----------------------------------------------------------------------------
+int main(int argc, char ** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
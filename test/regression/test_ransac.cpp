@@ -0,0 +1,291 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// gtest
+#include <gtest/gtest.h>
+
+// std
+#include <cmath>
+#include <random>
+
+// romea
+#include "romea_core_common/regression/ransac/Ransac.hpp"
+#include "romea_core_common/geometry/estimation/RansacLineModel.hpp"
+#include "romea_core_common/geometry/estimation/RansacCircleModel.hpp"
+#include "romea_core_common/geometry/estimation/RansacPlaneModel.hpp"
+#include "romea_core_common/geometry/estimation/RansacSequentialExtraction.hpp"
+
+const double NOISE_STD = 0.01;
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+void addOutliers(
+  romea::core::PointSet<PointType> & points,
+  const size_t & numberOfOutliers,
+  std::mt19937 & generator)
+{
+  std::uniform_real_distribution<double> uniform(-5., 5.);
+  for (size_t n = 0; n < numberOfOutliers; ++n) {
+    PointType point = PointType::Zero();
+    for (int i = 0; i < romea::core::PointTraits<PointType>::DIM; ++i) {
+      point[i] = uniform(generator);
+    }
+    if constexpr (romea::core::PointTraits<PointType>::SIZE !=
+      romea::core::PointTraits<PointType>::DIM)
+    {
+      point[romea::core::PointTraits<PointType>::DIM] = 1;
+    }
+    points.push_back(point);
+  }
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+romea::core::PointSet<PointType> makeLine(std::mt19937 & generator)
+{
+  std::normal_distribution<double> noise(0, NOISE_STD);
+  romea::core::PointSet<PointType> points;
+  for (size_t n = 0; n < 200; ++n) {
+    double x = -2 + 0.02 * n;
+    PointType point = PointType::Zero();
+    point[0] = x;
+    point[1] = 0.5 * x + 1 + noise(generator);
+    points.push_back(point);
+  }
+  addOutliers(points, 100, generator);
+  return points;
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+romea::core::PointSet<PointType> makeCircle(std::mt19937 & generator)
+{
+  std::normal_distribution<double> noise(0, NOISE_STD);
+  romea::core::PointSet<PointType> points;
+  for (size_t n = 0; n < 100; ++n) {
+    double theta = 0.05 * n;
+    double radius = 0.5 + noise(generator);
+    PointType point = PointType::Zero();
+    point[0] = 2 + radius * std::cos(theta);
+    point[1] = 3 + radius * std::sin(theta);
+    points.push_back(point);
+  }
+  addOutliers(points, 50, generator);
+  return points;
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+romea::core::PointSet<PointType> makePlane(std::mt19937 & generator)
+{
+  std::normal_distribution<double> noise(0, NOISE_STD);
+  romea::core::PointSet<PointType> points;
+  for (size_t i = 0; i < 20; ++i) {
+    for (size_t j = 0; j < 20; ++j) {
+      double x = -2 + 0.2 * i;
+      double y = -2 + 0.2 * j;
+      PointType point = PointType::Zero();
+      point[0] = x;
+      point[1] = y;
+      point[2] = 0.1 * x - 0.2 * y + 1 + noise(generator);
+      points.push_back(point);
+    }
+  }
+  addOutliers(points, 200, generator);
+  return points;
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+void testLine()
+{
+  std::mt19937 generator(1);
+  auto points = makeLine<PointType>(generator);
+
+  romea::core::RansacLineModel<PointType> model;
+  model.loadPointSet(&points);
+  romea::core::Ransac<romea::core::RansacLineModel<PointType>> ransac(&model, NOISE_STD);
+  ransac.setSeed(42);
+  ASSERT_TRUE(ransac.estimateModel());
+
+  Eigen::Vector2d expectedNormal = Eigen::Vector2d(-0.5, 1).normalized();
+  double sign = model.getNormal().template cast<double>().dot(expectedNormal) > 0 ? 1 : -1;
+  EXPECT_NEAR(sign * model.getNormal().x(), expectedNormal.x(), 0.01);
+  EXPECT_NEAR(sign * model.getNormal().y(), expectedNormal.y(), 0.01);
+  EXPECT_NEAR(sign * model.getDistanceToOrigin(), expectedNormal.y(), 0.01);
+  EXPECT_GE(model.getInliers().size(), 195u);
+  EXPECT_LT(model.getRootMeanSquareError(), 2 * NOISE_STD);
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestRansac, LineModel)
+{
+  testLine<Eigen::Vector2f>();
+  testLine<Eigen::Vector2d>();
+  testLine<romea::core::HomogeneousCoordinates2d>();
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+void testCircle()
+{
+  std::mt19937 generator(2);
+  auto points = makeCircle<PointType>(generator);
+
+  romea::core::RansacCircleModel<PointType> model;
+  model.setRadiusRange(0.1, 1.0);
+  model.loadPointSet(&points);
+  romea::core::Ransac<romea::core::RansacCircleModel<PointType>> ransac(&model, NOISE_STD);
+  ransac.setSeed(42);
+  ASSERT_TRUE(ransac.estimateModel());
+
+  EXPECT_NEAR(model.getCenter().x(), 2, 0.005);
+  EXPECT_NEAR(model.getCenter().y(), 3, 0.005);
+  EXPECT_NEAR(model.getRadius(), 0.5, 0.005);
+  EXPECT_GE(model.getInliers().size(), 95u);
+  EXPECT_LT(model.getRootMeanSquareError(), 2 * NOISE_STD);
+
+  romea::core::Circle circle = model.getCircle();
+  EXPECT_DOUBLE_EQ(circle.getRadius(), double(model.getRadius()));
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestRansac, CircleModel)
+{
+  testCircle<Eigen::Vector2f>();
+  testCircle<Eigen::Vector2d>();
+  testCircle<romea::core::HomogeneousCoordinates2d>();
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+void testPlane()
+{
+  std::mt19937 generator(3);
+  auto points = makePlane<PointType>(generator);
+
+  romea::core::RansacPlaneModel<PointType> model;
+  model.loadPointSet(&points);
+  romea::core::Ransac<romea::core::RansacPlaneModel<PointType>> ransac(&model, NOISE_STD);
+  ransac.setSeed(42);
+  ASSERT_TRUE(ransac.estimateModel());
+
+  Eigen::Vector3d expectedNormal = Eigen::Vector3d(-0.1, 0.2, 1).normalized();
+  double sign = model.getNormal().template cast<double>().dot(expectedNormal) > 0 ? 1 : -1;
+  EXPECT_NEAR(sign * model.getNormal().x(), expectedNormal.x(), 0.01);
+  EXPECT_NEAR(sign * model.getNormal().y(), expectedNormal.y(), 0.01);
+  EXPECT_NEAR(sign * model.getNormal().z(), expectedNormal.z(), 0.01);
+  EXPECT_NEAR(sign * model.getDistanceToOrigin(), expectedNormal.z(), 0.01);
+  EXPECT_GE(model.getInliers().size(), 390u);
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestRansac, PlaneModel)
+{
+  testPlane<Eigen::Vector3f>();
+  testPlane<Eigen::Vector3d>();
+  testPlane<romea::core::HomogeneousCoordinates3d>();
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestRansac, SameSeedGivesSameResult)
+{
+  std::mt19937 generator(1);
+  auto points = makeLine<Eigen::Vector2d>(generator);
+
+  romea::core::RansacLineModel<Eigen::Vector2d> model;
+  romea::core::Ransac<romea::core::RansacLineModel<Eigen::Vector2d>> ransac(&model, NOISE_STD);
+
+  model.loadPointSet(&points);
+  ransac.setSeed(7);
+  ASSERT_TRUE(ransac.estimateModel());
+  romea::core::RansacStatistics statistics = ransac.getStatistics();
+  std::vector<size_t> inliers = model.getInliers();
+
+  model.loadPointSet(&points);
+  ransac.setSeed(7);
+  ASSERT_TRUE(ransac.estimateModel());
+  EXPECT_EQ(ransac.getStatistics().numberOfIterations, statistics.numberOfIterations);
+  EXPECT_EQ(ransac.getStatistics().bestNumberOfInliers, statistics.bestNumberOfInliers);
+  EXPECT_EQ(model.getInliers(), inliers);
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestRansac, Statistics)
+{
+  std::mt19937 generator(1);
+  auto points = makeLine<Eigen::Vector2d>(generator);
+
+  romea::core::RansacLineModel<Eigen::Vector2d> model;
+  model.loadPointSet(&points);
+  romea::core::Ransac<romea::core::RansacLineModel<Eigen::Vector2d>> ransac(&model, NOISE_STD);
+  ransac.setMaximalNumberOfIterations(5);
+  ransac.estimateModel();
+
+  const romea::core::RansacStatistics & statistics = ransac.getStatistics();
+  EXPECT_LE(statistics.numberOfIterations, 5u);
+  EXPECT_GT(statistics.numberOfIterations, 0u);
+  EXPECT_GT(statistics.drawDuration.count(), 0);
+  EXPECT_GT(statistics.countInliersDuration.count(), 0);
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestRansac, SequentialExtraction)
+{
+  std::mt19937 generator(4);
+  std::normal_distribution<double> noise(0, NOISE_STD);
+
+  romea::core::PointSet<Eigen::Vector2d> points;
+  for (size_t n = 0; n < 200; ++n) {
+    double x = -2 + 0.02 * n;
+    points.emplace_back(x, 0.5 * x + 1 + noise(generator));
+  }
+  for (size_t n = 0; n < 150; ++n) {
+    double x = -1 + 0.02 * n;
+    points.emplace_back(x, -x - 3 + noise(generator));
+  }
+  addOutliers(points, 50, generator);
+
+  romea::core::RansacSequentialExtraction<romea::core::RansacLineModel<Eigen::Vector2d>>
+  extraction(NOISE_STD);
+  extraction.getModel().setMinimalNumberOfInliers(50);
+  extraction.getRansac().setSeed(1);
+  extraction.setMaximalNumberOfPrimitives(5);
+  const auto & lines = extraction.extract(points);
+
+  ASSERT_EQ(lines.size(), 2u);
+  EXPECT_GE(lines[0].inliers.size(), 195u);
+  EXPECT_GE(lines[1].inliers.size(), 145u);
+  EXPECT_NEAR(std::abs(lines[0].parameters.normal.dot(Eigen::Vector2d(-0.5, 1).normalized())),
+    1, 1e-3);
+  EXPECT_NEAR(std::abs(lines[1].parameters.normal.dot(Eigen::Vector2d(1, 1).normalized())),
+    1, 1e-3);
+
+  // First line inliers have been removed before extracting the second one
+  for (const size_t & index : lines[1].inliers) {
+    EXPECT_GE(index, 200u);
+  }
+
+  EXPECT_EQ(
+    lines[0].inliers.size() + lines[1].inliers.size() +
+    extraction.getRemainingPointIndexes().size(), points.size());
+}
+
+//-----------------------------------------------------------------------------
+int main(int argc, char ** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
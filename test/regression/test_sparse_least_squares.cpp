@@ -0,0 +1,109 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// gtest
+#include <gtest/gtest.h>
+
+// romea
+#include "romea_core_common/math/RandomGenerator.hpp"
+#include "romea_core_common/regression/leastsquares/LeastSquares.hpp"
+#include "romea_core_common/regression/leastsquares/SparseLeastSquares.hpp"
+
+//-----------------------------------------------------------------------------
+class TestSparseLeastSquares : public ::testing::Test
+{
+public:
+  // Chain of 2D blocks : each residual block links two consecutive parameter blocks
+  void SetUp() override
+  {
+    romea::core::RandomGenerator generator(2);
+    J = Eigen::MatrixXd::Zero(2 * NUMBER_OF_BLOCKS, 2 * NUMBER_OF_BLOCKS);
+    Y.resize(2 * NUMBER_OF_BLOCKS);
+    romea::core::generateStandardNormals(generator, Y.data(), size_t(Y.size()));
+
+    sparseLeastSquares.setEstimateSize(2 * NUMBER_OF_BLOCKS);
+    sparseLeastSquares.setDataSize(2 * NUMBER_OF_BLOCKS);
+    sparseLeastSquares.getY() = Y;
+    for (size_t n = 0; n < NUMBER_OF_BLOCKS; ++n) {
+      Eigen::Matrix2d block;
+      romea::core::generateStandardNormals(generator, block.data(), 4);
+      block += 3 * Eigen::Matrix2d::Identity();
+      J.block<2, 2>(2 * n, 2 * n) = block;
+      sparseLeastSquares.addJacobianBlock(2 * n, 2 * n, block);
+      if (n > 0) {
+        J.block<2, 2>(2 * n, 2 * n - 2) = -Eigen::Matrix2d::Identity();
+        sparseLeastSquares.addJacobianBlock(2 * n, 2 * n - 2, -Eigen::Matrix2d::Identity());
+      }
+    }
+
+    denseLeastSquares = romea::core::LeastSquares<double>(2 * NUMBER_OF_BLOCKS,
+        2 * NUMBER_OF_BLOCKS);
+    denseLeastSquares.getJ() = J;
+    denseLeastSquares.getY() = Y;
+  }
+
+  static constexpr size_t NUMBER_OF_BLOCKS = 20;
+  Eigen::MatrixXd J;
+  Eigen::VectorXd Y;
+  romea::core::LeastSquares<double> denseLeastSquares;
+  romea::core::SparseLeastSquares<double> sparseLeastSquares;
+};
+
+//-----------------------------------------------------------------------------
+TEST_F(TestSparseLeastSquares, SameEstimateAndCovarianceThanDense)
+{
+  Eigen::VectorXd expectedEstimate = denseLeastSquares.estimateUsingCholeskyDecomposition();
+  Eigen::MatrixXd expectedCovariance = denseLeastSquares.computeEstimateCovariance(0.1);
+
+  EXPECT_TRUE(Eigen::MatrixXd(sparseLeastSquares.getJ()).isApprox(J));
+  EXPECT_TRUE(sparseLeastSquares.estimateUsingCholeskyDecomposition().isApprox(expectedEstimate));
+  EXPECT_TRUE(sparseLeastSquares.isSolved());
+  EXPECT_TRUE(sparseLeastSquares.computeEstimateCovariance(0.1).isApprox(expectedCovariance));
+  EXPECT_TRUE(sparseLeastSquares.computeEstimateCovarianceBlock(6, 2, 0.1).
+    isApprox(expectedCovariance.block<2, 2>(6, 6)));
+
+  // Second solve reuses symbolic analysis
+  sparseLeastSquares.getY() *= 2;
+  EXPECT_TRUE(sparseLeastSquares.estimateUsingCholeskyDecomposition().
+    isApprox(2 * expectedEstimate));
+}
+
+//-----------------------------------------------------------------------------
+TEST_F(TestSparseLeastSquares, WeightsAndPreconditioner)
+{
+  Eigen::VectorXd W = Eigen::VectorXd::LinSpaced(2 * NUMBER_OF_BLOCKS, 0.5, 2);
+  Eigen::VectorXd Bc = Eigen::VectorXd::Ones(2 * NUMBER_OF_BLOCKS);
+  Eigen::VectorXd scale = Eigen::VectorXd::Constant(2 * NUMBER_OF_BLOCKS, 2);
+
+  denseLeastSquares.getW() = W;
+  denseLeastSquares.setPreconditionner(scale.asDiagonal().toDenseMatrix(), Bc);
+  Eigen::VectorXd expectedEstimate = denseLeastSquares.weightedEstimate();
+  Eigen::MatrixXd expectedCovariance = denseLeastSquares.computeEstimateCovariance(1);
+
+  Eigen::SparseMatrix<double> Ac(2 * NUMBER_OF_BLOCKS, 2 * NUMBER_OF_BLOCKS);
+  Ac.setIdentity();
+  Ac *= 2;
+  sparseLeastSquares.getW() = W;
+  sparseLeastSquares.setPreconditionner(Ac, Bc);
+  EXPECT_TRUE(sparseLeastSquares.weightedEstimate().isApprox(expectedEstimate));
+  EXPECT_TRUE(sparseLeastSquares.computeEstimateCovariance(1).isApprox(expectedCovariance));
+}
+
+//-----------------------------------------------------------------------------
+int main(int argc, char ** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
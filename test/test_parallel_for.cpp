@@ -0,0 +1,69 @@
+// Copyright 2022 INRAE, French National Research Institute for Agriculture, Food and Environment
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+// gtest
+#include <gtest/gtest.h>
+
+// std
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+// romea
+#include "romea_core_common/concurrency/ParallelFor.hpp"
+
+//-----------------------------------------------------------------------------
+TEST(TestParallelFor, RangesCoverInput)
+{
+  std::vector<int> counts(1000, 0);
+  romea::core::parallelFor(
+    counts.size(), 4,
+    [&](const size_t & /*threadIndex*/, const size_t & begin, const size_t & end) {
+      for (size_t n = begin; n < end; ++n) {
+        ++counts[n];
+      }
+    });
+
+  for (const int & count : counts) {
+    EXPECT_EQ(count, 1);
+  }
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestParallelFor, ExceptionOfCallingThreadIsRethrownAfterJoin)
+{
+  std::atomic<size_t> numberOfFinishedRanges(0);
+  EXPECT_THROW(
+    romea::core::parallelFor(
+      100, 4,
+      [&](const size_t & threadIndex, const size_t & /*begin*/, const size_t & /*end*/) {
+        if (threadIndex == 0) {
+          throw std::runtime_error("range failed");
+        }
+        ++numberOfFinishedRanges;
+      }),
+    std::runtime_error);
+
+  // Other ranges have been joined before the exception left parallelFor
+  EXPECT_EQ(numberOfFinishedRanges.load(), 3u);
+}
+
+//-----------------------------------------------------------------------------
+int main(int argc, char ** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
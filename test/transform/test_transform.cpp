@@ -17,6 +17,8 @@
 #include <gtest/gtest.h>
 
 // std
+#include <cmath>
+#include <cstdint>
 #include <vector>
 
 // local
@@ -25,6 +27,8 @@
 #include "romea_core_common/transform/estimation/FindRigidTransformationByLeastSquares.hpp"
 #include "romea_core_common/transform/estimation/FindRigidTransformationBySVD.hpp"
 #include "romea_core_common/transform/estimation/FindRigidTransformationByICP.hpp"
+#include "romea_core_common/transform/estimation/FindRigidTransformationByBranchAndBound.hpp"
+#include "romea_core_common/containers/grid/DistanceTransform.hpp"
 
 const Eigen::Affine2d transformation2d =
   Eigen::Translation2d(0.1, 0.2) *
@@ -103,6 +107,26 @@ TEST(TestTransform, FindBySVDWithoutPreconditionningh)
 }
 
 
+//-----------------------------------------------------------------------------
+TEST(TestTransform, FindByLeastSquaresMultithreaded)
+{
+  using PointType = Eigen::Vector3d;
+  romea::core::PointSet<PointType> sourcePoints = loadScan<PointType>("/scan3d.txt");
+  romea::core::PointSet<PointType> targetPoints = projectScan(sourcePoints, transformation3d);
+  romea::core::NormalSet<PointType> targetNormals = computeNormals(targetPoints);
+
+  romea::core::FindRigidTransformationByLeastSquares<PointType> estimator;
+  estimator.setMaximalNumberOfThreads(1);
+  auto singleThreadTransformation = estimator.find(sourcePoints, targetPoints, targetNormals);
+
+  estimator.setMaximalNumberOfThreads(4);
+  auto multiThreadTransformation = estimator.find(sourcePoints, targetPoints, targetNormals);
+  EXPECT_TRUE(multiThreadTransformation.isApprox(singleThreadTransformation, 1e-9));
+  EXPECT_TRUE(multiThreadTransformation == estimator.find(sourcePoints, targetPoints,
+    targetNormals));
+}
+
+
 //-----------------------------------------------------------------------------
 template<template<class PoinType> class EstimatorType, class PointType>
 void testWithPreconditionning(
@@ -178,12 +202,101 @@ TEST(TestTransform, FindBySVDWithPreconditionningh)
     "/scan3d.txt", transformation3d);
 }
 
+//-----------------------------------------------------------------------------
+template<class PointType>
+romea::core::Grid<typename PointType::Scalar, 2> makeLikelihoodGrid(
+  const romea::core::PointSet<PointType> & points,
+  const romea::core::GridIndexMapping<typename PointType::Scalar, 2> & gridIndexMapping)
+{
+  // Gaussian likelihood of distance to closest point
+  using Scalar = typename PointType::Scalar;
+  const Scalar resolution = gridIndexMapping.getCellResolution();
+  romea::core::Grid<std::uint8_t, 2> obstacles(gridIndexMapping.getNumberOfCellsAlongAxes());
+  obstacles.setValue(0);
+  for (const PointType & point : points) {
+    obstacles(gridIndexMapping.computeCellIndexes(point.template head<2>())) = 1;
+  }
+
+  romea::core::DistanceTransform<Scalar, 2> distanceTransform(
+    obstacles.getNumberOfCellsAlongAxes(), resolution, 0.5);
+  distanceTransform.compute(obstacles, [](const std::uint8_t & value) {return value != 0;});
+
+  romea::core::Grid<Scalar, 2> likelihoods(obstacles.getNumberOfCellsAlongAxes());
+  const auto & squaredDistances = distanceTransform.getSquaredDistances().getBuffer();
+  for (size_t n = 0; n < squaredDistances.size(); ++n) {
+    likelihoods.getBuffer()[n] = std::exp(-squaredDistances[n] * resolution * resolution / 0.02);
+  }
+  return likelihoods;
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+void testBranchAndBoundThenICP()
+{
+  using Scalar = typename PointType::Scalar;
+  using TransformationMatrixType = Eigen::Matrix<Scalar, 3, 3>;
+  const Eigen::Transform<Scalar, 2, Eigen::Affine> transformation =
+    Eigen::Translation<Scalar, 2>(0.7, -0.45) * Eigen::Rotation2D<Scalar>(0.35);
+
+  romea::core::PointSet<PointType> sourcePoints = loadScan<PointType>("/scan2d.txt");
+  romea::core::PointSet<PointType> targetPoints = projectScan(sourcePoints, transformation);
+
+  const romea::core::GridIndexMapping<Scalar, 2> gridIndexMapping(
+    romea::core::Interval2D<Scalar>(Eigen::Matrix<Scalar, 2, 1>(-6, -6),
+    Eigen::Matrix<Scalar, 2, 1>(6, 6)), 0.05);
+  const romea::core::Grid<Scalar, 2> likelihoods =
+    makeLikelihoodGrid(targetPoints, gridIndexMapping);
+
+  // Guess far outside of ICP convergence basin
+  romea::core::FindRigidTransformationByBranchAndBound<PointType> scanMatcher;
+  scanMatcher.setLinearSearchWindow(1.);
+  scanMatcher.setAngularSearchWindow(0.5);
+  scanMatcher.setMaximalNumberOfThreads(4);
+  scanMatcher.setLikelihoodGrid(likelihoods, gridIndexMapping);
+  ASSERT_TRUE(scanMatcher.find(sourcePoints, TransformationMatrixType::Identity()));
+
+  const TransformationMatrixType & guess = scanMatcher.getTransformation();
+  EXPECT_GT(scanMatcher.getScore(), 0.8);
+  EXPECT_NEAR(guess(0, 2), 0.7, 0.05);
+  EXPECT_NEAR(guess(1, 2), -0.45, 0.05);
+  EXPECT_NEAR(std::atan2(guess(1, 0), guess(0, 0)), 0.35, 0.02);
+
+  // Exhaustive search without pyramid gives the same score
+  romea::core::FindRigidTransformationByBranchAndBound<PointType> exhaustiveScanMatcher;
+  exhaustiveScanMatcher.setLinearSearchWindow(1.);
+  exhaustiveScanMatcher.setAngularSearchWindow(0.5);
+  exhaustiveScanMatcher.setNumberOfPyramidLevels(1);
+  exhaustiveScanMatcher.setLikelihoodGrid(likelihoods, gridIndexMapping);
+  ASSERT_TRUE(exhaustiveScanMatcher.find(sourcePoints, TransformationMatrixType::Identity()));
+  EXPECT_EQ(exhaustiveScanMatcher.getScore(), scanMatcher.getScore());
+
+  // Guess is refined by ICP, which estimates a correction of the guess
+  romea::core::FindRigidTransformationByICP<PointType> icp(0.2);
+  ASSERT_TRUE(icp.find(sourcePoints, targetPoints, guess));
+  EXPECT_NEAR(3,
+    (transformation.matrix().inverse() * icp.getTransformation() * guess).array().sum(), 0.01);
+
+  // No pose reaches an unreachable score
+  scanMatcher.setMinimalScore(1.1);
+  EXPECT_FALSE(scanMatcher.find(sourcePoints, TransformationMatrixType::Identity()));
+  EXPECT_EQ(scanMatcher.getScore(), 0);
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestTransform, FindByBranchAndBoundThenICP)
+{
+  testBranchAndBoundThenICP<Eigen::Vector2d>();
+  testBranchAndBoundThenICP<romea::core::HomogeneousCoordinates2f>();
+}
+
 //-----------------------------------------------------------------------------
 template<class PointType>
 void testICP(
   const std::string & scanFileName,
   const Eigen::Transform<typename PointType::Scalar,
-  romea::core::PointTraits<PointType>::DIM, Eigen::Affine> & transformation)
+  romea::core::PointTraits<PointType>::DIM, Eigen::Affine> & transformation,
+  typename romea::core::FindRigidTransformationByICP<PointType>::EstimationMethod method =
+  romea::core::FindRigidTransformationByICP<PointType>::EstimationMethod::LEAST_SQUARES)
 {
   typedef Eigen::Matrix<typename PointType::Scalar,
       romea::core::PointTraits<PointType>::DIM + 1,
@@ -193,8 +306,6 @@ void testICP(
   romea::core::PointSet<PointType> sourcePoints = loadScan<PointType>(scanFileName);
   romea::core::PointSet<PointType> targetPoints = projectScan(sourcePoints, transformation);
 
-  auto method =
-    romea::core::FindRigidTransformationByICP<PointType>::EstimationMethod::LEAST_SQUARES;
   bool found = icp.find(sourcePoints, targetPoints, GuessMatrix::Identity(), method);
   ASSERT_EQ(true, found);
 
@@ -217,6 +328,118 @@ TEST(TestTransform, FindByICPh)
   //  testICP<romea::HomogeneousCoordinates3d>("/scan3d.txt",transformation3d);
 }
 
+//-----------------------------------------------------------------------------
+TEST(TestTransform, FindByRobustICP)
+{
+  using Method = romea::core::FindRigidTransformationByICP<Eigen::Vector2d>::EstimationMethod;
+  testICP<Eigen::Vector2d>("/scan2d.txt", transformation2d, Method::ROBUST_LEAST_SQUARES);
+  testICP<romea::core::HomogeneousCoordinates2d>("/scan2d.txt", transformation2d,
+    romea::core::FindRigidTransformationByICP<romea::core::HomogeneousCoordinates2d>::
+    EstimationMethod::ROBUST_LEAST_SQUARES);
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestTransform, FindByRobustPointToPointICP)
+{
+  // Point to point ICP needs more iterations than point to plane one
+  romea::core::FindRigidTransformationByICP<Eigen::Vector2d> icp(0.2);
+  icp.setMaximalNumberOfIterations(30);
+  romea::core::PointSet<Eigen::Vector2d> sourcePoints = loadScan<Eigen::Vector2d>("/scan2d.txt");
+  romea::core::PointSet<Eigen::Vector2d> targetPoints = projectScan(sourcePoints, transformation2d);
+
+  ASSERT_TRUE(icp.find(sourcePoints, targetPoints, Eigen::Matrix3d::Identity(),
+    romea::core::FindRigidTransformationByICP<Eigen::Vector2d>::EstimationMethod::ROBUST_SVD));
+  EXPECT_NEAR(3, (transformation2d.matrix().inverse() * icp.getTransformation()).array().sum(),
+    0.01);
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestTransform, FindByWeightedSVD)
+{
+  // Corrupted correspondences get a zero weight and must not bias estimate
+  romea::core::PointSet<Eigen::Vector3d> sourcePoints = loadScan<Eigen::Vector3d>("/scan3d.txt");
+  romea::core::PointSet<Eigen::Vector3d> targetPoints = projectScan(sourcePoints, transformation3d);
+  std::vector<romea::core::Correspondence> correspondences =
+    fakeCorrespondences(sourcePoints.size());
+  for (size_t n = 0; n < correspondences.size(); n += 10) {
+    targetPoints[n] += Eigen::Vector3d(1, -2, 0.5);
+    correspondences[n].weight = 0;
+  }
+
+  romea::core::FindRigidTransformationBySVD<Eigen::Vector3d> estimator;
+  EXPECT_TRUE(estimator.find(sourcePoints, targetPoints, correspondences).
+    isApprox(transformation3d.matrix(), 1e-6));
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestTransform, FindByWeightedLeastSquares)
+{
+  romea::core::PointSet<Eigen::Vector2d> sourcePoints = loadScan<Eigen::Vector2d>("/scan2d.txt");
+  romea::core::PointSet<Eigen::Vector2d> targetPoints = projectScan(sourcePoints, transformation2d);
+  romea::core::NormalSet<Eigen::Vector2d> targetNormals = computeNormals(targetPoints);
+  std::vector<romea::core::Correspondence> correspondences =
+    fakeCorrespondences(sourcePoints.size());
+
+  romea::core::FindRigidTransformationByLeastSquares<Eigen::Vector2d> estimator;
+  Eigen::Matrix3d reference = estimator.find(
+    sourcePoints, targetPoints, targetNormals, correspondences);
+
+  for (size_t n = 0; n < correspondences.size(); n += 10) {
+    targetPoints[n] += Eigen::Vector2d(1, -2);
+    correspondences[n].weight = 0;
+  }
+  EXPECT_TRUE(estimator.find(sourcePoints, targetPoints, targetNormals, correspondences).
+    isApprox(reference, 1e-2));
+}
+
+//-----------------------------------------------------------------------------
+template<class PointType>
+void testSVD(
+  const std::string & scanFileName,
+  const Eigen::Transform<typename PointType::Scalar,
+  romea::core::PointTraits<PointType>::DIM, Eigen::Affine> & transformation)
+{
+  romea::core::PointSet<PointType> sourcePoints = loadScan<PointType>(scanFileName);
+  romea::core::PointSet<PointType> targetPoints = projectScan(sourcePoints, transformation);
+  std::vector<romea::core::Correspondence> correspondences =
+    fakeCorrespondences(sourcePoints.size());
+
+  romea::core::FindRigidTransformationBySVD<PointType> estimator;
+  EXPECT_TRUE(estimator.find(sourcePoints, targetPoints, correspondences).
+    isApprox(transformation.matrix(), 1e-6));
+  EXPECT_TRUE(estimator.find(sourcePoints, targetPoints).
+    isApprox(transformation.matrix(), 1e-6));
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestTransform, FindBySVD)
+{
+  testSVD<Eigen::Vector2d>("/scan2d.txt", transformation2d);
+  testSVD<Eigen::Vector3d>("/scan3d.txt", transformation3d);
+  testSVD<romea::core::HomogeneousCoordinates2d>("/scan2d.txt", transformation2d);
+  testSVD<romea::core::HomogeneousCoordinates3d>("/scan3d.txt", transformation3d);
+}
+
+//-----------------------------------------------------------------------------
+TEST(TestTransform, FindBySVDNeverReturnsReflection)
+{
+  // Coplanar points give a rank deficient cross covariance whose SVD can lead
+  // to a reflection instead of a rotation
+  romea::core::PointSet<Eigen::Vector3d> sourcePoints;
+  romea::core::PointSet<Eigen::Vector3d> targetPoints;
+  for (int i = 0; i < 10; ++i) {
+    for (int j = 0; j < 10; ++j) {
+      sourcePoints.emplace_back(0.1 * i, 0.2 * j - 1, 0);
+      targetPoints.push_back(transformation3d * sourcePoints.back());
+    }
+  }
+
+  romea::core::FindRigidTransformationBySVD<Eigen::Vector3d> estimator;
+  Eigen::Matrix4d H = estimator.find(sourcePoints, targetPoints);
+  EXPECT_NEAR(H.topLeftCorner(3, 3).determinant(), 1, 1e-9);
+  EXPECT_TRUE(H.isApprox(transformation3d.matrix(), 1e-6));
+}
+
 //-----------------------------------------------------------------------------
 int main(int argc, char ** argv)
 {